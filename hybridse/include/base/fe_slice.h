@@ -145,6 +145,12 @@ class RefCountedSlice : public Slice {
 
     RefCountedSlice() : Slice(nullptr, 0), ref_cnt_(nullptr) {}
 
+    // Give up the ownership of a managed buffer that no other slice refers
+    // to, and return it to the caller, who should free it with free(). The
+    // slice keeps referring to the buffer without ownership.
+    // Return nullptr if the buffer is unmanaged or shared.
+    int8_t *ReleaseOwnership();
+
     RefCountedSlice(const RefCountedSlice &slice);
     RefCountedSlice(RefCountedSlice &&);
     RefCountedSlice &operator=(const RefCountedSlice &);
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HYBRIDSE_INCLUDE_CODEC_COLUMN_BUFFER_H_
+#define HYBRIDSE_INCLUDE_CODEC_COLUMN_BUFFER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "codec/list_iterator_codec.h"
+#include "codec/row.h"
+
+namespace hybridse {
+namespace codec {
+
+/**
+ * Window column materialized into a contiguous value array plus a null
+ * bitmap, so that aggregate kernels can run over it with SIMD instead of
+ * decoding one row at a time through `ColumnIterator`.
+ *
+ * Null slots always hold `V()`, sum kernels need no masking.
+ */
+template <class V>
+class ColumnBuffer {
+ public:
+    ColumnBuffer() : null_count_(0) {}
+
+    void Clear() {
+        values_.clear();
+        null_bits_.clear();
+        null_count_ = 0;
+    }
+
+    void Append(const V& value) {
+        if ((values_.size() & 63) == 0) {
+            null_bits_.push_back(0);
+        }
+        values_.push_back(value);
+    }
+
+    void AppendNull() {
+        if ((values_.size() & 63) == 0) {
+            null_bits_.push_back(0);
+        }
+        null_bits_.back() |= uint64_t(1) << (values_.size() & 63);
+        values_.push_back(V());
+        null_count_ += 1;
+    }
+
+    /**
+     * Decode column at `offset` of slice `row_idx` from every row of
+     * `list`, the same field `ColumnImpl<V>` reads.
+     */
+    void Materialize(ListV<Row>* list, uint32_t row_idx, uint32_t col_idx,
+                     uint32_t offset) {
+        Clear();
+        values_.reserve(list->GetCount());
+        auto iter = list->GetIterator();
+        for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+            const int8_t* buf = iter->GetValue().buf(row_idx);
+            if (buf == nullptr || v1::IsNullAt(buf, col_idx)) {
+                AppendNull();
+            } else {
+                Append(*reinterpret_cast<const V*>(buf + offset));
+            }
+        }
+    }
+
+    bool IsNull(size_t pos) const {
+        return (null_bits_[pos >> 6] >> (pos & 63)) & 1;
+    }
+
+    size_t size() const { return values_.size(); }
+    size_t null_count() const { return null_count_; }
+    const V* values() const { return values_.data(); }
+    const uint64_t* null_bits() const { return null_bits_.data(); }
+
+ private:
+    std::vector<V> values_;
+    std::vector<uint64_t> null_bits_;
+    size_t null_count_;
+};
+
+/**
+ * Reduction kernels over column buffers. They use AVX2 when the cpu
+ * supports it and fall back to SSE2 or scalar code otherwise.
+ *
+ * Integer sums wrap like the row-wise aggregation does. Floating point
+ * sums are reassociated across lanes, results may differ from row-wise
+ * aggregation in the last bits.
+ */
+template <class V>
+V ColumnSum(const ColumnBuffer<V>& column);
+
+/**
+ * Sum in double precision, used by avg
+ */
+template <class V>
+double ColumnSumAsDouble(const ColumnBuffer<V>& column);
+
+/**
+ * Return false if there is no non-null value
+ */
+template <class V>
+bool ColumnMin(const ColumnBuffer<V>& column, V* res);
+
+template <class V>
+bool ColumnMax(const ColumnBuffer<V>& column, V* res);
+
+template <class V>
+int64_t ColumnCount(const ColumnBuffer<V>& column) {
+    return column.size() - column.null_count();
+}
+
+namespace v1 {
+
+/**
+ * The aggregates computed by `ColumnBufferAgg`, or-ed into `agg_mask`
+ */
+enum ColumnAggMask : int32_t {
+    kColumnAggSum = 1,
+    kColumnAggDoubleSum = 1 << 1,
+    kColumnAggMin = 1 << 2,
+    kColumnAggMax = 1 << 3,
+};
+
+/**
+ * Entry for llvm: materialize a numeric window column once and compute the
+ * aggregates of `agg_mask` and the non-null count over it. The outputs not
+ * in `agg_mask` are left untouched, so are `min` and `max` if the column has
+ * no non-null value.
+ */
+template <class V>
+void ColumnBufferAgg(int8_t* input, int32_t row_idx, uint32_t col_idx,
+                     int32_t offset, int32_t agg_mask, V* sum,
+                     double* double_sum, V* min, V* max, int64_t* count);
+
+}  // namespace v1
+}  // namespace codec
+}  // namespace hybridse
+
+#endif  // HYBRIDSE_INCLUDE_CODEC_COLUMN_BUFFER_H_
@@ -80,6 +80,12 @@ class Row {
     inline void Append(const hybridse::base::RefCountedSlice &slice) {
         slices_.emplace_back(slice);
     }
+    // Release the ownership of the buffer of slice `pos`,
+    // see RefCountedSlice::ReleaseOwnership
+    int8_t *ReleaseOwnership(int32_t pos) {
+        return 0 == pos ? slice_.ReleaseOwnership()
+                        : slices_[pos - 1].ReleaseOwnership();
+    }
     // Return a string that contains the copy of the referenced data.
     std::string ToString() const;
 
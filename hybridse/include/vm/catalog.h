@@ -379,6 +379,14 @@ class PartitionHandler : public TableHandler {
         }
         return segments;
     }
+
+    /// Get the write version of the data of segment `key`. The segment is
+    /// unchanged as long as the version is unchanged.
+    /// Return `false` by default, cause the segment may change without a
+    /// write, e.g. by the time based expiration.
+    virtual bool GetWriteVersion(const std::string& key, uint64_t* version) {
+        return false;
+    }
     /// Return the name of handler, and return `"PartitionHandler"` by default.
     const std::string GetHandlerTypeName() override {
         return "PartitionHandler";
@@ -53,6 +53,37 @@ TEST_F(MemPoolTest, ByteMemoryPoolTest) {
         ASSERT_EQ("helloworldhybri", std::string(s3, 15));
     }
 }
+
+TEST_F(MemPoolTest, ByteMemoryPoolRecycleTest) {
+    ::openmldb::base::ByteMemoryPool mem_pool;
+    for (int i = 0; i < 8; i++) {
+        mem_pool.Alloc(4000);
+    }
+    mem_pool.Alloc(10000);
+    ASSERT_EQ(9u, mem_pool.GetNewChuckCnt());
+    size_t used_size = mem_pool.GetUsedSize();
+
+    // keep all chucks, the same allocations reuse them
+    mem_pool.Recycle(used_size);
+    ASSERT_EQ(0u, mem_pool.GetUsedSize());
+    ASSERT_EQ(used_size, mem_pool.GetRetainedSize());
+    for (int i = 0; i < 8; i++) {
+        char* s = mem_pool.Alloc(4000);
+        memcpy(s, "helloworld", 10);
+        ASSERT_EQ("helloworld", std::string(s, 10));
+    }
+    mem_pool.Alloc(10000);
+    ASSERT_EQ(9u, mem_pool.GetNewChuckCnt());
+    ASSERT_EQ(9u, mem_pool.GetReusedChuckCnt());
+
+    // keep two chucks at most
+    mem_pool.Recycle(2 * ::openmldb::base::MemoryChunk::DEFAULT_CHUCK_SIZE);
+    ASSERT_EQ(2u * ::openmldb::base::MemoryChunk::DEFAULT_CHUCK_SIZE, mem_pool.GetRetainedSize());
+    mem_pool.Recycle(0);
+    ASSERT_EQ(0u, mem_pool.GetRetainedSize());
+    mem_pool.Alloc(10);
+    ASSERT_EQ(10u, mem_pool.GetNewChuckCnt());
+}
 }  // namespace base
 }  // namespace hybridse
 
@@ -41,6 +41,14 @@ static void BM_ArraySumColDouble(benchmark::State& state) {  // NOLINT
     SumArrayListCol(&state, BENCHMARK, state.range(0), "col4");
 }
 
+static void BM_ColumnBufferSumColInt(benchmark::State& state) {  // NOLINT
+    SumColumnBufferCol(&state, BENCHMARK, state.range(0), "col1");
+}
+
+static void BM_ColumnBufferSumColDouble(benchmark::State& state) {  // NOLINT
+    SumColumnBufferCol(&state, BENCHMARK, state.range(0), "col4");
+}
+
 static void BM_CopyMemSegment(benchmark::State& state) {  // NOLINT
     CopyMemSegment(&state, BENCHMARK, state.range(0));
 }
@@ -81,6 +89,12 @@ static void BM_AllocFromByteMemPool1000(benchmark::State& state) {  // NOLINT
 static void BM_AllocFromNewFree1000(benchmark::State& state) {  // NOLINT
     NewFree1000(&state, BENCHMARK, state.range(0));
 }
+static void BM_JitRuntimeRunStep(benchmark::State& state) {  // NOLINT
+    JitRuntimeRunStep(&state, BENCHMARK, state.range(0), true);
+}
+static void BM_JitRuntimeRunStepFreeAll(benchmark::State& state) {  // NOLINT
+    JitRuntimeRunStep(&state, BENCHMARK, state.range(0), false);
+}
 static void BM_HistoryWindowBuffer(benchmark::State& state) {  // NOLINT
     HistoryWindowBuffer(&state, BENCHMARK, state.range(0));
 }
@@ -95,6 +109,15 @@ static void BM_RequestUnionWindowExcludeCurrentTime(
     benchmark::State& state) {  // NOLINT
     RequestUnionWindowExcludeCurrentTime(&state, BENCHMARK, state.range(0));
 }
+static void BM_CountCateDict(benchmark::State& state) {  // NOLINT
+    CountCateDict(&state, BENCHMARK, state.range(0), state.range(1));
+}
+static void BM_TopNKeyCountCateDict(benchmark::State& state) {  // NOLINT
+    TopNKeyCountCateDict(&state, BENCHMARK, state.range(0), state.range(1));
+}
+static void BM_TopKContainerPush(benchmark::State& state) {  // NOLINT
+    TopKContainerPush(&state, BENCHMARK, state.range(0), state.range(1));
+}
 
 BENCHMARK(BM_CopyArrayList)
     ->Args({10})
@@ -123,6 +146,16 @@ BENCHMARK(BM_ArraySumColDouble)
     ->Args({100})
     ->Args({1000})
     ->Args({10000});
+BENCHMARK(BM_ColumnBufferSumColInt)
+    ->Args({10})
+    ->Args({100})
+    ->Args({1000})
+    ->Args({10000});
+BENCHMARK(BM_ColumnBufferSumColDouble)
+    ->Args({10})
+    ->Args({100})
+    ->Args({1000})
+    ->Args({10000});
 BENCHMARK(BM_RequestUnionSumColDouble)
     ->Args({10})
     ->Args({100})
@@ -156,6 +189,16 @@ BENCHMARK(BM_AllocFromNewFree1000)
     ->Args({100})
     ->Args({1000})
     ->Args({10000});
+BENCHMARK(BM_JitRuntimeRunStep)
+    ->Args({10})
+    ->Args({100})
+    ->Args({1000})
+    ->Args({10000});
+BENCHMARK(BM_JitRuntimeRunStepFreeAll)
+    ->Args({10})
+    ->Args({100})
+    ->Args({1000})
+    ->Args({10000});
 
 BENCHMARK(BM_TimestampFormat);
 BENCHMARK(BM_TimestampToString);
@@ -191,6 +234,27 @@ BENCHMARK(BM_RequestUnionWindowExcludeCurrentTime)
     ->Args({100})
     ->Args({1000})
     ->Args({10000});
+
+// {window size, category cardinality}
+BENCHMARK(BM_CountCateDict)
+    ->Args({1000, 10})
+    ->Args({1000, 100})
+    ->Args({1000, 1000})
+    ->Args({10000, 10})
+    ->Args({10000, 1000})
+    ->Args({10000, 10000});
+BENCHMARK(BM_TopNKeyCountCateDict)
+    ->Args({1000, 10})
+    ->Args({1000, 100})
+    ->Args({1000, 1000})
+    ->Args({10000, 10})
+    ->Args({10000, 1000})
+    ->Args({10000, 10000});
+BENCHMARK(BM_TopKContainerPush)
+    ->Args({1000, 10})
+    ->Args({1000, 1000})
+    ->Args({10000, 10})
+    ->Args({10000, 10000});
 }  // namespace bm
 }  // namespace hybridse
 
@@ -19,15 +19,21 @@
 #include <string>
 #include <vector>
 #include "case/case_data_mock.h"
+#include "codec/column_buffer.h"
 #include "codec/fe_row_codec.h"
 #include "codec/type_codec.h"
 #include "codegen/ir_base_builder.h"
 #include "codegen/window_ir_builder.h"
+#include "gflags/gflags.h"
 #include "gtest/gtest.h"
+#include "udf/containers.h"
 #include "udf/udf.h"
 #include "udf/udf_test.h"
 #include "vm/jit_runtime.h"
 #include "vm/mem_catalog.h"
+
+DECLARE_uint64(jit_runtime_retain_size_limit);
+
 namespace hybridse {
 namespace bm {
 using codec::ColumnImpl;
@@ -279,6 +285,83 @@ void SumArrayListCol(benchmark::State* state, MODE mode, int64_t data_size,
     }
 }
 
+template <typename V>
+V RunColumnBufferSum(codec::ListV<Row>* list, const codec::ColInfo* info) {
+    codec::ColumnBuffer<V> column;
+    column.Materialize(list, 0, info->idx, info->offset);
+    return codec::ColumnSum(column);
+}
+
+void SumColumnBufferCol(benchmark::State* state, MODE mode, int64_t data_size,
+                        const std::string& col_name) {
+    vm::MemTimeTableHandler window;
+    type::TableDef table_def;
+    BuildData(table_def, window, data_size);
+
+    std::vector<Row> buffer;
+    auto from_iter = window.GetIterator();
+    while (from_iter->Valid()) {
+        buffer.push_back(from_iter->GetValue());
+        from_iter->Next();
+    }
+    codec::ArrayListV<Row> list_table(&buffer);
+
+    vm::SchemasContext schemas_context;
+    schemas_context.BuildTrivial(table_def.catalog(), {&table_def});
+    size_t schema_idx;
+    size_t col_idx;
+    ASSERT_TRUE(
+        schemas_context
+            .ResolveColumnIndexByName("", col_name, &schema_idx, &col_idx)
+            .isOK());
+    const codec::ColInfo* info =
+        schemas_context.GetRowFormat(schema_idx)->GetColumnInfo(col_idx);
+
+    switch (mode) {
+        case BENCHMARK: {
+            switch (info->type) {
+                case type::kInt32: {
+                    for (auto _ : *state) {
+                        benchmark::DoNotOptimize(
+                            RunColumnBufferSum<int32_t>(&list_table, info));
+                    }
+                    break;
+                }
+                case type::kDouble: {
+                    for (auto _ : *state) {
+                        benchmark::DoNotOptimize(
+                            RunColumnBufferSum<double>(&list_table, info));
+                    }
+                    break;
+                }
+                default: {
+                    FAIL();
+                }
+            }
+            break;
+        }
+        case TEST: {
+            switch (info->type) {
+                case type::kInt32: {
+                    if (RunColumnBufferSum<int32_t>(&list_table, info) <= 0) {
+                        FAIL();
+                    }
+                    break;
+                }
+                case type::kDouble: {
+                    if (RunColumnBufferSum<double>(&list_table, info) <= 0) {
+                        FAIL();
+                    }
+                    break;
+                }
+                default: {
+                    FAIL();
+                }
+            }
+        }
+    }
+}
+
 void DoSumTableCol(vm::TableHandler* window, benchmark::State* state, MODE mode,
                    int64_t data_size, const std::string& col_name) {
     vm::SchemasContext schemas_context;
@@ -513,6 +596,53 @@ void ByteMemPoolAlloc1000(benchmark::State* state, MODE mode,
         }
     }
 }
+// a run step of a request: strings and containers of mixed sizes, with a
+// managed object every 16 allocations
+class RunStepObject : public base::FeBaseObject {
+ public:
+    std::vector<int64_t> values;
+};
+static int32_t RunStepAlloc(int64_t alloc_cnt) {
+    auto runtime = hybridse::vm::JitRuntime::get();
+    for (int64_t i = 0; i < alloc_cnt; i++) {
+        benchmark::DoNotOptimize(runtime->AllocManaged(16 + (i * 37) % 512));
+        if (i % 16 == 0) {
+            runtime->AddManagedObject(new RunStepObject());
+        }
+    }
+    runtime->ReleaseRunStep();
+    return 1;
+}
+void JitRuntimeRunStep(benchmark::State* state, MODE mode, int64_t alloc_cnt,
+                       bool retain) {
+    uint64_t retain_size_limit = FLAGS_jit_runtime_retain_size_limit;
+    FLAGS_jit_runtime_retain_size_limit = retain ? retain_size_limit : 0;
+    switch (mode) {
+        case BENCHMARK: {
+            for (auto _ : *state) {
+                benchmark::DoNotOptimize(RunStepAlloc(alloc_cnt));
+            }
+            break;
+        }
+        case TEST: {
+            RunStepAlloc(alloc_cnt);
+            auto stats = hybridse::vm::JitRuntime::get()->GetArenaStats();
+            RunStepAlloc(alloc_cnt);
+            auto next_stats =
+                hybridse::vm::JitRuntime::get()->GetArenaStats();
+            ASSERT_EQ(stats.run_steps + 1, next_stats.run_steps);
+            if (retain) {
+                // the second run step allocates from the retained chucks
+                ASSERT_EQ(stats.new_chucks, next_stats.new_chucks);
+                ASSERT_GT(next_stats.retained_bytes, 0u);
+            } else {
+                ASSERT_EQ(0u, next_stats.retained_bytes);
+            }
+            break;
+        }
+    }
+    FLAGS_jit_runtime_retain_size_limit = retain_size_limit;
+}
 void TimestampFormat(benchmark::State* state, MODE mode) {
     codec::Timestamp timestamp(1590115420000L);
     const std::string format = "%Y-%m-%d %H:%M:%S";
@@ -687,5 +817,98 @@ void RequestUnionWindowExcludeCurrentTime(benchmark::State* state, MODE mode,
         }
     }
 }
+// mimic `count_cate`/`top_n_key_count_cate_where` updates over a window
+// whose category column has `cardinality` distinct values
+static size_t RunCountCate(const std::vector<int32_t>& keys, int64_t bound) {
+    using ContainerT = udf::container::BoundedGroupByDict<int32_t, int32_t, int64_t>;
+    ContainerT container;
+    ContainerT::Init(&container);
+    for (int32_t key : keys) {
+        auto& map = container.map();
+        auto iter = map.find(key);
+        if (iter == map.end()) {
+            map.insert(iter, {key, 1});
+        } else {
+            iter->second += 1;
+        }
+        container.KeepTopKeys(bound);
+    }
+    codec::StringRef output;
+    ContainerT::OutputString(&container, bound >= 0, &output);
+    ContainerT::Destroy(&container);
+    vm::JitRuntime::get()->ReleaseRunStep();
+    return output.size_;
+}
+static size_t RunTopK(const std::vector<int32_t>& keys, int32_t bound) {
+    using ContainerT = udf::container::TopKContainer<int32_t, int32_t>;
+    ContainerT container;
+    ContainerT::Init(&container);
+    for (int32_t key : keys) {
+        ContainerT::Push(&container, key, false, bound);
+    }
+    codec::StringRef output;
+    ContainerT::Output(&container, &output);
+    vm::JitRuntime::get()->ReleaseRunStep();
+    return output.size_;
+}
+static std::vector<int32_t> BuildCategoryKeys(int64_t data_size,
+                                              int64_t cardinality) {
+    std::vector<int32_t> keys;
+    keys.reserve(data_size);
+    for (int64_t i = 0; i < data_size; ++i) {
+        keys.push_back(static_cast<int32_t>((i * 7919) % cardinality));
+    }
+    return keys;
+}
+void CountCateDict(benchmark::State* state, MODE mode, int64_t data_size,
+                   int64_t cardinality) {
+    auto keys = BuildCategoryKeys(data_size, cardinality);
+    switch (mode) {
+        case BENCHMARK: {
+            for (auto _ : *state) {
+                benchmark::DoNotOptimize(RunCountCate(keys, -1));
+            }
+            break;
+        }
+        case TEST: {
+            ASSERT_LT(0u, RunCountCate(keys, -1));
+            break;
+        }
+    }
+}
+void TopNKeyCountCateDict(benchmark::State* state, MODE mode, int64_t data_size,
+                          int64_t cardinality) {
+    auto keys = BuildCategoryKeys(data_size, cardinality);
+    switch (mode) {
+        case BENCHMARK: {
+            for (auto _ : *state) {
+                benchmark::DoNotOptimize(RunCountCate(keys, 10));
+            }
+            break;
+        }
+        case TEST: {
+            ASSERT_LT(0u, RunCountCate(keys, 10));
+            ASSERT_EQ(0u, RunCountCate(keys, 0));
+            break;
+        }
+    }
+}
+void TopKContainerPush(benchmark::State* state, MODE mode, int64_t data_size,
+                       int64_t cardinality) {
+    auto keys = BuildCategoryKeys(data_size, cardinality);
+    switch (mode) {
+        case BENCHMARK: {
+            for (auto _ : *state) {
+                benchmark::DoNotOptimize(RunTopK(keys, 10));
+            }
+            break;
+        }
+        case TEST: {
+            ASSERT_EQ(0u, RunTopK(keys, 0));
+            ASSERT_LT(0u, RunTopK(keys, 10));
+            break;
+        }
+    }
+}
 }  // namespace bm
 }  // namespace hybridse
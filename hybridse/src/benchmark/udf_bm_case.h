@@ -28,6 +28,8 @@ void SumRequestUnionTableCol(benchmark::State* state, MODE mode,
                              int64_t data_size, const std::string& col_name);
 void SumArrayListCol(benchmark::State* state, MODE mode, int64_t data_size,
                      const std::string& col_name);
+void SumColumnBufferCol(benchmark::State* state, MODE mode, int64_t data_size,
+                        const std::string& col_name);
 void CopyMemTable(benchmark::State* state, MODE mode, int64_t data_size);
 void CopyMemSegment(benchmark::State* state, MODE mode, int64_t data_size);
 void CopyArrayList(benchmark::State* state, MODE mode, int64_t data_size);
@@ -43,6 +45,8 @@ void DateFormat(benchmark::State* state, MODE mode);
 void ByteMemPoolAlloc1000(benchmark::State* state, MODE mode,
                           size_t request_size);
 void NewFree1000(benchmark::State* state, MODE mode, size_t request_size);
+void JitRuntimeRunStep(benchmark::State* state, MODE mode, int64_t alloc_cnt,
+                       bool retain);
 
 int64_t RunHistoryWindowBuffer(const hybridse::vm::WindowRange& window_range,
                                uint64_t data_size,
@@ -53,6 +57,13 @@ void HistoryWindowBufferExcludeCurrentTime(benchmark::State* state, MODE mode,
 void RequestUnionWindow(benchmark::State* state, MODE mode, int64_t data_size);
 void RequestUnionWindowExcludeCurrentTime(benchmark::State* state, MODE mode,
                                           int64_t data_size);
+// Category Udaf containers
+void CountCateDict(benchmark::State* state, MODE mode, int64_t data_size,
+                   int64_t cardinality);
+void TopNKeyCountCateDict(benchmark::State* state, MODE mode, int64_t data_size,
+                          int64_t cardinality);
+void TopKContainerPush(benchmark::State* state, MODE mode, int64_t data_size,
+                       int64_t cardinality);
 }  // namespace bm
 }  // namespace hybridse
 #endif  // HYBRIDSE_SRC_BENCHMARK_UDF_BM_CASE_H_
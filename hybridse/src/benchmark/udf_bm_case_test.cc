@@ -31,6 +31,13 @@ TEST_F(UdfBMCaseTest, SumArrayListCol1_TEST) {
     SumArrayListCol(nullptr, TEST, 10000L, "col1");
 }
 
+TEST_F(UdfBMCaseTest, SumColumnBufferCol_TEST) {
+    SumColumnBufferCol(nullptr, TEST, 10L, "col1");
+    SumColumnBufferCol(nullptr, TEST, 1000L, "col1");
+    SumColumnBufferCol(nullptr, TEST, 10L, "col4");
+    SumColumnBufferCol(nullptr, TEST, 1000L, "col4");
+}
+
 TEST_F(UdfBMCaseTest, SumMemTableCol1_TEST) {
     SumMemTableCol(nullptr, TEST, 10L, "col1");
     SumMemTableCol(nullptr, TEST, 100L, "col1");
@@ -72,6 +79,11 @@ TEST_F(UdfBMCaseTest, ByteMemPoolAlloc1000_TEST) {
     ByteMemPoolAlloc1000(nullptr, TEST, 1000);
     ByteMemPoolAlloc1000(nullptr, TEST, 10000);
 }
+TEST_F(UdfBMCaseTest, JitRuntimeRunStep_TEST) {
+    JitRuntimeRunStep(nullptr, TEST, 100, true);
+    JitRuntimeRunStep(nullptr, TEST, 1000, true);
+    JitRuntimeRunStep(nullptr, TEST, 1000, false);
+}
 TEST_F(UdfBMCaseTest, TimestampToString_TEST) {
     TimestampToString(nullptr, TEST);
 }
@@ -79,6 +91,18 @@ TEST_F(UdfBMCaseTest, TimestampFormat_TEST) { TimestampFormat(nullptr, TEST); }
 
 TEST_F(UdfBMCaseTest, DateToString_TEST) { DateToString(nullptr, TEST); }
 TEST_F(UdfBMCaseTest, DateFormat_TEST) { DateFormat(nullptr, TEST); }
+TEST_F(UdfBMCaseTest, CountCateDict_TEST) {
+    CountCateDict(nullptr, TEST, 1000, 10);
+    CountCateDict(nullptr, TEST, 1000, 1000);
+}
+TEST_F(UdfBMCaseTest, TopNKeyCountCateDict_TEST) {
+    TopNKeyCountCateDict(nullptr, TEST, 1000, 10);
+    TopNKeyCountCateDict(nullptr, TEST, 1000, 1000);
+}
+TEST_F(UdfBMCaseTest, TopKContainerPush_TEST) {
+    TopKContainerPush(nullptr, TEST, 1000, 10);
+    TopKContainerPush(nullptr, TEST, 1000, 1000);
+}
 
 }  // namespace bm
 }  // namespace hybridse
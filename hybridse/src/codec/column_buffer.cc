@@ -0,0 +1,316 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "codec/column_buffer.h"
+
+#include <cstring>
+#include <type_traits>
+
+namespace hybridse {
+namespace codec {
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HYBRIDSE_COLUMN_KERNEL_AVX2 1
+#define KERNEL_INLINE inline __attribute__((always_inline))
+#define KERNEL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define HYBRIDSE_COLUMN_KERNEL_AVX2 0
+#define KERNEL_INLINE inline
+#endif
+
+namespace {
+
+// 32 bytes vectors are lowered to one ymm register with AVX2 and two xmm
+// registers with the SSE2 baseline
+template <class V>
+struct VecTrait {
+    typedef V Vec __attribute__((vector_size(32)));
+    static constexpr size_t kLanes = 32 / sizeof(V);
+};
+
+template <class V>
+KERNEL_INLINE typename VecTrait<V>::Vec LoadVec(const V* ptr) {
+    typename VecTrait<V>::Vec v;
+    memcpy(&v, ptr, sizeof(v));
+    return v;
+}
+
+template <class V>
+KERNEL_INLINE typename VecTrait<V>::Vec BroadcastVec(V value) {
+    typename VecTrait<V>::Vec v;
+    for (size_t i = 0; i < VecTrait<V>::kLanes; ++i) {
+        v[i] = value;
+    }
+    return v;
+}
+
+// integers are summed as unsigned to wrap on overflow like llvm `add`
+template <class V, bool = std::is_integral<V>::value>
+struct SumAcc {
+    using type = V;
+};
+template <class V>
+struct SumAcc<V, true> {
+    using type = typename std::make_unsigned<V>::type;
+};
+template <class V>
+using SumAccT = typename SumAcc<V>::type;
+
+template <class V>
+KERNEL_INLINE V SumKernel(const V* values, size_t size) {
+    using AccT = SumAccT<V>;
+    using Vec = typename VecTrait<AccT>::Vec;
+    constexpr size_t kLanes = VecTrait<AccT>::kLanes;
+    auto acc_values = reinterpret_cast<const AccT*>(values);
+    Vec acc0 = BroadcastVec<AccT>(AccT(0));
+    Vec acc1 = acc0;
+    size_t i = 0;
+    for (; i + 2 * kLanes <= size; i += 2 * kLanes) {
+        acc0 += LoadVec(acc_values + i);
+        acc1 += LoadVec(acc_values + i + kLanes);
+    }
+    acc0 += acc1;
+    AccT sum = AccT(0);
+    for (size_t k = 0; k < kLanes; ++k) {
+        sum += acc0[k];
+    }
+    for (; i < size; ++i) {
+        sum += acc_values[i];
+    }
+    return static_cast<V>(sum);
+}
+
+template <class V>
+KERNEL_INLINE double SumAsDoubleKernel(const V* values, size_t size) {
+    typedef double DVec __attribute__((vector_size(32)));
+    typedef V SrcVec __attribute__((vector_size(4 * sizeof(V))));
+    DVec acc0 = {0, 0, 0, 0};
+    DVec acc1 = acc0;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        SrcVec src0, src1;
+        memcpy(&src0, values + i, sizeof(src0));
+        memcpy(&src1, values + i + 4, sizeof(src1));
+        acc0 += __builtin_convertvector(src0, DVec);
+        acc1 += __builtin_convertvector(src1, DVec);
+    }
+    acc0 += acc1;
+    double sum = acc0[0] + acc0[1] + acc0[2] + acc0[3];
+    for (; i < size; ++i) {
+        sum += static_cast<double>(values[i]);
+    }
+    return sum;
+}
+
+template <class V, bool IS_MIN>
+KERNEL_INLINE typename VecTrait<V>::Vec SelectVec(
+    typename VecTrait<V>::Vec l, typename VecTrait<V>::Vec r) {
+    // lane mask of all ones if picking `r`, as integer vector of same width
+    auto mask = IS_MIN ? (r < l) : (r > l);
+    using MaskVec = decltype(mask);
+    MaskVec li, ri;
+    memcpy(&li, &l, sizeof(l));
+    memcpy(&ri, &r, sizeof(r));
+    MaskVec res = (ri & mask) | (li & ~mask);
+    typename VecTrait<V>::Vec out;
+    memcpy(&out, &res, sizeof(out));
+    return out;
+}
+
+template <class V, bool IS_MIN>
+KERNEL_INLINE V SelectScalar(V l, V r) {
+    return (IS_MIN ? (r < l) : (r > l)) ? r : l;
+}
+
+// min or max over [begin, end) of values without nulls
+template <class V, bool IS_MIN>
+KERNEL_INLINE V MinMaxDenseKernel(const V* values, size_t begin, size_t end,
+                                  V init) {
+    using Vec = typename VecTrait<V>::Vec;
+    constexpr size_t kLanes = VecTrait<V>::kLanes;
+    Vec acc = BroadcastVec<V>(init);
+    size_t i = begin;
+    for (; i + kLanes <= end; i += kLanes) {
+        acc = SelectVec<V, IS_MIN>(acc, LoadVec(values + i));
+    }
+    V res = init;
+    for (size_t k = 0; k < kLanes; ++k) {
+        res = SelectScalar<V, IS_MIN>(res, acc[k]);
+    }
+    for (; i < end; ++i) {
+        res = SelectScalar<V, IS_MIN>(res, values[i]);
+    }
+    return res;
+}
+
+template <class V, bool IS_MIN>
+KERNEL_INLINE bool MinMaxKernel(const V* values, const uint64_t* null_bits,
+                                size_t size, size_t null_count, V* out) {
+    if (null_count == size) {
+        return false;
+    }
+    // seed with the first non-null value
+    size_t first = 0;
+    if (null_count > 0) {
+        while ((null_bits[first >> 6] >> (first & 63)) & 1) {
+            first += 1;
+        }
+    }
+    V res = values[first];
+    if (null_count == 0) {
+        *out = MinMaxDenseKernel<V, IS_MIN>(values, 0, size, res);
+        return true;
+    }
+    // blocks of 64 rows without null run vectorized, others scalar
+    for (size_t block = 0; block * 64 < size; ++block) {
+        size_t begin = block * 64;
+        size_t end = begin + 64 < size ? begin + 64 : size;
+        uint64_t bits = null_bits[block];
+        if (bits == 0) {
+            res = MinMaxDenseKernel<V, IS_MIN>(values, begin, end, res);
+            continue;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            if (!((bits >> (i - begin)) & 1)) {
+                res = SelectScalar<V, IS_MIN>(res, values[i]);
+            }
+        }
+    }
+    *out = res;
+    return true;
+}
+
+#if HYBRIDSE_COLUMN_KERNEL_AVX2
+static bool CpuSupportsAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+template <class V>
+KERNEL_TARGET_AVX2 V SumKernelAvx2(const V* values, size_t size) {
+    return SumKernel<V>(values, size);
+}
+
+template <class V>
+KERNEL_TARGET_AVX2 double SumAsDoubleKernelAvx2(const V* values,
+                                                size_t size) {
+    return SumAsDoubleKernel<V>(values, size);
+}
+
+template <class V, bool IS_MIN>
+KERNEL_TARGET_AVX2 bool MinMaxKernelAvx2(const V* values,
+                                         const uint64_t* null_bits,
+                                         size_t size, size_t null_count,
+                                         V* out) {
+    return MinMaxKernel<V, IS_MIN>(values, null_bits, size, null_count, out);
+}
+#endif
+
+}  // namespace
+
+template <class V>
+V ColumnSum(const ColumnBuffer<V>& column) {
+#if HYBRIDSE_COLUMN_KERNEL_AVX2
+    if (CpuSupportsAvx2()) {
+        return SumKernelAvx2<V>(column.values(), column.size());
+    }
+#endif
+    return SumKernel<V>(column.values(), column.size());
+}
+
+template <class V>
+double ColumnSumAsDouble(const ColumnBuffer<V>& column) {
+#if HYBRIDSE_COLUMN_KERNEL_AVX2
+    if (CpuSupportsAvx2()) {
+        return SumAsDoubleKernelAvx2<V>(column.values(), column.size());
+    }
+#endif
+    return SumAsDoubleKernel<V>(column.values(), column.size());
+}
+
+template <class V>
+bool ColumnMin(const ColumnBuffer<V>& column, V* res) {
+#if HYBRIDSE_COLUMN_KERNEL_AVX2
+    if (CpuSupportsAvx2()) {
+        return MinMaxKernelAvx2<V, true>(column.values(), column.null_bits(),
+                                         column.size(), column.null_count(),
+                                         res);
+    }
+#endif
+    return MinMaxKernel<V, true>(column.values(), column.null_bits(),
+                                 column.size(), column.null_count(), res);
+}
+
+template <class V>
+bool ColumnMax(const ColumnBuffer<V>& column, V* res) {
+#if HYBRIDSE_COLUMN_KERNEL_AVX2
+    if (CpuSupportsAvx2()) {
+        return MinMaxKernelAvx2<V, false>(column.values(), column.null_bits(),
+                                          column.size(), column.null_count(),
+                                          res);
+    }
+#endif
+    return MinMaxKernel<V, false>(column.values(), column.null_bits(),
+                                  column.size(), column.null_count(), res);
+}
+
+namespace v1 {
+
+template <class V>
+void ColumnBufferAgg(int8_t* input, int32_t row_idx, uint32_t col_idx,
+                     int32_t offset, int32_t agg_mask, V* sum,
+                     double* double_sum, V* min, V* max, int64_t* count) {
+    // reuse the buffer across calls on the same thread
+    static thread_local ColumnBuffer<V> column;
+    auto list_ref = reinterpret_cast<ListRef<>*>(input);
+    auto list = reinterpret_cast<ListV<Row>*>(list_ref->list);
+    column.Materialize(list, row_idx, col_idx, offset);
+    if (agg_mask & kColumnAggSum) {
+        *sum = ColumnSum(column);
+    }
+    if (agg_mask & kColumnAggDoubleSum) {
+        *double_sum = ColumnSumAsDouble(column);
+    }
+    if (agg_mask & kColumnAggMin) {
+        ColumnMin(column, min);
+    }
+    if (agg_mask & kColumnAggMax) {
+        ColumnMax(column, max);
+    }
+    *count = ColumnCount(column);
+}
+
+}  // namespace v1
+
+#define INSTANTIATE_COLUMN_KERNELS(V)                                    \
+    template V ColumnSum<V>(const ColumnBuffer<V>&);                     \
+    template double ColumnSumAsDouble<V>(const ColumnBuffer<V>&);        \
+    template bool ColumnMin<V>(const ColumnBuffer<V>&, V*);              \
+    template bool ColumnMax<V>(const ColumnBuffer<V>&, V*);              \
+    template void v1::ColumnBufferAgg<V>(int8_t*, int32_t, uint32_t,     \
+                                         int32_t, int32_t, V*, double*,  \
+                                         V*, V*, int64_t*);
+
+INSTANTIATE_COLUMN_KERNELS(int16_t)
+INSTANTIATE_COLUMN_KERNELS(int32_t)
+INSTANTIATE_COLUMN_KERNELS(int64_t)
+INSTANTIATE_COLUMN_KERNELS(float)
+INSTANTIATE_COLUMN_KERNELS(double)
+
+#undef INSTANTIATE_COLUMN_KERNELS
+
+}  // namespace codec
+}  // namespace hybridse
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "codec/column_buffer.h"
+
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace hybridse {
+namespace codec {
+
+class ColumnBufferTest : public ::testing::Test {};
+
+template <class V>
+void CheckKernels(size_t size, size_t null_step) {
+    ColumnBuffer<V> column;
+    V sum = 0;
+    double double_sum = 0;
+    int64_t cnt = 0;
+    V min = std::numeric_limits<V>::max();
+    V max = std::numeric_limits<V>::lowest();
+    for (size_t i = 0; i < size; ++i) {
+        if (null_step > 0 && i % null_step == 0) {
+            column.AppendNull();
+            continue;
+        }
+        V value = static_cast<V>((i * 37) % 101) - static_cast<V>(50);
+        column.Append(value);
+        sum += value;
+        double_sum += value;
+        cnt += 1;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    ASSERT_EQ(size, column.size());
+    ASSERT_EQ(cnt, ColumnCount(column));
+    ASSERT_DOUBLE_EQ(static_cast<double>(sum),
+                     static_cast<double>(ColumnSum(column)));
+    ASSERT_DOUBLE_EQ(double_sum, ColumnSumAsDouble(column));
+    V res_min, res_max;
+    ASSERT_EQ(cnt > 0, ColumnMin(column, &res_min));
+    ASSERT_EQ(cnt > 0, ColumnMax(column, &res_max));
+    if (cnt > 0) {
+        ASSERT_EQ(min, res_min);
+        ASSERT_EQ(max, res_max);
+    }
+}
+
+template <class V>
+void CheckKernels() {
+    for (size_t size : {0, 1, 7, 64, 65, 1000}) {
+        for (size_t null_step : {0, 1, 3, 100}) {
+            CheckKernels<V>(size, null_step);
+        }
+    }
+}
+
+TEST_F(ColumnBufferTest, Int16KernelTest) { CheckKernels<int16_t>(); }
+TEST_F(ColumnBufferTest, Int32KernelTest) { CheckKernels<int32_t>(); }
+TEST_F(ColumnBufferTest, Int64KernelTest) { CheckKernels<int64_t>(); }
+TEST_F(ColumnBufferTest, FloatKernelTest) { CheckKernels<float>(); }
+TEST_F(ColumnBufferTest, DoubleKernelTest) { CheckKernels<double>(); }
+
+TEST_F(ColumnBufferTest, NullBitmapTest) {
+    ColumnBuffer<int32_t> column;
+    for (int32_t i = 0; i < 130; ++i) {
+        if (i % 2 == 0) {
+            column.AppendNull();
+        } else {
+            column.Append(i);
+        }
+    }
+    ASSERT_EQ(65u, column.null_count());
+    for (size_t i = 0; i < column.size(); ++i) {
+        ASSERT_EQ(i % 2 == 0, column.IsNull(i));
+    }
+    column.Clear();
+    ASSERT_EQ(0u, column.size());
+    int32_t res;
+    ASSERT_FALSE(ColumnMin(column, &res));
+}
+
+}  // namespace codec
+}  // namespace hybridse
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
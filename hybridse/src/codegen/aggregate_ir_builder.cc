@@ -21,11 +21,16 @@
 #include <map>
 #include <memory>
 
+#include "codec/column_buffer.h"
 #include "codegen/expr_ir_builder.h"
 #include "codegen/ir_base_builder.h"
 #include "codegen/variable_ir_builder.h"
 #include "gflags/gflags.h"
 #include "glog/logging.h"
+
+DECLARE_bool(enable_column_buffer_agg);
+DECLARE_bool(enable_spark_unsaferow_format);
+
 namespace hybridse {
 namespace codegen {
 
@@ -622,6 +627,10 @@ base::Status AggregateIRBuilder::BuildMulti(const std::string& base_funcname,
         module_->getOrInsertFunction(fn_name, fnt),
         {window_ptr.GetValue(&builder), builder.CreateLoad(output_buf)});
 
+    if (FLAGS_enable_column_buffer_agg && !FLAGS_enable_spark_unsaferow_format) {
+        return BuildColumnBufferAgg(fn, output_schema);
+    }
+
     ::llvm::BasicBlock* head_block =
         ::llvm::BasicBlock::Create(llvm_ctx, "head", fn);
     ::llvm::BasicBlock* enter_block =
@@ -764,5 +773,112 @@ base::Status AggregateIRBuilder::BuildMulti(const std::string& base_funcname,
     return base::Status::OK();
 }
 
+static std::string GetColumnBufferAggFuncName(node::DataType dtype) {
+    switch (dtype) {
+        case ::hybridse::node::kInt16:
+            return "hybridse_storage_column_buffer_agg_int16";
+        case ::hybridse::node::kInt32:
+            return "hybridse_storage_column_buffer_agg_int32";
+        case ::hybridse::node::kInt64:
+            return "hybridse_storage_column_buffer_agg_int64";
+        case ::hybridse::node::kFloat:
+            return "hybridse_storage_column_buffer_agg_float";
+        case ::hybridse::node::kDouble:
+            return "hybridse_storage_column_buffer_agg_double";
+        default:
+            return "";
+    }
+}
+
+base::Status AggregateIRBuilder::BuildColumnBufferAgg(
+    ::llvm::Function* fn, const vm::Schema& output_schema) {
+    ::llvm::LLVMContext& llvm_ctx = module_->getContext();
+    ::llvm::IRBuilder<> builder(llvm_ctx);
+    auto void_ty = ::llvm::Type::getVoidTy(llvm_ctx);
+    auto int32_ty = ::llvm::Type::getInt32Ty(llvm_ctx);
+    auto int64_ty = ::llvm::Type::getInt64Ty(llvm_ctx);
+    auto double_ty = ::llvm::Type::getDoubleTy(llvm_ctx);
+    auto ptr_ty = ::llvm::Type::getInt8Ty(llvm_ctx)->getPointerTo();
+
+    ::llvm::BasicBlock* block = ::llvm::BasicBlock::Create(llvm_ctx, "column_agg", fn);
+    builder.SetInsertPoint(block);
+    ::llvm::Value* input_arg = fn->arg_begin();
+    ::llvm::Value* output_arg = fn->arg_begin() + 1;
+
+    std::map<uint32_t, NativeValue> dummy_map;
+    BufNativeEncoderIRBuilder output_encoder(&dummy_map, &output_schema, block);
+    for (auto& pair : agg_col_infos_) {
+        auto& info = pair.second;
+        std::string agg_fn_name = GetColumnBufferAggFuncName(info.col_type);
+        CHECK_TRUE(!agg_fn_name.empty(), common::kCodegenUdafError,
+                   "Column buffer agg not support type ", DataTypeName(info.col_type))
+        ::llvm::Type* col_ty = GetOutputLlvmType(llvm_ctx, "sum", info.col_type);
+
+        size_t slice_idx = info.schema_idx;
+        if (schema_context_->GetRowFormat() != nullptr) {
+            slice_idx = schema_context_->GetRowFormat()->GetSliceId(info.schema_idx);
+        }
+
+        // only the aggregates of the column in the plan are computed
+        int32_t agg_mask = 0;
+        for (auto& fname : info.agg_funcs) {
+            if (fname == "sum") {
+                agg_mask |= codec::v1::kColumnAggSum;
+            } else if (fname == "avg") {
+                agg_mask |= codec::v1::kColumnAggDoubleSum;
+            } else if (fname == "min") {
+                agg_mask |= codec::v1::kColumnAggMin;
+            } else if (fname == "max") {
+                agg_mask |= codec::v1::kColumnAggMax;
+            }
+        }
+
+        ::llvm::Value* sum = CreateAllocaAtHead(&builder, col_ty, "sum");
+        ::llvm::Value* double_sum = CreateAllocaAtHead(&builder, double_ty, "double_sum");
+        ::llvm::Value* min = CreateAllocaAtHead(&builder, col_ty, "min");
+        ::llvm::Value* max = CreateAllocaAtHead(&builder, col_ty, "max");
+        ::llvm::Value* cnt = CreateAllocaAtHead(&builder, int64_ty, "cnt");
+        ::llvm::Value* zero = ::llvm::Constant::getNullValue(col_ty);
+        builder.CreateStore(zero, min);
+        builder.CreateStore(zero, max);
+
+        auto col_ptr_ty = col_ty->getPointerTo();
+        auto agg_func = module_->getOrInsertFunction(
+            agg_fn_name,
+            ::llvm::FunctionType::get(void_ty,
+                                      {ptr_ty, int32_ty, int32_ty, int32_ty, int32_ty, col_ptr_ty,
+                                       double_ty->getPointerTo(), col_ptr_ty, col_ptr_ty, int64_ty->getPointerTo()},
+                                      false));
+        builder.CreateCall(agg_func, {input_arg, builder.getInt32(slice_idx), builder.getInt32(info.col_idx),
+                                      builder.getInt32(info.offset), builder.getInt32(agg_mask), sum, double_sum,
+                                      min, max, cnt});
+
+        ::llvm::Value* cnt_value = builder.CreateLoad(cnt);
+        ::llvm::Value* is_empty = builder.CreateICmpEQ(cnt_value, builder.getInt64(0));
+        for (size_t i = 0; i < info.GetOutputNum(); ++i) {
+            auto& fname = info.agg_funcs[i];
+            size_t out_idx = info.output_idxs[i];
+            NativeValue value;
+            if (fname == "sum") {
+                value = NativeValue::Create(builder.CreateLoad(sum));
+            } else if (fname == "avg") {
+                value = NativeValue::Create(
+                    builder.CreateFDiv(builder.CreateLoad(double_sum), builder.CreateSIToFP(cnt_value, double_ty)));
+            } else if (fname == "count") {
+                value = NativeValue::Create(cnt_value);
+            } else if (fname == "min") {
+                value = NativeValue::CreateWithFlag(builder.CreateLoad(min), is_empty);
+            } else if (fname == "max") {
+                value = NativeValue::CreateWithFlag(builder.CreateLoad(max), is_empty);
+            } else {
+                FAIL_STATUS(common::kCodegenUdafError, "Unknown agg function name: ", fname)
+            }
+            output_encoder.BuildEncodePrimaryField(output_arg, out_idx, value);
+        }
+    }
+    builder.CreateRetVoid();
+    return base::Status::OK();
+}
+
 }  // namespace codegen
 }  // namespace hybridse
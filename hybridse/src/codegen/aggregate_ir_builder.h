@@ -104,6 +104,11 @@ class AggregateIRBuilder {
     bool empty() const { return agg_col_infos_.empty(); }
 
  private:
+    // materialize each input column into a column buffer and reduce it
+    // with simd kernels instead of the fused row loop
+    base::Status BuildColumnBufferAgg(::llvm::Function* fn,
+                                      const vm::Schema& output_schema);
+
     const vm::SchemasContext* schema_context_;
     ::llvm::Module* module_;
     const node::FrameNode* frame_node_;
@@ -17,6 +17,9 @@
 #include <string>
 #include <vector>
 #include "codegen/fn_let_ir_builder_test.h"
+#include "gflags/gflags.h"
+
+DECLARE_bool(enable_column_buffer_agg);
 
 namespace hybridse {
 namespace codegen {
@@ -31,7 +34,7 @@ class AggregateIRBuilderTest : public ::testing::Test {
     node::NodeManager manager;
 };
 
-TEST_F(AggregateIRBuilderTest, TestMixedMultipleAgg) {
+void CheckMixedMultipleAgg(node::NodeManager* manager) {
     std::string sql =
         "SELECT "
         "sum(col1) OVER w1 as col1_sum, "
@@ -79,7 +82,7 @@ TEST_F(AggregateIRBuilderTest, TestMixedMultipleAgg) {
     window_ref.list = ptr;
     int8_t* window_ptr = reinterpret_cast<int8_t*>(&window_ref);
     codec::Schema schema;
-    CheckFnLetBuilder(&manager, table1, "", sql, row_ptr, window_ptr, &schema,
+    CheckFnLetBuilder(manager, table1, "", sql, row_ptr, window_ptr, &schema,
                       &output);
 
     codec::RowView view(schema);
@@ -124,6 +127,16 @@ TEST_F(AggregateIRBuilderTest, TestMixedMultipleAgg) {
     free(ptr);
 }
 
+TEST_F(AggregateIRBuilderTest, TestMixedMultipleAgg) {
+    CheckMixedMultipleAgg(&manager);
+}
+
+TEST_F(AggregateIRBuilderTest, TestMixedMultipleAggWithColumnBuffer) {
+    FLAGS_enable_column_buffer_agg = true;
+    CheckMixedMultipleAgg(&manager);
+    FLAGS_enable_column_buffer_agg = false;
+}
+
 }  // namespace codegen
 }  // namespace hybridse
 
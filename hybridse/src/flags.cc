@@ -22,3 +22,25 @@ DEFINE_string(default_db_name, "_hybridse",
 // Offline Spark config
 DEFINE_bool(enable_spark_unsaferow_format, false,
             "config if codec uses Spark UnsafeRow format");
+
+// Window aggregation config
+DEFINE_bool(enable_column_buffer_agg, false,
+            "config if built-in numeric window aggregates materialize columns "
+            "into contiguous buffers and reduce them with simd kernels");
+
+// Request mode runner config
+DEFINE_bool(enable_concurrent_runner, false,
+            "config if request mode runs independent producer subtrees of a "
+            "runner concurrently, so that remote sub queries and local scans "
+            "of different branches overlap");
+DEFINE_uint32(concurrent_runner_thread_num, 8,
+              "config the worker thread number of concurrent runner");
+DEFINE_uint32(request_result_cache_size, 0,
+              "config the max entries of the cross-request result cache of "
+              "each last join runner over tables without recent writes, 0 to "
+              "disable the cache");
+
+// Jit runtime config
+DEFINE_uint64(jit_runtime_retain_size_limit, 4 * 1024 * 1024,
+              "config the max bytes of arena chucks a thread keeps across "
+              "run steps, 0 to free them all after each run step");
@@ -19,14 +19,17 @@
 
 #include <algorithm>
 #include <functional>
-#include <map>
+#include <new>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "base/type.h"
 #include "codec/type_codec.h"
 #include "udf/literal_traits.h"
 #include "udf/udf.h"
+#include "vm/jit_runtime.h"
 
 namespace hybridse {
 namespace udf {
@@ -65,6 +68,44 @@ struct ContainerStorageTypeTrait<openmldb::base::Timestamp> {
     }
 };
 
+/**
+ * STL compatible allocator backed by the thread local JIT runtime memory
+ * pool. Deallocation is a no-op, all memory is reclaimed at once when the
+ * run step is released, so containers never touch the global allocator on
+ * the update path.
+ */
+template <typename T>
+class ManagedArenaAllocator {
+ public:
+    using value_type = T;
+
+    ManagedArenaAllocator() = default;
+    template <typename U>
+    ManagedArenaAllocator(const ManagedArenaAllocator<U>&) {}  // NOLINT
+
+    T* allocate(size_t n) {
+        // memory pool does not align its chunks
+        size_t bytes = n * sizeof(T) + alignof(T) - 1;
+        auto addr = reinterpret_cast<uintptr_t>(
+            vm::JitRuntime::get()->AllocManaged(bytes));
+        if (addr == 0) {
+            throw std::bad_alloc();
+        }
+        addr = (addr + alignof(T) - 1) & ~(uintptr_t)(alignof(T) - 1);
+        return reinterpret_cast<T*>(addr);
+    }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ManagedArenaAllocator<U>&) const {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const ManagedArenaAllocator<U>&) const {
+        return false;
+    }
+};
+
 template <typename T, typename BoundT>
 class TopKContainer {
  public:
@@ -98,18 +139,24 @@ class TopKContainer {
     }
 
     static void OutputString(ContainerT* ptr, codec::StringRef* output) {
-        auto& map = ptr->map_;
-        if (map.empty()) {
+        auto& values = ptr->values_;
+        size_t top_k = ptr->bound_ > 0 ? static_cast<size_t>(ptr->bound_) : 0;
+        if (values.size() > top_k) {
+            std::nth_element(values.begin(), values.begin() + top_k,
+                             values.end(), std::greater<StorageT>());
+            values.resize(top_k);
+        }
+        if (values.empty()) {
             output->size_ = 0;
             output->data_ = "";
             return;
         }
+        std::sort(values.begin(), values.end(), std::greater<StorageT>());
 
         // estimate output length
         uint32_t str_len = 0;
-        for (auto iter = map.rbegin(); iter != map.rend(); ++iter) {
-            uint32_t key_len = v1::to_string_len(iter->first);
-            str_len += (key_len + 1) * iter->second;  // "x,x,x,"
+        for (auto& value : values) {
+            str_len += v1::to_string_len(value) + 1;  // "x,x,x,"
         }
         // allocate string buffer
         char* buffer = udf::v1::AllocManagedStringBuf(str_len);
@@ -121,15 +168,12 @@ class TopKContainer {
         // fill string buffer
         char* cur = buffer;
         uint32_t remain_space = str_len;
-        for (auto iter = map.rbegin(); iter != map.rend(); ++iter) {
-            for (size_t k = 0; k < iter->second; ++k) {
-                uint32_t key_len =
-                    v1::format_string(iter->first, cur, remain_space);
-                cur += key_len;
-                remain_space -= key_len;
-                if (remain_space-- > 0) {
-                    *(cur++) = ',';
-                }
+        for (auto& value : values) {
+            uint32_t key_len = v1::format_string(value, cur, remain_space);
+            cur += key_len;
+            remain_space -= key_len;
+            if (remain_space-- > 0) {
+                *(cur++) = ',';
             }
         }
         *(buffer + str_len - 1) = '\0';
@@ -138,27 +182,21 @@ class TopKContainer {
     }
 
     void Push(InputT t) {
-        auto key = ContainerStorageTypeTrait<T>::to_stored_value(t);
-        auto iter = map_.find(key);
-        if (iter == map_.end()) {
-            map_.insert(iter, {key, 1});
-        } else {
-            iter->second += 1;
-        }
-        elem_cnt_ += 1;
-        if (elem_cnt_ > bound_) {
-            auto iter_min = map_.begin();
-            iter_min->second -= 1;
-            if (iter_min->second == 0) {
-                map_.erase(iter_min);
+        values_.push_back(ContainerStorageTypeTrait<T>::to_stored_value(t));
+        // evict lazily: once the buffer holds twice the bound, keep the
+        // largest `bound_` values in one pass so pushes stay amortized O(1)
+        size_t top_k = bound_ > 0 ? static_cast<size_t>(bound_) : 0;
+        if (values_.size() > 2 * top_k) {
+            if (top_k > 0) {
+                std::nth_element(values_.begin(), values_.begin() + top_k,
+                                 values_.end(), std::greater<StorageT>());
             }
-            elem_cnt_ -= 1;
+            values_.resize(top_k);
         }
     }
 
  private:
-    std::map<StorageT, size_t, std::less<StorageT>> map_;
-    BoundT elem_cnt_ = 0;
+    std::vector<StorageT, ManagedArenaAllocator<StorageT>> values_;
     BoundT bound_ = -1;  // delayed to be set by first push
 };
 
@@ -176,6 +214,13 @@ class BoundedGroupByDict {
     // self type
     using ContainerT = BoundedGroupByDict<K, V, StorageV>;
 
+    // open addressing dict, keys are only ordered when output
+    using EntryT = std::pair<const StorageK, StorageV>;
+    using MapT =
+        absl::flat_hash_map<StorageK, StorageV, std::hash<StorageK>,
+                            std::equal_to<StorageK>,
+                            ManagedArenaAllocator<EntryT>>;
+
     using FormatValueF =
         std::function<uint32_t(const StorageV&, char*, size_t)>;
 
@@ -217,33 +262,43 @@ class BoundedGroupByDict {
             return;
         }
 
+        // sort entries by key, keeping only the largest `bound_` keys
+        std::vector<const EntryT*, ManagedArenaAllocator<const EntryT*>>
+            entries;
+        entries.reserve(map.size());
+        for (auto& entry : map) {
+            entries.push_back(&entry);
+        }
+        std::sort(entries.begin(), entries.end(),
+                  [](const EntryT* l, const EntryT* r) {
+                      return l->first < r->first;
+                  });
+        if (ptr->bound_ >= 0 &&
+            entries.size() > static_cast<size_t>(ptr->bound_)) {
+            entries.erase(entries.begin(),
+                          entries.end() - static_cast<size_t>(ptr->bound_));
+        }
+        if (is_desc) {
+            std::reverse(entries.begin(), entries.end());
+        }
+        if (entries.empty()) {
+            output->size_ = 0;
+            output->data_ = "";
+            return;
+        }
+
         // estimate output length
         uint32_t str_len = 0;
-        auto stop_pos = map.end();
-        auto stop_rpos = map.rend();
-        if (is_desc) {
-            for (auto iter = map.rbegin(); iter != map.rend(); ++iter) {
-                uint32_t key_len = v1::to_string_len(iter->first);
-                uint32_t value_len = format_value(iter->second, nullptr, 0);
-                uint32_t new_len = str_len + key_len + value_len + 2;  // "k:v,"
-                if (new_len > MAX_OUTPUT_STR_SIZE) {
-                    stop_rpos = iter;
-                    break;
-                } else {
-                    str_len = new_len;
-                }
-            }
-        } else {
-            for (auto iter = map.begin(); iter != map.end(); ++iter) {
-                uint32_t key_len = v1::to_string_len(iter->first);
-                uint32_t value_len = format_value(iter->second, nullptr, 0);
-                uint32_t new_len = str_len + key_len + value_len + 2;  // "k:v,"
-                if (new_len > MAX_OUTPUT_STR_SIZE) {
-                    stop_pos = iter;
-                    break;
-                } else {
-                    str_len = new_len;
-                }
+        auto stop_pos = entries.end();
+        for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+            uint32_t key_len = v1::to_string_len((*iter)->first);
+            uint32_t value_len = format_value((*iter)->second, nullptr, 0);
+            uint32_t new_len = str_len + key_len + value_len + 2;  // "k:v,"
+            if (new_len > MAX_OUTPUT_STR_SIZE) {
+                stop_pos = iter;
+                break;
+            } else {
+                str_len = new_len;
             }
         }
 
@@ -258,43 +313,19 @@ class BoundedGroupByDict {
         // fill string buffer
         char* cur = buffer;
         uint32_t remain_space = str_len;
-        if (is_desc) {
-            for (auto iter = map.rbegin(); iter != map.rend(); ++iter) {
-                if (iter == stop_rpos) {
-                    break;
-                }
-                uint32_t key_len =
-                    v1::format_string(iter->first, cur, remain_space);
-                cur += key_len;
-                *(cur++) = ':';
-                remain_space -= key_len + 1;
-
-                uint32_t value_len =
-                    format_value(iter->second, cur, remain_space);
-                cur += value_len;
-                remain_space -= value_len;
-                if (remain_space-- > 0) {
-                    *(cur++) = ',';
-                }
-            }
-        } else {
-            for (auto iter = map.begin(); iter != map.end(); ++iter) {
-                if (iter == stop_pos) {
-                    break;
-                }
-                uint32_t key_len =
-                    v1::format_string(iter->first, cur, remain_space);
-                cur += key_len;
-                *(cur++) = ':';
-                remain_space -= key_len + 1;
-
-                uint32_t value_len =
-                    format_value(iter->second, cur, remain_space);
-                cur += value_len;
-                remain_space -= value_len;
-                if (remain_space-- > 0) {
-                    *(cur++) = ',';
-                }
+        for (auto iter = entries.begin(); iter != stop_pos; ++iter) {
+            uint32_t key_len =
+                v1::format_string((*iter)->first, cur, remain_space);
+            cur += key_len;
+            *(cur++) = ':';
+            remain_space -= key_len + 1;
+
+            uint32_t value_len =
+                format_value((*iter)->second, cur, remain_space);
+            cur += value_len;
+            remain_space -= value_len;
+            if (remain_space-- > 0) {
+                *(cur++) = ',';
             }
         }
 
@@ -304,10 +335,48 @@ class BoundedGroupByDict {
             str_len - 1;  // must leave one '\0' for string format impl
     }
 
-    std::map<StorageK, StorageV>& map() { return map_; }
+    /**
+     * Bound the dict to the `bound` largest keys, used by `top_n_key_*`
+     * udafs. Keys are evicted lazily: the dict may grow to twice the bound
+     * before every key below the bound-th largest one is dropped in one
+     * pass. A dropped key can never make it back into the top keys, so
+     * the output is the same as evicting on every update.
+     */
+    void KeepTopKeys(int64_t bound) {
+        if (bound < 0) {
+            return;
+        }
+        bound_ = bound;
+        size_t top_n = static_cast<size_t>(bound);
+        if (map_.size() <= 2 * top_n) {
+            return;
+        }
+        if (top_n == 0) {
+            map_.clear();
+            return;
+        }
+        std::vector<StorageK, ManagedArenaAllocator<StorageK>> keys;
+        keys.reserve(map_.size());
+        for (auto& entry : map_) {
+            keys.push_back(entry.first);
+        }
+        auto nth = keys.end() - top_n;
+        std::nth_element(keys.begin(), nth, keys.end());
+        const StorageK lower_key = *nth;
+        for (auto iter = map_.begin(); iter != map_.end();) {
+            if (iter->first < lower_key) {
+                map_.erase(iter++);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+    MapT& map() { return map_; }
 
  private:
-    std::map<StorageK, StorageV> map_;
+    MapT map_;
+    int64_t bound_ = -1;  // set by top_n_key udafs only
 
     static const size_t MAX_OUTPUT_STR_SIZE = 4096;
 };
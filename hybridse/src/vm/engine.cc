@@ -30,6 +30,7 @@
 #include "udf/default_udf_library.h"
 #include "vm/local_tablet_handler.h"
 #include "vm/mem_catalog.h"
+#include "vm/runner_scheduler.h"
 #include "vm/sql_compiler.h"
 
 DECLARE_bool(logtostderr);
@@ -456,6 +457,7 @@ int32_t RequestRunSession::Run(const uint32_t task_id, const Row& in_row, Row* o
     DLOG(INFO) << "Request Row Run with task_id " << task_id;
     RunnerContext ctx(&std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_)->get_sql_context().cluster_job, in_row,
                       sp_name_, is_debug_);
+    ctx.SetScheduler(RunnerScheduler::GetInstance());
     auto output = task->RunWithCache(ctx);
     if (!output) {
         LOG(WARNING) << "Run request plan output is null";
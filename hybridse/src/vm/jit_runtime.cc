@@ -15,9 +15,18 @@
  */
 #include "vm/jit_runtime.h"
 
+#include <algorithm>
+
+#include "gflags/gflags.h"
+
+DECLARE_uint64(jit_runtime_retain_size_limit);
+
 namespace hybridse {
 namespace vm {
 
+// the retained size decays by 1/64 of itself each run step
+constexpr size_t RETAIN_DECAY_SHIFT = 6;
+
 thread_local JitRuntime JitRuntime::tls_runtime_inst_;
 
 JitRuntime* JitRuntime::get() { return &tls_runtime_inst_; }
@@ -35,14 +44,29 @@ void JitRuntime::AddManagedObject(base::FeBaseObject* obj) {
 void JitRuntime::InitRunStep() {}
 
 void JitRuntime::ReleaseRunStep() {
-    mem_pool_.Reset();
+    size_t used_size = mem_pool_.GetUsedSize();
+    stats_.run_steps++;
+    stats_.peak_bytes = std::max(stats_.peak_bytes, static_cast<uint64_t>(used_size));
+    retain_size_ = std::max(used_size, retain_size_ - (retain_size_ >> RETAIN_DECAY_SHIFT));
+    retain_size_ = std::min(retain_size_, static_cast<size_t>(FLAGS_jit_runtime_retain_size_limit));
+    mem_pool_.Recycle(retain_size_);
+    stats_.managed_objects += allocated_obj_pool_.size();
     for (base::FeBaseObject* obj : allocated_obj_pool_) {
         if (obj != nullptr) {
             delete obj;
         }
     }
+    // keep the capacity for the next run step
     allocated_obj_pool_.clear();
 }
 
+JitRuntime::ArenaStats JitRuntime::GetArenaStats() const {
+    ArenaStats stats = stats_;
+    stats.new_chucks = mem_pool_.GetNewChuckCnt();
+    stats.reused_chucks = mem_pool_.GetReusedChuckCnt();
+    stats.retained_bytes = mem_pool_.GetRetainedSize();
+    return stats;
+}
+
 }  // namespace vm
 }  // namespace hybridse
@@ -16,7 +16,7 @@
 #ifndef HYBRIDSE_SRC_VM_JIT_RUNTIME_H_
 #define HYBRIDSE_SRC_VM_JIT_RUNTIME_H_
 
-#include <list>
+#include <vector>
 
 #include "base/fe_object.h"
 #include "base/mem_pool.h"
@@ -26,7 +26,22 @@ namespace vm {
 
 class JitRuntime {
  public:
-    JitRuntime() {}
+    /**
+     * Arena stats of a thread.
+     */
+    struct ArenaStats {
+        uint64_t run_steps = 0;
+        // chucks malloced and chucks reused from the retained ones
+        uint64_t new_chucks = 0;
+        uint64_t reused_chucks = 0;
+        uint64_t managed_objects = 0;
+        // the largest arena size of a run step
+        uint64_t peak_bytes = 0;
+        // the arena size kept for the next run step
+        uint64_t retained_bytes = 0;
+    };
+
+    JitRuntime() : retain_size_(0) {}
 
     /**
      * Get TLS JIT runtime instance.
@@ -56,13 +71,22 @@ class JitRuntime {
     void InitRunStep();
 
     /**
-     * Release resources allocated in run step
+     * Release resources allocated in run step. The arena keeps chucks up to
+     * the high-water-mark of recent run steps, which decays slowly, so that
+     * the following run steps allocate from them instead of malloc.
      */
     void ReleaseRunStep();
 
+    /**
+     * Get the arena stats of the current thread.
+     */
+    ArenaStats GetArenaStats() const;
+
  private:
     openmldb::base::ByteMemoryPool mem_pool_;
-    std::list<base::FeBaseObject*> allocated_obj_pool_;
+    std::vector<base::FeBaseObject*> allocated_obj_pool_;
+    size_t retain_size_;
+    ArenaStats stats_;
 
     static thread_local JitRuntime tls_runtime_inst_;
 };
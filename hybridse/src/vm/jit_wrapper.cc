@@ -17,6 +17,7 @@
 
 #include <string>
 #include <utility>
+#include "codec/column_buffer.h"
 #include "glog/logging.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
@@ -197,6 +198,23 @@ void InitBuiltinJitSymbols(HybridSeJitWrapper* jit) {
     jit->AddExternalFunction(
         "hybridse_storage_row_iter_delete",
         reinterpret_cast<void*>(&hybridse::vm::RowIterDelete));
+    // column buffer aggregation
+    jit->AddExternalFunction(
+        "hybridse_storage_column_buffer_agg_int16",
+        reinterpret_cast<void*>(&codec::v1::ColumnBufferAgg<int16_t>));
+    jit->AddExternalFunction(
+        "hybridse_storage_column_buffer_agg_int32",
+        reinterpret_cast<void*>(&codec::v1::ColumnBufferAgg<int32_t>));
+    jit->AddExternalFunction(
+        "hybridse_storage_column_buffer_agg_int64",
+        reinterpret_cast<void*>(&codec::v1::ColumnBufferAgg<int64_t>));
+    jit->AddExternalFunction(
+        "hybridse_storage_column_buffer_agg_float",
+        reinterpret_cast<void*>(&codec::v1::ColumnBufferAgg<float>));
+    jit->AddExternalFunction(
+        "hybridse_storage_column_buffer_agg_double",
+        reinterpret_cast<void*>(&codec::v1::ColumnBufferAgg<double>));
+
     jit->AddExternalFunction(
         "hybridse_storage_get_row_slice",
         reinterpret_cast<void*>(&hybridse::vm::RowGetSlice));
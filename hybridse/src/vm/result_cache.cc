@@ -0,0 +1,100 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "vm/result_cache.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "gflags/gflags.h"
+
+DECLARE_uint32(request_result_cache_size);
+
+namespace hybridse {
+namespace vm {
+
+// a managed copy of `value`, the empty slice for an empty value
+static base::RefCountedSlice CopySlice(const std::string& value) {
+    if (value.empty()) {
+        return base::RefCountedSlice();
+    }
+    int8_t* buf = reinterpret_cast<int8_t*>(malloc(value.size()));
+    memcpy(buf, value.data(), value.size());
+    return base::RefCountedSlice::CreateManaged(buf, value.size());
+}
+
+std::unique_ptr<ResultCache> ResultCache::Create() {
+    if (FLAGS_request_result_cache_size == 0) {
+        return nullptr;
+    }
+    return std::make_unique<ResultCache>(FLAGS_request_result_cache_size);
+}
+
+bool ResultCache::Get(const std::string& key, uint64_t version, Row* row) {
+    std::vector<std::string> slices;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = entries_.find(key);
+        if (it == entries_.end() || it->second.version != version) {
+            return false;
+        }
+        lru_.splice(lru_.begin(), lru_, it->second.pos);
+        slices = it->second.slices;
+    }
+    *row = Row(CopySlice(slices[0]));
+    for (size_t i = 1; i < slices.size(); i++) {
+        row->Append(CopySlice(slices[i]));
+    }
+    return true;
+}
+
+void ResultCache::Put(const std::string& key, uint64_t version, const Row& row) {
+    if (max_size_ == 0) {
+        return;
+    }
+    std::vector<std::string> slices;
+    for (int32_t i = 0; i < row.GetRowPtrCnt(); i++) {
+        if (row.buf(i) == nullptr) {
+            slices.emplace_back();
+        } else {
+            slices.emplace_back(reinterpret_cast<const char*>(row.buf(i)), row.size(i));
+        }
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        // a request may have computed it at an older version
+        if (it->second.version <= version) {
+            it->second.version = version;
+            it->second.slices = std::move(slices);
+        }
+        lru_.splice(lru_.begin(), lru_, it->second.pos);
+        return;
+    }
+    if (entries_.size() >= max_size_) {
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+    }
+    lru_.push_front(key);
+    entries_.emplace(key, Entry{version, std::move(slices), lru_.begin()});
+}
+
+size_t ResultCache::GetSize() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return entries_.size();
+}
+
+}  // namespace vm
+}  // namespace hybridse
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HYBRIDSE_SRC_VM_RESULT_CACHE_H_
+#define HYBRIDSE_SRC_VM_RESULT_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "codec/row.h"
+
+namespace hybridse {
+namespace vm {
+
+using hybridse::codec::Row;
+
+/**
+ * ResultCache keeps the results of a runner across the requests, keyed by
+ * the input key of the runner.
+ *
+ * Every entry is tagged with the write version of the data it was computed
+ * from, and a lookup with another version misses. The rows are copied in and
+ * out, so that a cached row never refers to the memory of a table, and the
+ * rows got by different requests share nothing.
+ */
+class ResultCache {
+ public:
+    explicit ResultCache(uint32_t max_size) : max_size_(max_size) {}
+
+    /**
+     * Create a cache with `FLAGS_request_result_cache_size` entries at most,
+     * nullptr when the result cache is disabled.
+     */
+    static std::unique_ptr<ResultCache> Create();
+
+    /**
+     * Get the row of `key` computed at `version`, false if it is not cached
+     * or it is computed at another version.
+     */
+    bool Get(const std::string& key, uint64_t version, Row* row);
+
+    /**
+     * Put the row of `key` computed at `version`, the least recently used
+     * entry is evicted if the cache is full.
+     */
+    void Put(const std::string& key, uint64_t version, const Row& row);
+
+    size_t GetSize();
+
+ private:
+    struct Entry {
+        uint64_t version;
+        std::vector<std::string> slices;
+        std::list<std::string>::iterator pos;
+    };
+
+    const uint32_t max_size_;
+    std::mutex mu_;
+    std::unordered_map<std::string, Entry> entries_;
+    // the keys from the most recently used one
+    std::list<std::string> lru_;
+};
+
+}  // namespace vm
+}  // namespace hybridse
+#endif  // HYBRIDSE_SRC_VM_RESULT_CACHE_H_
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vm/result_cache.h"
+#include <string>
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+
+DECLARE_uint32(request_result_cache_size);
+
+namespace hybridse {
+namespace vm {
+
+class ResultCacheTest : public ::testing::Test {
+ public:
+    ResultCacheTest() {}
+    ~ResultCacheTest() {}
+};
+
+TEST_F(ResultCacheTest, GetByVersion) {
+    ResultCache cache(16);
+    std::string left = "left";
+    std::string right = "right";
+    Row row(base::RefCountedSlice::Create(left.data(), left.size()));
+    row.Append(base::RefCountedSlice::Create(right.data(), right.size()));
+    cache.Put("key", 1, row);
+    // the cached row is a copy
+    left[0] = 'L';
+
+    Row cached;
+    ASSERT_TRUE(cache.Get("key", 1, &cached));
+    ASSERT_EQ(2, cached.GetRowPtrCnt());
+    ASSERT_EQ("left", std::string(reinterpret_cast<char*>(cached.buf(0)), cached.size(0)));
+    ASSERT_EQ("right", std::string(reinterpret_cast<char*>(cached.buf(1)), cached.size(1)));
+    ASSERT_NE(row.buf(1), cached.buf(1));
+    ASSERT_FALSE(cache.Get("key", 2, &cached));
+    ASSERT_FALSE(cache.Get("other", 1, &cached));
+
+    // a row computed at an older version does not replace a newer one
+    cache.Put("key", 3, Row(base::RefCountedSlice::Create(right.data(), right.size())));
+    cache.Put("key", 2, row);
+    ASSERT_TRUE(cache.Get("key", 3, &cached));
+    ASSERT_EQ(1, cached.GetRowPtrCnt());
+    ASSERT_EQ("right", std::string(reinterpret_cast<char*>(cached.buf(0)), cached.size(0)));
+
+    // the empty row of a join without a match
+    cache.Put("empty", 1, Row());
+    ASSERT_TRUE(cache.Get("empty", 1, &cached));
+    ASSERT_EQ(0, cached.size());
+    ASSERT_EQ(2u, cache.GetSize());
+}
+
+TEST_F(ResultCacheTest, EvictLeastRecentlyUsed) {
+    ResultCache cache(2);
+    std::string value = "value";
+    Row row(base::RefCountedSlice::Create(value.data(), value.size()));
+    Row cached;
+    cache.Put("a", 1, row);
+    cache.Put("b", 1, row);
+    ASSERT_TRUE(cache.Get("a", 1, &cached));
+    cache.Put("c", 1, row);
+    ASSERT_EQ(2u, cache.GetSize());
+    ASSERT_TRUE(cache.Get("a", 1, &cached));
+    ASSERT_FALSE(cache.Get("b", 1, &cached));
+    ASSERT_TRUE(cache.Get("c", 1, &cached));
+}
+
+TEST_F(ResultCacheTest, Create) {
+    ASSERT_EQ(nullptr, ResultCache::Create());
+    FLAGS_request_result_cache_size = 8;
+    ASSERT_NE(nullptr, ResultCache::Create());
+    FLAGS_request_result_cache_size = 0;
+}
+
+}  // namespace vm
+}  // namespace hybridse
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
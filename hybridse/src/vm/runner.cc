@@ -1152,15 +1152,38 @@ std::shared_ptr<DataHandlerList> Runner::BatchRequestRun(RunnerContext& ctx) {
 }
 std::shared_ptr<DataHandler> Runner::RunWithCache(RunnerContext& ctx) {
     if (need_cache_) {
-        auto cached = ctx.GetCache(id_);
-        if (cached != nullptr) {
+        std::shared_ptr<DataHandler> cached;
+        if (!ctx.AcquireCache(id_, &cached)) {
             DLOG(INFO) << "RUNNER ID " << id_ << " HIT CACHE!";
             return cached;
         }
     }
     std::vector<std::shared_ptr<DataHandler>> inputs(producers_.size());
-    for (size_t idx = producers_.size(); idx > 0; idx--) {
-        inputs[idx - 1] = producers_[idx - 1]->RunWithCache(ctx);
+    auto scheduler = ctx.scheduler();
+    if (nullptr != scheduler && producers_.size() > 1) {
+        // subtrees of the other producers run on the scheduler, leaf
+        // producers are too cheap to be worth a task
+        std::vector<std::shared_ptr<RunnerScheduler::Task>> tasks;
+        for (size_t idx = 0; idx + 1 < producers_.size(); idx++) {
+            if (producers_[idx]->producers_.empty()) {
+                continue;
+            }
+            tasks.push_back(scheduler->Submit([this, idx, &ctx, &inputs]() {
+                inputs[idx] = producers_[idx]->RunWithCache(ctx);
+            }));
+        }
+        for (size_t idx = producers_.size(); idx > 0; idx--) {
+            if (idx == producers_.size() || producers_[idx - 1]->producers_.empty()) {
+                inputs[idx - 1] = producers_[idx - 1]->RunWithCache(ctx);
+            }
+        }
+        for (auto& task : tasks) {
+            scheduler->Wait(task);
+        }
+    } else {
+        for (size_t idx = producers_.size(); idx > 0; idx--) {
+            inputs[idx - 1] = producers_[idx - 1]->RunWithCache(ctx);
+        }
     }
 
     auto res = Run(ctx, inputs);
@@ -1576,6 +1599,14 @@ std::shared_ptr<DataHandler> RequestLastJoinRunner::Run(
     }
     auto left_row = std::dynamic_pointer_cast<RowHandler>(left)->GetValue();
     auto &parameter = ctx.GetParameterRow();
+    Row right_row;
+    if (CachedRightRow(left_row, right, parameter, &right_row)) {
+        if (output_right_only_) {
+            return std::shared_ptr<RowHandler>(new MemRowHandler(right_row));
+        }
+        return std::shared_ptr<RowHandler>(new MemRowHandler(
+            Row(left_slices_, left_row, right_slices_, right_row)));
+    }
     if (output_right_only_) {
         return std::shared_ptr<RowHandler>(new MemRowHandler(
             join_gen_.RowLastJoinDropLeftSlices(left_row, right, parameter)));
@@ -1585,6 +1616,36 @@ std::shared_ptr<DataHandler> RequestLastJoinRunner::Run(
     }
 }
 
+bool RequestLastJoinRunner::CachedRightRow(const Row& left_row,
+                                           std::shared_ptr<DataHandler> right,
+                                           const Row& parameter,
+                                           Row* right_row) {
+    // the right row depends on the left row only by the keys without a
+    // condition
+    if (!result_cache_ || kPartitionHandler != right->GetHanlderType() ||
+        join_gen_.condition_gen_.Valid() || !join_gen_.index_key_gen_.Valid()) {
+        return false;
+    }
+    auto partition = std::dynamic_pointer_cast<PartitionHandler>(right);
+    std::string key = join_gen_.index_key_gen_.Gen(left_row, parameter);
+    uint64_t version = 0;
+    // the version is got before the rows, a write in between makes the entry
+    // stale at once
+    if (!partition->GetWriteVersion(key, &version)) {
+        return false;
+    }
+    if (join_gen_.left_key_gen_.Valid()) {
+        key.append(1, '\0');
+        key.append(join_gen_.left_key_gen_.Gen(left_row, parameter));
+    }
+    if (result_cache_->Get(key, version, right_row)) {
+        return true;
+    }
+    *right_row = join_gen_.RowLastJoinDropLeftSlices(left_row, right, parameter);
+    result_cache_->Put(key, version, *right_row);
+    return true;
+}
+
 std::shared_ptr<DataHandler> LastJoinRunner::Run(RunnerContext& ctx,
                                                  const std::vector<std::shared_ptr<DataHandler>>& inputs) {
     auto fail_ptr = std::shared_ptr<DataHandler>();
@@ -3119,6 +3180,75 @@ std::shared_ptr<DataHandler> RequestUnionRunner::Run(
                               range_gen_.window_range_, output_request_row_,
                               exclude_current_time_);
 }
+std::shared_ptr<DataHandlerList> RequestUnionRunner::BatchRequestRun(
+    RunnerContext& ctx) {
+    if (need_batch_cache_ || ctx.GetRequestSize() <= 1 || producers_.size() < 2) {
+        return Runner::BatchRequestRun(ctx);
+    }
+    if (need_cache_) {
+        auto cached = ctx.GetBatchCache(id_);
+        if (cached != nullptr) {
+            DLOG(INFO) << "RUNNER ID " << id_ << " HIT CACHE!";
+            return cached;
+        }
+    }
+    std::vector<std::shared_ptr<DataHandlerList>> batch_inputs(
+        producers_.size());
+    for (size_t idx = producers_.size(); idx > 0; idx--) {
+        batch_inputs[idx - 1] = producers_[idx - 1]->BatchRequestRun(ctx);
+    }
+    // the same checks as Run, the windows of valid requests are looked up
+    // in one batch so that the segment searches of the keys are interleaved
+    std::vector<Row> requests;
+    std::vector<size_t> request_idxs;
+    for (size_t idx = 0; idx < ctx.GetRequestSize(); idx++) {
+        auto left = batch_inputs[0]->Get(idx);
+        auto right = batch_inputs[1]->Get(idx);
+        if (!left || !right || kRowHandler != left->GetHanlderType()) {
+            continue;
+        }
+        requests.push_back(
+            std::dynamic_pointer_cast<RowHandler>(left)->GetValue());
+        request_idxs.push_back(idx);
+    }
+    std::vector<std::shared_ptr<DataHandler>> results(ctx.GetRequestSize());
+    if (!requests.empty()) {
+        auto union_inputs = windows_union_gen_.RunInputs(ctx);
+        auto union_segments = windows_union_gen_.GetRequestWindows(
+            requests, ctx.GetParameterRow(), union_inputs);
+        for (size_t i = 0; i < requests.size(); i++) {
+            int64_t ts_gen = range_gen_.Valid()
+                                 ? range_gen_.ts_gen_.Gen(requests[i])
+                                 : -1;
+            results[request_idxs[i]] = RequestUnionWindow(
+                requests[i], union_segments[i], ts_gen,
+                range_gen_.window_range_, output_request_row_,
+                exclude_current_time_);
+        }
+    }
+    std::shared_ptr<DataHandlerVector> outputs =
+        std::make_shared<DataHandlerVector>();
+    for (auto& res : results) {
+        outputs->Add(res);
+    }
+    if (ctx.is_debug()) {
+        std::ostringstream oss;
+        oss << "RUNNER TYPE: " << RunnerTypeName(type_) << ", ID: " << id_
+            << "\n";
+        for (size_t idx = 0; idx < outputs->GetSize(); idx++) {
+            if (idx >= MAX_DEBUG_BATCH_SiZE) {
+                oss << ">= MAX_DEBUG_BATCH_SiZE...\n";
+                break;
+            }
+            Runner::PrintData(oss, output_schemas_, outputs->Get(idx));
+        }
+        LOG(INFO) << oss.str();
+    }
+    if (need_cache_) {
+        ctx.SetBatchCache(id_, outputs);
+    }
+    return outputs;
+}
 std::shared_ptr<TableHandler> RequestUnionRunner::RequestUnionWindow(
     const Row& request,
     std::vector<std::shared_ptr<TableHandler>> union_segments, int64_t ts_gen,
@@ -3974,6 +4104,34 @@ std::shared_ptr<TableHandler> IndexSeekGenerator::SegmentOfKey(
         }
     }
 }
+std::vector<std::shared_ptr<TableHandler>> IndexSeekGenerator::SegmentsOfKeys(
+    const std::vector<Row>& rows, const Row& parameter, std::shared_ptr<DataHandler> input) {
+    std::vector<std::shared_ptr<TableHandler>> segments(rows.size());
+    if (!input || !index_key_gen_.Valid() || kPartitionHandler != input->GetHanlderType()) {
+        for (size_t i = 0; i < rows.size(); i++) {
+            segments[i] = SegmentOfKey(rows[i], parameter, input);
+        }
+        return segments;
+    }
+    auto partition = std::dynamic_pointer_cast<PartitionHandler>(input);
+    std::vector<std::string> keys;
+    std::vector<size_t> pos;
+    keys.reserve(rows.size());
+    pos.reserve(rows.size());
+    for (size_t i = 0; i < rows.size(); i++) {
+        if (rows[i].empty()) {
+            LOG(WARNING) << "fail to seek segment: key row is empty";
+            continue;
+        }
+        keys.push_back(index_key_gen_.Gen(rows[i], parameter));
+        pos.push_back(i);
+    }
+    auto found = partition->GetSegments(keys);
+    for (size_t i = 0; i < pos.size() && i < found.size(); i++) {
+        segments[pos[i]] = found[i];
+    }
+    return segments;
+}
 
 std::shared_ptr<DataHandler> FilterGenerator::Filter(
     std::shared_ptr<PartitionHandler> partition, const Row& parameter) {
@@ -4021,6 +4179,7 @@ void RunnerContext::SetBatchCache(int64_t id,
 }
 
 std::shared_ptr<DataHandler> RunnerContext::GetCache(int64_t id) const {
+    std::lock_guard<std::mutex> lock(cache_mu_);
     auto iter = cache_.find(id);
     if (iter == cache_.end()) {
         return std::shared_ptr<DataHandler>();
@@ -4031,7 +4190,39 @@ std::shared_ptr<DataHandler> RunnerContext::GetCache(int64_t id) const {
 
 void RunnerContext::SetCache(int64_t id,
                              const std::shared_ptr<DataHandler> data) {
+    std::lock_guard<std::mutex> lock(cache_mu_);
     cache_[id] = data;
+    auto iter = running_.find(id);
+    if (iter != running_.end()) {
+        iter->second.promise.set_value(data);
+        running_.erase(iter);
+    }
+}
+
+bool RunnerContext::AcquireCache(int64_t id,
+                                 std::shared_ptr<DataHandler>* data) {
+    std::shared_future<std::shared_ptr<DataHandler>> output;
+    {
+        std::lock_guard<std::mutex> lock(cache_mu_);
+        auto iter = cache_.find(id);
+        if (iter != cache_.end() && iter->second != nullptr) {
+            *data = iter->second;
+            return false;
+        }
+        if (nullptr == scheduler_) {
+            return true;
+        }
+        auto running_iter = running_.find(id);
+        if (running_iter == running_.end()) {
+            auto& running = running_[id];
+            running.output = running.promise.get_future().share();
+            return true;
+        }
+        output = running_iter->second.output;
+    }
+    // the runner is run by another branch, which never waits for this one
+    *data = output.get();
+    return false;
 }
 
 void RunnerContext::SetRequest(const hybridse::codec::Row& request) {
@@ -17,8 +17,10 @@
 #ifndef HYBRIDSE_SRC_VM_RUNNER_H_
 #define HYBRIDSE_SRC_VM_RUNNER_H_
 
+#include <future>  // NOLINT
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -33,6 +35,8 @@
 #include "vm/core_api.h"
 #include "vm/mem_catalog.h"
 #include "vm/physical_op.h"
+#include "vm/result_cache.h"
+#include "vm/runner_scheduler.h"
 namespace hybridse {
 namespace vm {
 
@@ -247,6 +251,9 @@ class IndexSeekGenerator {
         std::shared_ptr<DataHandler> input);
     std::shared_ptr<TableHandler> SegmentOfKey(
         const Row& row, const Row& parameter, std::shared_ptr<DataHandler> input);
+    // the segments of a batch of rows, the keys of a partition are looked up at once
+    std::vector<std::shared_ptr<TableHandler>> SegmentsOfKeys(
+        const std::vector<Row>& rows, const Row& parameter, std::shared_ptr<DataHandler> input);
     const bool Valid() const { return index_key_gen_.Valid(); }
 
     KeyGenerator index_key_gen_;
@@ -305,7 +312,18 @@ class RequestWindowGenertor {
     std::shared_ptr<TableHandler> GetRequestWindow(
         const Row& row, const Row& parameter, std::shared_ptr<DataHandler> input) {
         auto segment = index_seek_gen_.SegmentOfKey(row, parameter, input);
-
+        return WindowOfSegment(row, parameter, segment);
+    }
+    std::vector<std::shared_ptr<TableHandler>> GetRequestWindows(
+        const std::vector<Row>& rows, const Row& parameter, std::shared_ptr<DataHandler> input) {
+        auto segments = index_seek_gen_.SegmentsOfKeys(rows, parameter, input);
+        for (size_t i = 0; i < rows.size(); i++) {
+            segments[i] = WindowOfSegment(rows[i], parameter, segments[i]);
+        }
+        return segments;
+    }
+    std::shared_ptr<TableHandler> WindowOfSegment(
+        const Row& row, const Row& parameter, std::shared_ptr<TableHandler> segment) {
         if (filter_gen_.Valid()) {
             auto filter_key = filter_gen_.GetKey(row, parameter);
             segment = filter_gen_.Filter(parameter, segment, filter_key);
@@ -646,6 +664,22 @@ class RequestWindowUnionGenerator : public InputsGenerator {
         }
         return union_segments;
     }
+    // the windows of a batch of rows, union_segments[i] are the windows of rows[i]
+    std::vector<std::vector<std::shared_ptr<TableHandler>>> GetRequestWindows(
+        const std::vector<Row>& rows, const Row& parameter,
+        std::vector<std::shared_ptr<DataHandler>> union_inputs) {
+        std::vector<std::vector<std::shared_ptr<TableHandler>>> union_segments(
+            rows.size(), std::vector<std::shared_ptr<TableHandler>>(union_inputs.size()));
+        if (!windows_gen_.empty()) {
+            for (size_t i = 0; i < union_inputs.size(); i++) {
+                auto windows = windows_gen_[i].GetRequestWindows(rows, parameter, union_inputs[i]);
+                for (size_t j = 0; j < rows.size(); j++) {
+                    union_segments[j][i] = windows[j];
+                }
+            }
+        }
+        return union_segments;
+    }
     std::vector<RequestWindowGenertor> windows_gen_;
 };
 class JoinGenerator {
@@ -968,6 +1002,9 @@ class RequestUnionRunner : public Runner {
         RunnerContext& ctx,  // NOLINT
         const std::vector<std::shared_ptr<DataHandler>>& inputs)
         override;  // NOLINT
+    // the windows of all the requests are looked up at once
+    std::shared_ptr<DataHandlerList> BatchRequestRun(
+        RunnerContext& ctx) override;  // NOLINT
     static std::shared_ptr<TableHandler> RequestUnionWindow(
         const Row& request,
         std::vector<std::shared_ptr<TableHandler>> union_segments,
@@ -1073,7 +1110,10 @@ class RequestLastJoinRunner : public Runner {
                           const bool output_right_only)
         : Runner(id, kRunnerRequestLastJoin, schema, limit_cnt),
           join_gen_(join, left_slices, right_slices),
-          output_right_only_(output_right_only) {}
+          output_right_only_(output_right_only),
+          left_slices_(left_slices),
+          right_slices_(right_slices),
+          result_cache_(ResultCache::Create()) {}
     ~RequestLastJoinRunner() {}
 
     std::shared_ptr<DataHandler> Run(
@@ -1091,6 +1131,18 @@ class RequestLastJoinRunner : public Runner {
     }
     JoinGenerator join_gen_;
     const bool output_right_only_;
+
+ private:
+    // the right row of the join of `left_row` from the result cache, false if
+    // it can not be cached
+    bool CachedRightRow(const Row& left_row, std::shared_ptr<DataHandler> right,
+                        const Row& parameter, Row* right_row);
+
+    const size_t left_slices_;
+    const size_t right_slices_;
+    // the right rows keyed by the index key and the join key, nullptr if the
+    // result cache is disabled
+    std::unique_ptr<ResultCache> result_cache_;
 };
 class ConcatRunner : public Runner {
  public:
@@ -1578,8 +1630,16 @@ class RunnerContext {
     bool is_debug() const { return is_debug_; }
 
     const std::string& sp_name() { return sp_name_; }
+    // run independent producers on `scheduler`, nullptr to run them one by one
+    void SetScheduler(RunnerScheduler* scheduler) { scheduler_ = scheduler; }
+    RunnerScheduler* scheduler() const { return scheduler_; }
     std::shared_ptr<DataHandler> GetCache(int64_t id) const;
     void SetCache(int64_t id, std::shared_ptr<DataHandler> data);
+    // with a scheduler, the same cached runner may be reached by branches
+    // running concurrently. return true if the caller should run `id` and
+    // SetCache with the output, otherwise `data` is the output of the branch
+    // which ran it
+    bool AcquireCache(int64_t id, std::shared_ptr<DataHandler>* data);
     void ClearCache() { cache_.clear(); }
     std::shared_ptr<DataHandlerList> GetBatchCache(int64_t id) const;
     void SetBatchCache(int64_t id, std::shared_ptr<DataHandlerList> data);
@@ -1592,8 +1652,16 @@ class RunnerContext {
     hybridse::codec::Row parameter_;
     size_t idx_;
     const bool is_debug_;
+    RunnerScheduler* scheduler_ = nullptr;
     // TODO(chenjing): optimize
+    mutable std::mutex cache_mu_;
     std::map<int64_t, std::shared_ptr<DataHandler>> cache_;
+    // cached runners being run by some branch, with the future of their output
+    struct RunningCache {
+        std::promise<std::shared_ptr<DataHandler>> promise;
+        std::shared_future<std::shared_ptr<DataHandler>> output;
+    };
+    std::map<int64_t, RunningCache> running_;
     std::map<int64_t, std::shared_ptr<DataHandlerList>> batch_cache_;
 };
 }  // namespace vm
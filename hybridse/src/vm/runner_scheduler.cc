@@ -0,0 +1,103 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "vm/runner_scheduler.h"
+
+#include "gflags/gflags.h"
+
+DECLARE_bool(enable_concurrent_runner);
+DECLARE_uint32(concurrent_runner_thread_num);
+
+namespace hybridse {
+namespace vm {
+
+void RunnerScheduler::Task::RunAndNotify() {
+    fn_();
+    fn_ = nullptr;
+    std::lock_guard<std::mutex> lock(mu_);
+    state_.store(kDone);
+    cv_.notify_all();
+}
+
+RunnerScheduler::RunnerScheduler(uint32_t thread_num) : stop_(false) {
+    for (uint32_t i = 0; i < thread_num; i++) {
+        workers_.emplace_back(&RunnerScheduler::Work, this);
+    }
+}
+
+RunnerScheduler::~RunnerScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+RunnerScheduler* RunnerScheduler::GetInstance() {
+    if (!FLAGS_enable_concurrent_runner) {
+        return nullptr;
+    }
+    // never destroyed, workers may still be running at exit
+    static RunnerScheduler* scheduler = new RunnerScheduler(FLAGS_concurrent_runner_thread_num);
+    return scheduler;
+}
+
+std::shared_ptr<RunnerScheduler::Task> RunnerScheduler::Submit(std::function<void()> fn) {
+    auto task = std::make_shared<Task>(std::move(fn));
+    if (workers_.empty()) {
+        // the waiting thread will run it
+        return task;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        queue_.push_back(task);
+    }
+    cv_.notify_one();
+    return task;
+}
+
+void RunnerScheduler::Wait(const std::shared_ptr<Task>& task) {
+    if (task->Claim()) {
+        task->RunAndNotify();
+        return;
+    }
+    std::unique_lock<std::mutex> lock(task->mu_);
+    task->cv_.wait(lock, [&task] { return task->state_.load() == Task::kDone; });
+}
+
+void RunnerScheduler::Work() {
+    while (true) {
+        std::shared_ptr<Task> task;
+        {
+            std::unique_lock<std::mutex> lock(mu_);
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_ && queue_.empty()) {
+                return;
+            }
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        // skip the tasks already run by their waiters
+        if (task->Claim()) {
+            task->RunAndNotify();
+        }
+    }
+}
+
+}  // namespace vm
+}  // namespace hybridse
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HYBRIDSE_SRC_VM_RUNNER_SCHEDULER_H_
+#define HYBRIDSE_SRC_VM_RUNNER_SCHEDULER_H_
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+namespace hybridse {
+namespace vm {
+
+/**
+ * RunnerScheduler runs independent producer subtrees of a runner graph on
+ * a fixed pool of worker threads.
+ *
+ * A task that no worker has picked up yet is run by the thread waiting for
+ * it, so a waiting runner never depends on a free worker and nested waits
+ * can not deadlock the pool.
+ */
+class RunnerScheduler {
+ public:
+    class Task {
+     public:
+        explicit Task(std::function<void()> fn) : fn_(std::move(fn)), state_(kPending) {}
+
+     private:
+        friend class RunnerScheduler;
+        enum State { kPending, kRunning, kDone };
+
+        // claim the task, false if another thread has claimed it
+        bool Claim() {
+            int expected = kPending;
+            return state_.compare_exchange_strong(expected, kRunning);
+        }
+        void RunAndNotify();
+
+        std::function<void()> fn_;
+        std::atomic<int> state_;
+        std::mutex mu_;
+        std::condition_variable cv_;
+    };
+
+    explicit RunnerScheduler(uint32_t thread_num);
+    ~RunnerScheduler();
+
+    /**
+     * Get the scheduler shared by all request runs, nullptr when concurrent
+     * runner is disabled by `FLAGS_enable_concurrent_runner`.
+     */
+    static RunnerScheduler* GetInstance();
+
+    std::shared_ptr<Task> Submit(std::function<void()> fn);
+
+    /**
+     * Wait until `task` is done, run it on the current thread if it is still
+     * queued.
+     */
+    void Wait(const std::shared_ptr<Task>& task);
+
+ private:
+    void Work();
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<Task>> queue_;
+    bool stop_;
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace vm
+}  // namespace hybridse
+#endif  // HYBRIDSE_SRC_VM_RUNNER_SCHEDULER_H_
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vm/runner_scheduler.h"
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+
+namespace hybridse {
+namespace vm {
+
+class RunnerSchedulerTest : public ::testing::Test {
+ public:
+    RunnerSchedulerTest() {}
+    ~RunnerSchedulerTest() {}
+};
+
+TEST_F(RunnerSchedulerTest, RunConcurrently) {
+    RunnerScheduler scheduler(4);
+    std::atomic<int> running(0);
+    std::atomic<int> max_running(0);
+    std::vector<std::shared_ptr<RunnerScheduler::Task>> tasks;
+    for (int i = 0; i < 4; i++) {
+        tasks.push_back(scheduler.Submit([&running, &max_running]() {
+            int cur = ++running;
+            int max = max_running.load();
+            while (cur > max && !max_running.compare_exchange_weak(max, cur)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            running--;
+        }));
+    }
+    for (auto& task : tasks) {
+        scheduler.Wait(task);
+    }
+    ASSERT_EQ(0, running.load());
+    ASSERT_GT(max_running.load(), 1);
+}
+
+TEST_F(RunnerSchedulerTest, NestedWaitWithoutWorkers) {
+    // the queued tasks are run by their waiters
+    RunnerScheduler scheduler(0);
+    std::atomic<int> cnt(0);
+    auto outer = scheduler.Submit([&scheduler, &cnt]() {
+        std::vector<std::shared_ptr<RunnerScheduler::Task>> tasks;
+        for (int i = 0; i < 3; i++) {
+            tasks.push_back(scheduler.Submit([&cnt]() { cnt++; }));
+        }
+        for (auto& task : tasks) {
+            scheduler.Wait(task);
+        }
+        cnt++;
+    });
+    scheduler.Wait(outer);
+    ASSERT_EQ(4, cnt.load());
+}
+
+TEST_F(RunnerSchedulerTest, NestedWaitWithBusyWorker) {
+    RunnerScheduler scheduler(1);
+    std::atomic<int> cnt(0);
+    // the only worker waits for tasks that no other worker can pick up
+    auto outer = scheduler.Submit([&scheduler, &cnt]() {
+        auto inner = scheduler.Submit([&cnt]() { cnt++; });
+        scheduler.Wait(inner);
+        cnt++;
+    });
+    scheduler.Wait(outer);
+    ASSERT_EQ(2, cnt.load());
+}
+
+}  // namespace vm
+}  // namespace hybridse
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
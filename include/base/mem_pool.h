@@ -44,6 +44,10 @@ class MemoryChunk {
         return addr;
     }
     inline MemoryChunk* next() { return next_; }
+    inline void set_next(MemoryChunk* next) { next_ = next; }
+    inline size_t size() const { return chuck_size_; }
+    // make the whole chuck available again
+    inline void Clear() { allocated_size_ = 0; }
     enum { DEFAULT_CHUCK_SIZE = 4096 };
 
  private:
@@ -55,11 +59,13 @@ class MemoryChunk {
 class ByteMemoryPool {
  public:
     explicit ByteMemoryPool(size_t init_size = MemoryChunk::DEFAULT_CHUCK_SIZE)
-        : chucks_(nullptr) {
+        : chucks_(nullptr), free_chucks_(nullptr), new_chuck_cnt_(0), reused_chuck_cnt_(0) {
         ExpandStorage(init_size);
     }
     ~ByteMemoryPool() {
         Reset();
+        DeleteChucks(free_chucks_);
+        free_chucks_ = nullptr;
     }
     char* Alloc(size_t request_size) {
         if (nullptr == chucks_ || chucks_->available_size() < request_size) {
@@ -71,19 +77,86 @@ class ByteMemoryPool {
     // clear last chuck
     // and delete other chucks
     void Reset() {
-        auto chuck = chucks_;
-        while (chuck) {
-            chucks_ = chuck->next();
-            delete chuck;
-            chuck = chucks_;
+        DeleteChucks(chucks_);
+        chucks_ = nullptr;
+    }
+
+    // release all allocated memory like Reset, but keep chucks of at most
+    // `retain_size` bytes in total for the following Allocs
+    void Recycle(size_t retain_size) {
+        size_t retained = 0;
+        MemoryChunk* retained_chucks = nullptr;
+        for (MemoryChunk* list : {chucks_, free_chucks_}) {
+            auto chuck = list;
+            while (chuck) {
+                auto next = chuck->next();
+                if (retained + chuck->size() <= retain_size) {
+                    retained += chuck->size();
+                    chuck->Clear();
+                    chuck->set_next(retained_chucks);
+                    retained_chucks = chuck;
+                } else {
+                    delete chuck;
+                }
+                chuck = next;
+            }
         }
+        chucks_ = nullptr;
+        free_chucks_ = retained_chucks;
     }
+
     void ExpandStorage(size_t request_size) {
+        // first fit from the retained chucks
+        MemoryChunk* prev = nullptr;
+        for (auto chuck = free_chucks_; chuck != nullptr; prev = chuck, chuck = chuck->next()) {
+            if (chuck->size() >= request_size) {
+                if (prev == nullptr) {
+                    free_chucks_ = chuck->next();
+                } else {
+                    prev->set_next(chuck->next());
+                }
+                chuck->set_next(chucks_);
+                chucks_ = chuck;
+                reused_chuck_cnt_++;
+                return;
+            }
+        }
         chucks_ = new MemoryChunk(chucks_, request_size);
+        new_chuck_cnt_++;
+    }
+
+    // bytes of the chucks in use
+    size_t GetUsedSize() const {
+        size_t size = 0;
+        for (auto chuck = chucks_; chuck != nullptr; chuck = chuck->next()) {
+            size += chuck->size();
+        }
+        return size;
+    }
+    size_t GetRetainedSize() const {
+        size_t size = 0;
+        for (auto chuck = free_chucks_; chuck != nullptr; chuck = chuck->next()) {
+            size += chuck->size();
+        }
+        return size;
     }
+    uint64_t GetNewChuckCnt() const { return new_chuck_cnt_; }
+    uint64_t GetReusedChuckCnt() const { return reused_chuck_cnt_; }
 
  private:
+    static void DeleteChucks(MemoryChunk* chuck) {
+        while (chuck) {
+            auto next = chuck->next();
+            delete chuck;
+            chuck = next;
+        }
+    }
+
     MemoryChunk* chucks_;
+    // chucks kept by Recycle
+    MemoryChunk* free_chucks_;
+    uint64_t new_chuck_cnt_;
+    uint64_t reused_chuck_cnt_;
 };
 }  // namespace base
 }  // namespace openmldb
@@ -83,48 +83,6 @@ void APIServerImpl::Process(google::protobuf::RpcController* cntl_base, const Ht
     cntl->response_attachment().append(writer.GetString());
 }
 
-bool APIServerImpl::Json2SQLRequestRow(const butil::rapidjson::Value& non_common_cols_v,
-                                       const butil::rapidjson::Value& common_cols_v,
-                                       std::shared_ptr<openmldb::sdk::SQLRequestRow> row) {
-    auto sch = row->GetSchema();
-
-    // scan all strings to init the total string length
-    decltype(common_cols_v.Size()) str_len_sum = 0;
-    decltype(common_cols_v.Size()) non_common_idx = 0, common_idx = 0;
-    for (decltype(sch->GetColumnCnt()) i = 0; i < sch->GetColumnCnt(); ++i) {
-        // if element is null, GetStringLength() will get 0
-        if (sch->IsConstant(i)) {
-            if (sch->GetColumnType(i) == hybridse::sdk::kTypeString) {
-                str_len_sum += common_cols_v[common_idx].GetStringLength();
-            }
-            ++common_idx;
-        } else {
-            if (sch->GetColumnType(i) == hybridse::sdk::kTypeString) {
-                str_len_sum += non_common_cols_v[non_common_idx].GetStringLength();
-            }
-            ++non_common_idx;
-        }
-    }
-    row->Init(static_cast<int32_t>(str_len_sum));
-
-    non_common_idx = 0, common_idx = 0;
-    for (decltype(sch->GetColumnCnt()) i = 0; i < sch->GetColumnCnt(); ++i) {
-        if (sch->IsConstant(i)) {
-            if (!AppendJsonValue(common_cols_v[common_idx], sch->GetColumnType(i), sch->IsColumnNotNull(i), row)) {
-                return false;
-            }
-            ++common_idx;
-        } else {
-            if (!AppendJsonValue(non_common_cols_v[non_common_idx], sch->GetColumnType(i), sch->IsColumnNotNull(i),
-                                 row)) {
-                return false;
-            }
-            ++non_common_idx;
-        }
-    }
-    return true;
-}
-
 template <typename T>
 bool APIServerImpl::AppendJsonValue(const butil::rapidjson::Value& v, hybridse::sdk::DataType type, bool is_not_null,
                                     T row) {
@@ -217,58 +175,64 @@ void APIServerImpl::RegisterPut() {
         auto db = db_it->second;
         auto table = table_it->second;
 
-        // json2doc, then generate an insert sql
+        // parse in situ, strings are copied into the rows when encoding
+        std::string body = req_body.to_string();
         Document document;
-        if (document.Parse(req_body.to_string().c_str()).HasParseError()) {
+        if (document.ParseInsitu(&body[0]).HasParseError()) {
             DLOG(INFO) << "rapidjson doc parse [" << req_body.to_string().c_str() << "] failed, code "
                        << document.GetParseError() << ", offset " << document.GetErrorOffset();
             writer << err.Set("Json parse failed, error code: " + std::to_string(document.GetParseError()));
             return;
         }
 
-        const auto& value = document["value"];
-        // value should be an array, and multi put is not supported now
-        if (!value.IsArray() || value.Empty() || value.Size() > 1 || !value[0].IsArray()) {
-            writer << err.Set("Invalid value in body, only support to put one row");
+        auto value = document.FindMember("value");
+        // value should be an array of rows
+        if (value == document.MemberEnd() || !value->value.IsArray() || value->value.Empty()) {
+            writer << err.Set("Invalid value in body");
             return;
         }
-        const auto& arr = value[0];
-        std::string holders;
-        for (decltype(arr.Size()) i = 0; i < arr.Size(); ++i) {
-            holders += ((i == 0) ? "?" : ",?");
-        }
+        const auto& rows = value->value;
+
+        // encode rows with the cached table schema directly, no insert sql is parsed
         hybridse::sdk::Status status;
-        std::string insert_placeholder = "insert into " + table + " values(" + holders + ");";
-        auto row = sql_router_->GetInsertRow(db, insert_placeholder, &status);
-        if (!row) {
+        auto insert_rows = sql_router_->GetTableInsertRows(db, table, &status);
+        if (!insert_rows) {
             writer << err.Set(status.msg);
             return;
         }
-        auto schema = row->GetSchema();
+        auto schema = insert_rows->GetSchema();
         auto cnt = schema->GetColumnCnt();
-        if (cnt != static_cast<int>(arr.Size())) {
-            writer << err.Set("column size != schema size");
-            return;
-        }
+        for (decltype(rows.Size()) r = 0; r < rows.Size(); ++r) {
+            const auto& arr = rows[r];
+            if (!arr.IsArray()) {
+                writer << err.Set("Invalid value in body");
+                return;
+            }
+            if (cnt != static_cast<int>(arr.Size())) {
+                writer << err.Set("column size != schema size");
+                return;
+            }
 
-        // scan all strings , calc the sum, to init SQLInsertRow's string length
-        decltype(arr.Size()) str_len_sum = 0;
-        for (int i = 0; i < cnt; ++i) {
-            // if null, GetStringLength() will get 0
-            if (schema->GetColumnType(i) == hybridse::sdk::kTypeString) {
-                str_len_sum += arr[i].GetStringLength();
+            // calc the sum of string lengths to init SQLInsertRow, GetStringLength() is O(1)
+            decltype(arr.Size()) str_len_sum = 0;
+            for (int i = 0; i < cnt; ++i) {
+                // if null, GetStringLength() will get 0
+                if (schema->GetColumnType(i) == hybridse::sdk::kTypeString) {
+                    str_len_sum += arr[i].GetStringLength();
+                }
             }
-        }
-        row->Init(static_cast<int>(str_len_sum));
+            auto row = insert_rows->NewRow();
+            row->Init(static_cast<int>(str_len_sum));
 
-        for (int i = 0; i < cnt; ++i) {
-            if (!AppendJsonValue(arr[i], schema->GetColumnType(i), schema->IsColumnNotNull(i), row)) {
-                writer << err.Set("Translate to insert row failed");
-                return;
+            for (int i = 0; i < cnt; ++i) {
+                if (!AppendJsonValue(arr[i], schema->GetColumnType(i), schema->IsColumnNotNull(i), row)) {
+                    writer << err.Set("Translate to insert row failed");
+                    return;
+                }
             }
         }
 
-        auto ok = sql_router_->ExecuteInsert(db, insert_placeholder, row, &status);
+        auto ok = sql_router_->PutRows(db, insert_rows, &status);
         if (ok) {
             PutResp resp;
             writer << resp;
@@ -300,80 +264,23 @@ void APIServerImpl::ExecuteProcedure(bool has_common_col, const InterfaceProvide
     auto db = db_it->second;
     auto sp = sp_it->second;
 
-    Document document;
-    if (document.Parse(req_body.to_string().c_str()).HasParseError()) {
-        writer << err.Set("Json parse failed");
-        return;
-    }
-
-    butil::rapidjson::Value common_cols_v;
-    if (has_common_col) {
-        auto common_cols = document.FindMember("common_cols");
-        if (common_cols != document.MemberEnd()) {
-            common_cols_v = common_cols->value;  // move
-            if (!common_cols_v.IsArray()) {
-                writer << err.Set("common_cols is not array");
-                return;
-            }
-        } else {
-            common_cols_v.SetArray();  // If there's no common cols, no need to add this field in request
-        }
-    } else {
-        common_cols_v.SetArray();
-    }
-
-    auto input = document.FindMember("input");
-    if (input == document.MemberEnd() || !input->value.IsArray() || input->value.Empty()) {
-        writer << err.Set("Invalid input");
-        return;
-    }
-    const auto& rows = input->value;
-
     hybridse::sdk::Status status;
     // We need to use ShowProcedure to get input schema(should know which column is constant).
     // GetRequestRowByProcedure can't do that.
-    auto sp_info = sql_router_->ShowProcedure(db, sp, &status);
-    if (!sp_info) {
+    auto codec = GetJsonCodec(db, sp, has_common_col, &status);
+    if (!codec) {
         writer << err.Set(status.msg);
         return;
     }
 
-    const auto& schema_impl = dynamic_cast<const ::hybridse::sdk::SchemaImpl&>(sp_info->GetInputSchema());
-    // Hard copy, and RequestRow needs shared schema
-    auto input_schema = std::make_shared<::hybridse::sdk::SchemaImpl>(schema_impl.GetSchema());
-    auto common_column_indices = std::make_shared<openmldb::sdk::ColumnIndicesSet>(input_schema);
-    decltype(common_cols_v.Size()) expected_common_size = 0;
-    if (has_common_col) {
-        for (int i = 0; i < input_schema->GetColumnCnt(); ++i) {
-            if (input_schema->IsConstant(i)) {
-                common_column_indices->AddCommonColumnIdx(i);
-                ++expected_common_size;
-            }
-        }
-        if (common_cols_v.Size() != expected_common_size) {
-            writer << err.Set("Invalid common cols size");
-            return;
-        }
-    }
-    auto expected_input_size = input_schema->GetColumnCnt() - expected_common_size;
-
-    // TODO(hw): SQLRequestRowBatch should add common & non-common cols directly
-    auto row_batch = std::make_shared<sdk::SQLRequestRowBatch>(input_schema, common_column_indices);
-    std::set<std::string> col_set;
-    for (decltype(rows.Size()) i = 0; i < rows.Size(); ++i) {
-        if (!rows[i].IsArray() || rows[i].Size() != expected_input_size) {
-            writer << err.Set("Invalid input data row");
-            return;
-        }
-        auto row = std::make_shared<sdk::SQLRequestRow>(input_schema, col_set);
-
-        // sizes have been checked
-        if (!Json2SQLRequestRow(rows[i], common_cols_v, row)) {
-            writer << err.Set("Translate to request row failed");
-            return;
-        }
-        row->Build();
-        row_batch->AddRow(row);
+    // parsed in situ, the strings of the request point into the body
+    std::string body = req_body.to_string();
+    JsonRequest request;
+    std::string msg;
+    std::shared_ptr<sdk::SQLRequestRowBatch> row_batch;
+    if (!codec->ParseRequest(&body[0], &request, &msg) || !codec->BuildRequestRows(request, &row_batch, &msg)) {
+        writer << err.Set(msg);
+        return;
     }
 
     auto rs = sql_router_->CallSQLBatchRequestProcedure(db, sp, row_batch, &status);
@@ -382,16 +289,31 @@ void APIServerImpl::ExecuteProcedure(bool has_common_col, const InterfaceProvide
         return;
     }
 
-    ExecSPResp resp;
-    // output schema in sp_info is needed for encoding data, so we need a bool in ExecSPResp to know whether to
-    // print schema
-    resp.sp_info = sp_info;
-    if (document.HasMember("need_schema") && document["need_schema"].IsBool() &&
-        document["need_schema"].GetBool()) {
-        resp.need_schema = true;
+    std::string resp;
+    codec->WriteResponse(rs.get(), request.need_schema, &resp);
+    writer.RawDocument(resp.data(), resp.size());
+}
+
+std::shared_ptr<DeploymentJsonCodec> APIServerImpl::GetJsonCodec(const std::string& db, const std::string& sp,
+                                                                  bool has_common_col,
+                                                                  hybridse::sdk::Status* status) {
+    // sp info is cached by the sdk, a different one means the procedure is recreated
+    auto sp_info = sql_router_->ShowProcedure(db, sp, status);
+    if (!sp_info) {
+        return {};
+    }
+    auto key = std::make_tuple(db, sp, has_common_col);
+    {
+        std::lock_guard<std::mutex> lock(codec_mu_);
+        auto it = json_codecs_.find(key);
+        if (it != json_codecs_.end() && it->second->GetProcedureInfo() == sp_info) {
+            return it->second;
+        }
     }
-    resp.rs = rs;
-    writer << resp;
+    auto codec = std::make_shared<DeploymentJsonCodec>(sp_info, has_common_col);
+    std::lock_guard<std::mutex> lock(codec_mu_);
+    json_codecs_[key] = codec;
+    return codec;
 }
 
 void APIServerImpl::RegisterGetSP() {
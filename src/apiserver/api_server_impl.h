@@ -18,12 +18,16 @@
 #define SRC_APISERVER_API_SERVER_IMPL_H_
 
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "apiserver/interface_provider.h"
+#include "apiserver/json_codec.h"
 #include "apiserver/json_helper.h"
 #include "json2pb/rapidjson.h"  // rapidjson's DOM-style API
 #include "proto/api_server.pb.h"
@@ -66,9 +70,10 @@ class APIServerImpl : public APIServer {
     void ExecuteProcedure(bool has_common_col, const InterfaceProvider::Params& param,
             const butil::IOBuf& req_body, JsonWriter& writer); // NOLINT
 
-    static bool Json2SQLRequestRow(const butil::rapidjson::Value& non_common_cols_v,
-                                   const butil::rapidjson::Value& common_cols_v,
-                                   std::shared_ptr<openmldb::sdk::SQLRequestRow> row);
+    // get the json codec of the procedure, compile it if the procedure is new or changed
+    std::shared_ptr<DeploymentJsonCodec> GetJsonCodec(const std::string& db, const std::string& sp,
+                                                      bool has_common_col, hybridse::sdk::Status* status);
+
     template <typename T>
     static bool AppendJsonValue(const butil::rapidjson::Value& v, hybridse::sdk::DataType type, bool is_not_null,
                                 T row);
@@ -78,6 +83,9 @@ class APIServerImpl : public APIServer {
     InterfaceProvider provider_;
     // cluster_sdk_ is not owned by this class.
     ::openmldb::sdk::DBSDK* cluster_sdk_ = nullptr;
+    std::mutex codec_mu_;
+    // key is {db, sp, has_common_col}
+    std::map<std::tuple<std::string, std::string, bool>, std::shared_ptr<DeploymentJsonCodec>> json_codecs_;
 };
 
 struct PutResp {
@@ -25,6 +25,7 @@
 #include "json2pb/rapidjson.h"
 #include "sdk/mini_cluster.h"
 
+DECLARE_uint32(put_rows_max_inflight);
 
 namespace openmldb::apiserver {
 
@@ -370,6 +371,156 @@ TEST_F(APIServerTest, putCase1) {
     ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, "drop table " + table + ";", &status)) << status.msg;
 }
 
+TEST_F(APIServerTest, putMultiRows) {
+    const auto env = APIServerTestEnv::Instance();
+
+    std::string table = "put_multi";
+    std::string ddl = "create table if not exists " + table +
+                      "(c1 string, "
+                      "c3 int, "
+                      "c7 timestamp, "
+                      "index(key=(c1), ts=c7));";
+    hybridse::sdk::Status status;
+    ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, ddl, &status)) << status.msg;
+    ASSERT_TRUE(env->cluster_sdk->Refresh());
+
+    int row_cnt = 20;
+    std::string body = R"({"value": [)";
+    for (int i = 0; i < row_cnt; i++) {
+        if (i > 0) {
+            body.append(",");
+        }
+        body.append("[\"k" + std::to_string(i % 3) + "\", " + std::to_string(i) + ", " +
+                    std::to_string(1620471840256 + i) + "]");
+    }
+    body.append("]}");
+    {
+        brpc::Controller cntl;
+        cntl.http_request().set_method(brpc::HTTP_METHOD_PUT);
+        cntl.http_request().uri() = "http://127.0.0.1:8010/dbs/" + env->db + "/tables/" + table;
+        cntl.request_attachment().append(body);
+        env->http_channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+        PutResp resp;
+        JsonReader reader(cntl.response_attachment().to_string().c_str());
+        reader >> resp;
+        ASSERT_EQ(0, resp.code) << resp.msg;
+        ASSERT_STREQ("ok", resp.msg.c_str());
+    }
+
+    auto rs = env->cluster_remote->ExecuteSQL(env->db, "select * from " + table + ";", &status);
+    ASSERT_TRUE(rs) << "fail to execute sql";
+    ASSERT_EQ(row_cnt, rs->Size());
+    int64_t c3_sum = 0;
+    while (rs->Next()) {
+        int32_t c3 = 0;
+        ASSERT_TRUE(rs->GetInt32(1, &c3));
+        c3_sum += c3;
+    }
+    ASSERT_EQ(row_cnt * (row_cnt - 1) / 2, c3_sum);
+    ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, "drop table " + table + ";", &status)) << status.msg;
+}
+
+TEST_F(APIServerTest, putMultiRowsPartialFail) {
+    const auto env = APIServerTestEnv::Instance();
+
+    std::string table = "put_partial";
+    std::string ddl = "create table if not exists " + table +
+                      "(c1 string, "
+                      "c3 int, "
+                      "c7 timestamp, "
+                      "index(key=(c1), ts=c7));";
+    hybridse::sdk::Status status;
+    ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, ddl, &status)) << status.msg;
+    ASSERT_TRUE(env->cluster_sdk->Refresh());
+
+    // the bad rows in the middle fail the whole request, no row before them is put
+    std::vector<std::string> bodies = {
+        R"({"value": [["k1", 1, 1620471840256], ["k2", 2, "2020-05-01"], ["k3", 3, 1620471840258]]})",
+        R"({"value": [["k1", 1, 1620471840256], ["k2", 2], ["k3", 3, 1620471840258]]})",
+        R"({"value": [["k1", 1, 1620471840256], "k2", ["k3", 3, 1620471840258]]})",
+    };
+    for (const auto& body : bodies) {
+        brpc::Controller cntl;
+        cntl.http_request().set_method(brpc::HTTP_METHOD_PUT);
+        cntl.http_request().uri() = "http://127.0.0.1:8010/dbs/" + env->db + "/tables/" + table;
+        cntl.request_attachment().append(body);
+        env->http_channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+        LOG(INFO) << cntl.response_attachment().to_string();
+        PutResp resp;
+        JsonReader reader(cntl.response_attachment().to_string().c_str());
+        reader >> resp;
+        ASSERT_EQ(-1, resp.code);
+        ASSERT_FALSE(resp.msg.empty());
+    }
+
+    auto rs = env->cluster_remote->ExecuteSQL(env->db, "select * from " + table + ";", &status);
+    ASSERT_TRUE(rs) << "fail to execute sql";
+    ASSERT_EQ(0, rs->Size());
+    ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, "drop table " + table + ";", &status)) << status.msg;
+}
+
+TEST_F(APIServerTest, putMultiRowsMixedPartitions) {
+    const auto env = APIServerTestEnv::Instance();
+
+    // two indexes, so one row is put to the partitions of both keys
+    std::string table = "put_mixed";
+    std::string ddl = "create table if not exists " + table +
+                      "(c1 string, "
+                      "c2 string, "
+                      "c3 int, "
+                      "c7 timestamp, "
+                      "index(key=(c1), ts=c7), index(key=(c2), ts=c7)) options(partitionnum=8);";
+    hybridse::sdk::Status status;
+    ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, ddl, &status)) << status.msg;
+    ASSERT_TRUE(env->cluster_sdk->Refresh());
+
+    int row_cnt = 100;
+    std::string body = R"({"value": [)";
+    for (int i = 0; i < row_cnt; i++) {
+        if (i > 0) {
+            body.append(",");
+        }
+        body.append("[\"a" + std::to_string(i) + "\", \"b" + std::to_string(i % 10) + "\", " + std::to_string(i) +
+                    ", " + std::to_string(1620471840256 + i) + "]");
+    }
+    body.append("]}");
+    // fewer puts in flight than partitions, so the partitions take turns
+    uint32_t old_max_inflight = FLAGS_put_rows_max_inflight;
+    FLAGS_put_rows_max_inflight = 3;
+    {
+        brpc::Controller cntl;
+        cntl.http_request().set_method(brpc::HTTP_METHOD_PUT);
+        cntl.http_request().uri() = "http://127.0.0.1:8010/dbs/" + env->db + "/tables/" + table;
+        cntl.request_attachment().append(body);
+        env->http_channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+        PutResp resp;
+        JsonReader reader(cntl.response_attachment().to_string().c_str());
+        reader >> resp;
+        ASSERT_EQ(0, resp.code) << resp.msg;
+    }
+    FLAGS_put_rows_max_inflight = old_max_inflight;
+
+    auto rs = env->cluster_remote->ExecuteSQL(env->db, "select * from " + table + ";", &status);
+    ASSERT_TRUE(rs) << "fail to execute sql";
+    ASSERT_EQ(row_cnt, rs->Size());
+    // every key of the second index has its 10 rows
+    for (int i = 0; i < 10; i++) {
+        std::string sql = "select c3 from " + table + " where c2 = 'b" + std::to_string(i) + "';";
+        rs = env->cluster_remote->ExecuteSQL(env->db, sql, &status);
+        ASSERT_TRUE(rs) << "fail to execute sql " << sql;
+        ASSERT_EQ(10, rs->Size());
+        while (rs->Next()) {
+            int32_t c3 = 0;
+            ASSERT_TRUE(rs->GetInt32(0, &c3));
+            ASSERT_EQ(i, c3 % 10);
+        }
+    }
+    ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, "drop table " + table + ";", &status)) << status.msg;
+}
+
 TEST_F(APIServerTest, procedure) {
     const auto env = APIServerTestEnv::Instance();
 
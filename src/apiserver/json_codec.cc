@@ -0,0 +1,612 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "apiserver/json_codec.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <set>
+
+#include "absl/strings/str_cat.h"
+#include "json2pb/rapidjson.h"  // rapidjson's SAX-style API
+#include "sdk/base_impl.h"
+
+namespace openmldb {
+namespace apiserver {
+
+namespace {
+
+// JsonRequestHandler is a rapidjson sax handler which collects the scalars of
+// the input rows and common cols into JsonRequest. Keys may come in any order,
+// unknown members are skipped. It has both the old and new names of the
+// handler methods, e.g. Int and AddInt, and keys may come through Key or String
+class JsonRequestHandler {
+ public:
+    JsonRequestHandler(bool has_common_col, JsonRequest* request)
+        : has_common_col_(has_common_col), request_(request) {}
+
+    const std::string& msg() const { return msg_; }
+    bool ok() const { return msg_.empty(); }
+
+    bool Null() { return AddField(JsonField()); }
+    bool Bool(bool b) {
+        if (depth_ == 1 && section_ == kNeedSchema) {
+            request_->need_schema = b;
+            return EndMember();
+        }
+        JsonField field;
+        field.kind = JsonField::kBool;
+        field.bool_value = b;
+        return AddField(field);
+    }
+    bool Int(int i) { return AddInt(i, true, true); }
+    bool Uint(unsigned u) { return AddInt(u, u <= static_cast<unsigned>(INT32_MAX), true); }
+    bool Int64(int64_t i) { return AddInt(i, i >= INT32_MIN && i <= INT32_MAX, true); }
+    bool Uint64(uint64_t u) {
+        return AddInt(static_cast<int64_t>(u), u <= static_cast<uint64_t>(INT32_MAX),
+                      u <= static_cast<uint64_t>(INT64_MAX));
+    }
+    bool AddInt(int i) { return Int(i); }
+    bool AddUint(unsigned u) { return Uint(u); }
+    bool AddInt64(int64_t i) { return Int64(i); }
+    bool AddUint64(uint64_t u) { return Uint64(u); }
+    bool Double(double d) {
+        JsonField field;
+        field.kind = JsonField::kDouble;
+        field.double_value = d;
+        return AddField(field);
+    }
+    bool String(const char* str, butil::rapidjson::SizeType len, bool copy) {
+        if (depth_ == 1 && section_ == kNone) {
+            return Key(str, len, copy);
+        }
+        JsonField field;
+        field.kind = JsonField::kString;
+        field.str = str;
+        field.len = len;
+        return AddField(field);
+    }
+    bool Key(const char* str, butil::rapidjson::SizeType len, bool) {
+        if (section_ == kSkip) {
+            return true;
+        }
+        if (depth_ != 1 || section_ != kNone) {
+            return Fail("Json parse failed");
+        }
+        if (len == 5 && memcmp(str, "input", 5) == 0) {
+            section_ = kInput;
+        } else if (has_common_col_ && len == 11 && memcmp(str, "common_cols", 11) == 0) {
+            section_ = kCommonCols;
+        } else if (len == 11 && memcmp(str, "need_schema", 11) == 0) {
+            section_ = kNeedSchema;
+        } else {
+            section_ = kSkip;
+        }
+        return true;
+    }
+    bool StartObject() {
+        if (depth_ == 0) {
+            depth_ = 1;
+            return true;
+        }
+        if (section_ == kSkip || (depth_ == 1 && section_ == kNeedSchema)) {
+            section_ = kSkip;
+            depth_++;
+            return true;
+        }
+        return Fail(InvalidMsg());
+    }
+    bool EndObject(butil::rapidjson::SizeType = 0) { return EndContainer(); }
+    bool StartArray() {
+        if (depth_ == 0) {
+            return Fail("Json parse failed");
+        }
+        if (section_ == kSkip || (depth_ == 1 && section_ == kNeedSchema)) {
+            section_ = kSkip;
+            depth_++;
+            return true;
+        }
+        if (depth_ == 1) {
+            if (section_ == kInput) {
+                request_->has_input = true;
+            } else {
+                request_->has_common_cols = true;
+            }
+            depth_++;
+            return true;
+        }
+        if (depth_ == 2 && section_ == kInput) {
+            request_->row_offsets.push_back(request_->fields.size());
+            depth_++;
+            return true;
+        }
+        return Fail(InvalidMsg());
+    }
+    bool EndArray(butil::rapidjson::SizeType = 0) { return EndContainer(); }
+
+ private:
+    enum Section { kNone, kInput, kCommonCols, kNeedSchema, kSkip };
+
+    bool AddInt(int64_t i, bool is_int32, bool is_int64) {
+        JsonField field;
+        field.kind = JsonField::kInt;
+        field.int_value = i;
+        field.is_int32 = is_int32;
+        field.is_int64 = is_int64;
+        return AddField(field);
+    }
+    bool AddField(const JsonField& field) {
+        if (depth_ == 0) {
+            return Fail("Json parse failed");
+        }
+        if (depth_ == 1) {
+            // a scalar member, need_schema should be a bool
+            if (section_ == kInput || section_ == kCommonCols) {
+                return Fail(InvalidMsg());
+            }
+            return EndMember();
+        }
+        if (section_ == kSkip) {
+            return true;
+        }
+        if (section_ == kInput && depth_ == 3) {
+            request_->fields.push_back(field);
+            return true;
+        }
+        if (section_ == kCommonCols && depth_ == 2) {
+            request_->common_fields.push_back(field);
+            return true;
+        }
+        return Fail(InvalidMsg());
+    }
+    bool EndContainer() {
+        depth_--;
+        if (depth_ == 1) {
+            return EndMember();
+        }
+        return true;
+    }
+    bool EndMember() {
+        section_ = kNone;
+        return true;
+    }
+    std::string InvalidMsg() const {
+        if (section_ == kCommonCols) {
+            return "common_cols is not array";
+        }
+        return depth_ <= 1 ? "Invalid input" : "Invalid input data row";
+    }
+    bool Fail(const std::string& msg) {
+        if (msg_.empty()) {
+            msg_ = msg;
+        }
+        return false;
+    }
+
+    const bool has_common_col_;
+    JsonRequest* request_;
+    int depth_ = 0;
+    Section section_ = kNone;
+    std::string msg_;
+};
+
+inline void WriteExponent(int k, std::string* out) {
+    if (k < 0) {
+        out->push_back('-');
+        k = -k;
+    }
+    if (k >= 100) {
+        out->push_back(static_cast<char>('0' + k / 100));
+        k %= 100;
+        out->push_back(static_cast<char>('0' + k / 10));
+        out->push_back(static_cast<char>('0' + k % 10));
+    } else if (k >= 10) {
+        out->push_back(static_cast<char>('0' + k / 10));
+        out->push_back(static_cast<char>('0' + k % 10));
+    } else {
+        out->push_back(static_cast<char>('0' + k));
+    }
+}
+
+}  // namespace
+
+void AppendJsonString(const char* str, size_t len, std::string* out) {
+    static const char HEX[] = "0123456789ABCDEF";
+    out->push_back('"');
+    size_t start = 0;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = static_cast<unsigned char>(str[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out->append(str + start, i - start);
+        start = i + 1;
+        out->push_back('\\');
+        switch (c) {
+            case '"':
+            case '\\':
+                out->push_back(static_cast<char>(c));
+                break;
+            case '\b':
+                out->push_back('b');
+                break;
+            case '\f':
+                out->push_back('f');
+                break;
+            case '\n':
+                out->push_back('n');
+                break;
+            case '\r':
+                out->push_back('r');
+                break;
+            case '\t':
+                out->push_back('t');
+                break;
+            default:
+                out->append("u00");
+                out->push_back(HEX[c >> 4]);
+                out->push_back(HEX[c & 0xF]);
+        }
+    }
+    out->append(str + start, len - start);
+    out->push_back('"');
+}
+
+void AppendJsonDouble(double d, std::string* out) {
+    if (!std::isfinite(d)) {
+        out->append("null");
+        return;
+    }
+    if (d == 0) {
+        out->append(std::signbit(d) ? "-0.0" : "0.0");
+        return;
+    }
+    // 15 significant digits always read back to the shortest representation
+    // if it has no more digits, otherwise try 16 and 17
+    char buf[32];
+    for (int precision = 15; precision <= 17; precision++) {
+        snprintf(buf, sizeof(buf), "%.*e", precision - 1, d);
+        if (precision == 17 || strtod(buf, nullptr) == d) {
+            break;
+        }
+    }
+    // buf is [-]d.ddde[+-]xx
+    const char* p = buf;
+    if (*p == '-') {
+        out->push_back('-');
+        p++;
+    }
+    char digits[20];
+    int length = 0;
+    for (; *p != 'e'; p++) {
+        if (*p != '.') {
+            digits[length++] = *p;
+        }
+    }
+    int exp10 = atoi(p + 1);
+    while (length > 1 && digits[length - 1] == '0') {
+        length--;
+    }
+    // the value is digits * 10^k, and 10^(kk-1) <= value < 10^kk. the same
+    // cases as rapidjson's Prettify
+    int k = exp10 - length + 1;
+    int kk = length + k;
+    if (k >= 0 && kk <= 21) {
+        // 1234e7 -> 12340000000.0
+        out->append(digits, length);
+        out->append(k, '0');
+        out->append(".0");
+    } else if (0 < kk && kk <= 21) {
+        // 1234e-2 -> 12.34
+        out->append(digits, kk);
+        out->push_back('.');
+        out->append(digits + kk, length - kk);
+    } else if (-6 < kk && kk <= 0) {
+        // 1234e-6 -> 0.001234
+        out->append("0.");
+        out->append(-kk, '0');
+        out->append(digits, length);
+    } else if (length == 1) {
+        // 1e30
+        out->push_back(digits[0]);
+        out->push_back('e');
+        WriteExponent(kk - 1, out);
+    } else {
+        // 1234e30 -> 1.234e33
+        out->push_back(digits[0]);
+        out->push_back('.');
+        out->append(digits + 1, length - 1);
+        out->push_back('e');
+        WriteExponent(kk - 1, out);
+    }
+}
+
+DeploymentJsonCodec::DeploymentJsonCodec(std::shared_ptr<hybridse::sdk::ProcedureInfo> sp_info, bool has_common_col)
+    : sp_info_(sp_info), has_common_col_(has_common_col), common_cnt_(0), write_common_cols_(false) {
+    const auto& schema_impl = dynamic_cast<const ::hybridse::sdk::SchemaImpl&>(sp_info_->GetInputSchema());
+    // Hard copy, and RequestRow needs shared schema
+    input_schema_ = std::make_shared<::hybridse::sdk::SchemaImpl>(schema_impl.GetSchema());
+    common_column_indices_ = std::make_shared<sdk::ColumnIndicesSet>(input_schema_);
+    for (int i = 0; i < input_schema_->GetColumnCnt(); ++i) {
+        input_types_.push_back(input_schema_->GetColumnType(i));
+        input_not_null_.push_back(input_schema_->IsColumnNotNull(i));
+        bool is_common = has_common_col_ && input_schema_->IsConstant(i);
+        input_is_common_.push_back(is_common);
+        if (is_common) {
+            common_column_indices_->AddCommonColumnIdx(i);
+            common_cnt_++;
+        }
+    }
+
+    const auto& output_schema = sp_info_->GetOutputSchema();
+    schema_json_ = "\"schema\":[";
+    for (int i = 0; i < output_schema.GetColumnCnt(); ++i) {
+        output_types_.push_back(output_schema.GetColumnType(i));
+        if (output_schema.IsConstant(i)) {
+            output_common_cols_.push_back(i);
+        } else {
+            output_cols_.push_back(i);
+        }
+        if (i > 0) {
+            schema_json_.push_back(',');
+        }
+        const auto& name = output_schema.GetColumnName(i);
+        schema_json_.append("{\"name\":");
+        AppendJsonString(name.data(), name.size(), &schema_json_);
+        schema_json_.append(",\"type\":");
+        auto type_name = hybridse::sdk::DataTypeName(output_types_.back());
+        AppendJsonString(type_name.data(), type_name.size(), &schema_json_);
+        schema_json_.push_back('}');
+    }
+    schema_json_.push_back(']');
+    write_common_cols_ = sp_info_->GetType() == hybridse::sdk::kReqProcedure;
+}
+
+bool DeploymentJsonCodec::ParseRequest(char* body, JsonRequest* request, std::string* msg) const {
+    JsonRequestHandler handler(has_common_col_, request);
+    butil::rapidjson::Reader reader;
+    butil::rapidjson::InsituStringStream stream(body);
+    reader.Parse<butil::rapidjson::kParseInsituFlag>(stream, handler);
+    if (!handler.ok()) {
+        *msg = handler.msg();
+        return false;
+    }
+    if (reader.HasParseError()) {
+        *msg = "Json parse failed";
+        return false;
+    }
+    return true;
+}
+
+bool DeploymentJsonCodec::BuildRequestRows(const JsonRequest& request,
+                                           std::shared_ptr<sdk::SQLRequestRowBatch>* row_batch,
+                                           std::string* msg) const {
+    if (has_common_col_ && request.common_fields.size() != common_cnt_) {
+        *msg = "Invalid common cols size";
+        return false;
+    }
+    if (!request.has_input || request.row_offsets.empty()) {
+        *msg = "Invalid input";
+        return false;
+    }
+    size_t expected_input_size = input_types_.size() - common_cnt_;
+    // strings of common cols are in every row
+    uint32_t common_str_len = 0;
+    for (size_t i = 0, common_idx = 0; i < input_types_.size(); i++) {
+        if (input_is_common_[i]) {
+            if (input_types_[i] == hybridse::sdk::kTypeString) {
+                common_str_len += request.common_fields[common_idx].len;
+            }
+            common_idx++;
+        }
+    }
+    auto batch = std::make_shared<sdk::SQLRequestRowBatch>(input_schema_, common_column_indices_);
+    std::set<std::string> col_set;
+    for (size_t r = 0; r < request.row_offsets.size(); r++) {
+        size_t begin = request.row_offsets[r];
+        size_t end = r + 1 < request.row_offsets.size() ? request.row_offsets[r + 1] : request.fields.size();
+        if (end - begin != expected_input_size) {
+            *msg = "Invalid input data row";
+            return false;
+        }
+        const JsonField* fields = request.fields.data() + begin;
+        uint32_t str_len = common_str_len;
+        for (size_t i = 0, idx = 0; i < input_types_.size(); i++) {
+            if (!input_is_common_[i]) {
+                if (input_types_[i] == hybridse::sdk::kTypeString) {
+                    str_len += fields[idx].len;
+                }
+                idx++;
+            }
+        }
+        auto row = std::make_shared<sdk::SQLRequestRow>(input_schema_, col_set);
+        row->Init(static_cast<int32_t>(str_len));
+        for (size_t i = 0, idx = 0, common_idx = 0; i < input_types_.size(); i++) {
+            const JsonField& field =
+                input_is_common_[i] ? request.common_fields[common_idx++] : fields[idx++];
+            if (!AppendField(field, i, row.get())) {
+                *msg = "Translate to request row failed";
+                return false;
+            }
+        }
+        row->Build();
+        batch->AddRow(row);
+    }
+    *row_batch = batch;
+    return true;
+}
+
+bool DeploymentJsonCodec::AppendField(const JsonField& field, int idx, sdk::SQLRequestRow* row) const {
+    if (field.kind == JsonField::kNull) {
+        if (input_not_null_[idx]) {
+            return false;
+        }
+        return row->AppendNULL();
+    }
+    // the same type checks as APIServerImpl::AppendJsonValue
+    switch (input_types_[idx]) {
+        case hybridse::sdk::kTypeBool:
+            return field.kind == JsonField::kBool && row->AppendBool(field.bool_value);
+        case hybridse::sdk::kTypeInt16:
+            return field.kind == JsonField::kInt && field.is_int32 && field.int_value >= INT16_MIN &&
+                   field.int_value <= INT16_MAX && row->AppendInt16(static_cast<int16_t>(field.int_value));
+        case hybridse::sdk::kTypeInt32:
+            return field.kind == JsonField::kInt && field.is_int32 &&
+                   row->AppendInt32(static_cast<int32_t>(field.int_value));
+        case hybridse::sdk::kTypeInt64:
+            return field.kind == JsonField::kInt && field.is_int64 && row->AppendInt64(field.int_value);
+        case hybridse::sdk::kTypeFloat:
+            return field.kind == JsonField::kDouble && row->AppendFloat(static_cast<float>(field.double_value));
+        case hybridse::sdk::kTypeDouble:
+            return field.kind == JsonField::kDouble && row->AppendDouble(field.double_value);
+        case hybridse::sdk::kTypeString:
+            return field.kind == JsonField::kString && row->AppendString(field.str, field.len);
+        case hybridse::sdk::kTypeDate: {
+            if (field.kind != JsonField::kString) {
+                return false;
+            }
+            // yyyy-mm-dd, the in-situ string is null terminated
+            int32_t parts[3];
+            const char* p = field.str;
+            for (int i = 0; i < 3; i++) {
+                char* part_end = nullptr;
+                long value = strtol(p, &part_end, 10);  // NOLINT
+                if (part_end == p || value < INT32_MIN || value > INT32_MAX || *part_end != (i < 2 ? '-' : '\0')) {
+                    return false;
+                }
+                parts[i] = static_cast<int32_t>(value);
+                p = part_end + 1;
+            }
+            return row->AppendDate(parts[0], parts[1], parts[2]);
+        }
+        case hybridse::sdk::kTypeTimestamp:
+            return field.kind == JsonField::kInt && field.is_int64 && row->AppendTimestamp(field.int_value);
+        default:
+            return false;
+    }
+}
+
+void DeploymentJsonCodec::AppendValue(hybridse::sdk::ResultSet* rs, int idx, std::string* out) const {
+    if (rs->IsNULL(idx)) {
+        out->append("null");
+        return;
+    }
+    switch (output_types_[idx]) {
+        case hybridse::sdk::kTypeInt32: {
+            int32_t value = 0;
+            rs->GetInt32(idx, &value);
+            absl::StrAppend(out, value);
+            break;
+        }
+        case hybridse::sdk::kTypeInt64: {
+            int64_t value = 0;
+            rs->GetInt64(idx, &value);
+            absl::StrAppend(out, value);
+            break;
+        }
+        case hybridse::sdk::kTypeInt16: {
+            int16_t value = 0;
+            rs->GetInt16(idx, &value);
+            absl::StrAppend(out, value);
+            break;
+        }
+        case hybridse::sdk::kTypeFloat: {
+            float value = 0;
+            rs->GetFloat(idx, &value);
+            AppendJsonDouble(static_cast<double>(value), out);
+            break;
+        }
+        case hybridse::sdk::kTypeDouble: {
+            double value = 0;
+            rs->GetDouble(idx, &value);
+            AppendJsonDouble(value, out);
+            break;
+        }
+        case hybridse::sdk::kTypeString: {
+            std::string value;
+            rs->GetString(idx, &value);
+            AppendJsonString(value.data(), value.size(), out);
+            break;
+        }
+        case hybridse::sdk::kTypeTimestamp: {
+            int64_t ts = 0;
+            rs->GetTime(idx, &ts);
+            absl::StrAppend(out, ts);
+            break;
+        }
+        case hybridse::sdk::kTypeDate: {
+            int32_t year = 0;
+            int32_t month = 0;
+            int32_t day = 0;
+            rs->GetDate(idx, &year, &month, &day);
+            absl::StrAppend(out, "\"", year, "-", month, "-", day, "\"");
+            break;
+        }
+        case hybridse::sdk::kTypeBool: {
+            bool value = false;
+            rs->GetBool(idx, &value);
+            out->append(value ? "\"true\"" : "\"false\"");
+            break;
+        }
+        default: {
+            out->append("\"NA\"");
+            break;
+        }
+    }
+}
+
+void DeploymentJsonCodec::WriteResponse(hybridse::sdk::ResultSet* rs, bool need_schema, std::string* out) const {
+    out->append("{\"code\":0,\"msg\":\"ok\",\"data\":{");
+    if (need_schema) {
+        out->append(schema_json_);
+        out->push_back(',');
+    }
+    out->append("\"data\":[");
+    rs->Reset();
+    bool first_row = true;
+    while (rs->Next()) {
+        out->append(first_row ? "[" : ",[");
+        first_row = false;
+        for (size_t i = 0; i < output_cols_.size(); i++) {
+            if (i > 0) {
+                out->push_back(',');
+            }
+            AppendValue(rs, output_cols_[i], out);
+        }
+        out->push_back(']');
+    }
+    out->push_back(']');
+    if (write_common_cols_) {
+        out->append(",\"common_cols_data\":[");
+        rs->Reset();
+        if (rs->Next()) {
+            for (size_t i = 0; i < output_common_cols_.size(); i++) {
+                if (i > 0) {
+                    out->push_back(',');
+                }
+                AppendValue(rs, output_common_cols_[i], out);
+            }
+        }
+        out->push_back(']');
+    }
+    out->append("}}");
+}
+
+}  // namespace apiserver
+}  // namespace openmldb
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_APISERVER_JSON_CODEC_H_
+#define SRC_APISERVER_JSON_CODEC_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sdk/base.h"
+#include "sdk/result_set.h"
+#include "sdk/sql_request_row.h"
+
+namespace openmldb {
+namespace apiserver {
+
+// a scalar of the request body. strings point into the in-situ parsed body
+struct JsonField {
+    enum Kind : uint8_t { kNull, kBool, kInt, kDouble, kString };
+    Kind kind = kNull;
+    // for kInt, whether the value fits int32 and int64
+    bool is_int32 = false;
+    bool is_int64 = false;
+    bool bool_value = false;
+    int64_t int_value = 0;
+    double double_value = 0;
+    const char* str = nullptr;
+    uint32_t len = 0;
+};
+
+// the body of a procedure or deployment request
+// {"input": [[...], ...], "common_cols": [...], "need_schema": bool}
+struct JsonRequest {
+    bool has_input = false;
+    bool has_common_cols = false;
+    bool need_schema = false;
+    // fields of all input rows, row i is [row_offsets[i], row_offsets[i + 1])
+    std::vector<JsonField> fields;
+    std::vector<size_t> row_offsets;
+    std::vector<JsonField> common_fields;
+};
+
+// DeploymentJsonCodec is the json codec of a procedure or deployment, compiled
+// from its input and output schemas. Request bodies are parsed in situ by a sax
+// parser and encoded into request rows without a dom, and results are written
+// into a buffer directly with the precomputed column types.
+class DeploymentJsonCodec {
+ public:
+    DeploymentJsonCodec(std::shared_ptr<hybridse::sdk::ProcedureInfo> sp_info, bool has_common_col);
+
+    std::shared_ptr<hybridse::sdk::ProcedureInfo> GetProcedureInfo() const { return sp_info_; }
+
+    // `body` is modified by in-situ parsing and should outlive `request`
+    bool ParseRequest(char* body, JsonRequest* request, std::string* msg) const;
+
+    bool BuildRequestRows(const JsonRequest& request, std::shared_ptr<sdk::SQLRequestRowBatch>* row_batch,
+                          std::string* msg) const;
+
+    // write the response of a successful call, the same as ExecSPResp
+    void WriteResponse(hybridse::sdk::ResultSet* rs, bool need_schema, std::string* out) const;
+
+ private:
+    bool AppendField(const JsonField& field, int idx, sdk::SQLRequestRow* row) const;
+    void AppendValue(hybridse::sdk::ResultSet* rs, int idx, std::string* out) const;
+
+    std::shared_ptr<hybridse::sdk::ProcedureInfo> sp_info_;
+    const bool has_common_col_;
+    std::shared_ptr<hybridse::sdk::Schema> input_schema_;
+    std::shared_ptr<sdk::ColumnIndicesSet> common_column_indices_;
+    std::vector<hybridse::sdk::DataType> input_types_;
+    std::vector<uint8_t> input_not_null_;
+    std::vector<uint8_t> input_is_common_;
+    size_t common_cnt_;
+    std::vector<hybridse::sdk::DataType> output_types_;
+    std::vector<int> output_cols_;
+    std::vector<int> output_common_cols_;
+    bool write_common_cols_;
+    // "schema":[...]
+    std::string schema_json_;
+};
+
+// append `str` as a json string with the same escapes as rapidjson's writer
+void AppendJsonString(const char* str, size_t len, std::string* out);
+
+// append `d` with the fewest of 15, 16 or 17 significant digits that read back
+// to the same value, formatted like rapidjson's writer. nan and inf are null
+void AppendJsonDouble(double d, std::string* out);
+
+}  // namespace apiserver
+}  // namespace openmldb
+
+#endif  // SRC_APISERVER_JSON_CODEC_H_
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "apiserver/api_server_impl.h"
+#include "apiserver/json_codec.h"
+#include "benchmark/benchmark.h"
+#include "catalog/base.h"
+#include "codec/row_codec.h"
+#include "schema/schema_adapter.h"
+#include "sdk/result_set_sql.h"
+
+namespace openmldb {
+namespace apiserver {
+
+// the items processed are requests, each with `state.range(0)` rows
+
+static std::shared_ptr<hybridse::sdk::ProcedureInfo> BuildProcedureInfo() {
+    ::openmldb::api::ProcedureInfo sp;
+    sp.set_db_name("db");
+    sp.set_sp_name("sp");
+    sp.set_type(::openmldb::type::kReqDeployment);
+    auto add_col = [](google::protobuf::RepeatedPtrField<::openmldb::common::ColumnDesc>* schema,
+                      const std::string& name, ::openmldb::type::DataType type) {
+        auto col = schema->Add();
+        col->set_name(name);
+        col->set_data_type(type);
+    };
+    for (auto schema : {sp.mutable_input_schema(), sp.mutable_output_schema()}) {
+        add_col(schema, "c1", ::openmldb::type::kString);
+        add_col(schema, "c2", ::openmldb::type::kInt);
+        add_col(schema, "c3", ::openmldb::type::kBigInt);
+        add_col(schema, "c4", ::openmldb::type::kDouble);
+        add_col(schema, "c5", ::openmldb::type::kTimestamp);
+        add_col(schema, "c6", ::openmldb::type::kString);
+    }
+    return std::make_shared<::openmldb::catalog::ProcedureInfoImpl>(sp);
+}
+
+static std::string BuildRequestBody(int64_t row_cnt) {
+    std::string body = "{\"input\":[";
+    for (int64_t i = 0; i < row_cnt; i++) {
+        absl::StrAppend(&body, i > 0 ? "," : "", "[\"key", i, "\",", i, ",", i * 1000, ",", i * 0.5,
+                        ",1635247427000,\"some value of the row\"]");
+    }
+    body.append("],\"need_schema\":false}");
+    return body;
+}
+
+static std::shared_ptr<hybridse::sdk::ResultSet> BuildResultSet(const hybridse::sdk::ProcedureInfo& sp_info,
+                                                                 int64_t row_cnt) {
+    ::openmldb::codec::Schema schema;
+    const auto& output_schema = sp_info.GetOutputSchema();
+    ::openmldb::type::DataType types[] = {::openmldb::type::kString, ::openmldb::type::kInt,
+                                          ::openmldb::type::kBigInt, ::openmldb::type::kDouble,
+                                          ::openmldb::type::kTimestamp, ::openmldb::type::kString};
+    for (int i = 0; i < output_schema.GetColumnCnt(); i++) {
+        auto col = schema.Add();
+        col->set_name(output_schema.GetColumnName(i));
+        col->set_data_type(types[i]);
+    }
+    auto io_buf = std::make_shared<butil::IOBuf>();
+    std::string buf;
+    for (int64_t i = 0; i < row_cnt; i++) {
+        buf.clear();
+        std::vector<std::string> row = {absl::StrCat("key", i), std::to_string(i), std::to_string(i * 1000),
+                                        std::to_string(i * 0.5), "1635247427000", "some value of the row"};
+        ::openmldb::codec::RowCodec::EncodeRow(row, schema, 0, buf);
+        io_buf->append(buf);
+    }
+    ::hybridse::vm::Schema sql_schema;
+    ::openmldb::schema::SchemaAdapter::ConvertSchema(schema, &sql_schema);
+    auto rs = std::make_shared<::openmldb::sdk::ResultSetSQL>(sql_schema, row_cnt, io_buf);
+    rs->Init();
+    return rs;
+}
+
+static void BM_ParseRequestDom(benchmark::State& state) {  // NOLINT
+    auto body = BuildRequestBody(state.range(0));
+    for (auto _ : state) {
+        butil::rapidjson::Document document;
+        document.Parse(body.c_str());
+        benchmark::DoNotOptimize(document.HasParseError());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_ParseRequestSax(benchmark::State& state) {  // NOLINT
+    DeploymentJsonCodec codec(BuildProcedureInfo(), true);
+    auto body = BuildRequestBody(state.range(0));
+    std::string msg;
+    for (auto _ : state) {
+        // in-situ parsing modifies the body
+        std::string copy = body;
+        JsonRequest request;
+        benchmark::DoNotOptimize(codec.ParseRequest(&copy[0], &request, &msg));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_ParseAndBuildRequestRows(benchmark::State& state) {  // NOLINT
+    DeploymentJsonCodec codec(BuildProcedureInfo(), true);
+    auto body = BuildRequestBody(state.range(0));
+    std::string msg;
+    for (auto _ : state) {
+        std::string copy = body;
+        JsonRequest request;
+        std::shared_ptr<sdk::SQLRequestRowBatch> row_batch;
+        if (!codec.ParseRequest(&copy[0], &request, &msg) || !codec.BuildRequestRows(request, &row_batch, &msg)) {
+            state.SkipWithError(msg.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(row_batch);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_WriteResponseJsonWriter(benchmark::State& state) {  // NOLINT
+    auto sp_info = BuildProcedureInfo();
+    auto rs = BuildResultSet(*sp_info, state.range(0));
+    for (auto _ : state) {
+        JsonWriter writer;
+        ExecSPResp resp;
+        resp.sp_info = sp_info;
+        resp.rs = rs;
+        writer << resp;
+        benchmark::DoNotOptimize(writer.GetString());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_WriteResponseCodec(benchmark::State& state) {  // NOLINT
+    auto sp_info = BuildProcedureInfo();
+    DeploymentJsonCodec codec(sp_info, true);
+    auto rs = BuildResultSet(*sp_info, state.range(0));
+    for (auto _ : state) {
+        std::string out;
+        codec.WriteResponse(rs.get(), false, &out);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ParseRequestDom)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_ParseRequestSax)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_ParseAndBuildRequestRows)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_WriteResponseJsonWriter)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_WriteResponseCodec)->Arg(1)->Arg(10)->Arg(100);
+
+}  // namespace apiserver
+}  // namespace openmldb
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "apiserver/json_codec.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "json2pb/rapidjson.h"
+
+namespace openmldb::apiserver {
+
+class JsonCodecTest : public ::testing::Test {};
+
+std::string WriterDouble(double d) {
+    butil::rapidjson::StringBuffer buffer;
+    butil::rapidjson::Writer<butil::rapidjson::StringBuffer> writer(buffer);
+    writer.Double(d);
+    return buffer.GetString();
+}
+
+std::string WriterString(const std::string& s) {
+    butil::rapidjson::StringBuffer buffer;
+    butil::rapidjson::Writer<butil::rapidjson::StringBuffer> writer(buffer);
+    writer.String(s.data(), s.size());
+    return buffer.GetString();
+}
+
+TEST_F(JsonCodecTest, AppendJsonDouble) {
+    // the same as rapidjson's writer
+    for (double d : {0.0, 1.0, -1.5, 0.1, 123.456, 100.0, 1e21, 1e22, 1.5e300, -2.5e-7, 1e-6, 0.000001234,
+                     3.14159265358979, 1.0 / 3, 123456789012345680000.0, 1.7976931348623157e308}) {
+        std::string out;
+        AppendJsonDouble(d, &out);
+        ASSERT_EQ(WriterDouble(d), out);
+        ASSERT_EQ(d, strtod(out.c_str(), nullptr));
+    }
+    std::string out;
+    AppendJsonDouble(std::numeric_limits<double>::quiet_NaN(), &out);
+    ASSERT_EQ("null", out);
+}
+
+TEST_F(JsonCodecTest, AppendJsonString) {
+    for (std::string s : {std::string(""), std::string("abc"), std::string("a\"b\\c/d"),
+                          std::string("\b\f\n\r\t"), std::string("\x01\x1f", 2), std::string("中文")}) {
+        std::string out;
+        AppendJsonString(s.data(), s.size(), &out);
+        ASSERT_EQ(WriterString(s), out);
+    }
+}
+
+}  // namespace openmldb::apiserver
+
+int main(int argc, char* argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
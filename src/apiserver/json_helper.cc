@@ -16,6 +16,7 @@
 
 #include "apiserver/json_helper.h"
 
+#include <cstring>
 #include <stack>
 
 #include "json2pb/rapidjson.h"  // rapidjson's DOM-style API
@@ -322,5 +323,10 @@ JsonWriter& JsonWriter::SetNull() {
     WRITER->Null();
     return *this;
 }
+
+JsonWriter& JsonWriter::RawDocument(const char* json, size_t len) {
+    memcpy(STREAM->Push(len), json, len);
+    return *this;
+}
 }  // namespace apiserver
 }  // namespace openmldb
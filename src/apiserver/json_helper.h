@@ -115,6 +115,8 @@ class JsonWriter {
     JsonWriter& operator&(const double& d);
     JsonWriter& operator&(const std::string& s);
     JsonWriter& SetNull();
+    // append an encoded json document, the writer should be empty
+    JsonWriter& RawDocument(const char* json, size_t len);
 
     static const bool IsReader = false;
     static const bool IsWriter = !IsReader;
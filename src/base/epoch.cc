@@ -0,0 +1,152 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/epoch.h"
+
+#include <algorithm>
+#include <thread>  // NOLINT
+
+namespace openmldb {
+namespace base {
+
+EpochManager::EpochManager(uint32_t slot_cnt)
+    : epoch_(1), slot_cnt_(std::max(slot_cnt, 1u)), slots_(new Slot[slot_cnt_]), overflow_cnt_(0) {}
+
+EpochManager::~EpochManager() {
+    for (auto& kv : retired_) {
+        kv.second();
+    }
+}
+
+EpochManager* EpochManager::Default() {
+    // never destroyed, the tables may be freed by other static objects
+    static EpochManager* manager = new EpochManager();
+    return manager;
+}
+
+static std::mutex released_mu;
+// never destroyed like the default manager
+static std::vector<EpochManager*>* released = new std::vector<EpochManager*>();
+
+void EpochManager::Release(EpochManager* manager) {
+    if (manager == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(released_mu);
+        released->push_back(manager);
+    }
+    FreeReleased();
+}
+
+void EpochManager::FreeReleased() {
+    std::vector<EpochManager*> idle;
+    {
+        std::lock_guard<std::mutex> lock(released_mu);
+        auto it = std::partition(released->begin(), released->end(),
+                                 [](EpochManager* manager) { return !manager->IsIdle(); });
+        idle.assign(it, released->end());
+        released->erase(it, released->end());
+    }
+    for (auto manager : idle) {
+        delete manager;
+    }
+}
+
+bool EpochManager::IsIdle() const {
+    if (overflow_cnt_.load(std::memory_order_acquire) > 0) {
+        return false;
+    }
+    for (uint32_t i = 0; i < slot_cnt_; i++) {
+        if (slots_[i].epoch.load(std::memory_order_acquire) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t EpochManager::Enter() {
+    // the readers of a thread start from the slot they took last time, which is likely free
+    static thread_local uint32_t hint = std::hash<std::thread::id>()(std::this_thread::get_id()) % kSlotCnt;
+    uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+    for (uint32_t i = 0; i < slot_cnt_; i++) {
+        uint32_t slot = (hint + i) % slot_cnt_;
+        uint64_t expected = 0;
+        if (slots_[slot].epoch.load(std::memory_order_relaxed) == 0 &&
+            slots_[slot].epoch.compare_exchange_strong(expected, epoch, std::memory_order_seq_cst)) {
+            hint = slot;
+            // pairs with the fence of Reclaim: either Reclaim sees the slot, or the reader
+            // sees all the memory unlinked before Reclaim
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return slot;
+        }
+    }
+    overflow_cnt_.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return kOverflowSlot;
+}
+
+void EpochManager::Exit(uint32_t slot) {
+    if (slot == kOverflowSlot) {
+        overflow_cnt_.fetch_sub(1, std::memory_order_release);
+    } else {
+        slots_[slot].epoch.store(0, std::memory_order_release);
+    }
+}
+
+void EpochManager::Retire(std::function<void()>&& deleter) {
+    std::lock_guard<std::mutex> lock(mu_);
+    retired_.emplace_back(epoch_.load(std::memory_order_relaxed), std::move(deleter));
+}
+
+uint64_t EpochManager::Reclaim() {
+    std::vector<std::pair<uint64_t, std::function<void()>>> reclaimed;
+    {
+        // the epoch is advanced under the lock, so that a reader entered in a later epoch
+        // sees all the memory unlinked before it is retired
+        std::lock_guard<std::mutex> lock(mu_);
+        uint64_t min_epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (overflow_cnt_.load(std::memory_order_acquire) > 0) {
+            return 0;
+        }
+        for (uint32_t i = 0; i < slot_cnt_; i++) {
+            uint64_t epoch = slots_[i].epoch.load(std::memory_order_acquire);
+            if (epoch != 0 && epoch < min_epoch) {
+                min_epoch = epoch;
+            }
+        }
+        // retired in the order of the epoch
+        auto end = retired_.begin();
+        while (end != retired_.end() && end->first < min_epoch) {
+            end++;
+        }
+        reclaimed.assign(std::make_move_iterator(retired_.begin()), std::make_move_iterator(end));
+        retired_.erase(retired_.begin(), end);
+    }
+    for (auto& kv : reclaimed) {
+        kv.second();
+    }
+    return reclaimed.size();
+}
+
+uint64_t EpochManager::GetRetiredCnt() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return retired_.size();
+}
+
+}  // namespace base
+}  // namespace openmldb
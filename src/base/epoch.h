@@ -0,0 +1,105 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_BASE_EPOCH_H_
+#define SRC_BASE_EPOCH_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+namespace openmldb {
+namespace base {
+
+// EpochManager defers freeing the memory unlinked from lock free structures until no
+// reader can reach it. a reader enters the current epoch before it reads and exits after,
+// the memory unlinked by a writer is retired with the epoch it is retired in, and
+// Reclaim advances the epoch and frees the memory retired before the oldest reader entered.
+// a reader holds a slot instead of a thread, so it can move between threads, e.g. bthreads.
+// a reader stops the reclaim of all the memory retired to its manager while it is in, so a
+// manager should guard one structure, e.g. a table, and readers should not stay in long
+class EpochManager {
+ public:
+    static constexpr uint32_t kSlotCnt = 1024;
+    // the slot of a reader entered when all slots are taken
+    static constexpr uint32_t kOverflowSlot = UINT32_MAX;
+
+    explicit EpochManager(uint32_t slot_cnt = kSlotCnt);
+    // free all the retired memory, there should be no reader
+    ~EpochManager();
+
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    // the manager of the structures without their own, e.g. the segments out of a table
+    static EpochManager* Default();
+
+    // delete `manager` once no reader is in it, as a reader may leave after the structure it
+    // guards is destroyed. the managers left are checked again by the next Release or FreeReleased
+    static void Release(EpochManager* manager);
+    static void FreeReleased();
+
+    // return the slot to exit
+    uint32_t Enter();
+    void Exit(uint32_t slot);
+
+    // `deleter` is called by Reclaim once the readers entered before now have exited
+    void Retire(std::function<void()>&& deleter);
+
+    // return the count of the deleters called
+    uint64_t Reclaim();
+
+    uint64_t GetEpoch() const { return epoch_.load(std::memory_order_relaxed); }
+    uint64_t GetRetiredCnt();
+    // no reader is in
+    bool IsIdle() const;
+
+ private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{0};
+    };
+
+    // the epoch starts from 1, and 0 marks a free slot
+    std::atomic<uint64_t> epoch_;
+    const uint32_t slot_cnt_;
+    std::unique_ptr<Slot[]> slots_;
+    // the readers in no slot, which stop the reclaim while they are in
+    std::atomic<uint64_t> overflow_cnt_;
+    std::mutex mu_;
+    std::vector<std::pair<uint64_t, std::function<void()>>> retired_;
+};
+
+class EpochGuard {
+ public:
+    explicit EpochGuard(EpochManager* manager) : manager_(manager), slot_(manager->Enter()) {}
+    ~EpochGuard() { manager_->Exit(slot_); }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+ private:
+    EpochManager* manager_;
+    uint32_t slot_;
+};
+
+}  // namespace base
+}  // namespace openmldb
+
+#endif  // SRC_BASE_EPOCH_H_
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/epoch.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace base {
+
+class EpochTest : public ::testing::Test {};
+
+TEST_F(EpochTest, Reclaim) {
+    EpochManager manager;
+    int freed = 0;
+    manager.Retire([&freed] { freed++; });
+    ASSERT_EQ(1u, manager.Reclaim());
+    ASSERT_EQ(1, freed);
+
+    uint32_t slot = manager.Enter();
+    manager.Retire([&freed] { freed++; });
+    // retired after the reader entered
+    ASSERT_EQ(0u, manager.Reclaim());
+    {
+        // a reader entered later does not hold the memory retired before
+        EpochGuard guard(&manager);
+        manager.Exit(slot);
+        ASSERT_EQ(1u, manager.Reclaim());
+        ASSERT_EQ(2, freed);
+        manager.Retire([&freed] { freed++; });
+        ASSERT_EQ(0u, manager.Reclaim());
+    }
+    ASSERT_EQ(1u, manager.Reclaim());
+    ASSERT_EQ(3, freed);
+    ASSERT_EQ(0u, manager.GetRetiredCnt());
+}
+
+TEST_F(EpochTest, Overflow) {
+    EpochManager manager;
+    std::vector<uint32_t> slots;
+    for (uint32_t i = 0; i <= EpochManager::kSlotCnt; i++) {
+        slots.push_back(manager.Enter());
+    }
+    ASSERT_EQ(EpochManager::kOverflowSlot, slots.back());
+    int freed = 0;
+    manager.Retire([&freed] { freed++; });
+    for (uint32_t i = 0; i < EpochManager::kSlotCnt; i++) {
+        manager.Exit(slots[i]);
+    }
+    // the reader in no slot stops the reclaim
+    ASSERT_EQ(0u, manager.Reclaim());
+    manager.Exit(slots.back());
+    ASSERT_EQ(1u, manager.Reclaim());
+    ASSERT_EQ(1, freed);
+}
+
+TEST_F(EpochTest, SmallSlots) {
+    EpochManager manager(2);
+    uint32_t slot0 = manager.Enter();
+    uint32_t slot1 = manager.Enter();
+    ASSERT_NE(slot0, slot1);
+    ASSERT_EQ(EpochManager::kOverflowSlot, manager.Enter());
+    manager.Exit(EpochManager::kOverflowSlot);
+    manager.Exit(slot0);
+    manager.Exit(slot1);
+    ASSERT_TRUE(manager.IsIdle());
+}
+
+TEST_F(EpochTest, Release) {
+    int freed = 0;
+    auto manager = new EpochManager();
+    manager->Retire([&freed] { freed++; });
+    uint32_t slot = manager->Enter();
+    // the reader outlives the structure guarded by the manager
+    EpochManager::Release(manager);
+    ASSERT_EQ(0, freed);
+    EpochManager::FreeReleased();
+    ASSERT_EQ(0, freed);
+    manager->Exit(slot);
+    EpochManager::FreeReleased();
+    ASSERT_EQ(1, freed);
+}
+
+TEST_F(EpochTest, Concurrent) {
+    EpochManager manager;
+    std::atomic<int*> shared(new int(0));
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; i++) {
+        readers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                EpochGuard guard(&manager);
+                int* value = shared.load(std::memory_order_acquire);
+                // freed values are poisoned before they are deleted
+                ASSERT_GE(*value, 0);
+            }
+        });
+    }
+    for (int i = 1; i <= 10000; i++) {
+        int* old = shared.exchange(new int(i), std::memory_order_acq_rel);
+        manager.Retire([old] {
+            *old = -1;
+            delete old;
+        });
+        manager.Reclaim();
+    }
+    stop.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    manager.Reclaim();
+    ASSERT_EQ(0u, manager.GetRetiredCnt());
+    delete shared.load();
+}
+
+}  // namespace base
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,268 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/numa.h"
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <thread>  // NOLINT
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+
+namespace openmldb {
+namespace base {
+
+// the memory policy of mbind, see numaif.h
+constexpr int MPOL_PREFERRED_MODE = 1;
+constexpr int MAX_NUMA_NODE = 1024;
+
+bool ParseCpuList(const std::string& str, std::vector<int>* cpus) {
+    if (cpus == nullptr) {
+        return false;
+    }
+    cpus->clear();
+    for (absl::string_view range : absl::StrSplit(absl::StripAsciiWhitespace(str), ',', absl::SkipEmpty())) {
+        std::vector<absl::string_view> ends = absl::StrSplit(absl::StripAsciiWhitespace(range), '-');
+        int first = 0;
+        int last = 0;
+        if (ends.size() > 2 || !absl::SimpleAtoi(ends[0], &first) ||
+            !absl::SimpleAtoi(ends.size() == 2 ? ends[1] : ends[0], &last) || first < 0 || first > last) {
+            return false;
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus->push_back(cpu);
+        }
+    }
+    return !cpus->empty();
+}
+
+static bool ReadCpuList(const std::string& path, std::vector<int>* cpus) {
+    std::ifstream in(path);
+    std::string line;
+    if (!in.is_open() || !std::getline(in, line)) {
+        return false;
+    }
+    return ParseCpuList(line, cpus);
+}
+
+std::shared_ptr<NumaTopology> NumaTopology::Create(const std::string& fake) {
+    std::vector<std::vector<int>> nodes;
+    if (fake.empty()) {
+        const std::string root = "/sys/devices/system/node";
+        DIR* dir = opendir(root.c_str());
+        if (dir == nullptr) {
+            return nullptr;
+        }
+        std::vector<uint32_t> ids;
+        struct dirent* entry = nullptr;
+        while ((entry = readdir(dir)) != nullptr) {
+            uint32_t id = 0;
+            absl::string_view name(entry->d_name);
+            if (absl::ConsumePrefix(&name, "node") && absl::SimpleAtoi(name, &id)) {
+                ids.push_back(id);
+            }
+        }
+        closedir(dir);
+        if (ids.empty()) {
+            return nullptr;
+        }
+        // node ids may have holes, a node without cpus is filled with all the cpus of the others
+        uint32_t max_id = *std::max_element(ids.begin(), ids.end());
+        if (max_id >= MAX_NUMA_NODE) {
+            return nullptr;
+        }
+        nodes.resize(max_id + 1);
+        for (uint32_t id : ids) {
+            ReadCpuList(root + "/node" + std::to_string(id) + "/cpulist", &nodes[id]);
+        }
+        std::vector<int> all;
+        for (const auto& cpus : nodes) {
+            all.insert(all.end(), cpus.begin(), cpus.end());
+        }
+        if (all.empty()) {
+            return nullptr;
+        }
+        for (auto& cpus : nodes) {
+            if (cpus.empty()) {
+                cpus = all;
+            }
+        }
+        return std::shared_ptr<NumaTopology>(new NumaTopology(std::move(nodes), false));
+    }
+    uint32_t node_cnt = 0;
+    if (absl::SimpleAtoi(fake, &node_cnt)) {
+        std::vector<int> online;
+        if (!ReadCpuList("/sys/devices/system/cpu/online", &online)) {
+            for (uint32_t cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); cpu++) {
+                online.push_back(cpu);
+            }
+        }
+        if (node_cnt == 0 || node_cnt > online.size()) {
+            return nullptr;
+        }
+        nodes.resize(node_cnt);
+        for (uint32_t i = 0; i < online.size(); i++) {
+            nodes[i * node_cnt / online.size()].push_back(online[i]);
+        }
+    } else {
+        for (absl::string_view cpu_list : absl::StrSplit(fake, ';', absl::SkipEmpty())) {
+            std::vector<int> cpus;
+            if (!ParseCpuList(std::string(cpu_list), &cpus)) {
+                return nullptr;
+            }
+            nodes.push_back(std::move(cpus));
+        }
+        if (nodes.empty()) {
+            return nullptr;
+        }
+    }
+    return std::shared_ptr<NumaTopology>(new NumaTopology(std::move(nodes), true));
+}
+
+bool NumaTopology::BindCurrentThread(uint32_t node) const {
+    if (node >= nodes_.size()) {
+        return false;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : nodes_[node]) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+}
+
+NumaArena::NumaArena(int node, double max_waste_ratio)
+    : node_(node), max_waste_ratio_(max_waste_ratio), stats_(std::make_shared<Stats>()), shards_(), chunk_cnt_(0) {}
+
+NumaArena::~NumaArena() {
+    for (auto& shard : shards_) {
+        if (shard.current != nullptr) {
+            Unref(shard.current);
+        }
+    }
+}
+
+NumaArena::Chunk* NumaArena::NewChunk() {
+    // chunks are aligned to their size, so that Free finds the chunk of a pointer
+    void* mem = aligned_alloc(kChunkSize, kChunkSize);
+    if (mem == nullptr) {
+        return nullptr;
+    }
+    if (node_ >= 0 && node_ < MAX_NUMA_NODE) {
+        // the pages are not touched yet and will be placed on the node when first written.
+        // the preferred policy falls back to other nodes when the node is out of memory
+        unsigned long mask[MAX_NUMA_NODE / (8 * sizeof(unsigned long))] = {0};  // NOLINT
+        mask[node_ / (8 * sizeof(unsigned long))] |= 1ul << (node_ % (8 * sizeof(unsigned long)));
+        syscall(SYS_mbind, mem, kChunkSize, MPOL_PREFERRED_MODE, mask, MAX_NUMA_NODE, 0);
+    }
+    auto chunk = reinterpret_cast<Chunk*>(mem);
+    new (&chunk->ref) std::atomic<uint32_t>(1);
+    new (&chunk->stats) std::shared_ptr<Stats>(stats_);
+    stats_->live_chunks.fetch_add(1, std::memory_order_relaxed);
+    chunk_cnt_.fetch_add(1, std::memory_order_relaxed);
+    return chunk;
+}
+
+uint64_t NumaArena::GetUsedBytes() const {
+    uint64_t allocated = 0;
+    for (const auto& shard : shards_) {
+        allocated += shard.allocated_bytes.load(std::memory_order_relaxed);
+    }
+    uint64_t freed = stats_->freed_bytes.load(std::memory_order_relaxed);
+    return allocated > freed ? allocated - freed : 0;
+}
+
+double NumaArena::GetWasteRatio() const {
+    uint64_t chunk_bytes = GetLiveChunkCnt() * (kChunkSize - kHeaderSize);
+    if (chunk_bytes == 0) {
+        return 0;
+    }
+    uint64_t used = std::min(GetUsedBytes(), chunk_bytes);
+    return static_cast<double>(chunk_bytes - used) / chunk_bytes;
+}
+
+bool NumaArena::OverWasteCap() const {
+    return max_waste_ratio_ > 0 && GetLiveChunkCnt() >= kMinChunksToCap && GetWasteRatio() > max_waste_ratio_;
+}
+
+char* NumaArena::Allocate(uint32_t size) {
+    if (size > kMaxAllocSize) {
+        return nullptr;
+    }
+    static std::atomic<uint32_t> thread_cnt(0);
+    static thread_local uint32_t shard_idx = thread_cnt.fetch_add(1, std::memory_order_relaxed) % kShardCnt;
+    auto& shard = shards_[shard_idx];
+    size = std::max(8u, (size + 7) & ~7u);
+    Chunk* old = nullptr;
+    char* ptr = nullptr;
+    {
+        std::lock_guard<SpinMutex> lock(shard.mu);
+        if (shard.current == nullptr || shard.offset + size > kChunkSize) {
+            // the pinned chunks waste too much, let the caller fall back to malloc until some are released
+            if (OverWasteCap()) {
+                return nullptr;
+            }
+            Chunk* chunk = NewChunk();
+            if (chunk == nullptr) {
+                return nullptr;
+            }
+            old = shard.current;
+            shard.current = chunk;
+            shard.offset = kHeaderSize;
+        }
+        shard.current->ref.fetch_add(1, std::memory_order_relaxed);
+        ptr = reinterpret_cast<char*>(shard.current) + shard.offset;
+        shard.offset += size;
+        shard.allocated_bytes.store(shard.allocated_bytes.load(std::memory_order_relaxed) + size,
+                                    std::memory_order_relaxed);
+    }
+    if (old != nullptr) {
+        Unref(old);
+    }
+    return ptr;
+}
+
+void NumaArena::Free(char* ptr, uint32_t size) {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto chunk = reinterpret_cast<Chunk*>(reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(kChunkSize - 1));
+    chunk->stats->freed_bytes.fetch_add(std::max(8u, (size + 7) & ~7u), std::memory_order_relaxed);
+    Unref(chunk);
+}
+
+void NumaArena::Unref(Chunk* chunk) {
+    if (chunk->ref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        chunk->stats->live_chunks.fetch_sub(1, std::memory_order_relaxed);
+        chunk->stats.~shared_ptr<Stats>();
+        free(chunk);
+    }
+}
+
+}  // namespace base
+}  // namespace openmldb
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_BASE_NUMA_H_
+#define SRC_BASE_NUMA_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/spinlock.h"
+
+namespace openmldb {
+namespace base {
+
+// parse a cpu list of sysfs, e.g. "0-3,8,10-11"
+bool ParseCpuList(const std::string& str, std::vector<int>* cpus);
+
+// the numa nodes of the machine and their cpus. partitions are homed to nodes round robin
+class NumaTopology {
+ public:
+    // `fake` is empty to read the topology from /sys/devices/system/node,
+    // "<n>" to split the online cpus into n fake nodes, or "<cpulist>;<cpulist>..."
+    // to give the cpus of each fake node, e.g. "0-3;4-7" or "2;". return nullptr on failure
+    static std::shared_ptr<NumaTopology> Create(const std::string& fake);
+
+    uint32_t GetNodeCnt() const { return nodes_.size(); }
+    const std::vector<int>& GetCpus(uint32_t node) const { return nodes_[node]; }
+    // memory can not be bound to a fake node
+    bool IsFake() const { return fake_; }
+    uint32_t GetNode(uint32_t pid) const { return pid % nodes_.size(); }
+
+    // pin the calling thread to the cpus of `node`
+    bool BindCurrentThread(uint32_t node) const;
+
+ private:
+    NumaTopology(std::vector<std::vector<int>>&& nodes, bool fake) : nodes_(std::move(nodes)), fake_(fake) {}
+
+    std::vector<std::vector<int>> nodes_;
+    bool fake_;
+};
+
+// NumaArena allocates memory from chunks whose pages are bound to a node. allocations
+// are bumped from the current chunk of one of the shards, a thread always uses the same
+// shard so that the puts of different threads do not contend on one lock. a chunk is
+// released only when all of its allocations are freed, so one long lived allocation pins
+// the whole chunk. it suits rows expired by ttl which are freed in about the order they
+// are put, and the waste of pinned chunks is capped by `max_waste_ratio`
+class NumaArena {
+ public:
+    static constexpr uint32_t kChunkSize = 1 << 20;
+    // larger allocations are not served by the arena
+    static constexpr uint32_t kMaxAllocSize = kChunkSize / 8;
+    static constexpr uint32_t kShardCnt = 16;
+    // the waste is not checked before the arena has so many chunks
+    static constexpr uint64_t kMinChunksToCap = 2 * kShardCnt;
+
+    // pages are not bound if `node` < 0. no new chunk is allocated while the bytes of live
+    // chunks not used by live allocations are more than `max_waste_ratio` of all, 0 means no cap
+    explicit NumaArena(int node, double max_waste_ratio = 0);
+    ~NumaArena();
+
+    NumaArena(const NumaArena&) = delete;
+    NumaArena& operator=(const NumaArena&) = delete;
+
+    // return nullptr if size > kMaxAllocSize, the waste is over the cap or no memory
+    char* Allocate(uint32_t size);
+
+    // free a pointer of `size` bytes returned by Allocate of any arena
+    static void Free(char* ptr, uint32_t size);
+
+    // the chunks allocated so far
+    uint64_t GetChunkCnt() const { return chunk_cnt_.load(std::memory_order_relaxed); }
+    // the chunks not released yet
+    uint64_t GetLiveChunkCnt() const { return stats_->live_chunks.load(std::memory_order_relaxed); }
+    // the bytes of live allocations
+    uint64_t GetUsedBytes() const;
+    // the part of live chunks not used by live allocations
+    double GetWasteRatio() const;
+
+ private:
+    // shared by the arena and its chunks, as chunks may outlive the arena
+    struct Stats {
+        std::atomic<uint64_t> live_chunks{0};
+        std::atomic<uint64_t> freed_bytes{0};
+    };
+    struct Chunk {
+        // allocations in the chunk, and one for the arena while it is the current chunk
+        std::atomic<uint32_t> ref;
+        std::shared_ptr<Stats> stats;
+    };
+    struct alignas(64) Shard {
+        SpinMutex mu;
+        Chunk* current = nullptr;
+        uint32_t offset = 0;
+        // only written under `mu`
+        std::atomic<uint64_t> allocated_bytes{0};
+    };
+    static constexpr uint32_t kHeaderSize = (sizeof(Chunk) + 15) & ~15u;
+
+    Chunk* NewChunk();
+    bool OverWasteCap() const;
+    static void Unref(Chunk* chunk);
+
+    const int node_;
+    const double max_waste_ratio_;
+    std::shared_ptr<Stats> stats_;
+    Shard shards_[kShardCnt];
+    std::atomic<uint64_t> chunk_cnt_;
+};
+
+}  // namespace base
+}  // namespace openmldb
+
+#endif  // SRC_BASE_NUMA_H_
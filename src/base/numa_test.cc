@@ -0,0 +1,171 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/numa.h"
+
+#include <sched.h>
+
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace base {
+
+class NumaTest : public ::testing::Test {};
+
+TEST_F(NumaTest, ParseCpuList) {
+    std::vector<int> cpus;
+    ASSERT_TRUE(ParseCpuList("0-3,8,10-11\n", &cpus));
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}), cpus);
+    ASSERT_TRUE(ParseCpuList("5", &cpus));
+    ASSERT_EQ(std::vector<int>({5}), cpus);
+    ASSERT_FALSE(ParseCpuList("", &cpus));
+    ASSERT_FALSE(ParseCpuList("3-1", &cpus));
+    ASSERT_FALSE(ParseCpuList("a-b", &cpus));
+    ASSERT_FALSE(ParseCpuList("1-2-3", &cpus));
+}
+
+TEST_F(NumaTest, FakeTopology) {
+    auto topology = NumaTopology::Create("0-1;2;3-5");
+    ASSERT_TRUE(topology);
+    ASSERT_TRUE(topology->IsFake());
+    ASSERT_EQ(3u, topology->GetNodeCnt());
+    ASSERT_EQ(std::vector<int>({2}), topology->GetCpus(1));
+    ASSERT_EQ(std::vector<int>({3, 4, 5}), topology->GetCpus(2));
+    ASSERT_EQ(0u, topology->GetNode(3));
+    ASSERT_EQ(2u, topology->GetNode(5));
+    ASSERT_FALSE(NumaTopology::Create("0-1;x"));
+    ASSERT_FALSE(NumaTopology::Create("0"));
+
+    // split the online cpus into one node
+    topology = NumaTopology::Create("1");
+    ASSERT_TRUE(topology);
+    ASSERT_EQ(1u, topology->GetNodeCnt());
+    ASSERT_FALSE(topology->GetCpus(0).empty());
+}
+
+TEST_F(NumaTest, BindCurrentThread) {
+    auto topology = NumaTopology::Create("1");
+    ASSERT_TRUE(topology);
+    // the only cpu the thread may run on
+    int cpu = topology->GetCpus(0)[0];
+    auto fake = NumaTopology::Create(std::to_string(cpu) + ";");
+    ASSERT_TRUE(fake);
+    bool bound = false;
+    int running_cpu = -1;
+    std::thread t([&]() {
+        bound = fake->BindCurrentThread(0);
+        running_cpu = sched_getcpu();
+    });
+    t.join();
+    ASSERT_TRUE(bound);
+    ASSERT_EQ(cpu, running_cpu);
+    ASSERT_FALSE(fake->BindCurrentThread(1));
+}
+
+TEST_F(NumaTest, Arena) {
+    NumaArena arena(-1);
+    ASSERT_EQ(nullptr, arena.Allocate(NumaArena::kMaxAllocSize + 1));
+    std::vector<char*> ptrs;
+    for (int i = 0; i < 10000; i++) {
+        char* ptr = arena.Allocate(1000);
+        ASSERT_NE(nullptr, ptr);
+        memset(ptr, i % 128, 1000);
+        ptrs.push_back(ptr);
+    }
+    ASSERT_GT(arena.GetChunkCnt(), 1u);
+    for (int i = 0; i < 10000; i++) {
+        ASSERT_EQ(i % 128, ptrs[i][0]);
+        ASSERT_EQ(i % 128, ptrs[i][999]);
+        NumaArena::Free(ptrs[i], 1000);
+    }
+    ASSERT_EQ(0u, arena.GetUsedBytes());
+    // a bound arena works on a machine with node 0
+    NumaArena bound_arena(0);
+    char* ptr = bound_arena.Allocate(16);
+    ASSERT_NE(nullptr, ptr);
+    memset(ptr, 1, 16);
+    NumaArena::Free(ptr, 16);
+}
+
+TEST_F(NumaTest, ArenaThreads) {
+    NumaArena arena(-1);
+    std::vector<std::thread> threads;
+    std::vector<std::vector<char*>> ptrs(8);
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&arena, &ptrs, t] {
+            for (int i = 0; i < 2000; i++) {
+                char* ptr = arena.Allocate(100);
+                ASSERT_NE(nullptr, ptr);
+                memset(ptr, t, 100);
+                ptrs[t].push_back(ptr);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(8u * 2000 * 104, arena.GetUsedBytes());
+    for (int t = 0; t < 8; t++) {
+        for (char* ptr : ptrs[t]) {
+            ASSERT_EQ(t, ptr[0]);
+            ASSERT_EQ(t, ptr[99]);
+            NumaArena::Free(ptr, 100);
+        }
+    }
+    ASSERT_EQ(0u, arena.GetUsedBytes());
+}
+
+TEST_F(NumaTest, ArenaWasteCap) {
+    NumaArena arena(-1, 0.5);
+    // keep one row of every chunk, as a row with a long ttl does
+    uint32_t size = NumaArena::kMaxAllocSize;
+    std::vector<char*> kept;
+    std::vector<char*> freed;
+    while (true) {
+        char* ptr = arena.Allocate(size);
+        if (ptr == nullptr) {
+            break;
+        }
+        if (reinterpret_cast<uintptr_t>(ptr) % NumaArena::kChunkSize < size) {
+            kept.push_back(ptr);
+        } else {
+            NumaArena::Free(ptr, size);
+        }
+        ASSERT_LT(arena.GetChunkCnt(), 1000u);
+    }
+    ASSERT_GE(arena.GetLiveChunkCnt(), NumaArena::kMinChunksToCap);
+    ASSERT_GT(arena.GetWasteRatio(), 0.5);
+    // the chunks are released with their last rows and the arena serves again
+    for (char* ptr : kept) {
+        NumaArena::Free(ptr, size);
+    }
+    ASSERT_EQ(1u, arena.GetLiveChunkCnt());
+    char* ptr = arena.Allocate(size);
+    ASSERT_NE(nullptr, ptr);
+    NumaArena::Free(ptr, size);
+}
+
+}  // namespace base
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
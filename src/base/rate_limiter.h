@@ -0,0 +1,90 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_BASE_RATE_LIMITER_H_
+#define SRC_BASE_RATE_LIMITER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+
+namespace openmldb {
+namespace base {
+
+// token bucket shared by several threads, `rate` is in units per second and
+// 0 means unlimited. the bucket holds at most one second of tokens, a request
+// larger than the bucket is granted and paid back by later callers. with rate
+// 0 a request returns without taking the lock
+class RateLimiter {
+ public:
+    explicit RateLimiter(uint64_t rate) : rate_(rate), tokens_(static_cast<double>(rate)), last_(Now()), mu_() {}
+    ~RateLimiter() {}
+
+    void SetRate(uint64_t rate) {
+        std::lock_guard<std::mutex> lock(mu_);
+        rate_.store(rate, std::memory_order_relaxed);
+        tokens_ = std::min(tokens_, static_cast<double>(rate));
+    }
+
+    uint64_t GetRate() const { return rate_.load(std::memory_order_relaxed); }
+
+    // block until `count` tokens are available
+    void Acquire(uint64_t count) {
+        int64_t wait_us = Reserve(count);
+        if (wait_us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(wait_us));
+        }
+    }
+
+    // take `count` tokens and return the microseconds the caller has to wait
+    int64_t Reserve(uint64_t count) {
+        if (rate_.load(std::memory_order_relaxed) == 0) {
+            return 0;
+        }
+        std::lock_guard<std::mutex> lock(mu_);
+        uint64_t rate = rate_.load(std::memory_order_relaxed);
+        if (rate == 0) {
+            return 0;
+        }
+        int64_t now = Now();
+        tokens_ = std::min(static_cast<double>(rate), tokens_ + (now - last_) * static_cast<double>(rate) / 1000000);
+        last_ = now;
+        tokens_ -= count;
+        if (tokens_ >= 0) {
+            return 0;
+        }
+        return static_cast<int64_t>(-tokens_ * 1000000 / rate);
+    }
+
+ private:
+    static int64_t Now() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    std::atomic<uint64_t> rate_;
+    double tokens_;
+    int64_t last_;
+    std::mutex mu_;
+};
+
+}  // namespace base
+}  // namespace openmldb
+
+#endif  // SRC_BASE_RATE_LIMITER_H_
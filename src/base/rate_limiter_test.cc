@@ -0,0 +1,86 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/rate_limiter.h"
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace base {
+
+class RateLimiterTest : public ::testing::Test {
+ public:
+    RateLimiterTest() {}
+    ~RateLimiterTest() {}
+};
+
+TEST_F(RateLimiterTest, Unlimited) {
+    RateLimiter limiter(0);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(0, limiter.Reserve(1 << 30));
+    }
+}
+
+TEST_F(RateLimiterTest, Reserve) {
+    RateLimiter limiter(1000);
+    // the bucket starts full
+    ASSERT_EQ(0, limiter.Reserve(1000));
+    int64_t wait_us = limiter.Reserve(500);
+    ASSERT_GT(wait_us, 400000);
+    ASSERT_LE(wait_us, 500000);
+    // debt accumulates
+    ASSERT_GT(limiter.Reserve(500), wait_us);
+}
+
+TEST_F(RateLimiterTest, SetRate) {
+    RateLimiter limiter(1000);
+    ASSERT_EQ(1000u, limiter.GetRate());
+    limiter.SetRate(0);
+    ASSERT_EQ(0, limiter.Reserve(1 << 20));
+    limiter.SetRate(100);
+    ASSERT_EQ(0, limiter.Reserve(0));
+    ASSERT_GT(limiter.Reserve(100), 0);
+}
+
+TEST_F(RateLimiterTest, Concurrent) {
+    RateLimiter limiter(20000);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&limiter] {
+            for (int j = 0; j < 10; j++) {
+                limiter.Acquire(1000);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    // 40000 tokens with 20000 in the bucket take one more second
+    auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    ASSERT_GE(cost.count(), 900);
+}
+
+}  // namespace base
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
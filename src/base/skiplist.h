@@ -20,6 +20,7 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
 #include <iostream>
 
@@ -77,6 +78,8 @@ class Node {
         return nexts_[level].load(std::memory_order_relaxed);
     }
 
+    void PrefetchNexts() const { __builtin_prefetch(nexts_); }
+
     V& GetValue() { return value_; }
 
     const K& GetKey() const { return key_; }
@@ -90,6 +93,11 @@ class Node {
     std::atomic<Node<K, V>*>* nexts_;
 };
 
+// prefetch what a key refers to before it is compared, see Skiplist::MultiSeek.
+// keys which refer to other memory overload it in their own namespace
+template <class K>
+inline void PrefetchKey(const K&) {}
+
 template <class K, class V, class Comparator>
 class Skiplist {
  public:
@@ -251,6 +259,77 @@ class Skiplist {
         return -1;
     }
 
+    // nodes[i] is the first node not less than keys[i], or NULL.
+    // The searches of a group of keys are interleaved: each step of a search
+    // prefetches what its next step reads, and the other searches of the group
+    // run while that memory is fetched. For lists much larger than the cache
+    // this hides most of the misses of the towers
+    void MultiSeek(const K* keys, uint32_t n, Node<K, V>** nodes) {
+        struct Search {
+            Node<K, V>* node;
+            Node<K, V>* next;
+            uint8_t level;
+            uint8_t stage;
+        };
+        constexpr uint32_t kGroup = 16;
+        // kLoad reads the next node of `node` at `level`, kKey prefetches the
+        // key of `next` and kCompare moves to `next` or goes down a level
+        enum : uint8_t { kLoad, kKey, kCompare, kDone };
+        Search searches[kGroup];
+        for (uint32_t start = 0; start < n; start += kGroup) {
+            uint32_t cnt = std::min(kGroup, n - start);
+            uint8_t max_level = GetMaxHeight() - 1;
+            for (uint32_t i = 0; i < cnt; i++) {
+                searches[i] = {head_, NULL, max_level, kLoad};
+            }
+            uint32_t active = cnt;
+            while (active > 0) {
+                for (uint32_t i = 0; i < cnt; i++) {
+                    Search& search = searches[i];
+                    switch (search.stage) {
+                        case kLoad:
+                            search.next = search.node->GetNext(search.level);
+                            if (search.next != NULL) {
+                                __builtin_prefetch(search.next);
+                                search.stage = kKey;
+                                break;
+                            }
+                            if (search.level == 0) {
+                                nodes[start + i] = NULL;
+                                search.stage = kDone;
+                                active--;
+                            } else {
+                                search.level--;
+                            }
+                            break;
+                        case kKey:
+                            PrefetchKey(search.next->GetKey());
+                            search.next->PrefetchNexts();
+                            search.stage = kCompare;
+                            break;
+                        case kCompare:
+                            if (compare_(search.next->GetKey(), keys[start + i]) < 0) {
+                                search.node = search.next;
+                                search.stage = kLoad;
+                            } else if (search.level == 0) {
+                                nodes[start + i] = search.next;
+                                search.stage = kDone;
+                                active--;
+                            } else {
+                                search.level--;
+                                search.stage = kLoad;
+                            }
+                            break;
+                        default:
+                            break;
+                    }
+                }
+            }
+        }
+    }
+
+    Node<K, V>* GetFirst() { return head_->GetNext(0); }
+
     Node<K, V>* GetLast() { return tail_.load(std::memory_order_acquire); }
 
     uint32_t GetSize() {
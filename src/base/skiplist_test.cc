@@ -233,6 +233,56 @@ TEST_F(SkiplistTest, Iterator) {
     delete it;
 }
 
+TEST_F(SkiplistTest, MultiSeek) {
+    Comparator cmp;
+    for (auto height : vec) {
+        Skiplist<uint32_t, uint32_t, Comparator> sl(height, 4, cmp);
+        std::vector<uint32_t> keys;
+        std::vector<Node<uint32_t, uint32_t>*> nodes(100);
+        sl.MultiSeek(keys.data(), 0, nodes.data());
+        for (uint32_t i = 0; i < 100; i++) {
+            keys.push_back(i);
+        }
+        sl.MultiSeek(keys.data(), keys.size(), nodes.data());
+        for (auto node : nodes) {
+            ASSERT_TRUE(node == NULL);
+        }
+        // the even keys from 10 to 88
+        for (uint32_t key = 10; key < 90; key += 2) {
+            uint32_t value = key * 10;
+            sl.Insert(key, value);
+        }
+        sl.MultiSeek(keys.data(), keys.size(), nodes.data());
+        for (uint32_t i = 0; i < 100; i++) {
+            if (i >= 89) {
+                ASSERT_TRUE(nodes[i] == NULL);
+                continue;
+            }
+            uint32_t expect = i < 10 ? 10 : (i + 1) / 2 * 2;
+            ASSERT_TRUE(nodes[i] != NULL);
+            ASSERT_EQ(expect, nodes[i]->GetKey());
+            ASSERT_EQ(expect * 10, nodes[i]->GetValue());
+        }
+    }
+    SliceComparator slice_cmp;
+    Skiplist<Slice, uint32_t, SliceComparator> sl(12, 4, slice_cmp);
+    std::vector<std::string> strs;
+    for (uint32_t i = 0; i < 1000; i++) {
+        strs.push_back("key" + std::to_string(i * 2));
+    }
+    for (uint32_t i = 0; i < strs.size(); i++) {
+        sl.Insert(Slice(strs[i]), i);
+    }
+    std::vector<Slice> slices(strs.begin(), strs.end());
+    std::vector<Node<Slice, uint32_t>*> nodes(slices.size());
+    sl.MultiSeek(slices.data(), slices.size(), nodes.data());
+    for (uint32_t i = 0; i < slices.size(); i++) {
+        ASSERT_TRUE(nodes[i] != NULL);
+        ASSERT_EQ(0, nodes[i]->GetKey().compare(slices[i]));
+        ASSERT_EQ(i, nodes[i]->GetValue());
+    }
+}
+
 TEST_F(SkiplistTest, Split1) {
     for (auto height : vec) {
         Comparator cmp;
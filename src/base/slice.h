@@ -153,6 +153,9 @@ inline int Slice::compare(const Slice& b) const {
     return r;
 }
 
+// used by Skiplist::MultiSeek
+inline void PrefetchKey(const Slice& key) { __builtin_prefetch(key.data()); }
+
 }  // namespace base
 }  // namespace openmldb
 #endif  // SRC_BASE_SLICE_H_
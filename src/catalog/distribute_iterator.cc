@@ -16,6 +16,7 @@
 
 #include "catalog/distribute_iterator.h"
 #include "gflags/gflags.h"
+#include "storage/mem_table.h"
 
 DECLARE_uint32(traverse_cnt_limit);
 
@@ -27,7 +28,7 @@ constexpr uint32_t INVALID_PID = UINT32_MAX;
 FullTableIterator::FullTableIterator(uint32_t tid, std::shared_ptr<Tables> tables,
         const std::map<uint32_t, std::shared_ptr<::openmldb::client::TabletClient>>& tablet_clients)
     : tid_(tid), tables_(tables), tablet_clients_(tablet_clients), in_local_(true), cur_pid_(INVALID_PID),
-    it_(), kv_it_(), key_(0), last_ts_(0), last_pk_(), value_() {
+    it_(), copy_value_(false), kv_it_(), key_(0), last_ts_(0), last_pk_(), value_() {
 }
 
 void FullTableIterator::SeekToFirst() {
@@ -88,6 +89,8 @@ bool FullTableIterator::NextFromLocal() {
             return false;
         }
         cur_pid_ = iter->first;
+        auto mem_table = std::dynamic_pointer_cast<::openmldb::storage::MemTable>(iter->second);
+        copy_value_ = mem_table && mem_table->GetRowDict() != NULL;
         it_.reset(iter->second->NewTraverseIterator(0));
         it_->SeekToFirst();
         if (it_->Valid()) {
@@ -156,8 +159,15 @@ bool FullTableIterator::NextFromRemote() {
 
 const ::hybridse::codec::Row& FullTableIterator::GetValue() {
     if (it_) {
-        value_ = ::hybridse::codec::Row(
-            ::hybridse::base::RefCountedSlice::Create(it_->GetValue().data(), it_->GetValue().size()));
+        ::openmldb::base::Slice value = it_->GetValue();
+        if (copy_value_) {
+            // a row decoded by dictionaries is valid until the iterator moves, the row may be kept longer
+            int8_t* buf = reinterpret_cast<int8_t*>(malloc(value.size()));
+            memcpy(buf, value.data(), value.size());
+            value_ = ::hybridse::codec::Row(::hybridse::base::RefCountedSlice::CreateManaged(buf, value.size()));
+        } else {
+            value_ = ::hybridse::codec::Row(::hybridse::base::RefCountedSlice::Create(value.data(), value.size()));
+        }
         return value_;
     } else {
         value_ = ::hybridse::codec::Row(
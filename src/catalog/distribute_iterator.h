@@ -59,6 +59,8 @@ class FullTableIterator : public ::hybridse::codec::ConstIterator<uint64_t, ::hy
     bool in_local_;
     uint32_t cur_pid_;
     std::unique_ptr<::openmldb::storage::TableIterator> it_;
+    // the rows of it_ are copied if they are decoded by dictionaries
+    bool copy_value_;
     std::unique_ptr<::openmldb::base::KvIterator> kv_it_;
     uint64_t key_;
     uint64_t last_ts_;
@@ -22,6 +22,7 @@
 #include <string>
 #include <utility>
 
+#include "base/hash.h"
 #include "catalog/distribute_iterator.h"
 #include "codec/list_iterator_codec.h"
 #include "glog/logging.h"
@@ -198,6 +199,95 @@ std::shared_ptr<::hybridse::vm::PartitionHandler> TabletTableHandler::GetPartiti
     return std::make_shared<TabletPartitionHandler>(shared_from_this(), index_name);
 }
 
+std::vector<std::shared_ptr<::hybridse::vm::TableHandler>> TabletTableHandler::GetSegments(
+    std::shared_ptr<::hybridse::vm::PartitionHandler> partition, const std::string& index_name,
+    const std::vector<std::string>& keys) {
+    std::vector<std::shared_ptr<::hybridse::vm::TableHandler>> segments(keys.size());
+    auto iter = index_hint_.find(index_name);
+    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+    // the positions of the keys in each local memory table
+    std::map<uint32_t, std::vector<size_t>> local_keys;
+    for (size_t i = 0; i < keys.size(); i++) {
+        uint32_t pid = 0;
+        if (partition_num_ > 0) {
+            pid = static_cast<uint32_t>(::openmldb::base::hash64(keys[i]) % partition_num_);
+        }
+        if (iter != index_hint_.end() && tables) {
+            auto table_iter = tables->find(pid);
+            if (table_iter != tables->end() &&
+                std::dynamic_pointer_cast<::openmldb::storage::MemTable>(table_iter->second)) {
+                local_keys[pid].push_back(i);
+                continue;
+            }
+        }
+        segments[i] = std::make_shared<TabletSegmentHandler>(partition, keys[i]);
+    }
+    std::vector<std::string> pks;
+    std::vector<::openmldb::storage::KeyEntry*> entries;
+    for (const auto& kv : local_keys) {
+        auto table = std::dynamic_pointer_cast<::openmldb::storage::MemTable>(tables->at(kv.first));
+        pks.clear();
+        for (size_t pos : kv.second) {
+            pks.push_back(keys[pos]);
+        }
+        auto ticket = std::make_shared<::openmldb::storage::Ticket>();
+        if (!table->GetKeyEntries(iter->second.index, pks, *ticket, &entries)) {
+            for (size_t pos : kv.second) {
+                segments[pos] = std::make_shared<TabletSegmentHandler>(partition, keys[pos]);
+            }
+            continue;
+        }
+        for (size_t i = 0; i < kv.second.size(); i++) {
+            segments[kv.second[i]] =
+                std::make_shared<LocalSegmentHandler>(partition, table, iter->second.index, entries[i], ticket);
+        }
+    }
+    return segments;
+}
+
+bool TabletTableHandler::GetWriteVersion(const std::string& index_name, const std::string& key, uint64_t* version) {
+    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+    if (!tables || partition_num_ == 0) {
+        return false;
+    }
+    uint32_t pid = static_cast<uint32_t>(::openmldb::base::hash64(key) % partition_num_);
+    auto table_iter = tables->find(pid);
+    if (table_iter == tables->end()) {
+        return false;
+    }
+    auto table = std::dynamic_pointer_cast<::openmldb::storage::MemTable>(table_iter->second);
+    if (!table) {
+        return false;
+    }
+    auto index_def = table->GetIndex(index_name);
+    if (!index_def || !index_def->IsReady()) {
+        return false;
+    }
+    auto ttl = index_def->GetTTL();
+    if (ttl->ttl_type != ::openmldb::storage::TTLType::kLatestTime && ttl->abs_ttl > 0) {
+        return false;
+    }
+    *version = table->GetWriteVersion();
+    return true;
+}
+
+std::vector<std::shared_ptr<::hybridse::vm::TableHandler>> TabletPartitionHandler::GetSegments(
+    const std::vector<std::string>& keys) {
+    auto table_handler = std::dynamic_pointer_cast<TabletTableHandler>(table_handler_);
+    if (!table_handler) {
+        return PartitionHandler::GetSegments(keys);
+    }
+    return table_handler->GetSegments(shared_from_this(), index_name_, keys);
+}
+
+bool TabletPartitionHandler::GetWriteVersion(const std::string& key, uint64_t* version) {
+    auto table_handler = std::dynamic_pointer_cast<TabletTableHandler>(table_handler_);
+    if (!table_handler) {
+        return false;
+    }
+    return table_handler->GetWriteVersion(index_name_, key, version);
+}
+
 void TabletTableHandler::AddTable(std::shared_ptr<::openmldb::storage::Table> table) {
     std::shared_ptr<Tables> old_tables;
     std::shared_ptr<Tables> new_tables;
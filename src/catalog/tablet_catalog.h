@@ -29,6 +29,7 @@
 #include "catalog/distribute_iterator.h"
 #include "client/tablet_client.h"
 #include "codec/row.h"
+#include "storage/mem_table.h"
 #include "storage/schema.h"
 #include "storage/table.h"
 #include "sdk/sql_cluster_router.h"
@@ -117,6 +118,78 @@ class TabletSegmentHandler : public ::hybridse::vm::TableHandler {
     std::string key_;
 };
 
+// the segment of a key entry looked up in a local memory table
+class LocalSegmentHandler : public ::hybridse::vm::TableHandler {
+ public:
+    LocalSegmentHandler(std::shared_ptr<::hybridse::vm::PartitionHandler> partition_handler,
+                        std::shared_ptr<::openmldb::storage::MemTable> table, uint32_t index,
+                        ::openmldb::storage::KeyEntry *entry, std::shared_ptr<::openmldb::storage::Ticket> ticket)
+        : TableHandler(),
+          partition_handler_(partition_handler),
+          table_(table),
+          index_(index),
+          entry_(entry),
+          ticket_(ticket) {}
+
+    ~LocalSegmentHandler() {}
+
+    const ::hybridse::vm::Schema *GetSchema() override { return partition_handler_->GetSchema(); }
+
+    const std::string &GetName() override { return partition_handler_->GetName(); }
+
+    const std::string &GetDatabase() override { return partition_handler_->GetDatabase(); }
+
+    const ::hybridse::vm::Types &GetTypes() override { return partition_handler_->GetTypes(); }
+
+    const ::hybridse::vm::IndexHint &GetIndex() override { return partition_handler_->GetIndex(); }
+
+    const ::hybridse::vm::OrderType GetOrderType() const override { return partition_handler_->GetOrderType(); }
+
+    std::unique_ptr<::hybridse::vm::RowIterator> GetIterator() override {
+        return std::unique_ptr<::hybridse::vm::RowIterator>(GetRawIterator());
+    }
+
+    ::hybridse::vm::RowIterator *GetRawIterator() override {
+        if (entry_ == nullptr) {
+            return nullptr;
+        }
+        return table_->NewWindowIterator(index_, entry_);
+    }
+
+    std::unique_ptr<::hybridse::vm::WindowIterator> GetWindowIterator(const std::string &idx_name) override {
+        return std::unique_ptr<::hybridse::vm::WindowIterator>();
+    }
+
+    const uint64_t GetCount() override {
+        auto iter = GetIterator();
+        if (!iter) return 0;
+        uint64_t cnt = 0;
+        while (iter->Valid()) {
+            cnt++;
+            iter->Next();
+        }
+        return cnt;
+    }
+
+    ::hybridse::vm::Row At(uint64_t pos) override {
+        auto iter = GetIterator();
+        if (!iter) return ::hybridse::vm::Row();
+        while (pos-- > 0 && iter->Valid()) {
+            iter->Next();
+        }
+        return iter->Valid() ? iter->GetValue() : ::hybridse::vm::Row();
+    }
+    const std::string GetHandlerTypeName() override { return "LocalSegmentHandler"; }
+
+ private:
+    std::shared_ptr<::hybridse::vm::PartitionHandler> partition_handler_;
+    std::shared_ptr<::openmldb::storage::MemTable> table_;
+    uint32_t index_;
+    ::openmldb::storage::KeyEntry *entry_;
+    // holds the entry
+    std::shared_ptr<::openmldb::storage::Ticket> ticket_;
+};
+
 class TabletPartitionHandler : public ::hybridse::vm::PartitionHandler,
                                public std::enable_shared_from_this<hybridse::vm::PartitionHandler> {
  public:
@@ -157,6 +230,12 @@ class TabletPartitionHandler : public ::hybridse::vm::PartitionHandler,
     std::shared_ptr<::hybridse::vm::TableHandler> GetSegment(const std::string &key) override {
         return std::make_shared<TabletSegmentHandler>(shared_from_this(), key);
     }
+
+    std::vector<std::shared_ptr<::hybridse::vm::TableHandler>> GetSegments(
+        const std::vector<std::string> &keys) override;
+
+    bool GetWriteVersion(const std::string &key, uint64_t *version) override;
+
     const std::string GetHandlerTypeName() override { return "TabletPartitionHandler"; }
 
  private:
@@ -201,6 +280,16 @@ class TabletTableHandler : public ::hybridse::vm::TableHandler,
     ::hybridse::codec::Row At(uint64_t pos) override;
 
     std::shared_ptr<::hybridse::vm::PartitionHandler> GetPartition(const std::string &index_name) override;
+
+    // the segments of `keys` in an index. the keys in the local memory tables are looked up at
+    // once per partition, the others are looked up lazily by TabletSegmentHandler
+    std::vector<std::shared_ptr<::hybridse::vm::TableHandler>> GetSegments(
+        std::shared_ptr<::hybridse::vm::PartitionHandler> partition, const std::string &index_name,
+        const std::vector<std::string> &keys);
+
+    // the write version of the local memory table of `key`. false if the table is remote, or the
+    // rows of the index expire by time without a write
+    bool GetWriteVersion(const std::string &index_name, const std::string &key, uint64_t *version);
     const std::string GetHandlerTypeName() override { return "TabletTableHandler"; }
 
     std::shared_ptr<::hybridse::vm::Tablet> GetTablet(const std::string &index_name, const std::string &pk) override;
@@ -268,6 +268,29 @@ bool TabletClient::Put(uint32_t tid, uint32_t pid, uint64_t time, const std::str
     return false;
 }
 
+bool TabletClient::AsyncPut(uint32_t tid, uint32_t pid, uint64_t time, const std::string& value,
+                            const std::vector<std::pair<std::string, uint32_t>>& dimensions, uint32_t format_version,
+                            openmldb::RpcCallback<openmldb::api::PutResponse>* callback) {
+    if (callback == nullptr) {
+        return false;
+    }
+    ::openmldb::api::PutRequest request;
+    request.set_time(time);
+    request.set_value(value);
+    request.set_tid(tid);
+    request.set_pid(pid);
+    request.set_format_version(format_version);
+    for (const auto& dimension : dimensions) {
+        ::openmldb::api::Dimension* d = request.add_dimensions();
+        d->set_key(dimension.first);
+        d->set_idx(dimension.second);
+    }
+    // the request is serialized before sending returns, only the response and controller are kept in callback
+    callback->GetController()->set_timeout_ms(FLAGS_request_timeout_ms);
+    return client_.SendRequest(&::openmldb::api::TabletServer_Stub::Put, callback->GetController().get(), &request,
+                               callback->GetResponse().get(), callback);
+}
+
 bool TabletClient::Put(uint32_t tid, uint32_t pid, const char* pk, uint64_t time, const char* value, uint32_t size,
                        uint32_t format_version) {
     ::openmldb::api::PutRequest request;
@@ -591,6 +614,15 @@ bool TabletClient::GetTableStatus(uint32_t tid, uint32_t pid, bool need_schema,
     return false;
 }
 
+bool TabletClient::GetTableStatus(const ::openmldb::api::GetTableStatusRequest& request,
+                                  openmldb::RpcCallback<openmldb::api::GetTableStatusResponse>* callback) {
+    if (callback == nullptr) {
+        return false;
+    }
+    return client_.SendRequest(&::openmldb::api::TabletServer_Stub::GetTableStatus, callback->GetController().get(),
+                               &request, callback->GetResponse().get(), callback);
+}
+
 ::openmldb::base::KvIterator* TabletClient::Scan(uint32_t tid, uint32_t pid, const std::string& pk, uint64_t stime,
                                                  uint64_t etime, const std::string& idx_name,
                                                  const std::string& ts_name, uint32_t limit, uint32_t atleast,
@@ -1274,6 +1306,15 @@ bool TabletClient::AsyncScan(const ::openmldb::api::ScanRequest& request,
                                callback->GetResponse().get(), callback);
 }
 
+bool TabletClient::AsyncMultiScan(const ::openmldb::api::MultiScanRequest& request,
+                                  openmldb::RpcCallback<openmldb::api::MultiScanResponse>* callback) {
+    if (callback == nullptr) {
+        return false;
+    }
+    return client_.SendRequest(&::openmldb::api::TabletServer_Stub::MultiScan, callback->GetController().get(),
+                               &request, callback->GetResponse().get(), callback);
+}
+
 bool TabletClient::Scan(const ::openmldb::api::ScanRequest& request, brpc::Controller* cntl,
                         ::openmldb::api::ScanResponse* response) {
     bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::Scan, cntl, &request, response);
@@ -1475,5 +1516,33 @@ bool TabletClient::GetAndFlushDeployStats(::openmldb::api::DeployStatsResponse*
     return ok && res->code() == 0;
 }
 
+bool TabletClient::GetBulkLoadInfo(uint32_t tid, uint32_t pid, ::openmldb::api::BulkLoadInfoResponse* response) {
+    ::openmldb::api::BulkLoadInfoRequest request;
+    request.set_tid(tid);
+    request.set_pid(pid);
+    bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::GetBulkLoadInfo, &request, response,
+                                  FLAGS_request_timeout_ms, FLAGS_request_max_retry);
+    return ok && response->code() == 0;
+}
+
+bool TabletClient::BulkLoad(const ::openmldb::api::BulkLoadRequest& request, const butil::IOBuf& data,
+                            std::string* msg) {
+    // parts must arrive in order exactly once, so never retry
+    brpc::Controller cntl;
+    cntl.set_timeout_ms(FLAGS_request_timeout_ms);
+    cntl.request_attachment().append(data);
+    ::openmldb::api::GeneralResponse response;
+    bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::BulkLoad, &cntl, &request, &response);
+    if (!ok) {
+        msg->assign(cntl.ErrorText());
+        return false;
+    }
+    if (response.code() != 0) {
+        msg->assign(response.msg());
+        return false;
+    }
+    return true;
+}
+
 }  // namespace client
 }  // namespace openmldb
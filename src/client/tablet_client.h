@@ -90,6 +90,10 @@ class TabletClient : public Client {
     bool Put(uint32_t tid, uint32_t pid, uint64_t time, const std::string& value,
              const std::vector<std::pair<std::string, uint32_t>>& dimensions, uint32_t format_version);
 
+    bool AsyncPut(uint32_t tid, uint32_t pid, uint64_t time, const std::string& value,
+                  const std::vector<std::pair<std::string, uint32_t>>& dimensions, uint32_t format_version,
+                  openmldb::RpcCallback<openmldb::api::PutResponse>* callback);
+
 
 
     bool Get(uint32_t tid, uint32_t pid, const std::string& pk, uint64_t time, std::string& value,  // NOLINT
@@ -137,6 +141,9 @@ class TabletClient : public Client {
     bool AsyncScan(const ::openmldb::api::ScanRequest& request,
                    openmldb::RpcCallback<openmldb::api::ScanResponse>* callback);
 
+    bool AsyncMultiScan(const ::openmldb::api::MultiScanRequest& request,
+                        openmldb::RpcCallback<openmldb::api::MultiScanResponse>* callback);
+
     bool GetTableSchema(uint32_t tid, uint32_t pid,
                         ::openmldb::api::TableMeta& table_meta);  // NOLINT
 
@@ -198,6 +205,9 @@ class TabletClient : public Client {
                         ::openmldb::api::TableStatus& table_status);  // NOLINT
     bool GetTableStatus(uint32_t tid, uint32_t pid, bool need_schema,
                         ::openmldb::api::TableStatus& table_status);  // NOLINT
+    // async, the timeout is set in the controller of the callback
+    bool GetTableStatus(const ::openmldb::api::GetTableStatusRequest& request,
+                        openmldb::RpcCallback<openmldb::api::GetTableStatusResponse>* callback);
 
     bool FollowOfNoOne(uint32_t tid, uint32_t pid, uint64_t term,
                        uint64_t& offset);  // NOLINT
@@ -296,6 +306,11 @@ class TabletClient : public Client {
 
     bool GetAndFlushDeployStats(::openmldb::api::DeployStatsResponse* res);
 
+    bool GetBulkLoadInfo(uint32_t tid, uint32_t pid, ::openmldb::api::BulkLoadInfoResponse* response);
+
+    // `data` is the data region of this part, sent as the request attachment
+    bool BulkLoad(const ::openmldb::api::BulkLoadRequest& request, const butil::IOBuf& data, std::string* msg);
+
  private:
     ::openmldb::RpcClient<::openmldb::api::TabletServer_Stub> client_;
     std::vector<uint64_t> percentile_;
@@ -18,7 +18,6 @@
 
 #include <algorithm>
 #include <array>
-#include <unordered_set>
 
 #include "base/glog_wapper.h"
 #include "boost/lexical_cast.hpp"
@@ -28,11 +27,6 @@ namespace codec {
 
 #define BitMapSize(size) (((size) >> 3) + !!((size)&0x07))
 
-static const std::unordered_set<::openmldb::type::DataType> TYPE_SET(
-    {::openmldb::type::kBool, ::openmldb::type::kSmallInt, ::openmldb::type::kInt, ::openmldb::type::kBigInt,
-     ::openmldb::type::kFloat, ::openmldb::type::kDouble, ::openmldb::type::kDate, ::openmldb::type::kTimestamp,
-     ::openmldb::type::kVarchar, ::openmldb::type::kString});
-
 static constexpr std::array<uint32_t, 9> TYPE_SIZE_ARRAY = {
     0,
     sizeof(bool),     // kBool
@@ -68,17 +62,20 @@ RowBuilder::RowBuilder(const Schema& schema)
       str_offset_(0),
       schema_version_(1) {
     str_field_start_offset_ = HEADER_LENGTH + BitMapSize(schema.size());
+    fields_.reserve(schema.size());
     for (int idx = 0; idx < schema.size(); idx++) {
         const ::openmldb::common::ColumnDesc& column = schema.Get(idx);
         openmldb::type::DataType cur_type = column.data_type();
-        if (cur_type == ::openmldb::type::kVarchar || cur_type == ::openmldb::type::kString) {
-            offset_vec_.push_back(str_field_cnt_);
+        if (IsStringType(cur_type)) {
+            fields_.push_back({cur_type, column.not_null(), str_field_cnt_});
             str_field_cnt_++;
         } else {
             if (cur_type < TYPE_SIZE_ARRAY.size() && cur_type > 0) {
-                offset_vec_.push_back(str_field_start_offset_);
+                fields_.push_back({cur_type, column.not_null(), str_field_start_offset_});
                 str_field_start_offset_ += TYPE_SIZE_ARRAY[cur_type];
             } else {
+                // no setter accepts the type
+                fields_.push_back({cur_type, column.not_null(), 0});
                 PDLOG(WARNING, "type is not supported");
             }
         }
@@ -130,17 +127,11 @@ uint32_t RowBuilder::CalTotalLength(uint32_t string_length) {
     return 0;
 }
 
-bool RowBuilder::Check(uint32_t index, ::openmldb::type::DataType type) {
-    if ((int32_t)index >= schema_.size()) {
-        return false;
-    }
-    const ::openmldb::common::ColumnDesc& column = schema_.Get(index);
-    if (column.data_type() != type) {
-        return false;
-    }
-    if (TYPE_SET.find(column.data_type()) == TYPE_SET.end()) {
-        return false;
-    }
+template <::openmldb::type::DataType TYPE, typename T>
+bool RowBuilder::SetFixedField(int8_t* buf, uint32_t index, T val) {
+    if (!Check(index, TYPE)) return false;
+    SetField(buf, index);
+    *(reinterpret_cast<T*>(buf + fields_[index].offset)) = val;
     return true;
 }
 
@@ -153,11 +144,7 @@ bool RowBuilder::AppendDate(int32_t date) {
 bool RowBuilder::SetDate(uint32_t index, int32_t date) { return SetDate(buf_, index, date); }
 
 bool RowBuilder::SetDate(int8_t* buf, uint32_t index, int32_t date) {
-    if (!Check(index, ::openmldb::type::kDate)) return false;
-    SetField(buf, index);
-    int8_t* ptr = buf + offset_vec_[index];
-    *(reinterpret_cast<int32_t*>(ptr)) = date;
-    return true;
+    return SetFixedField<::openmldb::type::kDate>(buf, index, date);
 }
 
 bool RowBuilder::AppendDate(uint32_t year, uint32_t month, uint32_t day) {
@@ -174,14 +161,10 @@ bool RowBuilder::SetDate(int8_t* buf, uint32_t index, uint32_t year, uint32_t mo
     if (year < 1900 || year > 9999) return false;
     if (month < 1 || month > 12) return false;
     if (day < 1 || day > 31) return false;
-    if (!Check(index, ::openmldb::type::kDate)) return false;
-    int8_t* ptr = buf + offset_vec_[index];
     int32_t data = (year - 1900) << 16;
     data = data | ((month - 1) << 8);
     data = data | day;
-    *(reinterpret_cast<int32_t*>(ptr)) = data;
-    SetField(buf, index);
-    return true;
+    return SetFixedField<::openmldb::type::kDate>(buf, index, data);
 }
 
 void RowBuilder::SetField(uint32_t index) { SetField(buf_, index); }
@@ -198,25 +181,26 @@ bool RowBuilder::AppendNULL() {
 }
 
 bool RowBuilder::SetNULL(uint32_t index) {
-    const ::openmldb::common::ColumnDesc& column = schema_.Get(index);
-    if (column.not_null()) return false;
+    if (index >= fields_.size()) return false;
+    const FieldLayout& field = fields_[index];
+    if (field.not_null) return false;
     int8_t* ptr = buf_ + HEADER_LENGTH + (index >> 3);
     *(reinterpret_cast<uint8_t*>(ptr)) |= 1 << (index & 0x07);
-    if (column.data_type() == ::openmldb::type::kVarchar || column.data_type() == openmldb::type::kString) {
-        uint32_t str_pos = offset_vec_[index];
-        SetStrOffset(str_pos + 1);
+    if (IsStringType(field.type)) {
+        SetStrOffset(field.offset + 1);
     }
     return true;
 }
 
 bool RowBuilder::SetNULL(int8_t* buf, uint32_t size, uint32_t index) {
-    const ::openmldb::common::ColumnDesc& column = schema_.Get(index);
-    if (column.not_null()) return false;
+    if (index >= fields_.size()) return false;
+    const FieldLayout& field = fields_[index];
+    if (field.not_null) return false;
     int8_t* ptr = buf + HEADER_LENGTH + (index >> 3);
     *(reinterpret_cast<uint8_t*>(ptr)) |= 1 << (index & 0x07);
-    if (column.data_type() == ::openmldb::type::kVarchar || column.data_type() == openmldb::type::kString) {
+    if (IsStringType(field.type)) {
         uint32_t str_offset = 0;
-        uint32_t str_pos = offset_vec_[index];
+        uint32_t str_pos = field.offset;
         auto str_addr_length = GetAddrLength(size);
         if (str_pos == 0) {
             str_offset = str_field_start_offset_ + str_addr_length * str_field_cnt_;
@@ -225,18 +209,17 @@ bool RowBuilder::SetNULL(int8_t* buf, uint32_t size, uint32_t index) {
                 return false;
             }
         }
-        SetStrOffset(buf, size, str_pos + 1, str_offset);
+        SetStrOffset(buf, str_addr_length, str_pos + 1, str_offset);
     }
     return true;
 }
 
-void RowBuilder::SetStrOffset(uint32_t str_pos) { SetStrOffset(buf_, size_, str_pos, str_offset_); }
+void RowBuilder::SetStrOffset(uint32_t str_pos) { SetStrOffset(buf_, str_addr_length_, str_pos, str_offset_); }
 
-void RowBuilder::SetStrOffset(int8_t* buf, uint32_t size, uint32_t str_pos, uint32_t str_offset) {
+void RowBuilder::SetStrOffset(int8_t* buf, uint8_t str_addr_length, uint32_t str_pos, uint32_t str_offset) {
     if (str_pos >= str_field_cnt_) {
         return;
     }
-    auto str_addr_length = GetAddrLength(size);
     int8_t* ptr = buf + str_field_start_offset_ + str_addr_length * str_pos;
     if (str_addr_length == 1) {
         *(reinterpret_cast<uint8_t*>(ptr)) = (uint8_t)str_offset;
@@ -282,11 +265,7 @@ bool RowBuilder::AppendBool(bool val) {
 bool RowBuilder::SetBool(uint32_t index, bool val) { return SetBool(buf_, index, val); }
 
 bool RowBuilder::SetBool(int8_t* buf, uint32_t index, bool val) {
-    if (!Check(index, ::openmldb::type::kBool)) return false;
-    SetField(buf, index);
-    int8_t* ptr = buf + offset_vec_[index];
-    *(reinterpret_cast<uint8_t*>(ptr)) = val ? 1 : 0;
-    return true;
+    return SetFixedField<::openmldb::type::kBool, uint8_t>(buf, index, val ? 1 : 0);
 }
 
 bool RowBuilder::AppendInt16(int16_t val) {
@@ -298,11 +277,7 @@ bool RowBuilder::AppendInt16(int16_t val) {
 bool RowBuilder::SetInt16(uint32_t index, int16_t val) { return SetInt16(buf_, index, val); }
 
 bool RowBuilder::SetInt16(int8_t* buf, uint32_t index, int16_t val) {
-    if (!Check(index, ::openmldb::type::kSmallInt)) return false;
-    SetField(buf, index);
-    int8_t* ptr = buf + offset_vec_[index];
-    *(reinterpret_cast<int16_t*>(ptr)) = val;
-    return true;
+    return SetFixedField<::openmldb::type::kSmallInt>(buf, index, val);
 }
 
 bool RowBuilder::AppendInt32(int32_t val) {
@@ -314,11 +289,7 @@ bool RowBuilder::AppendInt32(int32_t val) {
 bool RowBuilder::SetInt32(uint32_t index, int32_t val) { return SetInt32(buf_, index, val); }
 
 bool RowBuilder::SetInt32(int8_t* buf, uint32_t index, int32_t val) {
-    if (!Check(index, ::openmldb::type::kInt)) return false;
-    SetField(buf, index);
-    int8_t* ptr = buf + offset_vec_[index];
-    *(reinterpret_cast<int32_t*>(ptr)) = val;
-    return true;
+    return SetFixedField<::openmldb::type::kInt>(buf, index, val);
 }
 
 bool RowBuilder::AppendInt64(int64_t val) {
@@ -330,11 +301,7 @@ bool RowBuilder::AppendInt64(int64_t val) {
 bool RowBuilder::SetInt64(uint32_t index, int64_t val) { return SetInt64(buf_, index, val); }
 
 bool RowBuilder::SetInt64(int8_t* buf, uint32_t index, int64_t val) {
-    if (!Check(index, ::openmldb::type::kBigInt)) return false;
-    SetField(buf, index);
-    int8_t* ptr = buf + offset_vec_[index];
-    *(reinterpret_cast<int64_t*>(ptr)) = val;
-    return true;
+    return SetFixedField<::openmldb::type::kBigInt>(buf, index, val);
 }
 
 bool RowBuilder::AppendTimestamp(int64_t val) {
@@ -346,11 +313,7 @@ bool RowBuilder::AppendTimestamp(int64_t val) {
 bool RowBuilder::SetTimestamp(uint32_t index, int64_t val) { return SetTimestamp(buf_, index, val); }
 
 bool RowBuilder::SetTimestamp(int8_t* buf, uint32_t index, int64_t val) {
-    if (!Check(index, ::openmldb::type::kTimestamp)) return false;
-    SetField(buf, index);
-    int8_t* ptr = buf + offset_vec_[index];
-    *(reinterpret_cast<int64_t*>(ptr)) = val;
-    return true;
+    return SetFixedField<::openmldb::type::kTimestamp>(buf, index, val);
 }
 
 bool RowBuilder::AppendFloat(float val) {
@@ -362,11 +325,7 @@ bool RowBuilder::AppendFloat(float val) {
 bool RowBuilder::SetFloat(uint32_t index, float val) { return SetFloat(buf_, index, val); }
 
 bool RowBuilder::SetFloat(int8_t* buf, uint32_t index, float val) {
-    if (!Check(index, ::openmldb::type::kFloat)) return false;
-    SetField(buf, index);
-    int8_t* ptr = buf + offset_vec_[index];
-    *(reinterpret_cast<float*>(ptr)) = val;
-    return true;
+    return SetFixedField<::openmldb::type::kFloat>(buf, index, val);
 }
 
 bool RowBuilder::AppendDouble(double val) {
@@ -378,11 +337,7 @@ bool RowBuilder::AppendDouble(double val) {
 bool RowBuilder::SetDouble(uint32_t index, double val) { return SetDouble(buf_, index, val); }
 
 bool RowBuilder::SetDouble(int8_t* buf, uint32_t index, double val) {
-    if (!Check(index, ::openmldb::type::kDouble)) return false;
-    SetField(buf, index);
-    int8_t* ptr = buf + offset_vec_[index];
-    *(reinterpret_cast<double*>(ptr)) = val;
-    return true;
+    return SetFixedField<::openmldb::type::kDouble>(buf, index, val);
 }
 
 bool RowBuilder::AppendString(const char* val, uint32_t length) {
@@ -392,11 +347,11 @@ bool RowBuilder::AppendString(const char* val, uint32_t length) {
 }
 
 bool RowBuilder::SetString(uint32_t index, const char* val, uint32_t length) {
-    if (val == NULL || (!Check(index, ::openmldb::type::kVarchar) && !Check(index, openmldb::type::kString))) {
+    if (val == NULL || index >= fields_.size() || !IsStringType(fields_[index].type)) {
         return false;
     }
     if (str_offset_ + length > size_) return false;
-    uint32_t str_pos = offset_vec_[index];
+    uint32_t str_pos = fields_[index].offset;
     if (str_pos == 0) {
         SetStrOffset(str_pos);
     }
@@ -410,15 +365,15 @@ bool RowBuilder::SetString(uint32_t index, const char* val, uint32_t length) {
 }
 
 bool RowBuilder::SetString(int8_t* buf, uint32_t size, uint32_t index, const char* val, uint32_t length) {
-    if (val == NULL || (!Check(index, ::openmldb::type::kVarchar) && !Check(index, openmldb::type::kString))) {
+    if (val == NULL || index >= fields_.size() || !IsStringType(fields_[index].type)) {
         return false;
     }
     uint32_t str_offset = 0;
-    uint32_t str_pos = offset_vec_[index];
+    uint32_t str_pos = fields_[index].offset;
     auto str_addr_length = GetAddrLength(size);
     if (str_pos == 0) {
         str_offset = str_field_start_offset_ + str_addr_length * str_field_cnt_;
-        SetStrOffset(buf, size, str_pos, str_offset);
+        SetStrOffset(buf, str_addr_length, str_pos, str_offset);
     } else {
         if (!GetStrOffset(buf, size, str_pos, &str_offset)) {
             return false;
@@ -429,7 +384,7 @@ bool RowBuilder::SetString(int8_t* buf, uint32_t size, uint32_t index, const cha
         memcpy(reinterpret_cast<char*>(buf + str_offset), val, length);
     }
     str_offset += length;
-    SetStrOffset(buf, size, str_pos + 1, str_offset);
+    SetStrOffset(buf, str_addr_length, str_pos + 1, str_offset);
     SetField(buf, index);
     return true;
 }
@@ -503,7 +458,7 @@ RowView::RowView(const Schema& schema)
       size_(0),
       row_(NULL),
       schema_(schema),
-      offset_vec_() {
+      fields_() {
     Init();
 }
 
@@ -515,7 +470,7 @@ RowView::RowView(const Schema& schema, const int8_t* row, uint32_t size)
       size_(size),
       row_(row),
       schema_(schema),
-      offset_vec_() {
+      fields_() {
     if (schema_.size() == 0) {
         is_valid_ = false;
         return;
@@ -530,12 +485,12 @@ bool RowView::Init() {
     for (int idx = 0; idx < schema_.size(); idx++) {
         const ::openmldb::common::ColumnDesc& column = schema_.Get(idx);
         openmldb::type::DataType cur_type = column.data_type();
-        if (cur_type == ::openmldb::type::kVarchar || cur_type == ::openmldb::type::kString) {
-            offset_vec_.push_back(string_field_cnt_);
+        if (IsStringType(cur_type)) {
+            fields_.push_back({cur_type, column.not_null(), string_field_cnt_});
             string_field_cnt_++;
         } else {
             if (cur_type < TYPE_SIZE_ARRAY.size() && cur_type > 0) {
-                offset_vec_.push_back(offset);
+                fields_.push_back({cur_type, column.not_null(), offset});
                 offset += TYPE_SIZE_ARRAY[cur_type];
             } else {
                 is_valid_ = false;
@@ -578,14 +533,7 @@ bool RowView::CheckValid(uint32_t idx, ::openmldb::type::DataType type) const {
     if (row_ == NULL || !is_valid_) {
         return false;
     }
-    if ((int32_t)idx >= schema_.size()) {
-        return false;
-    }
-    const ::openmldb::common::ColumnDesc& column = schema_.Get(idx);
-    if (column.data_type() != type) {
-        return false;
-    }
-    return true;
+    return idx < fields_.size() && fields_[idx].type == type;
 }
 
 int32_t RowView::GetBool(uint32_t idx, bool* val) const {
@@ -598,7 +546,7 @@ int32_t RowView::GetBool(uint32_t idx, bool* val) const {
     if (IsNULL(row_, idx)) {
         return 1;
     }
-    uint32_t offset = offset_vec_.at(idx);
+    uint32_t offset = fields_[idx].offset;
     int8_t v = v1::GetBoolField(row_, offset);
     if (v == 1) {
         *val = true;
@@ -618,7 +566,7 @@ int32_t RowView::GetDate(uint32_t idx, uint32_t* year, uint32_t* month, uint32_t
     if (IsNULL(row_, idx)) {
         return 1;
     }
-    uint32_t offset = offset_vec_.at(idx);
+    uint32_t offset = fields_[idx].offset;
     int32_t date = static_cast<int32_t>(v1::GetInt32Field(row_, offset));
     *day = date & 0x0000000FF;
     date = date >> 8;
@@ -637,7 +585,7 @@ int32_t RowView::GetDate(uint32_t idx, int32_t* val) const {
     if (IsNULL(row_, idx)) {
         return 1;
     }
-    uint32_t offset = offset_vec_.at(idx);
+    uint32_t offset = fields_[idx].offset;
     *val = static_cast<int32_t>(v1::GetInt32Field(row_, offset));
     return 0;
 }
@@ -652,7 +600,7 @@ int32_t RowView::GetInt32(uint32_t idx, int32_t* val) const {
     if (IsNULL(row_, idx)) {
         return 1;
     }
-    uint32_t offset = offset_vec_.at(idx);
+    uint32_t offset = fields_[idx].offset;
     *val = v1::GetInt32Field(row_, offset);
     return 0;
 }
@@ -667,7 +615,7 @@ int32_t RowView::GetTimestamp(uint32_t idx, int64_t* val) const {
     if (IsNULL(row_, idx)) {
         return 1;
     }
-    uint32_t offset = offset_vec_.at(idx);
+    uint32_t offset = fields_[idx].offset;
     *val = v1::GetInt64Field(row_, offset);
     return 0;
 }
@@ -682,7 +630,7 @@ int32_t RowView::GetInt64(uint32_t idx, int64_t* val) const {
     if (IsNULL(row_, idx)) {
         return 1;
     }
-    uint32_t offset = offset_vec_.at(idx);
+    uint32_t offset = fields_[idx].offset;
     *val = v1::GetInt64Field(row_, offset);
     return 0;
 }
@@ -697,7 +645,7 @@ int32_t RowView::GetInt16(uint32_t idx, int16_t* val) const {
     if (IsNULL(row_, idx)) {
         return 1;
     }
-    uint32_t offset = offset_vec_.at(idx);
+    uint32_t offset = fields_[idx].offset;
     *val = v1::GetInt16Field(row_, offset);
     return 0;
 }
@@ -712,7 +660,7 @@ int32_t RowView::GetFloat(uint32_t idx, float* val) const {
     if (IsNULL(row_, idx)) {
         return 1;
     }
-    uint32_t offset = offset_vec_.at(idx);
+    uint32_t offset = fields_[idx].offset;
     *val = v1::GetFloatField(row_, offset);
     return 0;
 }
@@ -727,7 +675,7 @@ int32_t RowView::GetDouble(uint32_t idx, double* val) const {
     if (IsNULL(row_, idx)) {
         return 1;
     }
-    uint32_t offset = offset_vec_.at(idx);
+    uint32_t offset = fields_[idx].offset;
     *val = v1::GetDoubleField(row_, offset);
     return 0;
 }
@@ -761,14 +709,7 @@ int32_t RowView::GetInteger(const int8_t* row, uint32_t idx, ::openmldb::type::D
 }
 
 int32_t RowView::GetValue(const int8_t* row, uint32_t idx, ::openmldb::type::DataType type, void* val) const {
-    if (schema_.size() == 0 || row == NULL) {
-        return -1;
-    }
-    if ((int32_t)idx >= schema_.size()) {
-        return -1;
-    }
-    const ::openmldb::common::ColumnDesc& column = schema_.Get(idx);
-    if (column.data_type() != type) {
+    if (row == NULL || idx >= fields_.size() || fields_[idx].type != type) {
         return -1;
     }
     if (GetSize(row) <= HEADER_LENGTH) {
@@ -777,7 +718,7 @@ int32_t RowView::GetValue(const int8_t* row, uint32_t idx, ::openmldb::type::Dat
     if (IsNULL(row, idx)) {
         return 1;
     }
-    uint32_t offset = offset_vec_.at(idx);
+    uint32_t offset = fields_[idx].offset;
     switch (type) {
         case ::openmldb::type::kBool: {
             int8_t v = v1::GetBoolField(row, offset);
@@ -814,14 +755,7 @@ int32_t RowView::GetValue(const int8_t* row, uint32_t idx, ::openmldb::type::Dat
 }
 
 int32_t RowView::GetValue(const int8_t* row, uint32_t idx, char** val, uint32_t* length) const {
-    if (schema_.size() == 0 || row == NULL || length == NULL) {
-        return -1;
-    }
-    if ((int32_t)idx >= schema_.size()) {
-        return -1;
-    }
-    const ::openmldb::common::ColumnDesc& column = schema_.Get(idx);
-    if (column.data_type() != ::openmldb::type::kVarchar && column.data_type() != ::openmldb::type::kString) {
+    if (row == NULL || length == NULL || idx >= fields_.size() || !IsStringType(fields_[idx].type)) {
         return -1;
     }
     uint32_t size = GetSize(row);
@@ -831,9 +765,9 @@ int32_t RowView::GetValue(const int8_t* row, uint32_t idx, char** val, uint32_t*
     if (IsNULL(row, idx)) {
         return 1;
     }
-    uint32_t field_offset = offset_vec_.at(idx);
+    uint32_t field_offset = fields_[idx].offset;
     uint32_t next_str_field_offset = 0;
-    if (offset_vec_.at(idx) < string_field_cnt_ - 1) {
+    if (field_offset < string_field_cnt_ - 1) {
         next_str_field_offset = field_offset + 1;
     }
     return v1::GetStrField(row, field_offset, next_str_field_offset, str_field_start_offset_, GetAddrLength(size),
@@ -845,15 +779,15 @@ int32_t RowView::GetString(uint32_t idx, char** val, uint32_t* length) const {
         return -1;
     }
 
-    if (!CheckValid(idx, ::openmldb::type::kVarchar) && !CheckValid(idx, openmldb::type::kString)) {
+    if (row_ == NULL || !is_valid_ || idx >= fields_.size() || !IsStringType(fields_[idx].type)) {
         return -1;
     }
     if (IsNULL(row_, idx)) {
         return 1;
     }
-    uint32_t field_offset = offset_vec_.at(idx);
+    uint32_t field_offset = fields_[idx].offset;
     uint32_t next_str_field_offset = 0;
-    if (offset_vec_.at(idx) < string_field_cnt_ - 1) {
+    if (field_offset < string_field_cnt_ - 1) {
         next_str_field_offset = field_offset + 1;
     }
     return v1::GetStrField(row_, field_offset, next_str_field_offset, str_field_start_offset_, str_addr_length_,
@@ -863,13 +797,10 @@ int32_t RowView::GetString(uint32_t idx, char** val, uint32_t* length) const {
 int32_t RowView::GetStrValue(uint32_t idx, std::string* val) const { return GetStrValue(row_, idx, val); }
 
 int32_t RowView::GetStrValue(const int8_t* row, uint32_t idx, std::string* val) const {
-    if (schema_.size() == 0 || row == NULL) {
+    if (row == NULL || idx >= fields_.size()) {
         return -1;
     }
-    if ((int32_t)idx >= schema_.size()) {
-        return -1;
-    }
-    const ::openmldb::common::ColumnDesc& column = schema_.Get(idx);
+    const ::openmldb::type::DataType type = fields_[idx].type;
     if (GetSize(row) <= HEADER_LENGTH) {
         return -1;
     }
@@ -877,7 +808,7 @@ int32_t RowView::GetStrValue(const int8_t* row, uint32_t idx, std::string* val)
         val->assign("null");
         return 1;
     }
-    switch (column.data_type()) {
+    switch (type) {
         case ::openmldb::type::kBool: {
             bool value = false;
             GetValue(row, idx, ::openmldb::type::kBool, &value);
@@ -889,7 +820,7 @@ int32_t RowView::GetStrValue(const int8_t* row, uint32_t idx, std::string* val)
         case ::openmldb::type::kTimestamp:
         case ::openmldb::type::kBigInt: {
             int64_t value = 0;
-            GetInteger(row, idx, column.data_type(), &value);
+            GetInteger(row, idx, type, &value);
             val->assign(std::to_string(value));
             break;
         }
@@ -74,6 +74,19 @@ class RowProject {
     uint32_t cur_ver_;
 };
 
+// FieldLayout is the layout of a column compiled from its ColumnDesc, so that
+// encoding and decoding need not look up the schema for every field
+struct FieldLayout {
+    ::openmldb::type::DataType type;
+    bool not_null;
+    // the offset of a fixed size field, or the index of a string field
+    uint32_t offset;
+};
+
+inline bool IsStringType(::openmldb::type::DataType type) {
+    return type == ::openmldb::type::kVarchar || type == ::openmldb::type::kString;
+}
+
 class RowBuilder {
  public:
     explicit RowBuilder(const Schema& schema);
@@ -124,11 +137,15 @@ class RowBuilder {
     inline uint32_t GetAppendPos() { return cnt_; }
 
  private:
-    bool Check(uint32_t index, ::openmldb::type::DataType type);
+    inline bool Check(uint32_t index, ::openmldb::type::DataType type) const {
+        return index < fields_.size() && fields_[index].type == type;
+    }
+    template <::openmldb::type::DataType TYPE, typename T>
+    inline bool SetFixedField(int8_t* buf, uint32_t index, T val);
     inline void SetField(uint32_t index);
     inline void SetField(int8_t* buf, uint32_t index);
     inline void SetStrOffset(uint32_t str_pos);
-    void SetStrOffset(int8_t* buf, uint32_t size, uint32_t str_pos, uint32_t str_offset);
+    void SetStrOffset(int8_t* buf, uint8_t str_addr_length, uint32_t str_pos, uint32_t str_offset);
     bool GetStrOffset(int8_t* buf, uint32_t size, uint32_t str_pos, uint32_t* offset);
 
  private:
@@ -141,7 +158,7 @@ class RowBuilder {
     uint32_t str_field_start_offset_;
     uint32_t str_offset_;
     uint8_t schema_version_;
-    std::vector<uint32_t> offset_vec_;
+    std::vector<FieldLayout> fields_;
 };
 
 class RowView {
@@ -171,6 +188,11 @@ class RowView {
     }
     inline uint32_t GetSize() const { return size_; }
 
+    // the layout of the strings: the offsets of the string fields start from the start offset
+    inline bool IsValid() const { return is_valid_; }
+    inline uint32_t GetStrFieldCnt() const { return string_field_cnt_; }
+    inline uint32_t GetStrFieldStartOffset() const { return str_field_start_offset_; }
+
     static inline uint32_t GetSize(const int8_t* row) {
         return *(reinterpret_cast<const uint32_t*>(row + VERSION_LENGTH));
     }
@@ -196,7 +218,7 @@ class RowView {
     uint32_t size_;
     const int8_t* row_;
     const Schema& schema_;
-    std::vector<uint32_t> offset_vec_;
+    std::vector<FieldLayout> fields_;
 };
 
 namespace v1 {
@@ -19,6 +19,9 @@
 namespace openmldb {
 namespace codec {
 
+// smaller slices are cheaper to copy than to hold in a user data block
+constexpr size_t ZERO_COPY_MIN_SIZE = 1024;
+
 bool DecodeRpcRow(const butil::IOBuf& buf, size_t offset, size_t size, size_t slice_num, hybridse::codec::Row* row) {
     if (row == nullptr) {
         return false;
@@ -96,6 +99,53 @@ bool EncodeRpcRow(const hybridse::codec::Row& row, butil::IOBuf* buf, size_t* to
     return true;
 }
 
+bool MoveRowSlice(hybridse::codec::Row* row, int32_t pos, butil::IOBuf* buf) {
+    int8_t* slice_buf = row->buf(pos);
+    size_t slice_size = row->size(pos);
+    if (slice_size >= ZERO_COPY_MIN_SIZE) {
+        int8_t* owned_buf = row->ReleaseOwnership(pos);
+        if (owned_buf != nullptr) {
+            // managed slices are malloced by the jit functions
+            if (buf->append_user_data(owned_buf, slice_size, free) != 0) {
+                free(owned_buf);
+                LOG(WARNING) << "Append user data of size " << slice_size << " failed";
+                return false;
+            }
+            return true;
+        }
+    }
+    if (buf->append(slice_buf, slice_size) != 0) {
+        LOG(WARNING) << "Append slice of size " << slice_size << " failed";
+        return false;
+    }
+    return true;
+}
+
+bool MoveRpcRow(hybridse::codec::Row* row, butil::IOBuf* buf, size_t* total_size) {
+    if (buf == nullptr) {
+        return false;
+    }
+    *total_size = 0;
+    size_t slice_num = row->GetRowPtrCnt();
+    for (size_t i = 0; i < slice_num; ++i) {
+        size_t slice_size = row->size(i);
+        if (row->buf(i) == nullptr || slice_size == 0) {
+            char empty_header[6] = {1, 1, 0, 0, 0, 0};
+            if (buf->append(empty_header, 6) != 0) {
+                LOG(WARNING) << "Append " << i << "th slice of size " << slice_size << " failed";
+                return false;
+            }
+            *total_size += 6;
+            continue;
+        }
+        if (!MoveRowSlice(row, i, buf)) {
+            return false;
+        }
+        *total_size += slice_size;
+    }
+    return true;
+}
+
 bool EncodeRpcRow(const int8_t* buf, size_t size, butil::IOBuf* io_buf) {
     int code = io_buf->append(buf, size);
     if (code != 0) {
@@ -37,6 +37,14 @@ bool EncodeRpcRow(const hybridse::codec::Row& row, butil::IOBuf* buf, size_t* to
 
 bool EncodeRpcRow(const int8_t* buf, size_t size, butil::IOBuf* io_buf);
 
+// append slice `pos` of row to buf. a large slice that is owned by row only
+// is handed over to buf as user data instead of being copied, and row should
+// not be read after that
+bool MoveRowSlice(hybridse::codec::Row* row, int32_t pos, butil::IOBuf* buf);
+
+// same as EncodeRpcRow, but moves the slices of row into buf by MoveRowSlice
+bool MoveRpcRow(hybridse::codec::Row* row, butil::IOBuf* buf, size_t* total_size);
+
 }  // namespace codec
 }  // namespace openmldb
 #endif  // SRC_CODEC_SQL_RPC_ROW_CODEC_H_
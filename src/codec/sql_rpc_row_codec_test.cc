@@ -16,6 +16,7 @@
 
 #include "codec/sql_rpc_row_codec.h"
 
+#include <cstring>
 #include <memory>
 #include <string>
 #include <vector>
@@ -123,6 +124,43 @@ TEST_F(SqlRpcRowCodecTest, TestMultiSlice) {
     ASSERT_EQ(0, decoded.size(3));
 }
 
+TEST_F(SqlRpcRowCodecTest, TestMoveRpcRow) {
+    hybridse::codec::Schema schema;
+    InitSchema(&schema);
+    hybridse::codec::RowBuilder builder(schema);
+    std::string large_str(4096, 'a');
+    size_t buf_size = builder.CalTotalLength(large_str.size());
+    int8_t* buf1 = reinterpret_cast<int8_t*>(malloc(buf_size));
+    builder.SetBuffer(buf1, buf_size);
+    builder.AppendInt32(42);
+    builder.AppendFloat(3.14);
+    builder.AppendString(large_str.data(), large_str.size());
+    hybridse::codec::Row row(hybridse::codec::RefCountedSlice::CreateManaged(buf1, buf_size));
+    // a shared slice is copied
+    int8_t* buf2 = reinterpret_cast<int8_t*>(malloc(buf_size));
+    memcpy(buf2, buf1, buf_size);
+    auto shared_slice = hybridse::codec::RefCountedSlice::CreateManaged(buf2, buf_size);
+    row.Append(shared_slice);
+
+    butil::IOBuf iobuf;
+    size_t total_size;
+    ASSERT_TRUE(MoveRpcRow(&row, &iobuf, &total_size));
+    ASSERT_EQ(2 * buf_size, total_size);
+    ASSERT_EQ(2 * buf_size, iobuf.size());
+    // the first slice is handed over to iobuf
+    ASSERT_EQ(nullptr, row.ReleaseOwnership(0));
+    ASSERT_EQ(nullptr, row.ReleaseOwnership(1));
+
+    hybridse::codec::Row decoded;
+    ASSERT_TRUE(DecodeRpcRow(iobuf, 0, total_size, 2, &decoded));
+    hybridse::codec::RowView row_view(schema);
+    for (int i = 0; i < 2; i++) {
+        row_view.Reset(decoded.buf(i), decoded.size(i));
+        ASSERT_EQ(42, row_view.GetInt32Unsafe(0));
+        ASSERT_EQ(large_str, row_view.GetStringUnsafe(2));
+    }
+}
+
 }  // namespace codec
 }  // namespace openmldb
 
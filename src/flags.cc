@@ -30,6 +30,7 @@ DEFINE_string(host, "", "used in stand-alone mode, config the name server ip");
 DEFINE_int32(port, 0, "used in stand-alone mode, config the name server port");
 DEFINE_int32(get_task_status_interval, 2000, "config the interval of get task status");
 DEFINE_uint32(get_table_status_interval, 2000, "config the interval of get table status");
+DEFINE_uint32(get_table_status_timeout, 2000, "config the timeout of get table status from a tablet");
 DEFINE_uint32(get_table_diskused_interval, 600000, "config the interval of get table diskused");
 DEFINE_int32(name_server_task_pool_size, 8, "config the size of name server task pool");
 DEFINE_uint32(name_server_task_concurrency, 2, "config the concurrency of name_server_task");
@@ -47,9 +48,31 @@ DEFINE_uint32(system_table_replica_num, 1, "config the default replica_num of sy
 DEFINE_int32(gc_interval, 120, "the gc interval of tablet every two hour");
 DEFINE_int32(disk_gc_interval, 120, "the rocksdb gc interval of tablet");
 DEFINE_int32(gc_pool_size, 2, "the size of tablet gc thread pool");
+DEFINE_bool(enable_numa, false,
+            "home memory table partitions to numa nodes, with node local rows and gc threads. rows are put in "
+            "1MB chunks which are released only when all of their rows are gone, so a long lived row pins its chunk");
+DEFINE_string(numa_fake_topology, "",
+              "use a fake numa topology, \"<n>\" to split the cpus into n nodes or \"<cpus>;<cpus>...\"");
+DEFINE_double(numa_arena_max_waste_ratio, 0.5,
+              "rows are put with malloc instead of the numa chunks while this part of the live chunks is not used "
+              "by live rows, 0 means no cap");
 DEFINE_int32(gc_safe_offset, 1, "the safe offset of tablet gc in minute");
 DEFINE_uint64(gc_on_table_recover_count, 10000000, "make a gc on recover count");
 DEFINE_uint32(gc_deleted_pk_version_delta, 2, "config the gc version delta");
+DEFINE_bool(gc_use_expire_index, false,
+            "gc absolute ttl by an index of the keys by their oldest ts instead of visiting all keys");
+DEFINE_uint32(gc_expire_bucket_ms, 60000, "the time span of a bucket of the gc expire index");
+DEFINE_uint32(gc_slice_key_cnt, 1000, "the keys visited by the gc by expire index in a slice");
+DEFINE_uint32(gc_slice_interval_us, 0, "the pause between two slices of the gc by expire index");
+DEFINE_uint32(hot_key_sample_rate, 64, "sample one of the accesses to find the hot keys of an index, 0 to disable");
+DEFINE_uint64(segment_split_min_put_cnt, 0,
+              "split the segments of a memory table at gc if a segment gets at least the puts in a round and "
+              "more than twice of its share, 0 to disable");
+DEFINE_uint32(max_seg_cnt, 64, "the max segment count of a memory table split at gc");
+DEFINE_uint32(mem_dict_max_size, 65536, "the max values of the dictionary of a string column of a memory table");
+DEFINE_uint32(mem_freeze_age, 0,
+              "freeze the rows of a memory table older than it in minute into read-only blocks at gc, 0 to disable");
+DEFINE_uint32(mem_freeze_min_cnt, 16, "the min rows of a key frozen at a time");
 DEFINE_double(mem_release_rate, 5, "specify memory release rate, which should be in 0 ~ 10");
 DEFINE_int32(task_pool_size, 3, "the size of tablet task thread pool");
 DEFINE_int32(io_pool_size, 2, "the size of tablet io task thread pool");
@@ -62,6 +85,7 @@ DEFINE_string(bucket_size, "1d", "the default bucket size in pre-aggr table");
 // scan configuration
 DEFINE_uint32(scan_max_bytes_size, 2 * 1024 * 1024, "config the max size of scan bytes size");
 DEFINE_uint32(scan_reserve_size, 1024, "config the size of vec reserve");
+DEFINE_uint32(multi_scan_max_key_cnt, 1000, "the max number of keys in one multi scan request");
 DEFINE_uint32(preview_limit_max_num, 1000, "config the max num of preview limit");
 DEFINE_uint32(preview_default_limit, 100, "config the default limit of preview");
 // binlog configuration
@@ -92,6 +116,9 @@ DEFINE_int32(get_concurrency_limit, 8, "the limit of get concurrency");
 DEFINE_int32(request_max_retry, 3, "max retry time when request error");
 DEFINE_int32(request_timeout_ms, 20000, "request timeout");
 DEFINE_int32(request_sleep_time, 1000, "the sleep time when request error");
+DEFINE_uint32(bulk_load_chunk_rows, 4096, "rows parsed and encoded at a time by load data in bulk_load mode");
+DEFINE_uint32(bulk_load_rpc_size_limit, 32 * 1024 * 1024, "the max size of one BulkLoad request in bulk_load mode");
+DEFINE_uint32(put_rows_max_inflight, 32, "the max number of put requests in flight for one batch of rows put by sdk");
 
 DEFINE_uint32(max_traverse_cnt, 50000, "max traverse iter loop cnt");
 DEFINE_uint32(traverse_cnt_limit, 1000, "limit traverse cnt");
@@ -104,7 +131,11 @@ DEFINE_int32(send_file_max_try, 3, "the max retry time when send file failed");
 DEFINE_int32(retry_send_file_wait_time_ms, 3000, "conf the wait time when retry send file");
 DEFINE_int32(stream_close_wait_time_ms, 1000, "the wait time before close stream");
 DEFINE_uint32(stream_block_size, 1 * 1204 * 1024, "config the write/read block size in streaming");
-DEFINE_int32(stream_bandwidth_limit, 10 * 1204 * 1024, "the limit bandwidth. Byte/Second");
+DEFINE_int32(stream_bandwidth_limit, 10 * 1204 * 1024,
+             "the limit bandwidth shared by all the files sent by the tablet. Byte/Second");
+DEFINE_uint32(send_file_parallelism, 1,
+              "the blocks of a file sent in parallel. if more than 1, files are sent by ranges with a checksum, "
+              "which needs the receivers of the same version");
 
 // if set 23, the task will execute 23:00 every day
 DEFINE_int32(make_snapshot_time, 23, "config the time to make snapshot");
@@ -115,6 +146,9 @@ DEFINE_uint32(make_snapshot_offline_interval, 60 * 60 * 24,
               "config tablet self makesnapshot when how long time do not "
               "makesnapshot from ns. unit is second");
 DEFINE_string(snapshot_compression, "off", "Type of snapshot compression, can be off, snappy, zlib");
+DEFINE_uint32(snapshot_max_delta_cnt, 0,
+              "the max deltas of the binlog made after a memory table snapshot before they are compacted into it, "
+              "0 means every snapshot is a full one");
 DEFINE_int32(snapshot_pool_size, 1, "the size of tablet thread pool for making snapshot");
 
 DEFINE_uint32(load_index_max_wait_time, 120 * 60 * 1000, "config the max wait time of load index");
@@ -148,6 +182,12 @@ DEFINE_bool(verify_compression, false, "For debug");
 DEFINE_uint32(load_table_batch, 30, "set laod table batch size");
 DEFINE_uint32(load_table_thread_num, 3, "set load tabale thread pool size");
 DEFINE_uint32(load_table_queue_size, 1000, "set load tabale queue size");
+DEFINE_uint32(binlog_replay_thread_num, 1,
+              "the number of threads applying binlog on table recover, entries with the same key keep their "
+              "order. only tables with a single index are applied in parallel");
+DEFINE_uint32(load_table_parallelism, 3, "the max number of partitions loading at the same time");
+DEFINE_uint64(load_table_read_bandwidth_limit, 0,
+              "the max bytes per second read from snapshot and binlog by all loading partitions, 0 means unlimited");
 
 // multiple data center
 DEFINE_uint32(get_replica_status_interval, 10000, "config the interval to sync replica cluster status time");
@@ -59,6 +59,7 @@ DECLARE_bool(auto_failover);
 DECLARE_uint32(tablet_heartbeat_timeout);
 DECLARE_uint32(tablet_offline_check_interval);
 DECLARE_uint32(get_table_status_interval);
+DECLARE_uint32(get_table_status_timeout);
 DECLARE_uint32(name_server_task_max_concurrency);
 DECLARE_uint32(check_binlog_sync_progress_delta);
 DECLARE_uint32(name_server_op_execute_timeout);
@@ -2309,6 +2310,9 @@ int NameServerImpl::CreateTableOnTablet(const std::shared_ptr<::openmldb::namese
     table_meta.set_compress_type(compress_type);
     table_meta.set_format_version(table_info->format_version());
     table_meta.set_storage_mode(table_info->storage_mode());
+    table_meta.set_dict_encode(table_info->dict_encode());
+    table_meta.set_cold_age(table_info->cold_age());
+    table_meta.set_cold_storage_mode(table_info->cold_storage_mode());
     if (table_info->has_key_entry_max_height()) {
         table_meta.set_key_entry_max_height(table_info->key_entry_max_height());
     }
@@ -5150,26 +5154,82 @@ void NameServerImpl::UpdateTableStatus() {
             tablet_ptr_map.insert(std::make_pair(kv.first, kv.second));
         }
     }
-    std::unordered_map<std::string, ::openmldb::api::TableStatus> pos_response;
-    pos_response.reserve(16);
+    std::lock_guard<std::mutex> status_lock(table_status_mu_);
+    // poll all tablets at once, a tablet returns the partitions changed since the last poll
+    std::vector<std::pair<std::string, std::shared_ptr<brpc::Controller>>> cntls;
+    std::vector<std::shared_ptr<::openmldb::api::GetTableStatusResponse>> responses;
     for (const auto& kv : tablet_ptr_map) {
-        ::openmldb::api::GetTableStatusResponse tablet_status_response;
-        if (!kv.second->client_->GetTableStatus(tablet_status_response)) {
+        ::openmldb::api::GetTableStatusRequest request;
+        auto cache_iter = table_status_cache_.find(kv.first);
+        if (cache_iter != table_status_cache_.end()) {
+            request.set_status_epoch(cache_iter->second.epoch);
+            request.set_since_version(cache_iter->second.version);
+        } else {
+            request.set_since_version(0);
+        }
+        auto cntl = std::make_shared<brpc::Controller>();
+        cntl->set_timeout_ms(FLAGS_get_table_status_timeout);
+        auto response = std::make_shared<::openmldb::api::GetTableStatusResponse>();
+        auto callback = new ::openmldb::RpcCallback<::openmldb::api::GetTableStatusResponse>(response, cntl);
+        if (!kv.second->client_->GetTableStatus(request, callback)) {
             PDLOG(WARNING, "get table status failed! endpoint[%s]", kv.first.c_str());
+            callback->UnRef();
             continue;
         }
-        for (int pos = 0; pos < tablet_status_response.all_table_status_size(); pos++) {
-            std::string key = std::to_string(tablet_status_response.all_table_status(pos).tid()) + "_" +
-                              std::to_string(tablet_status_response.all_table_status(pos).pid()) + "_" + kv.first;
-            pos_response.insert(std::make_pair(key, tablet_status_response.all_table_status(pos)));
+        cntls.emplace_back(kv.first, cntl);
+        responses.push_back(response);
+    }
+    std::set<std::string> reported;
+    for (size_t i = 0; i < cntls.size(); i++) {
+        const std::string& endpoint = cntls[i].first;
+        brpc::Join(cntls[i].second->call_id());
+        const auto& response = responses[i];
+        if (cntls[i].second->Failed() || response->code() != ::openmldb::base::ReturnCode::kOk) {
+            PDLOG(WARNING, "get table status failed! endpoint[%s] error[%s]", endpoint.c_str(),
+                  cntls[i].second->ErrorText().c_str());
+            continue;
+        }
+        TabletStatusCache& cache = table_status_cache_[endpoint];
+        if (!response->is_delta()) {
+            cache.status.clear();
+        }
+        for (auto& table_status : *response->mutable_all_table_status()) {
+            cache.status[std::make_pair(table_status.tid(), table_status.pid())].Swap(&table_status);
+        }
+        for (const auto& table_status : response->dropped_table_status()) {
+            cache.status.erase(std::make_pair(table_status.tid(), table_status.pid()));
+        }
+        cache.epoch = response->status_epoch();
+        cache.version = response->status_version();
+        reported.insert(endpoint);
+    }
+    // the partitions of the tablets failed to report are not on them
+    for (auto it = table_status_cache_.begin(); it != table_status_cache_.end();) {
+        if (reported.count(it->first) == 0) {
+            it = table_status_cache_.erase(it);
+        } else {
+            ++it;
         }
     }
-    if (pos_response.empty()) {
-        DEBUGLOG("pos_response is empty");
+    if (table_status_cache_.empty()) {
+        DEBUGLOG("table status is empty");
     } else {
-        UpdateTableStatusFun(table_info_, pos_response);
-        for (const auto& kv : db_table_info_) {
-            UpdateTableStatusFun(kv.second, pos_response);
+        std::vector<std::shared_ptr<TableInfo>> table_infos;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            for (const auto& kv : table_info_) {
+                table_infos.push_back(kv.second);
+            }
+            for (const auto& db_kv : db_table_info_) {
+                for (const auto& kv : db_kv.second) {
+                    table_infos.push_back(kv.second);
+                }
+            }
+        }
+        // merge table by table, so ddl and failover are not blocked by the whole merge
+        for (const auto& table_info : table_infos) {
+            std::lock_guard<std::mutex> lock(mu_);
+            UpdateTableStatusFun(table_info);
         }
     }
     if (running_.load(std::memory_order_acquire)) {
@@ -5178,58 +5238,53 @@ void NameServerImpl::UpdateTableStatus() {
     }
 }
 
-void NameServerImpl::UpdateTableStatusFun(
-    const std::map<std::string, std::shared_ptr<TableInfo>>& table_info_map,
-    const std::unordered_map<std::string, ::openmldb::api::TableStatus>& pos_response) {
-    std::lock_guard<std::mutex> lock(mu_);
-    for (const auto& kv : table_info_map) {
-        uint32_t tid = kv.second->tid();
-        std::string first_index_col;
-        if (kv.second->column_key_size() > 0) {
-            first_index_col = kv.second->column_key(0).index_name();
-        }
-        for (int idx = 0; idx < kv.second->table_partition_size(); idx++) {
-            uint32_t pid = kv.second->table_partition(idx).pid();
-            ::openmldb::nameserver::TablePartition* table_partition = kv.second->mutable_table_partition(idx);
-            ::google::protobuf::RepeatedPtrField<::openmldb::nameserver::PartitionMeta>* partition_meta_field =
-                table_partition->mutable_partition_meta();
-            for (int meta_idx = 0; meta_idx < kv.second->table_partition(idx).partition_meta_size(); meta_idx++) {
-                std::string endpoint = kv.second->table_partition(idx).partition_meta(meta_idx).endpoint();
-                bool tablet_has_partition = false;
-                ::openmldb::nameserver::PartitionMeta* partition_meta = partition_meta_field->Mutable(meta_idx);
-                std::string pos_key = std::to_string(tid) + "_" + std::to_string(pid) + "_" + endpoint;
-                auto pos_response_iter = pos_response.find(pos_key);
-                if (pos_response_iter != pos_response.end()) {
-                    const ::openmldb::api::TableStatus& table_status = pos_response_iter->second;
-                    partition_meta->set_offset(table_status.offset());
-                    partition_meta->set_record_byte_size(table_status.record_byte_size() +
-                                                         table_status.record_idx_byte_size());
-                    uint64_t record_cnt = table_status.record_cnt();
-                    if (!first_index_col.empty()) {
-                        for (int pos = 0; pos < table_status.ts_idx_status_size(); pos++) {
-                            if (table_status.ts_idx_status(pos).idx_name() == first_index_col) {
-                                record_cnt = 0;
-                                for (int seg_idx = 0; seg_idx < table_status.ts_idx_status(pos).seg_cnts_size();
-                                     seg_idx++) {
-                                    record_cnt += table_status.ts_idx_status(pos).seg_cnts(seg_idx);
-                                }
-                                break;
-                            }
+void NameServerImpl::UpdateTableStatusFun(const std::shared_ptr<TableInfo>& table_info) {
+    uint32_t tid = table_info->tid();
+    std::string first_index_col;
+    if (table_info->column_key_size() > 0) {
+        first_index_col = table_info->column_key(0).index_name();
+    }
+    for (int idx = 0; idx < table_info->table_partition_size(); idx++) {
+        uint32_t pid = table_info->table_partition(idx).pid();
+        ::openmldb::nameserver::TablePartition* table_partition = table_info->mutable_table_partition(idx);
+        for (int meta_idx = 0; meta_idx < table_partition->partition_meta_size(); meta_idx++) {
+            ::openmldb::nameserver::PartitionMeta* partition_meta = table_partition->mutable_partition_meta(meta_idx);
+            const ::openmldb::api::TableStatus* status = nullptr;
+            auto cache_iter = table_status_cache_.find(partition_meta->endpoint());
+            if (cache_iter != table_status_cache_.end()) {
+                auto status_iter = cache_iter->second.status.find(std::make_pair(tid, pid));
+                if (status_iter != cache_iter->second.status.end()) {
+                    status = &status_iter->second;
+                }
+            }
+            if (status == nullptr) {
+                partition_meta->set_tablet_has_partition(false);
+                continue;
+            }
+            const ::openmldb::api::TableStatus& table_status = *status;
+            partition_meta->set_offset(table_status.offset());
+            partition_meta->set_record_byte_size(table_status.record_byte_size() + table_status.record_idx_byte_size());
+            uint64_t record_cnt = table_status.record_cnt();
+            if (!first_index_col.empty()) {
+                for (int pos = 0; pos < table_status.ts_idx_status_size(); pos++) {
+                    if (table_status.ts_idx_status(pos).idx_name() == first_index_col) {
+                        record_cnt = 0;
+                        for (int seg_idx = 0; seg_idx < table_status.ts_idx_status(pos).seg_cnts_size(); seg_idx++) {
+                            record_cnt += table_status.ts_idx_status(pos).seg_cnts(seg_idx);
                         }
+                        break;
                     }
-                    partition_meta->set_record_cnt(record_cnt);
-                    partition_meta->set_diskused(table_status.diskused());
-                    if (kv.second->table_partition(idx).partition_meta(meta_idx).is_alive() &&
-                        kv.second->table_partition(idx).partition_meta(meta_idx).is_leader()) {
-                        table_partition->set_record_cnt(record_cnt);
-                        table_partition->set_record_byte_size(table_status.record_byte_size() +
-                                                              table_status.record_idx_byte_size());
-                        table_partition->set_diskused(table_status.diskused());
-                    }
-                    tablet_has_partition = true;
                 }
-                partition_meta->set_tablet_has_partition(tablet_has_partition);
             }
+            partition_meta->set_record_cnt(record_cnt);
+            partition_meta->set_diskused(table_status.diskused());
+            if (partition_meta->is_alive() && partition_meta->is_leader()) {
+                table_partition->set_record_cnt(record_cnt);
+                table_partition->set_record_byte_size(table_status.record_byte_size() +
+                                                      table_status.record_idx_byte_size());
+                table_partition->set_diskused(table_status.diskused());
+            }
+            partition_meta->set_tablet_has_partition(true);
         }
     }
 }
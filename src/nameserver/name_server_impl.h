@@ -68,6 +68,14 @@ struct EndpointInfo {
 };
 
 // tablet info
+// the table status reported by a tablet
+struct TabletStatusCache {
+    // the version of the status in the epoch of the tablet
+    uint64_t epoch = 0;
+    uint64_t version = 0;
+    std::map<std::pair<uint32_t, uint32_t>, ::openmldb::api::TableStatus> status;
+};
+
 struct TabletInfo {
     // tablet state
     ::openmldb::type::EndpointState state_;
@@ -739,9 +747,8 @@ class NameServerImpl : public NameServer {
 
     bool SetTableInfo(std::shared_ptr<::openmldb::nameserver::TableInfo> table_info);
 
-    void UpdateTableStatusFun(
-        const std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>>& table_info_map,
-        const std::unordered_map<std::string, ::openmldb::api::TableStatus>& pos_response);
+    // update the partition status of the table from table_status_cache_. mu_ and table_status_mu_ should be locked
+    void UpdateTableStatusFun(const std::shared_ptr<::openmldb::nameserver::TableInfo>& table_info);
 
     void UpdateRealEpMapToTablet(bool check_running);
 
@@ -791,6 +798,9 @@ class NameServerImpl : public NameServer {
  private:
     std::mutex mu_;
     Tablets tablets_;
+    // guard table_status_cache_, which is updated by UpdateTableStatus out of mu_
+    std::mutex table_status_mu_;
+    std::map<std::string, TabletStatusCache> table_status_cache_;
     ::openmldb::nameserver::TableInfos table_info_;
     std::map<std::string, ::openmldb::nameserver::TableInfos> db_table_info_;
     std::map<std::string, std::shared_ptr<::openmldb::nameserver::ClusterInfo>> nsc_;
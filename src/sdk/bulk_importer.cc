@@ -0,0 +1,547 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sdk/bulk_importer.h"
+
+#include <map>
+#include <set>
+#include <utility>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "base/hash.h"
+#include "codec/fe_row_codec.h"
+#include "common/timer.h"
+#include "glog/logging.h"
+#include "sdk/split.h"
+
+namespace openmldb {
+namespace sdk {
+
+// bytes read from the file at a time
+constexpr size_t READ_BLOCK_SIZE = 4 * 1024 * 1024;
+
+CsvChunkReader::CsvChunkReader(const std::string& path, const std::string& delimiter, char quote, bool header,
+                               uint32_t chunk_rows)
+    : path_(path),
+      delimiter_(delimiter),
+      quote_(quote),
+      header_(header),
+      chunk_rows_(chunk_rows == 0 ? 1 : chunk_rows),
+      column_cnt_(0),
+      file_(),
+      eof_(false),
+      buf_(),
+      pos_(0),
+      end_(0),
+      lines_(),
+      unquoted_(),
+      fields_() {}
+
+::openmldb::base::Status CsvChunkReader::Open(const std::vector<std::string>& column_names) {
+    column_cnt_ = column_names.size();
+    file_.open(path_, std::ios::binary);
+    if (!file_.is_open()) {
+        return {::openmldb::base::kSQLCmdRunError, "open file failed"};
+    }
+    if (header_) {
+        size_t offset = 0, size = 0;
+        if (!ReadLine(&offset, &size)) {
+            return {::openmldb::base::kSQLCmdRunError, "read from file failed"};
+        }
+        std::vector<std::string> cols;
+        SplitLineWithDelimiterForStrings(buf_.substr(offset, size), delimiter_, &cols, quote_);
+        if (cols.size() != column_names.size()) {
+            return {::openmldb::base::kSQLCmdRunError, "mismatch column size"};
+        }
+        for (size_t i = 0; i < cols.size(); i++) {
+            if (cols[i] != column_names[i]) {
+                return {::openmldb::base::kSQLCmdRunError, "mismatch column name"};
+            }
+        }
+    }
+    return {};
+}
+
+void CsvChunkReader::Compact() {
+    if (pos_ > 0) {
+        buf_.erase(0, pos_);
+        end_ -= pos_;
+        pos_ = 0;
+    }
+}
+
+bool CsvChunkReader::ReadLine(size_t* offset, size_t* size) {
+    size_t searched = pos_;
+    while (true) {
+        size_t nl = buf_.find('\n', searched);
+        if (nl != std::string::npos && nl < end_) {
+            *offset = pos_;
+            *size = nl - pos_;
+            pos_ = nl + 1;
+            return true;
+        }
+        if (eof_) {
+            if (pos_ == end_) {
+                return false;
+            }
+            // the last line without a line break
+            *offset = pos_;
+            *size = end_ - pos_;
+            pos_ = end_;
+            return true;
+        }
+        searched = end_;
+        buf_.resize(end_ + READ_BLOCK_SIZE);
+        file_.read(&buf_[end_], READ_BLOCK_SIZE);
+        end_ += file_.gcount();
+        buf_.resize(end_);
+        if (!file_) {
+            eof_ = true;
+        }
+    }
+}
+
+bool CsvChunkReader::SplitLine(absl::string_view line, ColumnChunk* chunk) {
+    if (quote_ != '\0' && line.find(quote_) != absl::string_view::npos) {
+        // quoted values are unescaped into strings owned by the chunk
+        fields_.clear();
+        SplitLineWithDelimiterForStrings(std::string(line), delimiter_, &fields_, quote_);
+        if (fields_.size() != column_cnt_) {
+            return false;
+        }
+        for (uint32_t i = 0; i < column_cnt_; i++) {
+            unquoted_.emplace_back(std::move(fields_[i]));
+            chunk->columns[i].emplace_back(unquoted_.back());
+        }
+        return true;
+    }
+    uint32_t i = 0;
+    for (absl::string_view field : absl::StrSplit(line, delimiter_)) {
+        if (i >= column_cnt_) {
+            return false;
+        }
+        chunk->columns[i++].emplace_back(absl::StripAsciiWhitespace(field));
+    }
+    return i == column_cnt_;
+}
+
+::openmldb::base::Status CsvChunkReader::Next(ColumnChunk* chunk) {
+    // the lines of the last chunk are not used any more
+    Compact();
+    unquoted_.clear();
+    chunk->rows = 0;
+    chunk->columns.resize(column_cnt_);
+    for (auto& column : chunk->columns) {
+        column.clear();
+        column.reserve(chunk_rows_);
+    }
+    // buf_ may grow while reading, so the lines are split after all of them are read
+    lines_.clear();
+    size_t offset = 0, size = 0;
+    while (lines_.size() < chunk_rows_ && ReadLine(&offset, &size)) {
+        if (!absl::StripAsciiWhitespace(absl::string_view(buf_.data() + offset, size)).empty()) {
+            lines_.emplace_back(offset, size);
+        }
+    }
+    for (const auto& kv : lines_) {
+        absl::string_view line(buf_.data() + kv.first, kv.second);
+        if (!SplitLine(line, chunk)) {
+            return {::openmldb::base::kSQLCmdRunError, "line [" + std::string(line) + "] mismatch column size"};
+        }
+        chunk->rows++;
+    }
+    return {};
+}
+
+BulkImporter::BulkImporter(std::shared_ptr<::openmldb::nameserver::TableInfo> table_info,
+                           const std::vector<std::shared_ptr<::openmldb::client::TabletClient>>& clients,
+                           const std::string& null_value, uint64_t rpc_size_limit)
+    : table_info_(table_info),
+      clients_(clients),
+      null_value_(null_value),
+      rpc_size_limit_(rpc_size_limit),
+      row_builder_(table_info->column_desc()),
+      index_cols_(),
+      is_index_col_(table_info->column_desc_size(), 0),
+      ts_cols_(),
+      has_auto_gen_ts_(false),
+      builders_(),
+      parsed_(table_info->column_desc_size()),
+      row_buf_(),
+      row_cnt_(0) {}
+
+::openmldb::base::Status BulkImporter::Init() {
+    if (clients_.empty() || clients_.size() != static_cast<size_t>(table_info_->table_partition_size())) {
+        return {::openmldb::base::kSQLCmdRunError, "partition leaders mismatch partition num"};
+    }
+    std::map<std::string, uint32_t> column_name_map;
+    for (int i = 0; i < table_info_->column_desc_size(); i++) {
+        column_name_map.emplace(table_info_->column_desc(i).name(), i);
+    }
+    std::set<uint32_t> ts_cols;
+    for (const auto& column_key : table_info_->column_key()) {
+        std::vector<uint32_t> cols;
+        for (const auto& name : column_key.col_name()) {
+            auto iter = column_name_map.find(name);
+            if (iter == column_name_map.end()) {
+                return {::openmldb::base::kSQLCmdRunError, "index column " + name + " is not exist"};
+            }
+            cols.push_back(iter->second);
+            is_index_col_[iter->second] = 1;
+        }
+        index_cols_.emplace_back(std::move(cols));
+        if (column_key.ts_name().empty()) {
+            has_auto_gen_ts_ = true;
+        } else {
+            auto iter = column_name_map.find(column_key.ts_name());
+            if (iter == column_name_map.end()) {
+                return {::openmldb::base::kSQLCmdRunError, "ts column " + column_key.ts_name() + " is not exist"};
+            }
+            ts_cols.insert(iter->second);
+        }
+    }
+    if (index_cols_.empty()) {
+        return {::openmldb::base::kSQLCmdRunError, "table has no index"};
+    }
+    ts_cols_.assign(ts_cols.begin(), ts_cols.end());
+    for (size_t pid = 0; pid < clients_.size(); pid++) {
+        ::openmldb::api::BulkLoadInfoResponse info;
+        if (!clients_[pid] || !clients_[pid]->GetBulkLoadInfo(table_info_->tid(), pid, &info)) {
+            return {::openmldb::base::kSQLCmdRunError, "fail to get bulk load info of partition " +
+                                                           std::to_string(pid) + ", " + info.msg()};
+        }
+        builders_.emplace_back(new BulkLoadBuilder(table_info_->tid(), pid, info, rpc_size_limit_));
+    }
+    return {};
+}
+
+bool BulkImporter::ParseColumn(uint32_t idx, const std::vector<absl::string_view>& values, ParsedColumn* column,
+                               std::string* msg) {
+    const auto& column_desc = table_info_->column_desc(idx);
+    auto type = column_desc.data_type();
+    size_t rows = values.size();
+    column->is_null.assign(rows, 0);
+    column->ints.resize(rows);
+    column->doubles.resize(rows);
+    for (size_t i = 0; i < rows; i++) {
+        if (values[i] == null_value_) {
+            column->is_null[i] = 1;
+        }
+    }
+    bool ok = true;
+    size_t i = 0;
+    // one type dispatch per column, the loops only parse
+    switch (type) {
+        case ::openmldb::type::kBool:
+            for (; ok && i < rows; i++) {
+                if (column->is_null[i]) continue;
+                if (absl::EqualsIgnoreCase(values[i], "true")) {
+                    column->ints[i] = 1;
+                } else if (absl::EqualsIgnoreCase(values[i], "false")) {
+                    column->ints[i] = 0;
+                } else {
+                    ok = false;
+                }
+            }
+            break;
+        case ::openmldb::type::kSmallInt:
+            for (; ok && i < rows; i++) {
+                int32_t v = 0;
+                if (column->is_null[i]) continue;
+                ok = absl::SimpleAtoi(values[i], &v) && v >= INT16_MIN && v <= INT16_MAX;
+                column->ints[i] = v;
+            }
+            break;
+        case ::openmldb::type::kInt:
+            for (; ok && i < rows; i++) {
+                int32_t v = 0;
+                if (column->is_null[i]) continue;
+                ok = absl::SimpleAtoi(values[i], &v);
+                column->ints[i] = v;
+            }
+            break;
+        case ::openmldb::type::kBigInt:
+        case ::openmldb::type::kTimestamp:
+            for (; ok && i < rows; i++) {
+                if (column->is_null[i]) continue;
+                ok = absl::SimpleAtoi(values[i], &column->ints[i]);
+            }
+            break;
+        case ::openmldb::type::kFloat:
+            for (; ok && i < rows; i++) {
+                float v = 0;
+                if (column->is_null[i]) continue;
+                ok = absl::SimpleAtof(values[i], &v);
+                column->doubles[i] = v;
+            }
+            break;
+        case ::openmldb::type::kDouble:
+            for (; ok && i < rows; i++) {
+                if (column->is_null[i]) continue;
+                ok = absl::SimpleAtod(values[i], &column->doubles[i]);
+            }
+            break;
+        case ::openmldb::type::kDate:
+            for (; ok && i < rows; i++) {
+                if (column->is_null[i]) continue;
+                std::vector<absl::string_view> parts = absl::StrSplit(values[i], '-');
+                int32_t year = 0, month = 0, day = 0;
+                ok = parts.size() == 3 && absl::SimpleAtoi(parts[0], &year) && absl::SimpleAtoi(parts[1], &month) &&
+                     absl::SimpleAtoi(parts[2], &day) && year >= 1900 && year <= 9999 && month >= 1 && month <= 12 &&
+                     day >= 1 && day <= 31;
+                column->ints[i] = ((year - 1900) << 16) | ((month - 1) << 8) | day;
+            }
+            break;
+        case ::openmldb::type::kString:
+        case ::openmldb::type::kVarchar:
+            break;
+        default:
+            *msg = "unsupported data type " + ::openmldb::type::DataType_Name(type);
+            return false;
+    }
+    if (!ok) {
+        *msg = "invalid value [" + std::string(values[i - 1]) + "] of column " + column_desc.name();
+        return false;
+    }
+    if (column_desc.not_null()) {
+        for (i = 0; i < rows; i++) {
+            if (column->is_null[i]) {
+                *msg = "column " + column_desc.name() + " is not null";
+                return false;
+            }
+        }
+    }
+    if (!is_index_col_[idx]) {
+        return true;
+    }
+    // keys are packed the same as SQLInsertRow
+    column->keys.resize(rows);
+    for (i = 0; i < rows; i++) {
+        auto& key = column->keys[i];
+        if (column->is_null[i]) {
+            key = ::hybridse::codec::NONETOKEN;
+            continue;
+        }
+        switch (type) {
+            case ::openmldb::type::kBool:
+                key = column->ints[i] ? "true" : "false";
+                break;
+            case ::openmldb::type::kSmallInt:
+            case ::openmldb::type::kInt:
+            case ::openmldb::type::kBigInt:
+            case ::openmldb::type::kTimestamp:
+            case ::openmldb::type::kDate:
+                key = std::to_string(column->ints[i]);
+                break;
+            case ::openmldb::type::kString:
+            case ::openmldb::type::kVarchar:
+                if (values[i].empty()) {
+                    key = ::hybridse::codec::EMPTY_STRING;
+                } else {
+                    key.assign(values[i].data(), values[i].size());
+                }
+                break;
+            default:
+                key = ::hybridse::codec::NONETOKEN;
+                break;
+        }
+    }
+    return true;
+}
+
+::openmldb::base::Status BulkImporter::EncodeChunk(const ColumnChunk& chunk) {
+    const auto& schema = table_info_->column_desc();
+    uint32_t column_cnt = schema.size();
+    if (chunk.columns.size() != column_cnt) {
+        return {::openmldb::base::kSQLCmdRunError, "mismatch column size"};
+    }
+    std::string msg;
+    for (uint32_t i = 0; i < column_cnt; i++) {
+        if (!ParseColumn(i, chunk.columns[i], &parsed_[i], &msg)) {
+            return {::openmldb::base::kSQLCmdRunError, msg};
+        }
+    }
+    for (auto col : ts_cols_) {
+        for (uint32_t row = 0; row < chunk.rows; row++) {
+            if (parsed_[col].is_null[row]) {
+                return {::openmldb::base::kSQLCmdRunError, "ts column " + schema.Get(col).name() + " is null"};
+            }
+        }
+    }
+    uint32_t pid_num = builders_.size();
+    std::vector<std::vector<std::pair<std::string, uint32_t>>> dimensions(pid_num);
+    std::map<int32_t, uint64_t> ts_map;
+    uint64_t time = ::baidu::common::timer::get_micros() / 1000;
+    for (uint32_t row = 0; row < chunk.rows; row++) {
+        uint32_t str_len = 0;
+        for (uint32_t i = 0; i < column_cnt; i++) {
+            auto type = schema.Get(i).data_type();
+            if ((type == ::openmldb::type::kString || type == ::openmldb::type::kVarchar) && !parsed_[i].is_null[row]) {
+                str_len += chunk.columns[i][row].size();
+            }
+        }
+        uint32_t size = row_builder_.CalTotalLength(str_len);
+        row_buf_.resize(size);
+        row_builder_.SetBuffer(reinterpret_cast<int8_t*>(&row_buf_[0]), size);
+        bool ok = true;
+        for (uint32_t i = 0; ok && i < column_cnt; i++) {
+            const auto& column = parsed_[i];
+            if (column.is_null[row]) {
+                ok = row_builder_.AppendNULL();
+                continue;
+            }
+            switch (schema.Get(i).data_type()) {
+                case ::openmldb::type::kBool:
+                    ok = row_builder_.AppendBool(column.ints[row]);
+                    break;
+                case ::openmldb::type::kSmallInt:
+                    ok = row_builder_.AppendInt16(column.ints[row]);
+                    break;
+                case ::openmldb::type::kInt:
+                    ok = row_builder_.AppendInt32(column.ints[row]);
+                    break;
+                case ::openmldb::type::kBigInt:
+                    ok = row_builder_.AppendInt64(column.ints[row]);
+                    break;
+                case ::openmldb::type::kTimestamp:
+                    ok = row_builder_.AppendTimestamp(column.ints[row]);
+                    break;
+                case ::openmldb::type::kDate:
+                    ok = row_builder_.AppendDate(static_cast<int32_t>(column.ints[row]));
+                    break;
+                case ::openmldb::type::kFloat:
+                    ok = row_builder_.AppendFloat(column.doubles[row]);
+                    break;
+                case ::openmldb::type::kDouble:
+                    ok = row_builder_.AppendDouble(column.doubles[row]);
+                    break;
+                default:
+                    ok = row_builder_.AppendString(chunk.columns[i][row].data(), chunk.columns[i][row].size());
+                    break;
+            }
+        }
+        if (!ok) {
+            return {::openmldb::base::kSQLCmdRunError, "encode row failed"};
+        }
+        for (auto& dims : dimensions) {
+            dims.clear();
+        }
+        for (uint32_t idx = 0; idx < index_cols_.size(); idx++) {
+            std::string key;
+            for (auto col : index_cols_[idx]) {
+                if (!key.empty()) {
+                    key.append("|");
+                }
+                key.append(parsed_[col].keys[row]);
+            }
+            uint32_t pid = static_cast<uint32_t>(::openmldb::base::hash64(key) % pid_num);
+            dimensions[pid].emplace_back(std::move(key), idx);
+        }
+        ts_map.clear();
+        for (auto col : ts_cols_) {
+            ts_map.emplace(col, parsed_[col].ints[row]);
+        }
+        if (has_auto_gen_ts_) {
+            ts_map.emplace(-1, time);
+        }
+        for (uint32_t pid = 0; pid < pid_num; pid++) {
+            if (dimensions[pid].empty()) {
+                continue;
+            }
+            if (!builders_[pid]->AddRow(reinterpret_cast<const int8_t*>(row_buf_.data()), size, dimensions[pid],
+                                        ts_map, time)) {
+                return {::openmldb::base::kSQLCmdRunError, "add row to partition " + std::to_string(pid) + " failed"};
+            }
+            if (builders_[pid]->IsDataRegionFull()) {
+                auto status = SendDataRegion(pid);
+                if (!status.OK()) {
+                    return status;
+                }
+            }
+        }
+    }
+    row_cnt_ += chunk.rows;
+    return {};
+}
+
+::openmldb::base::Status BulkImporter::SendDataRegion(uint32_t pid) {
+    ::openmldb::api::BulkLoadRequest request;
+    butil::IOBuf data;
+    if (!builders_[pid]->BuildDataRegion(&request, &data)) {
+        return {};
+    }
+    std::string msg;
+    if (!clients_[pid]->BulkLoad(request, data, &msg)) {
+        return {::openmldb::base::kSQLCmdRunError,
+                "fail to send data part " + std::to_string(request.part_id()) + " of partition " +
+                    std::to_string(pid) + ", " + msg};
+    }
+    return {};
+}
+
+::openmldb::base::Status BulkImporter::SendIndexRegion(uint32_t pid) {
+    ::openmldb::api::BulkLoadRequest request;
+    butil::IOBuf empty;
+    std::string msg;
+    while (builders_[pid]->BuildIndexRegion(&request)) {
+        if (!clients_[pid]->BulkLoad(request, empty, &msg)) {
+            return {::openmldb::base::kSQLCmdRunError,
+                    "fail to send index part " + std::to_string(request.part_id()) + " of partition " +
+                        std::to_string(pid) + ", " + msg};
+        }
+    }
+    return {};
+}
+
+::openmldb::base::Status BulkImporter::Import(ChunkReader* reader) {
+    ColumnChunk chunk;
+    while (true) {
+        auto status = reader->Next(&chunk);
+        if (!status.OK()) {
+            return status;
+        }
+        if (chunk.rows == 0) {
+            break;
+        }
+        status = EncodeChunk(chunk);
+        if (!status.OK()) {
+            return status;
+        }
+    }
+    for (uint32_t pid = 0; pid < builders_.size(); pid++) {
+        // a partition without rows has no data receiver on the tablet
+        if (builders_[pid]->GetRowCnt() == 0) {
+            continue;
+        }
+        auto status = SendDataRegion(pid);
+        if (!status.OK()) {
+            return status;
+        }
+        status = SendIndexRegion(pid);
+        if (!status.OK()) {
+            return status;
+        }
+        LOG(INFO) << "bulk load " << builders_[pid]->GetRowCnt() << " rows to " << table_info_->name() << " pid "
+                  << pid;
+    }
+    return {};
+}
+
+}  // namespace sdk
+}  // namespace openmldb
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_SDK_BULK_IMPORTER_H_
+#define SRC_SDK_BULK_IMPORTER_H_
+
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "base/status.h"
+#include "client/tablet_client.h"
+#include "codec/codec.h"
+#include "proto/name_server.pb.h"
+#include "sdk/bulk_load_builder.h"
+
+namespace openmldb {
+namespace sdk {
+
+// rows of a chunk in column-major layout. the values point into the buffer of
+// the reader and are valid until the next call of ChunkReader::Next
+struct ColumnChunk {
+    uint32_t rows = 0;
+    std::vector<std::vector<absl::string_view>> columns;
+};
+
+// ChunkReader reads a file in chunks of rows. a columnar format such as
+// parquet can implement it to hand its column chunks over without going
+// through lines
+class ChunkReader {
+ public:
+    virtual ~ChunkReader() {}
+    // chunk->rows is 0 at the end of file
+    virtual ::openmldb::base::Status Next(ColumnChunk* chunk) = 0;
+};
+
+class CsvChunkReader : public ChunkReader {
+ public:
+    CsvChunkReader(const std::string& path, const std::string& delimiter, char quote, bool header,
+                   uint32_t chunk_rows);
+
+    // open the file and check the header against the table columns if there is one
+    ::openmldb::base::Status Open(const std::vector<std::string>& column_names);
+
+    ::openmldb::base::Status Next(ColumnChunk* chunk) override;
+
+ private:
+    // position of the next complete line in buf_, read more of the file into
+    // buf_ if there is none. lines read since the last Compact stay in buf_
+    bool ReadLine(size_t* offset, size_t* size);
+    void Compact();
+    bool SplitLine(absl::string_view line, ColumnChunk* chunk);
+
+    const std::string path_;
+    const std::string delimiter_;
+    const char quote_;
+    const bool header_;
+    const uint32_t chunk_rows_;
+    uint32_t column_cnt_;
+    std::ifstream file_;
+    bool eof_;
+    std::string buf_;
+    // [pos_, end_) is not read yet
+    size_t pos_;
+    size_t end_;
+    // (offset, size) of the lines of the current chunk
+    std::vector<std::pair<size_t, size_t>> lines_;
+    // unquoted fields of the current chunk
+    std::deque<std::string> unquoted_;
+    std::vector<std::string> fields_;
+};
+
+// BulkImporter encodes the chunks of a reader column by column and loads them
+// into a memory table through the BulkLoad rpc of each partition leader,
+// instead of putting rows one by one
+class BulkImporter {
+ public:
+    // `clients` are the leaders indexed by pid
+    BulkImporter(std::shared_ptr<::openmldb::nameserver::TableInfo> table_info,
+                 const std::vector<std::shared_ptr<::openmldb::client::TabletClient>>& clients,
+                 const std::string& null_value, uint64_t rpc_size_limit);
+
+    ::openmldb::base::Status Init();
+
+    ::openmldb::base::Status Import(ChunkReader* reader);
+
+    uint64_t GetRowCnt() const { return row_cnt_; }
+
+ private:
+    // one column of a chunk converted to its type
+    struct ParsedColumn {
+        std::vector<uint8_t> is_null;
+        // bool, smallint, int, bigint, timestamp and encoded date
+        std::vector<int64_t> ints;
+        std::vector<double> doubles;
+        // the key of the column in dimensions, only for index columns
+        std::vector<std::string> keys;
+    };
+
+    bool ParseColumn(uint32_t idx, const std::vector<absl::string_view>& values, ParsedColumn* column,
+                     std::string* msg);
+    ::openmldb::base::Status EncodeChunk(const ColumnChunk& chunk);
+    ::openmldb::base::Status SendDataRegion(uint32_t pid);
+    ::openmldb::base::Status SendIndexRegion(uint32_t pid);
+
+    std::shared_ptr<::openmldb::nameserver::TableInfo> table_info_;
+    std::vector<std::shared_ptr<::openmldb::client::TabletClient>> clients_;
+    const std::string null_value_;
+    const uint64_t rpc_size_limit_;
+    ::openmldb::codec::RowBuilder row_builder_;
+    // column idx of each index
+    std::vector<std::vector<uint32_t>> index_cols_;
+    std::vector<uint8_t> is_index_col_;
+    std::vector<uint32_t> ts_cols_;
+    bool has_auto_gen_ts_;
+    std::vector<std::unique_ptr<BulkLoadBuilder>> builders_;
+    std::vector<ParsedColumn> parsed_;
+    std::string row_buf_;
+    uint64_t row_cnt_;
+};
+
+}  // namespace sdk
+}  // namespace openmldb
+#endif  // SRC_SDK_BULK_IMPORTER_H_
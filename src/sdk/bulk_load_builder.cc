@@ -0,0 +1,237 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sdk/bulk_load_builder.h"
+
+#include "base/hash.h"
+#include "glog/logging.h"
+
+namespace openmldb {
+namespace sdk {
+
+// same seed as MemTable
+constexpr uint32_t SEED = 0xe17a1465;
+// upper bounds of the serialized size of index region messages, the tags,
+// length prefixes and varints included
+constexpr uint64_t TIME_ENTRY_SIZE = 20;
+constexpr uint64_t KEY_ENTRY_SIZE = 12;
+constexpr uint64_t MESSAGE_SIZE = 16;
+
+BulkLoadBuilder::BulkLoadBuilder(uint32_t tid, uint32_t pid, const ::openmldb::api::BulkLoadInfoResponse& info,
+                                 uint64_t rpc_size_limit)
+    : tid_(tid),
+      pid_(pid),
+      rpc_size_limit_(rpc_size_limit),
+      seg_cnt_(info.seg_cnt()),
+      inner_index_pos_(info.inner_index_pos().begin(), info.inner_index_pos().end()),
+      ready_cnt_(),
+      segments_(),
+      next_part_id_(0),
+      next_block_id_(0),
+      data_request_(),
+      data_(),
+      cursor_(),
+      index_started_(false),
+      index_done_(false) {
+    for (const auto& inner_index : info.inner_index()) {
+        uint32_t cnt = 0;
+        for (const auto& index_def : inner_index.index_def()) {
+            if (index_def.is_ready()) {
+                cnt++;
+            }
+        }
+        ready_cnt_.push_back(cnt);
+    }
+    segments_.resize(info.inner_segments_size());
+    for (int i = 0; i < info.inner_segments_size(); i++) {
+        const auto& inner_segments = info.inner_segments(i);
+        segments_[i].resize(inner_segments.segment_size());
+        for (int j = 0; j < inner_segments.segment_size(); j++) {
+            const auto& segment = inner_segments.segment(j);
+            auto& region = segments_[i][j];
+            region.ts_cnt = segment.ts_cnt();
+            for (const auto& kv : segment.ts_idx_map()) {
+                // the auto gen ts column id is UINT32_MAX, which is -1 in ts map
+                region.ts_idx_map.emplace(static_cast<int32_t>(kv.key()), kv.value());
+            }
+        }
+    }
+}
+
+BulkLoadBuilder::KeyEntries* BulkLoadBuilder::GetKeyEntries(SegmentRegion* segment, const std::string& key) {
+    auto iter = segment->key_pos.find(key);
+    if (iter != segment->key_pos.end()) {
+        return &segment->keys[iter->second];
+    }
+    segment->key_pos.emplace(key, segment->keys.size());
+    segment->keys.emplace_back();
+    auto* key_entries = &segment->keys.back();
+    key_entries->key = key;
+    key_entries->entries.resize(segment->ts_cnt);
+    return key_entries;
+}
+
+bool BulkLoadBuilder::AddRow(const int8_t* row, uint32_t size,
+                             const std::vector<std::pair<std::string, uint32_t>>& dimensions,
+                             const std::map<int32_t, uint64_t>& ts_map, uint64_t time) {
+    if (dimensions.empty() || ts_map.empty()) {
+        return false;
+    }
+    if (index_started_) {
+        LOG(WARNING) << tid_ << "-" << pid_ << " can not add rows after building the index region";
+        return false;
+    }
+    // inner index pos to key, same as MemTable::Put
+    std::map<int32_t, const std::string*> inner_index_key_map;
+    for (const auto& dim : dimensions) {
+        if (dim.second >= inner_index_pos_.size() || inner_index_pos_[dim.second] < 0 ||
+            static_cast<uint32_t>(inner_index_pos_[dim.second]) >= segments_.size()) {
+            LOG(WARNING) << tid_ << "-" << pid_ << " invalid dimension idx " << dim.second;
+            return false;
+        }
+        inner_index_key_map.emplace(inner_index_pos_[dim.second], &dim.first);
+    }
+    uint32_t block_id = next_block_id_;
+    uint32_t ref_cnt = 0;
+    for (const auto& kv : inner_index_key_map) {
+        uint32_t ready_cnt = static_cast<uint32_t>(kv.first) < ready_cnt_.size() ? ready_cnt_[kv.first] : 0;
+        if (ready_cnt == 0) {
+            continue;
+        }
+        ref_cnt += ready_cnt;
+        const std::string& key = *kv.second;
+        uint32_t seg_idx = 0;
+        if (seg_cnt_ > 1) {
+            seg_idx = ::openmldb::base::hash(key.data(), key.size(), SEED) % seg_cnt_;
+        }
+        auto& segment = segments_[kv.first][seg_idx];
+        if (segment.ts_cnt == 1) {
+            auto pos = segment.ts_idx_map.empty() ? ts_map.begin() : ts_map.find(segment.ts_idx_map.begin()->first);
+            if (pos != ts_map.end()) {
+                GetKeyEntries(&segment, key)->entries[0].push_back({pos->second, block_id});
+            }
+            continue;
+        }
+        KeyEntries* key_entries = nullptr;
+        for (const auto& ts : ts_map) {
+            auto pos = segment.ts_idx_map.find(ts.first);
+            if (pos == segment.ts_idx_map.end() || pos->second >= segment.ts_cnt) {
+                continue;
+            }
+            if (key_entries == nullptr) {
+                key_entries = GetKeyEntries(&segment, key);
+            }
+            key_entries->entries[pos->second].push_back({ts.second, block_id});
+        }
+    }
+
+    auto* block_info = data_request_.add_block_info();
+    block_info->set_ref_cnt(ref_cnt);
+    block_info->set_offset(data_.size());
+    block_info->set_length(size);
+    auto* binlog_info = data_request_.add_binlog_info();
+    for (const auto& dim : dimensions) {
+        auto* pb_dim = binlog_info->add_dimensions();
+        pb_dim->set_key(dim.first);
+        pb_dim->set_idx(dim.second);
+    }
+    binlog_info->set_time(time);
+    binlog_info->set_block_id(block_id);
+    data_.append(row, size);
+    next_block_id_++;
+    return true;
+}
+
+bool BulkLoadBuilder::BuildDataRegion(::openmldb::api::BulkLoadRequest* request, butil::IOBuf* data) {
+    if (data_request_.block_info_size() == 0) {
+        return false;
+    }
+    request->Clear();
+    request->Swap(&data_request_);
+    request->set_tid(tid_);
+    request->set_pid(pid_);
+    request->set_part_id(next_part_id_++);
+    data->clear();
+    data->swap(data_);
+    return true;
+}
+
+bool BulkLoadBuilder::BuildIndexRegion(::openmldb::api::BulkLoadRequest* request) {
+    if (index_done_) {
+        return false;
+    }
+    index_started_ = true;
+    request->Clear();
+    request->set_tid(tid_);
+    request->set_pid(pid_);
+    request->set_part_id(next_part_id_++);
+    uint64_t size = MESSAGE_SIZE;
+    for (; cursor_.inner < segments_.size(); cursor_.inner++, cursor_.seg = 0) {
+        auto& segments = segments_[cursor_.inner];
+        ::openmldb::api::BulkLoadIndex* index_pb = nullptr;
+        for (; cursor_.seg < segments.size(); cursor_.seg++, cursor_.key = 0) {
+            auto& segment = segments[cursor_.seg];
+            // keys are looked up only while adding rows
+            segment.key_pos.clear();
+            ::openmldb::api::Segment* segment_pb = nullptr;
+            for (; cursor_.key < segment.keys.size(); cursor_.key++, cursor_.entry = 0) {
+                auto& key_entries = segment.keys[cursor_.key];
+                ::openmldb::api::Segment::KeyEntries* key_entries_pb = nullptr;
+                for (; cursor_.entry < key_entries.entries.size(); cursor_.entry++, cursor_.time = 0) {
+                    const auto& times = key_entries.entries[cursor_.entry];
+                    ::openmldb::api::Segment::KeyEntries::KeyEntry* key_entry_pb = nullptr;
+                    for (; cursor_.time < times.size(); cursor_.time++) {
+                        if (size >= rpc_size_limit_) {
+                            return true;
+                        }
+                        if (index_pb == nullptr) {
+                            index_pb = request->add_index_region();
+                            index_pb->set_inner_index_id(cursor_.inner);
+                            size += MESSAGE_SIZE;
+                        }
+                        if (segment_pb == nullptr) {
+                            segment_pb = index_pb->add_segment();
+                            segment_pb->set_id(cursor_.seg);
+                            size += MESSAGE_SIZE;
+                        }
+                        if (key_entries_pb == nullptr) {
+                            key_entries_pb = segment_pb->add_key_entries();
+                            key_entries_pb->set_key(key_entries.key);
+                            size += MESSAGE_SIZE + key_entries.key.size();
+                        }
+                        if (key_entry_pb == nullptr) {
+                            key_entry_pb = key_entries_pb->add_key_entry();
+                            key_entry_pb->set_key_entry_id(cursor_.entry);
+                            size += KEY_ENTRY_SIZE;
+                        }
+                        auto* time_entry_pb = key_entry_pb->add_time_entry();
+                        time_entry_pb->set_time(times[cursor_.time].time);
+                        time_entry_pb->set_block_id(times[cursor_.time].block_id);
+                        size += TIME_ENTRY_SIZE;
+                    }
+                }
+                // the entries of this key are all built
+                std::vector<std::vector<TimeEntry>>().swap(key_entries.entries);
+            }
+        }
+    }
+    request->set_eof(true);
+    index_done_ = true;
+    return true;
+}
+
+}  // namespace sdk
+}  // namespace openmldb
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_SDK_BULK_LOAD_BUILDER_H_
+#define SRC_SDK_BULK_LOAD_BUILDER_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "butil/iobuf.h"
+#include "proto/tablet.pb.h"
+
+namespace openmldb {
+namespace sdk {
+
+// BulkLoadBuilder builds the BulkLoad requests of one partition. Encoded rows go
+// to the data region, which is cut into parts of about `rpc_size_limit` bytes
+// that can be sent as soon as they are full. Index entries are kept until all
+// data parts are sent, then they are cut into index parts the same way.
+// Part ids are continuous from 0, and the last index part has eof set.
+class BulkLoadBuilder {
+ public:
+    BulkLoadBuilder(uint32_t tid, uint32_t pid, const ::openmldb::api::BulkLoadInfoResponse& info,
+                    uint64_t rpc_size_limit);
+
+    // `dimensions` are the (key, index idx) pairs of this partition and `ts_map`
+    // maps ts column id to ts, the same as the arguments of MemTable::Put
+    bool AddRow(const int8_t* row, uint32_t size, const std::vector<std::pair<std::string, uint32_t>>& dimensions,
+                const std::map<int32_t, uint64_t>& ts_map, uint64_t time);
+
+    bool IsDataRegionFull() const { return data_.size() >= rpc_size_limit_; }
+
+    uint64_t GetRowCnt() const { return next_block_id_; }
+
+    // move the pending rows into the next data part, false if there are none
+    bool BuildDataRegion(::openmldb::api::BulkLoadRequest* request, butil::IOBuf* data);
+
+    // build the next index part, false if the eof part has been built. all data
+    // parts must be built before the first index part
+    bool BuildIndexRegion(::openmldb::api::BulkLoadRequest* request);
+
+ private:
+    struct TimeEntry {
+        uint64_t time;
+        uint32_t block_id;
+    };
+
+    struct KeyEntries {
+        std::string key;
+        // indexed by key entry id
+        std::vector<std::vector<TimeEntry>> entries;
+    };
+
+    struct SegmentRegion {
+        uint32_t ts_cnt = 1;
+        std::map<int32_t, uint32_t> ts_idx_map;
+        absl::flat_hash_map<std::string, uint32_t> key_pos;
+        std::vector<KeyEntries> keys;
+    };
+
+    KeyEntries* GetKeyEntries(SegmentRegion* segment, const std::string& key);
+
+    const uint32_t tid_;
+    const uint32_t pid_;
+    const uint64_t rpc_size_limit_;
+    uint32_t seg_cnt_;
+    // dimension idx to inner index pos
+    std::vector<int32_t> inner_index_pos_;
+    // ready index defs of each inner index
+    std::vector<uint32_t> ready_cnt_;
+    // [inner index pos][segment idx]
+    std::vector<std::vector<SegmentRegion>> segments_;
+
+    int32_t next_part_id_;
+    uint32_t next_block_id_;
+    ::openmldb::api::BulkLoadRequest data_request_;
+    butil::IOBuf data_;
+
+    // where the next index part starts
+    struct {
+        uint32_t inner = 0;
+        uint32_t seg = 0;
+        uint32_t key = 0;
+        uint32_t entry = 0;
+        uint32_t time = 0;
+    } cursor_;
+    bool index_started_;
+    bool index_done_;
+};
+
+}  // namespace sdk
+}  // namespace openmldb
+#endif  // SRC_SDK_BULK_LOAD_BUILDER_H_
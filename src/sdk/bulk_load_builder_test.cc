@@ -0,0 +1,151 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sdk/bulk_load_builder.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace sdk {
+
+class BulkLoadBuilderTest : public ::testing::Test {};
+
+// two inner indexes: index 0 with one ts column 2, index 1 with ts column 2 and 3
+static ::openmldb::api::BulkLoadInfoResponse MakeInfo(uint32_t seg_cnt) {
+    ::openmldb::api::BulkLoadInfoResponse info;
+    info.set_seg_cnt(seg_cnt);
+    info.add_inner_index_pos(0);
+    info.add_inner_index_pos(1);
+    info.add_inner_index_pos(1);
+    auto* inner_index = info.add_inner_index();
+    auto* index_def = inner_index->add_index_def();
+    index_def->set_ts_idx(2);
+    index_def->set_is_ready(true);
+    inner_index = info.add_inner_index();
+    for (int ts_idx : {2, 3}) {
+        index_def = inner_index->add_index_def();
+        index_def->set_ts_idx(ts_idx);
+        index_def->set_is_ready(true);
+    }
+    for (int i = 0; i < 2; i++) {
+        auto* inner_segments = info.add_inner_segments();
+        for (uint32_t j = 0; j < seg_cnt; j++) {
+            auto* segment = inner_segments->add_segment();
+            segment->set_ts_cnt(i + 1);
+            for (int k = 0; k <= i; k++) {
+                auto* entry = segment->add_ts_idx_map();
+                entry->set_key(2 + k);
+                entry->set_value(k);
+            }
+        }
+    }
+    return info;
+}
+
+TEST_F(BulkLoadBuilderTest, DataAndIndexRegion) {
+    BulkLoadBuilder builder(1, 0, MakeInfo(1), 64 * 1024 * 1024);
+    std::string row = "row";
+    for (int i = 0; i < 10; i++) {
+        std::vector<std::pair<std::string, uint32_t>> dimensions = {
+            {"k" + std::to_string(i % 2), 0}, {"m" + std::to_string(i % 3), 1}, {"m" + std::to_string(i % 3), 2}};
+        std::map<int32_t, uint64_t> ts_map = {{2, 100 + i}, {3, 200 + i}};
+        ASSERT_TRUE(builder.AddRow(reinterpret_cast<const int8_t*>(row.data()), row.size(), dimensions, ts_map, 0));
+    }
+    ASSERT_EQ(10u, builder.GetRowCnt());
+
+    ::openmldb::api::BulkLoadRequest request;
+    butil::IOBuf data;
+    ASSERT_TRUE(builder.BuildDataRegion(&request, &data));
+    ASSERT_EQ(0, request.part_id());
+    ASSERT_EQ(10, request.block_info_size());
+    ASSERT_EQ(10, request.binlog_info_size());
+    // one ts of index 0 and two of index 1
+    ASSERT_EQ(3u, request.block_info(0).ref_cnt());
+    ASSERT_EQ(3u, request.block_info(1).length());
+    ASSERT_EQ(9u, request.binlog_info(9).block_id());
+    ASSERT_FALSE(builder.BuildDataRegion(&request, &data));
+
+    ASSERT_TRUE(builder.BuildIndexRegion(&request));
+    ASSERT_EQ(1, request.part_id());
+    ASSERT_TRUE(request.eof());
+    ASSERT_EQ(2, request.index_region_size());
+    const auto& index0 = request.index_region(0).segment(0);
+    ASSERT_EQ(2, index0.key_entries_size());
+    ASSERT_EQ(1, index0.key_entries(0).key_entry_size());
+    ASSERT_EQ(5, index0.key_entries(0).key_entry(0).time_entry_size());
+    const auto& index1 = request.index_region(1).segment(0);
+    ASSERT_EQ(3, index1.key_entries_size());
+    ASSERT_EQ(2, index1.key_entries(0).key_entry_size());
+    ASSERT_EQ(1u, index1.key_entries(0).key_entry(1).key_entry_id());
+    ASSERT_EQ(200u, index1.key_entries(0).key_entry(1).time_entry(0).time());
+    ASSERT_FALSE(builder.BuildIndexRegion(&request));
+    // no more rows after the index region is built
+    std::vector<std::pair<std::string, uint32_t>> dimensions = {{"k0", 0}};
+    ASSERT_FALSE(builder.AddRow(reinterpret_cast<const int8_t*>(row.data()), row.size(), dimensions, {{2, 1}}, 0));
+}
+
+TEST_F(BulkLoadBuilderTest, SplitIndexRegion) {
+    BulkLoadBuilder builder(1, 0, MakeInfo(8), 1024);
+    std::string row = "row";
+    const int rows = 1000;
+    for (int i = 0; i < rows; i++) {
+        std::vector<std::pair<std::string, uint32_t>> dimensions = {{"k" + std::to_string(i % 100), 0}};
+        ASSERT_TRUE(builder.AddRow(reinterpret_cast<const int8_t*>(row.data()), row.size(), dimensions,
+                                   {{2, static_cast<uint64_t>(i)}}, 0));
+    }
+    ::openmldb::api::BulkLoadRequest request;
+    butil::IOBuf data;
+    ASSERT_TRUE(builder.BuildDataRegion(&request, &data));
+    int32_t part_id = 1;
+    int time_entries = 0;
+    std::map<uint32_t, int> block_cnt;
+    while (builder.BuildIndexRegion(&request)) {
+        ASSERT_EQ(part_id++, request.part_id());
+        ASSERT_LE(request.ByteSizeLong(), 1024u + 128u);
+        for (const auto& index : request.index_region()) {
+            ASSERT_EQ(0u, index.inner_index_id());
+            for (const auto& segment : index.segment()) {
+                for (const auto& key_entries : segment.key_entries()) {
+                    for (const auto& key_entry : key_entries.key_entry()) {
+                        for (const auto& time_entry : key_entry.time_entry()) {
+                            block_cnt[time_entry.block_id()]++;
+                            time_entries++;
+                        }
+                    }
+                }
+            }
+        }
+        if (request.eof()) {
+            break;
+        }
+    }
+    ASSERT_GT(part_id, 3);
+    ASSERT_EQ(rows, time_entries);
+    ASSERT_EQ(static_cast<size_t>(rows), block_cnt.size());
+}
+
+}  // namespace sdk
+}  // namespace openmldb
+
+int main(int argc, char* argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -145,7 +145,24 @@ class FileOptionsParser {
 
 class ReadFileOptionsParser : public FileOptionsParser {
  public:
-    ReadFileOptionsParser() { quote_ = '\0'; }
+    ReadFileOptionsParser() {
+        quote_ = '\0';
+        check_map_.emplace("load_mode", std::make_pair(CheckLoadMode(), hybridse::node::kVarchar));
+    }
+    const std::string& GetLoadMode() const { return load_mode_; }
+
+ private:
+    // insert: put rows one by one, bulk_load: build the table data in sdk and send it by BulkLoad
+    std::string load_mode_ = "insert";
+    std::function<bool(const hybridse::node::ConstNode* node)> CheckLoadMode() {
+        return [this](const hybridse::node::ConstNode* node) {
+            load_mode_ = node->GetAsString();
+            if (load_mode_ != "insert" && load_mode_ != "bulk_load") {
+                return false;
+            }
+            return true;
+        };
+    }
 };
 
 class WriteFileOptionsParser : public FileOptionsParser {
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gflags/gflags.h>
+
+#include <string>
+#include <vector>
+
+#include "base/file_util.h"
+#include "benchmark/benchmark.h"
+#include "sdk/mini_cluster.h"
+#include "sdk/sql_router.h"
+#include "tablet/tablet_impl.h"
+
+DECLARE_string(db_root_path);
+DECLARE_uint32(binlog_replay_thread_num);
+
+::openmldb::sdk::MiniCluster* mc;
+std::string cluster_root_path;
+
+class MockClosure : public ::google::protobuf::Closure {
+ public:
+    MockClosure() {}
+    ~MockClosure() {}
+    void Run() {}
+};
+
+static bool CopyDir(const std::string& src, const std::string& dst) {
+    if (!::openmldb::base::MkdirRecur(dst + "/")) {
+        return false;
+    }
+    std::vector<std::string> files;
+    if (::openmldb::base::GetFileName(src, files) < 0) {
+        return false;
+    }
+    for (const auto& file : files) {
+        if (!::openmldb::base::CopyFile(file, dst + "/" + ::openmldb::base::ParseFileNameFromPath(file))) {
+            return false;
+        }
+    }
+    std::vector<std::string> sub_dirs;
+    ::openmldb::base::GetSubDir(src, sub_dirs);
+    for (const auto& dir : sub_dirs) {
+        if (!CopyDir(src + "/" + dir, dst + "/" + dir)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// write `rows` rows into a single partition table without snapshot, all of
+// them are replayed from binlog on load. return the tid
+static uint32_t PrepareTable(::openmldb::sdk::SQLRouter* router, const std::string& db, const std::string& name,
+                             int64_t rows) {
+    hybridse::sdk::Status status;
+    router->ExecuteSQL("create database if not exists " + db + ";", &status);
+    router->ExecuteSQL(db, "drop table if exists " + name + ";", &status);
+    router->ExecuteSQL(db,
+                       "create table " + name +
+                           " (c1 string, c2 string, c3 bigint, c4 timestamp, index(key=c1, ts=c4), "
+                           "index(key=c2, ts=c4)) options(partitionnum=1, replicanum=1);",
+                       &status);
+    if (!status.IsOK()) {
+        return 0;
+    }
+    const int64_t batch = 100;
+    for (int64_t i = 0; i < rows; i += batch) {
+        std::string sql = "insert into " + name + " values ";
+        for (int64_t j = i; j < i + batch && j < rows; j++) {
+            if (j != i) {
+                sql.append(",");
+            }
+            sql.append("('k" + std::to_string(j % 1000) + "', 'm" + std::to_string(j % 37) + "', " +
+                       std::to_string(j) + ", " + std::to_string(1590738989000 + j) + ")");
+        }
+        router->ExecuteInsert(db, sql, &status);
+        if (!status.IsOK()) {
+            return 0;
+        }
+    }
+    return router->GetTableInfo(db, name).tid();
+}
+
+// time from LoadTable to the partition being normal on a fresh tablet, which is
+// what a follower promoted on failover or a restarted tablet goes through
+static void BM_FailoverLoadTable(benchmark::State& state) {  // NOLINT
+    ::openmldb::sdk::SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc->GetZkCluster();
+    sql_opt.zk_path = mc->GetZkPath();
+    auto router = NewClusterSQLRouter(sql_opt);
+    if (router == nullptr) {
+        state.SkipWithError("fail to init sql cluster router");
+        return;
+    }
+    std::string name = "t_failover_" + std::to_string(state.range(0));
+    uint32_t tid = PrepareTable(router.get(), "failover_bm", name, state.range(0));
+    if (tid == 0) {
+        state.SkipWithError("fail to prepare table");
+        return;
+    }
+    // let the binlog be flushed
+    sleep(2);
+    std::string partition = std::to_string(tid) + "_0";
+    std::string load_root_path = cluster_root_path + "_failover";
+    FLAGS_binlog_replay_thread_num = state.range(1);
+    for (auto _ : state) {
+        state.PauseTiming();
+        ::openmldb::base::RemoveDirRecursive(load_root_path);
+        if (!CopyDir(cluster_root_path + "/" + partition, load_root_path + "/" + partition)) {
+            state.SkipWithError("fail to copy partition data");
+            break;
+        }
+        FLAGS_db_root_path = load_root_path;
+        auto tablet = new ::openmldb::tablet::TabletImpl();
+        tablet->Init("");
+        MockClosure closure;
+        ::openmldb::api::LoadTableRequest request;
+        ::openmldb::api::TableMeta* table_meta = request.mutable_table_meta();
+        table_meta->set_name(name);
+        table_meta->set_tid(tid);
+        table_meta->set_pid(0);
+        table_meta->set_storage_mode(::openmldb::common::kMemory);
+        ::openmldb::api::GeneralResponse response;
+        state.ResumeTiming();
+
+        tablet->LoadTable(NULL, &request, &response, &closure);
+        while (response.code() == 0) {
+            ::openmldb::api::GetTableStatusRequest status_request;
+            status_request.set_tid(tid);
+            status_request.set_pid(0);
+            ::openmldb::api::GetTableStatusResponse status_response;
+            tablet->GetTableStatus(NULL, &status_request, &status_response, &closure);
+            if (status_response.all_table_status_size() > 0 &&
+                status_response.all_table_status(0).state() == ::openmldb::api::TableState::kTableNormal) {
+                break;
+            }
+            usleep(1000);
+        }
+
+        state.PauseTiming();
+        delete tablet;
+        FLAGS_db_root_path = cluster_root_path;
+        state.ResumeTiming();
+    }
+    FLAGS_binlog_replay_thread_num = 1;
+    ::openmldb::base::RemoveDirRecursive(load_root_path);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    hybridse::sdk::Status status;
+    router->ExecuteSQL("failover_bm", "drop table " + name + ";", &status);
+}
+
+BENCHMARK(BM_FailoverLoadTable)
+    ->Unit(benchmark::kMillisecond)
+    ->ArgNames({"rows", "replay_threads"})
+    ->Args({100000, 1})
+    ->Args({100000, 4})
+    ->Args({100000, 8})
+    ->Args({1000000, 1})
+    ->Args({1000000, 4})
+    ->Args({1000000, 8});
+
+int main(int argc, char** argv) {
+    ::hybridse::vm::Engine::InitializeGlobalLLVM();
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    ::openmldb::sdk::MiniCluster mini_cluster(6181);
+    mc = &mini_cluster;
+    mini_cluster.SetUp(1);
+    cluster_root_path = FLAGS_db_root_path;
+    sleep(2);
+    ::benchmark::RunSpecifiedBenchmarks();
+    mini_cluster.Close();
+}
@@ -17,6 +17,7 @@
 #include "sdk/sql_cluster_router.h"
 
 #include <algorithm>
+#include <deque>
 #include <fstream>
 #include <memory>
 #include <string>
@@ -43,12 +44,16 @@
 #include "sdk/base.h"
 #include "sdk/base_impl.h"
 #include "sdk/batch_request_result_set_sql.h"
+#include "sdk/bulk_importer.h"
 #include "sdk/file_option_parser.h"
 #include "sdk/node_adapter.h"
 #include "sdk/result_set_sql.h"
 #include "sdk/split.h"
 
 DECLARE_int32(request_timeout_ms);
+DECLARE_uint32(bulk_load_chunk_rows);
+DECLARE_uint32(bulk_load_rpc_size_limit);
+DECLARE_uint32(put_rows_max_inflight);
 DECLARE_string(bucket_size);
 DEFINE_string(spark_conf, "", "The config file of Spark job");
 DECLARE_uint32(replica_num);
@@ -1237,6 +1242,120 @@ bool SQLClusterRouter::ExecuteInsert(const std::string& db, const std::string& s
     }
 }
 
+std::shared_ptr<SQLInsertRows> SQLClusterRouter::GetTableInsertRows(const std::string& db, const std::string& table,
+                                                                    ::hybridse::sdk::Status* status) {
+    if (status == nullptr) {
+        return {};
+    }
+    auto table_info = cluster_sdk_->GetTableInfo(db, table);
+    if (!table_info) {
+        status->code = 1;
+        status->msg = "table " + table + " does not exist in db " + db;
+        return {};
+    }
+    std::shared_ptr<SQLCache> cache;
+    {
+        std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
+        auto& table_cache = table_insert_cache_[db];
+        auto it = table_cache.find(table);
+        if (it != table_cache.end() && it->second->table_info == table_info) {
+            cache = it->second;
+        }
+    }
+    if (!cache) {
+        // all columns are given, so there is no default value
+        cache = std::make_shared<SQLCache>(table_info, std::make_shared<DefaultValueMap::element_type>(), 0);
+        std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
+        table_insert_cache_[db][table] = cache;
+    }
+    status->code = 0;
+    return std::make_shared<SQLInsertRows>(cache->table_info, cache->column_schema, cache->default_map,
+                                           cache->str_length);
+}
+
+bool SQLClusterRouter::PutRows(const std::string& db, std::shared_ptr<SQLInsertRows> rows,
+                               ::hybridse::sdk::Status* status) {
+    if (!rows || !status) {
+        LOG(WARNING) << "input is invalid";
+        return false;
+    }
+    auto table_info = rows->GetTableInfo();
+    std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> tablets;
+    bool ret = cluster_sdk_->GetTablet(db, table_info->name(), &tablets);
+    if (!ret || tablets.empty()) {
+        status->msg = "fail to get table " + table_info->name() + " tablet";
+        return false;
+    }
+    // group the puts by partition, the puts to one partition are sent one after another so they arrive in order
+    std::vector<std::vector<std::pair<SQLInsertRow*, const std::vector<std::pair<std::string, uint32_t>>*>>>
+        partition_puts(tablets.size());
+    for (uint32_t i = 0; i < rows->GetCnt(); ++i) {
+        auto row = rows->GetRow(i).get();
+        for (const auto& kv : row->GetDimensions()) {
+            if (kv.first >= tablets.size() || !tablets[kv.first] || !tablets[kv.first]->GetClient()) {
+                status->msg = "fail to get tablet client. pid " + std::to_string(kv.first);
+                LOG(WARNING) << status->msg;
+                return false;
+            }
+            partition_puts[kv.first].emplace_back(row, &kv.second);
+        }
+    }
+    std::deque<uint32_t> pending_pids;
+    for (uint32_t pid = 0; pid < partition_puts.size(); ++pid) {
+        if (!partition_puts[pid].empty()) {
+            pending_pids.push_back(pid);
+        }
+    }
+    std::vector<uint32_t> next_put(partition_puts.size(), 0);
+    uint32_t max_inflight = std::max(FLAGS_put_rows_max_inflight, 1u);
+    uint64_t cur_ts = ::baidu::common::timer::get_micros() / 1000;
+    std::vector<std::pair<uint32_t, openmldb::RpcCallback<openmldb::api::PutResponse>*>> callbacks;
+    bool ok = true;
+    // every round sends the next put of at most max_inflight partitions, partitions left are served first next round
+    while (ok && !pending_pids.empty()) {
+        callbacks.clear();
+        while (!pending_pids.empty() && callbacks.size() < max_inflight) {
+            uint32_t pid = pending_pids.front();
+            pending_pids.pop_front();
+            const auto& put = partition_puts[pid][next_put[pid]];
+            auto callback = new openmldb::RpcCallback<openmldb::api::PutResponse>(
+                std::make_shared<openmldb::api::PutResponse>(), std::make_shared<brpc::Controller>());
+            // one ref for waiting, the other is released when the rpc is done
+            callback->Ref();
+            if (!tablets[pid]->GetClient()->AsyncPut(table_info->tid(), pid, cur_ts, put.first->GetRow(),
+                                                     *put.second, 1, callback)) {
+                callback->UnRef();
+                callback->UnRef();
+                status->msg = "fail to make a put request to table. tid " + std::to_string(table_info->tid());
+                ok = false;
+                break;
+            }
+            callbacks.emplace_back(pid, callback);
+        }
+        // wait for all the sent puts even if some failed
+        for (const auto& kv : callbacks) {
+            auto callback = kv.second;
+            brpc::Join(callback->GetController()->call_id());
+            if (ok && (callback->GetController()->Failed() || callback->GetResponse()->code() != 0)) {
+                status->msg = "fail to make a put request to table. tid " + std::to_string(table_info->tid()) +
+                              ", " +
+                              (callback->GetController()->Failed() ? callback->GetController()->ErrorText()
+                                                                   : callback->GetResponse()->msg());
+                ok = false;
+            }
+            callback->UnRef();
+            if (++next_put[kv.first] < partition_puts[kv.first].size()) {
+                pending_pids.push_back(kv.first);
+            }
+        }
+    }
+    if (!ok) {
+        status->code = 1;
+        LOG(WARNING) << status->msg;
+    }
+    return ok;
+}
+
 bool SQLClusterRouter::ExecuteInsert(const std::string& db, const std::string& sql, std::shared_ptr<SQLInsertRow> row,
                                      hybridse::sdk::Status* status) {
     if (!row || !status) {
@@ -2683,6 +2802,9 @@ hybridse::sdk::Status SQLClusterRouter::HandleLoadDataInfile(
     if (!st.OK()) {
         return {::hybridse::common::StatusCode::kCmdError, st.msg};
     }
+    if (options_parse.GetLoadMode() == "bulk_load") {
+        return HandleBulkLoad(database, table, file_path, options_parse);
+    }
     /*std::cout << "Load " << file_path << " to " << real_db << "-" << table << ", options: delimiter ["
               << options_parse.GetDelimiter() << "], has header[" << (options_parse.GetHeader() ? "true" : "false")
               << "], null_value[" << options_parse.GetNullValue() << "], format[" << options_parse.GetFormat()
@@ -2750,6 +2872,49 @@ hybridse::sdk::Status SQLClusterRouter::HandleLoadDataInfile(
     return {0, "Load " + std::to_string(i) + " rows"};
 }
 
+hybridse::sdk::Status SQLClusterRouter::HandleBulkLoad(const std::string& database, const std::string& table,
+                                                       const std::string& file_path,
+                                                       const openmldb::sdk::ReadFileOptionsParser& options) {
+    auto table_info = cluster_sdk_->GetTableInfo(database, table);
+    if (!table_info) {
+        return {::hybridse::common::StatusCode::kCmdError, "table is not exist"};
+    }
+    if (table_info->storage_mode() != ::openmldb::common::kMemory) {
+        return {::hybridse::common::StatusCode::kCmdError, "bulk_load only supports memory table"};
+    }
+    if (options.GetFormat() != "csv") {
+        return {::hybridse::common::StatusCode::kCmdError, "bulk_load only supports csv format"};
+    }
+    std::vector<std::shared_ptr<::openmldb::client::TabletClient>> clients;
+    for (int pid = 0; pid < table_info->table_partition_size(); pid++) {
+        auto tablet = cluster_sdk_->GetTablet(database, table, pid);
+        if (!tablet || !tablet->GetClient()) {
+            return {::hybridse::common::StatusCode::kCmdError, "fail to get the leader of partition " +
+                                                                   std::to_string(pid)};
+        }
+        clients.push_back(tablet->GetClient());
+    }
+    std::vector<std::string> column_names;
+    for (const auto& column_desc : table_info->column_desc()) {
+        column_names.push_back(column_desc.name());
+    }
+    openmldb::sdk::CsvChunkReader reader(file_path, options.GetDelimiter(), options.GetQuote(), options.GetHeader(),
+                                         FLAGS_bulk_load_chunk_rows);
+    auto st = reader.Open(column_names);
+    if (!st.OK()) {
+        return {::hybridse::common::StatusCode::kCmdError, st.msg};
+    }
+    openmldb::sdk::BulkImporter importer(table_info, clients, options.GetNullValue(), FLAGS_bulk_load_rpc_size_limit);
+    st = importer.Init();
+    if (st.OK()) {
+        st = importer.Import(&reader);
+    }
+    if (!st.OK()) {
+        return {::hybridse::common::StatusCode::kCmdError, st.msg};
+    }
+    return {0, "Load " + std::to_string(importer.GetRowCnt()) + " rows"};
+}
+
 hybridse::sdk::Status SQLClusterRouter::InsertOneRow(const std::string& database, const std::string& insert_placeholder,
                                                      const std::vector<int>& str_col_idx, const std::string& null_value,
                                                      const std::vector<std::string>& cols) {
@@ -38,6 +38,8 @@
 namespace openmldb {
 namespace sdk {
 
+class ReadFileOptionsParser;
+
 typedef ::google::protobuf::RepeatedPtrField<::openmldb::common::ColumnDesc> PBSchema;
 
 constexpr const char* FORMAT_STRING_KEY = "!%$FORMAT_STRING_KEY";
@@ -153,6 +155,11 @@ class SQLClusterRouter : public SQLRouter {
     std::shared_ptr<SQLInsertRows> GetInsertRows(const std::string& db, const std::string& sql,
                                                  ::hybridse::sdk::Status* status) override;
 
+    std::shared_ptr<SQLInsertRows> GetTableInsertRows(const std::string& db, const std::string& table,
+                                                      ::hybridse::sdk::Status* status) override;
+
+    bool PutRows(const std::string& db, std::shared_ptr<SQLInsertRows> rows, ::hybridse::sdk::Status* status) override;
+
     std::shared_ptr<hybridse::sdk::ResultSet> ExecuteSQLRequest(const std::string& db, const std::string& sql,
                                                                 std::shared_ptr<SQLRequestRow> row,
                                                                 hybridse::sdk::Status* status) override;
@@ -348,6 +355,10 @@ class SQLClusterRouter : public SQLRouter {
             const std::string& table, const std::string& file_path,
             const std::shared_ptr<hybridse::node::OptionsMap>& options);
 
+    // load the file by BulkLoad of the partition leaders instead of inserting rows one by one
+    hybridse::sdk::Status HandleBulkLoad(const std::string& database, const std::string& table,
+            const std::string& file_path, const openmldb::sdk::ReadFileOptionsParser& options);
+
     hybridse::sdk::Status InsertOneRow(const std::string& database,
             const std::string& insert_placeholder, const std::vector<int>& str_col_idx,
             const std::string& null_value, const std::vector<std::string>& cols);
@@ -401,6 +412,8 @@ class SQLClusterRouter : public SQLRouter {
     std::map<std::string,
              std::map<hybridse::vm::EngineMode,
                       base::lru_cache<std::string, std::shared_ptr<SQLCache>>>> input_lru_cache_;
+    // db -> table -> cache of all columns, used by GetTableInsertRows
+    std::map<std::string, std::map<std::string, std::shared_ptr<SQLCache>>> table_insert_cache_;
     ::openmldb::base::SpinMutex mu_;
     ::openmldb::base::Random rand_;
 };
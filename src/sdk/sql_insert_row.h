@@ -130,6 +130,7 @@ class SQLInsertRows {
         return rows_[i];
     }
     inline const std::shared_ptr<hybridse::sdk::Schema> GetSchema() { return schema_; }
+    inline const std::shared_ptr<::openmldb::nameserver::TableInfo> GetTableInfo() { return table_info_; }
     const std::vector<uint32_t> GetHoleIdx() {
         std::vector<uint32_t> result;
         for (uint32_t i = 0; i < (int64_t)schema_->GetColumnCnt(); ++i) {
@@ -115,6 +115,16 @@ class SQLRouter {
     virtual std::shared_ptr<openmldb::sdk::SQLInsertRows> GetInsertRows(const std::string& db, const std::string& sql,
                                                                         ::hybridse::sdk::Status* status) = 0;
 
+    /// Get empty rows of all columns of `table`, built from the cached table schema without any insert sql
+    virtual std::shared_ptr<openmldb::sdk::SQLInsertRows> GetTableInsertRows(const std::string& db,
+                                                                             const std::string& table,
+                                                                             ::hybridse::sdk::Status* status) = 0;
+
+    /// Put the rows to their partitions. partitions are put in parallel and the rows of one partition in order,
+    /// with at most put_rows_max_inflight puts in flight
+    virtual bool PutRows(const std::string& db, std::shared_ptr<openmldb::sdk::SQLInsertRows> rows,
+                         ::hybridse::sdk::Status* status) = 0;
+
     virtual std::shared_ptr<hybridse::sdk::ResultSet> ExecuteSQLRequest(
         const std::string& db, const std::string& sql, std::shared_ptr<openmldb::sdk::SQLRequestRow> row,
         hybridse::sdk::Status* status) = 0;
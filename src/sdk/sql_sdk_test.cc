@@ -19,6 +19,7 @@
 #include <sched.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -718,6 +719,66 @@ TEST_F(SQLSDKTest, TableReaderAsyncScan) {
     ASSERT_EQ(1609212669000l, rs->GetInt64Unsafe(1));
     ASSERT_FALSE(rs->Next());
 }
+
+TEST_F(SQLSDKTest, TableReaderMultiScan) {
+    SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc_->GetZkCluster();
+    sql_opt.zk_path = mc_->GetZkPath();
+    auto router = NewClusterSQLRouter(sql_opt);
+    ASSERT_TRUE(router != nullptr);
+    SetOnlineMode(router);
+    std::string db = GenRand("db");
+    ::hybridse::sdk::Status status;
+    ASSERT_TRUE(router->CreateDB(db, &status));
+    std::string ddl =
+        "create table test0 ("
+        "col1 string, col2 bigint, col3 int,"
+        "index(key=col1, ts=col2)) options(partitionnum=4);";
+    ASSERT_TRUE(router->ExecuteDDL(db, ddl, &status));
+    ASSERT_TRUE(router->RefreshCatalog());
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j <= i; j++) {
+            std::string insert = "insert into test0 values('key" + std::to_string(i) + "', " +
+                                 std::to_string(1609212669000l + j) + "L, " + std::to_string(j) + ");";
+            ASSERT_TRUE(router->ExecuteInsert(db, insert, &status));
+        }
+    }
+    auto table_reader = router->GetTableReader();
+    std::vector<ScanKey> keys;
+    for (int i = 9; i >= 0; i--) {
+        ScanKey key;
+        key.key = "key" + std::to_string(i);
+        key.st = 1609212679000l;
+        key.limit = i % 2 == 0 ? 2 : 0;
+        keys.push_back(key);
+    }
+    ScanKey not_exist;
+    not_exist.key = "not_exist";
+    keys.push_back(not_exist);
+    auto result = table_reader->MultiScan(db, "test0", keys, {"col2", "col3"}, 1000, &status);
+    ASSERT_TRUE(status.IsOK()) << status.msg;
+    ASSERT_EQ(keys.size(), result.size());
+    for (int i = 0; i < 10; i++) {
+        int key_idx = 9 - i;
+        auto& rs = result[i];
+        ASSERT_TRUE(rs);
+        ASSERT_EQ(2, rs->GetSchema()->GetColumnCnt());
+        int expect_cnt = key_idx % 2 == 0 ? std::min(2, key_idx + 1) : key_idx + 1;
+        ASSERT_EQ(expect_cnt, rs->Size());
+        for (int j = key_idx; j > key_idx - expect_cnt; j--) {
+            ASSERT_TRUE(rs->Next());
+            ASSERT_EQ(1609212669000l + j, rs->GetInt64Unsafe(0));
+            ASSERT_EQ(j, rs->GetInt32Unsafe(1));
+        }
+        ASSERT_FALSE(rs->Next());
+    }
+    ASSERT_TRUE(result[10]);
+    ASSERT_EQ(0, result[10]->Size());
+
+    result = table_reader->MultiScan(db, "test0", keys, {"col4"}, 1000, &status);
+    ASSERT_FALSE(status.IsOK());
+    ASSERT_TRUE(result.empty());
+}
 TEST_F(SQLSDKTest, CreateTable) {
     SQLRouterOptions sql_opt;
     sql_opt.zk_cluster = mc_->GetZkCluster();
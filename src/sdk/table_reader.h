@@ -33,6 +33,15 @@ struct ScanOption {
     std::vector<std::string> projection;
 };
 
+struct ScanKey {
+    std::string key;
+    int64_t st = 0;
+    int64_t et = 0;
+    std::string idx_name;
+    uint32_t limit = 0;
+    uint32_t at_least = 0;
+};
+
 class ScanFuture {
  public:
     ScanFuture() {}
@@ -55,6 +64,13 @@ class TableReader {
                                                                  const std::string& key, int64_t st, int64_t et,
                                                                  const ScanOption& so, int64_t timeout_ms,
                                                                  hybridse::sdk::Status* status) = 0;
+
+    // scan many keys with one request per partition. the result sets are in the order of `keys`,
+    // and nothing is returned if any of the scans fails. the keys of a partition are limited by
+    // multi_scan_max_key_cnt of the tablets, and their rows share the limit of scan_max_bytes_size
+    virtual std::vector<std::shared_ptr<hybridse::sdk::ResultSet>> MultiScan(
+        const std::string& db, const std::string& table, const std::vector<ScanKey>& keys,
+        const std::vector<std::string>& projection, int64_t timeout_ms, hybridse::sdk::Status* status) = 0;
 };
 
 }  // namespace sdk
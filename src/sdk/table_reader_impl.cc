@@ -16,13 +16,16 @@
 
 #include "sdk/table_reader_impl.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/hash.h"
 #include "brpc/channel.h"
 #include "client/tablet_client.h"
 #include "proto/tablet.pb.h"
+#include "schema/schema_adapter.h"
 #include "sdk/result_set_sql.h"
 
 namespace openmldb {
@@ -203,5 +206,137 @@ std::shared_ptr<hybridse::sdk::ResultSet> TableReaderImpl::Scan(const std::strin
     return rs;
 }
 
+std::vector<std::shared_ptr<hybridse::sdk::ResultSet>> TableReaderImpl::MultiScan(
+    const std::string& db, const std::string& table, const std::vector<ScanKey>& keys,
+    const std::vector<std::string>& projection, int64_t timeout_ms, ::hybridse::sdk::Status* status) {
+    std::vector<std::shared_ptr<hybridse::sdk::ResultSet>> result;
+    if (status == nullptr) {
+        return result;
+    }
+    auto table_handler = cluster_sdk_->GetCatalog()->GetTable(db, table);
+    if (!table_handler) {
+        status->code = -1;
+        status->msg = "fail to get table " + table + " desc from catalog";
+        LOG(WARNING) << status->msg;
+        return result;
+    }
+    auto sdk_table_handler = dynamic_cast<::openmldb::catalog::SDKTableHandler*>(table_handler.get());
+    ::google::protobuf::RepeatedField<uint32_t> col_idxs;
+    for (const auto& col : projection) {
+        int32_t col_idx = sdk_table_handler->GetColumnIndex(col);
+        if (col_idx < 0) {
+            status->code = -1;
+            status->msg = "fail to get col " + col + " from table " + table;
+            LOG(WARNING) << status->msg;
+            return result;
+        }
+        col_idxs.Add(static_cast<uint32_t>(col_idx));
+    }
+    ::hybridse::vm::Schema schema;
+    if (col_idxs.empty()) {
+        schema = *(sdk_table_handler->GetSchema());
+    } else if (!::openmldb::schema::SchemaAdapter::SubSchema(sdk_table_handler->GetSchema(), col_idxs, &schema)) {
+        status->code = -1;
+        status->msg = "fail to get sub schema";
+        return result;
+    }
+    uint32_t pid_num = std::max(sdk_table_handler->GetPartitionNum(), 1u);
+    std::vector<::openmldb::api::MultiScanRequest> requests(pid_num);
+    // the position in `keys` of each scan in the requests
+    std::vector<std::vector<size_t>> key_pos(pid_num);
+    for (size_t i = 0; i < keys.size(); i++) {
+        const auto& key = keys[i];
+        uint32_t pid = ::openmldb::base::hash64(key.key) % pid_num;
+        auto scan = requests[pid].add_scans();
+        scan->set_pk(key.key);
+        scan->set_st(key.st);
+        scan->set_et(key.et);
+        if (!key.idx_name.empty()) {
+            scan->set_idx_name(key.idx_name);
+        }
+        if (key.limit > 0) {
+            scan->set_limit(key.limit);
+        }
+        if (key.at_least > 0) {
+            scan->set_atleast(key.at_least);
+        }
+        *scan->mutable_projection() = col_idxs;
+        key_pos[pid].push_back(i);
+    }
+    std::vector<std::pair<uint32_t, openmldb::RpcCallback<openmldb::api::MultiScanResponse>*>> callbacks;
+    bool ok = true;
+    for (uint32_t pid = 0; pid < pid_num; pid++) {
+        if (key_pos[pid].empty()) {
+            continue;
+        }
+        auto accessor = sdk_table_handler->GetTablet(pid);
+        if (!accessor || !accessor->GetClient()) {
+            status->msg = "fail to get tablet for db " + db + " table " + table;
+            ok = false;
+            break;
+        }
+        auto cntl = std::make_shared<brpc::Controller>();
+        cntl->set_timeout_ms(timeout_ms);
+        auto callback = new openmldb::RpcCallback<openmldb::api::MultiScanResponse>(
+            std::make_shared<openmldb::api::MultiScanResponse>(), cntl);
+        // one ref for waiting, the other is released when the rpc is done
+        callback->Ref();
+        requests[pid].set_tid(sdk_table_handler->GetTid());
+        requests[pid].set_pid(pid);
+        if (!accessor->GetClient()->AsyncMultiScan(requests[pid], callback)) {
+            callback->UnRef();
+            callback->UnRef();
+            status->msg = "fail to send the multi scan request of table " + table;
+            ok = false;
+            break;
+        }
+        callbacks.emplace_back(pid, callback);
+    }
+    if (ok) {
+        result.resize(keys.size());
+    }
+    // wait for all the sent requests even if some failed
+    for (const auto& kv : callbacks) {
+        auto callback = kv.second;
+        brpc::Join(callback->GetController()->call_id());
+        const auto& response = callback->GetResponse();
+        if (ok && callback->GetController()->Failed()) {
+            status->msg = "request error, " + callback->GetController()->ErrorText();
+            ok = false;
+        } else if (ok && response->code() != ::openmldb::base::kOk) {
+            status->msg = "request error, " + response->msg();
+            ok = false;
+        } else if (ok && (response->count_size() != static_cast<int>(key_pos[kv.first].size()) ||
+                          response->buf_size_size() != response->count_size())) {
+            status->msg = "request error, mismatched scan count in response";
+            ok = false;
+        }
+        if (ok) {
+            // the rows of every key are cut from the attachment without copy
+            butil::IOBuf& buf = callback->GetController()->response_attachment();
+            for (int j = 0; j < response->count_size(); j++) {
+                auto io_buf = std::make_shared<butil::IOBuf>();
+                buf.cutn(io_buf.get(), response->buf_size(j));
+                auto rs = std::make_shared<ResultSetSQL>(schema, response->count(j), io_buf);
+                if (!rs->Init()) {
+                    status->msg = "request error, ResultSetSQL init failed";
+                    ok = false;
+                    break;
+                }
+                result[key_pos[kv.first][j]] = rs;
+            }
+        }
+        callback->UnRef();
+    }
+    if (!ok) {
+        status->code = -1;
+        LOG(WARNING) << status->msg;
+        result.clear();
+        return result;
+    }
+    *status = {};
+    return result;
+}
+
 }  // namespace sdk
 }  // namespace openmldb
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "sdk/db_sdk.h"
 #include "sdk/table_reader.h"
@@ -41,6 +42,12 @@ class TableReaderImpl : public TableReader {
                                                          const ScanOption& so, int64_t timeout_ms,
                                                          ::hybridse::sdk::Status* status);
 
+    std::vector<std::shared_ptr<hybridse::sdk::ResultSet>> MultiScan(const std::string& db, const std::string& table,
+                                                                      const std::vector<ScanKey>& keys,
+                                                                      const std::vector<std::string>& projection,
+                                                                      int64_t timeout_ms,
+                                                                      ::hybridse::sdk::Status* status) override;
+
  private:
     DBSDK* cluster_sdk_;
 };
@@ -16,6 +16,7 @@
 
 #include "statistics/query_response_time/deploy_query_response_time.h"
 #include <memory>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
@@ -44,14 +45,28 @@ void DeployResponseTimeRowReducer::Reduce(const std::string &dp_name, TIME time,
     }
 }
 
+static std::atomic<uint64_t> next_collector_id{1};
+
+thread_local DeployQueryTimeCollector::LocalCache DeployQueryTimeCollector::local_cache_;
+
+DeployQueryTimeCollector::DeployQueryTimeCollector()
+    : id_(next_collector_id.fetch_add(1, std::memory_order_relaxed)), version_(0) {}
+
 absl::Status DeployQueryTimeCollector::Collect(const std::string& deploy_name, absl::Duration time) {
-    absl::ReaderMutexLock lock(&mutex_);
-    auto it = collectors_.find(deploy_name);
-    if (it == collectors_.end()) {
+    auto& cache = local_cache_;
+    if (cache.id != id_ || cache.version != version_.load(std::memory_order_acquire)) {
+        absl::ReaderMutexLock lock(&mutex_);
+        cache.collectors = collectors_;
+        cache.id = id_;
+        cache.version = version_.load(std::memory_order_relaxed);
+    }
+    auto it = cache.collectors.find(deploy_name);
+    if (it == cache.collectors.end()) {
         return absl::NotFoundError(absl::StrCat("deploy name ", deploy_name, " not found"));
     }
 
-    it->second->Collect(time);
+    it->second->time_collector.Collect(time);
+    it->second->histogram.Record(time);
     return absl::OkStatus();
 }
 
@@ -60,7 +75,8 @@ absl::Status DeployQueryTimeCollector::AddDeploy(const std::string& deploy_name)
     if (collectors_.find(deploy_name) != collectors_.end()) {
         return absl::AlreadyExistsError(absl::StrCat("deploy name ", deploy_name, " already exists"));
     }
-    collectors_.emplace(deploy_name, std::make_shared<TimeCollector>());
+    collectors_.emplace(deploy_name, std::make_shared<DeployCollector>());
+    version_.fetch_add(1, std::memory_order_release);
     return absl::OkStatus();
 }
 
@@ -72,6 +88,7 @@ absl::Status DeployQueryTimeCollector::DeleteDeploy(const std::string& deploy_na
     }
 
     collectors_.erase(it);
+    version_.fetch_add(1, std::memory_order_release);
     return absl::OkStatus();
 }
 
@@ -84,9 +101,9 @@ absl::StatusOr<std::vector<DeployResponseTimeRow>> DeployQueryTimeCollector::Get
     }
 
     std::vector<DeployResponseTimeRow> rows;
-    rows.reserve(it->second->BucketCount());
-    for (auto idx = 0u; idx < it->second->BucketCount(); ++idx) {
-        auto row = it->second->GetRow(idx);
+    rows.reserve(it->second->time_collector.BucketCount());
+    for (auto idx = 0u; idx < it->second->time_collector.BucketCount(); ++idx) {
+        auto row = it->second->time_collector.GetRow(idx);
         rows.emplace_back(it->first, row->time_, row->count_, row->total_);
     }
     return rows;
@@ -97,8 +114,8 @@ std::vector<DeployResponseTimeRow> DeployQueryTimeCollector::GetRows() const {
     std::vector<DeployResponseTimeRow> rows;
     rows.reserve(GetRecordsCnt());
     for (auto& kv : collectors_) {
-        for (auto idx = 0u; idx < kv.second->BucketCount(); ++idx) {
-            auto row = kv.second->GetRow(idx);
+        for (auto idx = 0u; idx < kv.second->time_collector.BucketCount(); ++idx) {
+            auto row = kv.second->time_collector.GetRow(idx);
             rows.emplace_back(kv.first, row->time_, row->count_, row->total_);
         }
     }
@@ -111,7 +128,7 @@ std::vector<DeployResponseTimeRow> DeployQueryTimeCollector::Flush() {
     std::vector<DeployResponseTimeRow> rows;
     rows.reserve(GetRecordsCnt());
     for (auto& kv : collectors_) {
-        auto rs = kv.second->Flush();
+        auto rs = kv.second->time_collector.Flush();
         for (auto& r : rs) {
             rows.emplace_back(kv.first, r.time_, r.count_, r.total_);
         }
@@ -120,10 +137,70 @@ std::vector<DeployResponseTimeRow> DeployQueryTimeCollector::Flush() {
     return rows;
 }
 
+static DeployLatencyRow ToLatencyRow(const std::string& deploy_name, const LatencySnapshot& snapshot) {
+    DeployLatencyRow row;
+    row.deploy_name = deploy_name;
+    row.count = snapshot.count;
+    row.p50 = snapshot.Percentile(0.5);
+    row.p90 = snapshot.Percentile(0.9);
+    row.p99 = snapshot.Percentile(0.99);
+    row.p999 = snapshot.Percentile(0.999);
+    row.max = snapshot.max;
+    return row;
+}
+
+std::vector<DeployLatencyRow> DeployQueryTimeCollector::FlushLatencies() {
+    // the writer lock serializes the flushes, which update the flushed snapshots
+    absl::WriterMutexLock lock(&mutex_);
+    std::vector<DeployLatencyRow> rows;
+    rows.reserve(collectors_.size());
+    for (auto& kv : collectors_) {
+        auto snapshot = kv.second->histogram.Snapshot();
+        auto delta = snapshot;
+        delta.Subtract(kv.second->flushed);
+        kv.second->flushed = std::move(snapshot);
+        rows.push_back(ToLatencyRow(kv.first, delta));
+    }
+    return rows;
+}
+
+std::string DeployQueryTimeCollector::ExportPrometheus() const {
+    std::vector<std::pair<std::string, LatencySnapshot>> snapshots;
+    {
+        absl::ReaderMutexLock lock(&mutex_);
+        snapshots.reserve(collectors_.size());
+        for (auto& kv : collectors_) {
+            snapshots.emplace_back(kv.first, kv.second->histogram.Snapshot());
+        }
+    }
+    std::string out;
+    absl::StrAppend(&out, "# HELP openmldb_deploy_latency_seconds the response time of deployments\n",
+                    "# TYPE openmldb_deploy_latency_seconds summary\n");
+    for (auto& kv : snapshots) {
+        auto row = ToLatencyRow(kv.first, kv.second);
+        std::pair<const char*, uint64_t> quantiles[] = {
+            {"0.5", row.p50}, {"0.9", row.p90}, {"0.99", row.p99}, {"0.999", row.p999}};
+        for (auto& q : quantiles) {
+            absl::StrAppend(&out, "openmldb_deploy_latency_seconds{deploy=\"", kv.first, "\",quantile=\"", q.first,
+                            "\"} ", q.second / 1e9, "\n");
+        }
+        absl::StrAppend(&out, "openmldb_deploy_latency_seconds_sum{deploy=\"", kv.first, "\"} ",
+                        kv.second.sum / 1e9, "\n", "openmldb_deploy_latency_seconds_count{deploy=\"", kv.first,
+                        "\"} ", row.count, "\n");
+    }
+    absl::StrAppend(&out, "# HELP openmldb_deploy_latency_max_seconds the max response time of deployments\n",
+                    "# TYPE openmldb_deploy_latency_max_seconds gauge\n");
+    for (auto& kv : snapshots) {
+        absl::StrAppend(&out, "openmldb_deploy_latency_max_seconds{deploy=\"", kv.first, "\"} ",
+                        kv.second.max / 1e9, "\n");
+    }
+    return out;
+}
+
 uint32_t DeployQueryTimeCollector::GetRecordsCnt() const {
     uint32_t cnt = 0;
     for (auto& kv : collectors_) {
-        cnt += kv.second->BucketCount();
+        cnt += kv.second->time_collector.BucketCount();
     }
     return cnt;
 }
@@ -17,6 +17,7 @@
 #ifndef SRC_STATISTICS_QUERY_RESPONSE_TIME_DEPLOY_QUERY_RESPONSE_TIME_H_
 #define SRC_STATISTICS_QUERY_RESPONSE_TIME_DEPLOY_QUERY_RESPONSE_TIME_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -28,6 +29,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
+#include "statistics/query_response_time/latency_histogram.h"
 #include "statistics/query_response_time/query_response_time.h"
 
 namespace openmldb {
@@ -46,6 +48,17 @@ inline bool operator==(const DeployResponseTimeRow& lhs, const DeployResponseTim
            lhs.count_ == rhs.count_;
 }
 
+// latency percentiles of a deployment, in nanoseconds
+struct DeployLatencyRow {
+    std::string deploy_name;
+    uint64_t count = 0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+    uint64_t max = 0;
+};
+
 // helper class to merge different list of deploy response rows into united one
 // that is, after reduce, the output rows will have each row with unique key combine: (deploy_name_ + time)
 class DeployResponseTimeRowReducer {
@@ -74,9 +87,12 @@ class DeployResponseTimeRowReducer {
     std::map<std::string, std::map<TIME, std::shared_ptr<DeployResponseTimeRow>>> cache_;
 };
 
+// DeployQueryTimeCollector collects the response time of deployments. Collect looks up the
+// deployment in a copy of the deployments cached by the calling thread, which is refreshed
+// only after a deployment is added or deleted, so recording takes no lock
 class DeployQueryTimeCollector {
  public:
-    DeployQueryTimeCollector() {}
+    DeployQueryTimeCollector();
     // collector is not copyable
     DeployQueryTimeCollector(const DeployQueryTimeCollector& c) = delete;
 
@@ -95,11 +111,37 @@ class DeployQueryTimeCollector {
 
     std::vector<DeployResponseTimeRow> GetRows() const LOCKS_EXCLUDED(mutex_);
 
+    /// \brief the latency percentiles of each deployment since the last call
+    std::vector<DeployLatencyRow> FlushLatencies() LOCKS_EXCLUDED(mutex_);
+
+    /// \brief the latency percentiles of each deployment since it is added, in the prometheus text format
+    std::string ExportPrometheus() const LOCKS_EXCLUDED(mutex_);
+
  private:
+    struct DeployCollector {
+        TimeCollector time_collector;
+        LatencyHistogram histogram;
+        // the histogram at the last FlushLatencies
+        LatencySnapshot flushed;
+    };
+    using Collectors = std::unordered_map<std::string, std::shared_ptr<DeployCollector>>;
+
+    // the deployments cached by a thread for the collector with `id` at `version`
+    struct LocalCache {
+        uint64_t id = 0;
+        uint64_t version = 0;
+        Collectors collectors;
+    };
+
     uint32_t GetRecordsCnt() const SHARED_LOCKS_REQUIRED(mutex_);
 
  private:
-    std::unordered_map<std::string, std::shared_ptr<TimeCollector>> collectors_ GUARDED_BY(mutex_);
+    static thread_local LocalCache local_cache_;
+
+    const uint64_t id_;
+    // bumped when a deployment is added or deleted
+    std::atomic<uint64_t> version_;
+    Collectors collectors_ GUARDED_BY(mutex_);
     mutable absl::Mutex mutex_;  // protects collectors_
 };
 
@@ -288,6 +288,64 @@ TEST_F(DeployTimeCollectorTest, FlushTest) {
     ExpectRowsEq(helper_, dp2, ts2, v2);
 }
 
+TEST_F(DeployTimeCollectorTest, Latencies) {
+    DeployQueryTimeCollector col;
+    ASSERT_TRUE(col.AddDeploy("db.dp1").ok());
+    ASSERT_TRUE(col.AddDeploy("db.dp2").ok());
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&col]() {
+            for (int v = 1; v <= 1000; v++) {
+                ASSERT_TRUE(col.Collect("db.dp1", absl::Microseconds(v)).ok());
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    ASSERT_TRUE(col.Collect("db.dp2", absl::Milliseconds(2)).ok());
+
+    auto rows = col.FlushLatencies();
+    ASSERT_EQ(2u, rows.size());
+    for (auto& row : rows) {
+        if (row.deploy_name == "db.dp1") {
+            ASSERT_EQ(4000u, row.count);
+            ASSERT_GE(row.p50, 500000u);
+            ASSERT_LE(row.p50, 500000u * 17 / 16);
+            ASSERT_GE(row.p99, 990000u);
+            ASSERT_EQ(1000000u, row.max);
+        } else {
+            ASSERT_EQ("db.dp2", row.deploy_name);
+            ASSERT_EQ(1u, row.count);
+            ASSERT_EQ(2000000u, row.p50);
+            ASSERT_EQ(2000000u, row.max);
+        }
+    }
+    // only the latencies after the last flush
+    ASSERT_TRUE(col.Collect("db.dp2", absl::Microseconds(30)).ok());
+    rows = col.FlushLatencies();
+    for (auto& row : rows) {
+        ASSERT_EQ(row.deploy_name == "db.dp1" ? 0u : 1u, row.count);
+        if (row.deploy_name == "db.dp2") {
+            ASSERT_LT(row.p999, 32000u);
+        }
+    }
+
+    // the exported summary is cumulative
+    auto text = col.ExportPrometheus();
+    ASSERT_NE(std::string::npos, text.find("# TYPE openmldb_deploy_latency_seconds summary"));
+    ASSERT_NE(std::string::npos, text.find("openmldb_deploy_latency_seconds_count{deploy=\"db.dp1\"} 4000\n"));
+    ASSERT_NE(std::string::npos, text.find("openmldb_deploy_latency_seconds_count{deploy=\"db.dp2\"} 2\n"));
+    ASSERT_NE(std::string::npos, text.find("openmldb_deploy_latency_max_seconds{deploy=\"db.dp2\"} 0.002\n"));
+    ASSERT_NE(std::string::npos, text.find("openmldb_deploy_latency_seconds{deploy=\"db.dp1\",quantile=\"0.99\"}"));
+
+    // a deleted deployment is not found by the threads that cached it
+    ASSERT_TRUE(col.DeleteDeploy("db.dp2").ok());
+    ASSERT_TRUE(absl::IsNotFound(col.Collect("db.dp2", absl::Microseconds(1))));
+    ASSERT_TRUE(col.AddDeploy("db.dp2").ok());
+    ASSERT_TRUE(col.Collect("db.dp2", absl::Microseconds(1)).ok());
+}
+
 }  // namespace statistics
 }  // namespace openmldb
 
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2022 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "statistics/query_response_time/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace openmldb {
+namespace statistics {
+
+static uint32_t LocalShard() {
+    static std::atomic<uint32_t> next_shard{0};
+    thread_local uint32_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % LatencyHistogram::kShardCnt;
+    return shard;
+}
+
+uint32_t LatencyHistogram::BucketIdx(uint64_t ns) {
+    if (ns < kSubBucketCnt) {
+        return ns;
+    }
+    uint32_t bits = 63 - __builtin_clzll(ns);
+    if (bits >= kMaxBits) {
+        return kBucketCnt - 1;
+    }
+    uint32_t shift = bits - kSubBucketBits;
+    return (shift + 1) * kSubBucketCnt + ((ns >> shift) & (kSubBucketCnt - 1));
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(uint32_t idx) {
+    if (idx < kSubBucketCnt) {
+        return idx;
+    }
+    uint32_t shift = idx / kSubBucketCnt - 1;
+    uint64_t lower = static_cast<uint64_t>(kSubBucketCnt + idx % kSubBucketCnt) << shift;
+    return lower + (1ull << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t ns) {
+    auto& shard = shards_[LocalShard()];
+    shard.buckets[BucketIdx(ns)].fetch_add(1, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t max = shard.max.load(std::memory_order_relaxed);
+    while (ns > max && !shard.max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::Record(absl::Duration time) {
+    Record(static_cast<uint64_t>(std::max<int64_t>(absl::ToInt64Nanoseconds(time), 0)));
+}
+
+LatencySnapshot LatencyHistogram::Snapshot() const {
+    LatencySnapshot snapshot;
+    snapshot.buckets.assign(kBucketCnt, 0);
+    for (uint32_t i = 0; i < kShardCnt; i++) {
+        const auto& shard = shards_[i];
+        for (uint32_t idx = 0; idx < kBucketCnt; idx++) {
+            snapshot.buckets[idx] += shard.buckets[idx].load(std::memory_order_relaxed);
+        }
+        snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+        snapshot.max = std::max(snapshot.max, shard.max.load(std::memory_order_relaxed));
+    }
+    // the count of the buckets, which may be ahead of the shard counts while recording
+    for (uint64_t cnt : snapshot.buckets) {
+        snapshot.count += cnt;
+    }
+    return snapshot;
+}
+
+uint64_t LatencySnapshot::Percentile(double q) const {
+    if (count == 0 || buckets.empty()) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(q * count));
+    rank = std::min(std::max<uint64_t>(rank, 1), count);
+    uint64_t seen = 0;
+    for (uint32_t idx = 0; idx < buckets.size(); idx++) {
+        seen += buckets[idx];
+        if (seen >= rank) {
+            return std::min(LatencyHistogram::BucketUpperBound(idx), max);
+        }
+    }
+    return max;
+}
+
+void LatencySnapshot::Subtract(const LatencySnapshot& prev) {
+    if (prev.buckets.size() != buckets.size()) {
+        return;
+    }
+    count = 0;
+    uint64_t top = 0;
+    for (uint32_t idx = 0; idx < buckets.size(); idx++) {
+        buckets[idx] -= std::min(buckets[idx], prev.buckets[idx]);
+        count += buckets[idx];
+        if (buckets[idx] > 0) {
+            top = LatencyHistogram::BucketUpperBound(idx);
+        }
+    }
+    sum -= std::min(sum, prev.sum);
+    max = std::min(max, top);
+}
+
+}  // namespace statistics
+}  // namespace openmldb
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2022 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_STATISTICS_QUERY_RESPONSE_TIME_LATENCY_HISTOGRAM_H_
+#define SRC_STATISTICS_QUERY_RESPONSE_TIME_LATENCY_HISTOGRAM_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/time/time.h"
+
+namespace openmldb {
+namespace statistics {
+
+// merged counters of a LatencyHistogram, values are in nanoseconds
+struct LatencySnapshot {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    std::vector<uint64_t> buckets;
+
+    // the upper bound of the bucket holding the `q` quantile, no larger than max. 0 if empty
+    uint64_t Percentile(double q) const;
+
+    // keep the values recorded after `prev`, an earlier snapshot of the same histogram.
+    // max becomes the upper bound of the largest bucket left
+    void Subtract(const LatencySnapshot& prev);
+};
+
+// LatencyHistogram records latencies into log-linear buckets like HdrHistogram. values
+// below 2^kSubBucketBits ns have buckets of their own, and each power of two above is split
+// into 2^kSubBucketBits buckets, so a percentile is off by less than 1/2^kSubBucketBits.
+// every thread records into one of the shards with relaxed atomic adds, and the shards
+// are merged on read
+class LatencyHistogram {
+ public:
+    static constexpr uint32_t kSubBucketBits = 4;
+    static constexpr uint32_t kSubBucketCnt = 1u << kSubBucketBits;
+    // values from 2^kMaxBits ns, about 18 minutes, are in the last bucket
+    static constexpr uint32_t kMaxBits = 40;
+    static constexpr uint32_t kBucketCnt = (kMaxBits - kSubBucketBits + 1) * kSubBucketCnt;
+    static constexpr uint32_t kShardCnt = 16;
+
+    LatencyHistogram() : shards_(new Shard[kShardCnt]) {}
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void Record(uint64_t ns);
+    void Record(absl::Duration time);
+
+    // all the values recorded so far
+    LatencySnapshot Snapshot() const;
+
+    static uint32_t BucketIdx(uint64_t ns);
+    // the largest value in bucket `idx`
+    static uint64_t BucketUpperBound(uint32_t idx);
+
+ private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+        std::atomic<uint64_t> buckets[kBucketCnt] = {};
+    };
+
+    std::unique_ptr<Shard[]> shards_;
+};
+
+}  // namespace statistics
+}  // namespace openmldb
+
+#endif  // SRC_STATISTICS_QUERY_RESPONSE_TIME_LATENCY_HISTOGRAM_H_
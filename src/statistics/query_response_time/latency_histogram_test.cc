@@ -0,0 +1,99 @@
+/*
+ * Copyright 2022 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "statistics/query_response_time/latency_histogram.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace statistics {
+
+class LatencyHistogramTest : public ::testing::Test {};
+
+TEST_F(LatencyHistogramTest, BucketIdx) {
+    for (uint64_t v = 0; v < LatencyHistogram::kSubBucketCnt; v++) {
+        ASSERT_EQ(v, LatencyHistogram::BucketIdx(v));
+    }
+    // every value is in the bucket that bounds it, and the relative error is small
+    uint32_t last_idx = 0;
+    for (uint64_t v = 1; v < (1ull << LatencyHistogram::kMaxBits); v = v * 9 / 8 + 1) {
+        uint32_t idx = LatencyHistogram::BucketIdx(v);
+        ASSERT_GE(idx, last_idx);
+        last_idx = idx;
+        uint64_t upper = LatencyHistogram::BucketUpperBound(idx);
+        ASSERT_GE(upper, v);
+        ASSERT_LE(upper - v, v / LatencyHistogram::kSubBucketCnt);
+        if (idx > 0) {
+            ASSERT_LT(LatencyHistogram::BucketUpperBound(idx - 1), v);
+        }
+    }
+    ASSERT_EQ(LatencyHistogram::kBucketCnt - 1, LatencyHistogram::BucketIdx(UINT64_MAX));
+}
+
+TEST_F(LatencyHistogramTest, Percentile) {
+    LatencyHistogram histogram;
+    ASSERT_EQ(0u, histogram.Snapshot().Percentile(0.5));
+    for (uint64_t v = 1; v <= 1000; v++) {
+        histogram.Record(v * 1000);
+    }
+    auto snapshot = histogram.Snapshot();
+    ASSERT_EQ(1000u, snapshot.count);
+    ASSERT_EQ(500500000u, snapshot.sum);
+    ASSERT_EQ(1000000u, snapshot.max);
+    for (double q : {0.5, 0.9, 0.99, 0.999}) {
+        double expect = q * 1000000;
+        ASSERT_GE(snapshot.Percentile(q), expect);
+        ASSERT_LE(snapshot.Percentile(q), expect * (1 + 1.0 / LatencyHistogram::kSubBucketCnt));
+    }
+    ASSERT_EQ(1000000u, snapshot.Percentile(1));
+
+    histogram.Record(absl::Milliseconds(5));
+    auto delta = histogram.Snapshot();
+    delta.Subtract(snapshot);
+    ASSERT_EQ(1u, delta.count);
+    ASSERT_EQ(5000000u, delta.sum);
+    ASSERT_GE(delta.Percentile(0.5), 5000000u);
+    ASSERT_EQ(delta.Percentile(0.5), delta.max);
+}
+
+TEST_F(LatencyHistogramTest, RecordConcurrently) {
+    LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; i++) {
+        threads.emplace_back([&histogram, i]() {
+            for (uint64_t v = 0; v < 10000; v++) {
+                histogram.Record(v + i);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto snapshot = histogram.Snapshot();
+    ASSERT_EQ(80000u, snapshot.count);
+    ASSERT_EQ(10006u, snapshot.max);
+}
+
+}  // namespace statistics
+}  // namespace openmldb
+
+int main(int argc, char* argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -33,8 +33,9 @@ TimeCollector::TimeCollector()
 // TimeCollector(std::initializer_list<std::initializer_list<ResponseTimeRow>> data) {}
 
 void TimeCollector::Collect(absl::Duration time) {
-    for (size_t idx = 0; idx < helper_.BucketCount(); ++idx) {
-        if (time <= helper_.UpperBound(idx).value()) {
+    const auto& upper_bounds = helper_.UpperBounds();
+    for (size_t idx = 0; idx < upper_bounds.size(); ++idx) {
+        if (time <= upper_bounds[idx]) {
             count_[idx].fetch_add(1, std::memory_order_relaxed);
             total_[idx].fetch_add(absl::ToInt64Microseconds(time), std::memory_order_relaxed);
             break;
@@ -151,6 +151,9 @@ class TimeDistributionHelper {
     /// \brief return number of time intervals in the whole distribution
     uint32_t BucketCount() const { return bucket_count_; }
 
+    /// \brief upper bounds of all the time intervals, the last one is infinite
+    const std::vector<absl::Duration>& UpperBounds() const { return upper_bounds_; }
+
  private:
     void Setup();
 
@@ -17,14 +17,18 @@
 #include "storage/binlog.h"
 
 #include <map>
+#include <memory>
 #include <set>
 #include <utility>
 #include <vector>
 
+#include "base/count_down_latch.h"
 #include "base/glog_wapper.h"
 #include "base/hash.h"
 #include "base/kv_iterator.h"
 #include "base/strings.h"
+#include "base/taskpool.hpp"
+#include "boost/bind.hpp"
 #include "codec/schema_codec.h"
 #include "common/timer.h"
 #include "gflags/gflags.h"
@@ -33,10 +37,83 @@
 
 DECLARE_uint64(gc_on_table_recover_count);
 DECLARE_int32(binlog_name_length);
+DECLARE_uint32(binlog_replay_thread_num);
+DECLARE_uint32(load_table_batch);
+DECLARE_uint32(load_table_queue_size);
 
 namespace openmldb {
 namespace storage {
 
+static const uint32_t SEED = 0xe17a1465;
+
+// apply put entries on single thread pools, entries with the same key of the
+// first dimension always go to the same pool so that their order is kept.
+// an entry of a table with several indexes may share the key of any other
+// index with entries hashed to another pool, so all of them go to the first
+// pool in order and only the entries of single index tables are spread
+class BinlogReplayer {
+ public:
+    BinlogReplayer(std::shared_ptr<Table> table, uint32_t thread_num)
+        : table_(table), single_index_(table->GetAllIndex().size() <= 1), batches_(thread_num) {
+        for (uint32_t i = 0; i < thread_num; i++) {
+            pools_.emplace_back(new ::openmldb::base::TaskPool(1, FLAGS_load_table_queue_size));
+        }
+    }
+
+    ~BinlogReplayer() { Wait(); }
+
+    // take over the content of `entry`
+    void Put(::openmldb::api::LogEntry* entry) {
+        uint32_t idx = 0;
+        if (single_index_ && entry->dimensions_size() <= 1) {
+            const std::string& key = entry->dimensions_size() > 0 ? entry->dimensions(0).key() : entry->pk();
+            idx = ::openmldb::base::hash(key.c_str(), key.length(), SEED) % pools_.size();
+        }
+        auto& batch = batches_[idx];
+        if (!batch) {
+            batch = std::make_shared<std::vector<::openmldb::api::LogEntry>>();
+            batch->reserve(FLAGS_load_table_batch);
+        }
+        batch->emplace_back();
+        batch->back().Swap(entry);
+        if (batch->size() >= FLAGS_load_table_batch) {
+            Dispatch(idx);
+        }
+    }
+
+    // block until all entries put before are applied
+    void Wait() {
+        for (uint32_t i = 0; i < pools_.size(); i++) {
+            Dispatch(i);
+        }
+        ::openmldb::base::CountDownLatch latch(pools_.size());
+        for (auto& pool : pools_) {
+            pool->AddTask(boost::bind(&::openmldb::base::CountDownLatch::CountDown, &latch));
+        }
+        latch.Wait();
+    }
+
+ private:
+    void Dispatch(uint32_t idx) {
+        auto& batch = batches_[idx];
+        if (batch && !batch->empty()) {
+            pools_[idx]->AddTask(boost::bind(&BinlogReplayer::Apply, table_, batch));
+        }
+        batch.reset();
+    }
+
+    static void Apply(std::shared_ptr<Table> table, std::shared_ptr<std::vector<::openmldb::api::LogEntry>> batch) {
+        for (const auto& entry : *batch) {
+            table->Put(entry);
+        }
+    }
+
+    std::shared_ptr<Table> table_;
+    bool single_index_;
+    std::vector<std::unique_ptr<::openmldb::base::TaskPool>> pools_;
+    std::vector<std::shared_ptr<std::vector<::openmldb::api::LogEntry>>> batches_;
+};
+
 Binlog::Binlog(LogParts* log_part, const std::string& binlog_path) : log_part_(log_part), log_path_(binlog_path) {}
 
 bool Binlog::RecoverFromBinlog(std::shared_ptr<Table> table, uint64_t offset, uint64_t& latest_offset) {
@@ -53,6 +130,11 @@ bool Binlog::RecoverFromBinlog(std::shared_ptr<Table> table, uint64_t offset, ui
     uint64_t consumed = ::baidu::common::timer::now_time();
     int last_log_index = log_reader.GetLogIndex();
     bool reach_end_log = true;
+    std::unique_ptr<BinlogReplayer> replayer;
+    if (FLAGS_binlog_replay_thread_num > 1) {
+        replayer.reset(new BinlogReplayer(table, FLAGS_binlog_replay_thread_num));
+    }
+    RecoverProgressBatch progress(progress_.get());
     while (true) {
         buffer.clear();
         ::openmldb::base::Slice record;
@@ -88,6 +170,7 @@ bool Binlog::RecoverFromBinlog(std::shared_ptr<Table> table, uint64_t offset, ui
             failed_cnt++;
             continue;
         }
+        progress.Consume(record.size());
         bool ok = entry.ParseFromString(record.ToString());
         if (!ok) {
             PDLOG(WARNING, "fail parse record for tid %u, pid %u with value %s", tid, pid,
@@ -108,16 +191,22 @@ bool Binlog::RecoverFromBinlog(std::shared_ptr<Table> table, uint64_t offset, ui
                   cur_offset, entry.log_index(), tid, pid);
         }
 
+        cur_offset = entry.log_index();
         if (entry.has_method_type() && entry.method_type() == ::openmldb::api::MethodType::kDelete) {
             if (entry.dimensions_size() == 0) {
                 PDLOG(WARNING, "no dimesion. tid %u pid %u offset %lu", tid, pid, entry.log_index());
             } else {
+                // the key may be in any dimension of the entries before, wait for all of them
+                if (replayer) {
+                    replayer->Wait();
+                }
                 table->Delete(entry.dimensions(0).key(), entry.dimensions(0).idx());
             }
+        } else if (replayer) {
+            replayer->Put(&entry);
         } else {
             table->Put(entry);
         }
-        cur_offset = entry.log_index();
         succ_cnt++;
         if (succ_cnt % 100000 == 0) {
             PDLOG(INFO,
@@ -129,6 +218,9 @@ bool Binlog::RecoverFromBinlog(std::shared_ptr<Table> table, uint64_t offset, ui
             table->SchedGc();
         }
     }
+    if (replayer) {
+        replayer->Wait();
+    }
     latest_offset = cur_offset;
     if (!reach_end_log) {
         int log_index = log_reader.GetLogIndex();
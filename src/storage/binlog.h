@@ -21,6 +21,7 @@
 
 #include "log/log_reader.h"
 #include "log/log_writer.h"
+#include "storage/recover_progress.h"
 #include "storage/table.h"
 
 typedef ::openmldb::base::Skiplist<uint32_t, uint64_t, ::openmldb::base::DefaultComparator> LogParts;
@@ -34,10 +35,12 @@ class Binlog {
     ~Binlog() = default;
     bool RecoverFromBinlog(std::shared_ptr<Table> table, uint64_t offset,
                            uint64_t& latest_offset);  // NOLINT
+    void SetRecoverProgress(std::shared_ptr<RecoverProgress> progress) { progress_ = progress; }
 
  private:
     LogParts* log_part_;
     std::string log_path_;
+    std::shared_ptr<RecoverProgress> progress_;
 };
 
 }  // namespace storage
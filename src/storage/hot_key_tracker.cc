@@ -0,0 +1,71 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/hot_key_tracker.h"
+
+#include <algorithm>
+#include <mutex>  // NOLINT
+
+namespace openmldb {
+namespace storage {
+
+void HotKeyTracker::Sample(const ::openmldb::base::Slice& key) {
+    std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
+    std::string skey(key.data(), key.size());
+    auto it = counts_.find(skey);
+    if (it != counts_.end()) {
+        it->second++;
+        return;
+    }
+    if (counts_.size() < capacity_) {
+        counts_.emplace(std::move(skey), 1);
+        return;
+    }
+    if (counts_.empty()) {
+        return;
+    }
+    auto min = std::min_element(counts_.begin(), counts_.end(),
+                                [](const auto& a, const auto& b) { return a.second < b.second; });
+    uint64_t cnt = min->second + 1;
+    counts_.erase(min);
+    counts_.emplace(std::move(skey), cnt);
+}
+
+void HotKeyTracker::GetHotKeys(std::vector<std::pair<std::string, uint64_t>>* hot_keys) {
+    hot_keys->clear();
+    {
+        std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
+        for (const auto& kv : counts_) {
+            hot_keys->emplace_back(kv.first, kv.second * sample_rate_);
+        }
+    }
+    std::sort(hot_keys->begin(), hot_keys->end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+}
+
+void HotKeyTracker::Decay() {
+    std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
+    for (auto it = counts_.begin(); it != counts_.end();) {
+        it->second /= 2;
+        if (it->second == 0) {
+            it = counts_.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+}  // namespace storage
+}  // namespace openmldb
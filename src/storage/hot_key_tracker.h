@@ -0,0 +1,70 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_STORAGE_HOT_KEY_TRACKER_H_
+#define SRC_STORAGE_HOT_KEY_TRACKER_H_
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/slice.h"
+#include "base/spinlock.h"
+
+namespace openmldb {
+namespace storage {
+
+// HotKeyTracker finds the most accessed keys of an index. one access of `sample_rate` is
+// sampled on each thread, and the samples are counted by the space saving algorithm: a key
+// out of the tracked ones replaces the least counted key and takes over its count, so the
+// count of a key is an overestimate by at most the count it took over
+class HotKeyTracker {
+ public:
+    // sample_rate 0 disables the tracker
+    HotKeyTracker(uint32_t capacity, uint32_t sample_rate) : capacity_(capacity), sample_rate_(sample_rate) {}
+
+    HotKeyTracker(const HotKeyTracker&) = delete;
+    HotKeyTracker& operator=(const HotKeyTracker&) = delete;
+
+    inline void Access(const ::openmldb::base::Slice& key) {
+        static thread_local uint32_t tick = 0;
+        if (sample_rate_ == 0 || ++tick < sample_rate_) {
+            return;
+        }
+        tick = 0;
+        Sample(key);
+    }
+
+    // the tracked keys and their estimated accesses, the hottest first
+    void GetHotKeys(std::vector<std::pair<std::string, uint64_t>>* hot_keys);
+
+    // halve the counts, so that the keys which are no longer hot are replaced
+    void Decay();
+
+ private:
+    void Sample(const ::openmldb::base::Slice& key);
+
+    const uint32_t capacity_;
+    const uint32_t sample_rate_;
+    ::openmldb::base::SpinMutex mu_;
+    std::unordered_map<std::string, uint64_t> counts_;
+};
+
+}  // namespace storage
+}  // namespace openmldb
+
+#endif  // SRC_STORAGE_HOT_KEY_TRACKER_H_
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/hot_key_tracker.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace storage {
+
+class HotKeyTrackerTest : public ::testing::Test {};
+
+TEST_F(HotKeyTrackerTest, HotKeys) {
+    HotKeyTracker tracker(8, 1);
+    // key0 is the hottest, and the cold keys replace each other
+    for (int i = 0; i < 1000; i++) {
+        tracker.Access(::openmldb::base::Slice("key0"));
+        if (i % 2 == 0) {
+            tracker.Access(::openmldb::base::Slice("key1"));
+        }
+        if (i % 4 == 0) {
+            tracker.Access(::openmldb::base::Slice("cold" + std::to_string(i)));
+        }
+    }
+    std::vector<std::pair<std::string, uint64_t>> hot_keys;
+    tracker.GetHotKeys(&hot_keys);
+    ASSERT_EQ(8u, hot_keys.size());
+    ASSERT_EQ("key0", hot_keys[0].first);
+    ASSERT_EQ(1000u, hot_keys[0].second);
+    ASSERT_EQ("key1", hot_keys[1].first);
+    ASSERT_EQ(500u, hot_keys[1].second);
+
+    tracker.Decay();
+    tracker.GetHotKeys(&hot_keys);
+    ASSERT_EQ("key0", hot_keys[0].first);
+    ASSERT_EQ(500u, hot_keys[0].second);
+}
+
+TEST_F(HotKeyTrackerTest, Sample) {
+    HotKeyTracker tracker(4, 8);
+    for (int i = 0; i < 800; i++) {
+        tracker.Access(::openmldb::base::Slice("key0"));
+    }
+    std::vector<std::pair<std::string, uint64_t>> hot_keys;
+    tracker.GetHotKeys(&hot_keys);
+    ASSERT_EQ(1u, hot_keys.size());
+    ASSERT_EQ(800u, hot_keys[0].second);
+
+    HotKeyTracker disabled(4, 0);
+    disabled.Access(::openmldb::base::Slice("key0"));
+    disabled.GetHotKeys(&hot_keys);
+    ASSERT_TRUE(hot_keys.empty());
+}
+
+}  // namespace storage
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
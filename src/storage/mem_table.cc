@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <utility>
 
+#include "base/epoch.h"
 #include "base/glog_wapper.h"
 #include "base/hash.h"
 #include "base/slice.h"
@@ -32,28 +33,67 @@ DECLARE_uint32(key_entry_max_height);
 DECLARE_uint32(absolute_default_skiplist_height);
 DECLARE_uint32(latest_default_skiplist_height);
 DECLARE_uint32(max_traverse_cnt);
+DECLARE_uint32(gc_deleted_pk_version_delta);
+DECLARE_uint32(hot_key_sample_rate);
+DECLARE_uint64(segment_split_min_put_cnt);
+DECLARE_uint32(max_seg_cnt);
+DECLARE_uint32(mem_dict_max_size);
+DECLARE_uint32(mem_freeze_age);
+DECLARE_uint32(mem_freeze_min_cnt);
 
 namespace openmldb {
 namespace storage {
 
 static const uint32_t SEED = 0xe17a1465;
+static const uint32_t HOT_KEY_CAPACITY = 16;
+// the readers of one table in the epoch at a time, the others share an overflow count
+static const uint32_t EPOCH_SLOT_CNT = 256;
+
+// the first write version of a new table, 2^40 writes apart from the tables created before
+static uint64_t NewWriteVersionBase() {
+    static std::atomic<uint64_t> table_cnt(0);
+    return (table_cnt.fetch_add(1, std::memory_order_relaxed) + 1) << 40;
+}
+
+SegmentGroup::~SegmentGroup() {
+    for (auto seg_arr : segments) {
+        if (seg_arr != NULL) {
+            for (uint32_t j = 0; j < seg_cnt; j++) {
+                delete seg_arr[j];
+            }
+            delete[] seg_arr;
+        }
+    }
+}
 
 MemTable::MemTable(const std::string& name, uint32_t id, uint32_t pid, uint32_t seg_cnt,
                    const std::map<std::string, uint32_t>& mapping, uint64_t ttl, ::openmldb::type::TTLType ttl_type)
     : Table(::openmldb::common::StorageMode::kMemory, name, id, pid, ttl * 60 * 1000, true, 60 * 1000, mapping,
             ttl_type, ::openmldb::type::CompressType::kNoCompress),
       seg_cnt_(seg_cnt),
-      segments_(MAX_INDEX_NUM, NULL),
+      epoch_(new ::openmldb::base::EpochManager(EPOCH_SLOT_CNT), &::openmldb::base::EpochManager::Release),
+      cur_group_(NULL),
+      gc_round_(0),
+      hot_key_trackers_(MAX_INDEX_NUM),
+      last_group_(NULL),
       enable_gc_(true),
       record_cnt_(0),
       segment_released_(false),
-      record_byte_size_(0) {}
+      record_byte_size_(0),
+      write_version_(NewWriteVersionBase()),
+      cold_age_(0) {}
 
 MemTable::MemTable(const ::openmldb::api::TableMeta& table_meta)
     : Table(table_meta.storage_mode(), table_meta.name(), table_meta.tid(), table_meta.pid(), 0, true, 60 * 1000,
             std::map<std::string, uint32_t>(), ::openmldb::type::TTLType::kAbsoluteTime,
             ::openmldb::type::CompressType::kNoCompress),
-      segments_(MAX_INDEX_NUM, NULL) {
+      epoch_(new ::openmldb::base::EpochManager(EPOCH_SLOT_CNT), &::openmldb::base::EpochManager::Release),
+      cur_group_(NULL),
+      gc_round_(0),
+      hot_key_trackers_(MAX_INDEX_NUM),
+      last_group_(NULL),
+      write_version_(NewWriteVersionBase()),
+      cold_age_(0) {
     seg_cnt_ = 8;
     enable_gc_ = true;
     record_cnt_ = 0;
@@ -64,19 +104,13 @@ MemTable::MemTable(const ::openmldb::api::TableMeta& table_meta)
 }
 
 MemTable::~MemTable() {
-    if (segments_.empty()) {
+    if (!segment_group_) {
         return;
     }
     Release();
-    for (uint32_t i = 0; i < segments_.size(); i++) {
-        if (segments_[i] != NULL) {
-            for (uint32_t j = 0; j < seg_cnt_; j++) {
-                delete segments_[i][j];
-            }
-            delete[] segments_[i];
-        }
-    }
-    segments_.clear();
+    cur_group_.store(NULL, std::memory_order_relaxed);
+    retired_groups_.clear();
+    segment_group_.reset();
     PDLOG(INFO, "drop memtable. tid %u pid %u", id_, pid_);
 }
 
@@ -93,6 +127,7 @@ bool MemTable::Init() {
         table_meta_->key_entry_max_height() > 0) {
         global_key_entry_max_height = table_meta_->key_entry_max_height();
     }
+    auto group = std::make_shared<SegmentGroup>(seg_cnt_);
     auto inner_indexs = table_index_.GetAllInnerIndex();
     for (uint32_t i = 0; i < inner_indexs->size(); i++) {
         const std::vector<uint32_t>& ts_vec = inner_indexs->at(i)->GetTsIdx();
@@ -116,9 +151,43 @@ bool MemTable::Init() {
                 PDLOG(INFO, "init %u, %u segment. height %u tid %u pid %u", i, j, cur_key_entry_max_height, id_, pid_);
             }
         }
-        segments_[i] = seg_arr;
+        for (uint32_t j = 0; j < seg_cnt_; j++) {
+            seg_arr[j]->SetEpochManager(epoch_.get());
+        }
+        group->segments[i] = seg_arr;
+        hot_key_trackers_[i] = std::make_shared<HotKeyTracker>(HOT_KEY_CAPACITY, FLAGS_hot_key_sample_rate);
         key_entry_max_height_ = cur_key_entry_max_height;
     }
+    // the compressed rows and the legacy format are kept as they are
+    if (table_meta_->dict_encode() && table_meta_->compress_type() != ::openmldb::type::CompressType::kSnappy &&
+        table_meta_->format_version() == 1) {
+        row_dict_.reset(new RowDict(table_meta_->column_desc(), FLAGS_mem_dict_max_size));
+        for (uint32_t i = 0; i < inner_indexs->size(); i++) {
+            for (uint32_t j = 0; j < seg_cnt_; j++) {
+                group->segments[i][j]->SetRowDict(row_dict_.get());
+            }
+        }
+        PDLOG(INFO, "encode rows by dictionaries. tid %u pid %u", id_, pid_);
+    }
+    if (cold_table_) {
+        // the rows of an index with a latest ttl are not ordered by the age
+        bool is_absolute = table_meta_->cold_age() > 0;
+        for (const auto& index_def : table_index_.GetAllIndex()) {
+            if (index_def->GetTTLType() != ::openmldb::storage::TTLType::kAbsoluteTime) {
+                is_absolute = false;
+            }
+        }
+        if (is_absolute) {
+            cold_age_ = table_meta_->cold_age() * 60 * 1000;
+            PDLOG(INFO, "move the rows older than %lu minutes to the cold tier. tid %u pid %u",
+                  table_meta_->cold_age(), id_, pid_);
+        } else {
+            PDLOG(WARNING, "the cold tier needs cold_age and absolute ttls, disable it. tid %u pid %u", id_, pid_);
+            cold_table_.reset();
+        }
+    }
+    segment_group_ = group;
+    cur_group_.store(group.get(), std::memory_order_release);
     PDLOG(INFO, "init table name %s, id %d, pid %d, seg_cnt %d", name_.c_str(), id_, pid_, seg_cnt_);
     return true;
 }
@@ -127,15 +196,24 @@ void MemTable::SetCompressType(::openmldb::type::CompressType compress_type) { c
 
 ::openmldb::type::CompressType MemTable::GetCompressType() { return compress_type_; }
 
-bool MemTable::Put(const std::string& pk, uint64_t time, const char* data, uint32_t size) {
-    if (segments_.empty()) return false;
-    uint32_t index = 0;
-    if (seg_cnt_ > 1) {
-        index = ::openmldb::base::hash(pk.c_str(), pk.length(), SEED) % seg_cnt_;
+inline Segment* MemTable::GetSegment(uint32_t real_idx, const Slice& pk) const {
+    const SegmentGroup* group = cur_group_.load(std::memory_order_acquire);
+    uint32_t seg_idx = 0;
+    if (group->seg_cnt > 1) {
+        seg_idx = ::openmldb::base::hash(pk.data(), pk.size(), SEED) % group->seg_cnt;
     }
-    Segment* segment = segments_[0][index];
+    return group->segments[real_idx][seg_idx];
+}
+
+bool MemTable::Put(const std::string& pk, uint64_t time, const char* data, uint32_t size) {
+    if (segment_released_) return false;
     Slice spk(pk);
-    segment->Put(spk, time, data, size);
+    hot_key_trackers_[0]->Access(spk);
+    // a segment retired by a split refuses the put, which goes to the new segment of the key
+    Segment* segment = NULL;
+    do {
+        segment = GetSegment(0, spk);
+    } while (!segment->Put(spk, time, data, size) && segment->IsRetired());
     record_cnt_.fetch_add(1, std::memory_order_relaxed);
     record_byte_size_.fetch_add(GetRecordSize(size));
     return true;
@@ -194,7 +272,31 @@ bool MemTable::Put(uint64_t time, const std::string& value, const Dimensions& di
     if (ts_map.empty()) {
         return false;
     }
-    auto* block = new DataBlock(real_ref_cnt, value.c_str(), value.length());
+    if (cold_table_) {
+        // the old rows of the recovery and the late ones go to the cold tier at once
+        uint64_t cold_time = ::baidu::common::timer::get_micros() / 1000 - cold_age_;
+        bool is_cold = true;
+        for (const auto& kv : ts_map) {
+            if (kv.second >= cold_time) {
+                is_cold = false;
+                break;
+            }
+        }
+        if (is_cold) {
+            bool ok = cold_table_->Put(time, value, dimensions);
+            BumpWriteVersion();
+            return ok;
+        }
+    }
+    DataBlock* block = NULL;
+    static thread_local std::string encoded;
+    if (row_dict_ && row_dict_->Encode(value.data(), value.length(), &encoded)) {
+        const char* encoded_data = encoded.data();
+        block = new DataBlock(real_ref_cnt, encoded_data, encoded.length(), numa_arena_.get());
+        block->dict_encoded = true;
+    } else {
+        block = new DataBlock(real_ref_cnt, value.c_str(), value.length(), numa_arena_.get());
+    }
     for (const auto& kv : inner_index_key_map) {
         auto inner_index = table_index_.GetInnerIndex(kv.first);
         bool need_put = false;
@@ -206,16 +308,15 @@ bool MemTable::Put(uint64_t time, const std::string& value, const Dimensions& di
             }
         }
         if (need_put) {
-            uint32_t seg_idx = 0;
-            if (seg_cnt_ > 1) {
-                seg_idx = ::openmldb::base::hash(kv.second.data(), kv.second.size(), SEED) % seg_cnt_;
-            }
-            Segment* segment = segments_[kv.first][seg_idx];
-            segment->Put(::openmldb::base::Slice(kv.second), ts_map, block);
+            hot_key_trackers_[kv.first]->Access(kv.second);
+            Segment* segment = NULL;
+            do {
+                segment = GetSegment(kv.first, kv.second);
+            } while (!segment->Put(kv.second, ts_map, block) && segment->IsRetired());
         }
     }
     record_cnt_.fetch_add(1, std::memory_order_relaxed);
-    record_byte_size_.fetch_add(GetRecordSize(value.length()));
+    record_byte_size_.fetch_add(GetRecordSize(block->size));
     return true;
 }
 
@@ -225,32 +326,38 @@ bool MemTable::Delete(const std::string& pk, uint32_t idx) {
         return false;
     }
     Slice spk(pk);
-    uint32_t seg_idx = 0;
-    if (seg_cnt_ > 1) {
-        seg_idx = ::openmldb::base::hash(spk.data(), spk.size(), SEED) % seg_cnt_;
-    }
     uint32_t real_idx = index_def->GetInnerPos();
-    Segment* segment = segments_[real_idx][seg_idx];
-    return segment->Delete(spk);
+    Segment* segment = NULL;
+    bool ok = false;
+    do {
+        segment = GetSegment(real_idx, spk);
+        ok = segment->Delete(spk);
+    } while (!ok && segment->IsRetired());
+    if (cold_table_ && cold_table_->Delete(pk, idx)) {
+        ok = true;
+        BumpWriteVersion();
+    }
+    return ok;
 }
 
 uint64_t MemTable::Release() {
     if (segment_released_) {
         return 0;
     }
-    if (segments_.empty()) {
+    auto group = GetSegmentGroup();
+    if (!group) {
         return 0;
     }
     uint64_t total_cnt = 0;
-    for (uint32_t i = 0; i < segments_.size(); i++) {
-        if (segments_[i] != NULL) {
-            for (uint32_t j = 0; j < seg_cnt_; j++) {
-                total_cnt += segments_[i][j]->Release();
+    for (auto seg_arr : group->segments) {
+        if (seg_arr != NULL) {
+            for (uint32_t j = 0; j < group->seg_cnt; j++) {
+                total_cnt += seg_arr[j]->Release();
             }
         }
     }
     segment_released_ = true;
-    segments_.clear();
+    BumpWriteVersion();
     return total_cnt;
 }
 
@@ -260,6 +367,13 @@ void MemTable::SchedGc() {
     uint64_t gc_idx_cnt = 0;
     uint64_t gc_record_cnt = 0;
     uint64_t gc_record_byte_size = 0;
+    // the old rows are frozen with the gc of absolute ttl, and moved by the cold tier if any
+    uint64_t freeze_time = 0;
+    uint64_t freeze_cnt = 0;
+    if (FLAGS_mem_freeze_age > 0 && !cold_table_ && consumed / 1000 > FLAGS_mem_freeze_age * 60 * 1000ul) {
+        freeze_time = consumed / 1000 - FLAGS_mem_freeze_age * 60 * 1000ul;
+    }
+    auto group = GetSegmentGroup();
     auto inner_indexs = table_index_.GetAllInnerIndex();
     for (uint32_t i = 0; i < inner_indexs->size(); i++) {
         const std::vector<std::shared_ptr<IndexDef>>& real_index = inner_indexs->at(i)->GetIndex();
@@ -279,10 +393,11 @@ void MemTable::SchedGc() {
                 need_gc = false;
             } else if (cur_index->GetStatus() == IndexStatus::kDeleting) {
                 if (real_index.size() == 1) {
-                    if (segments_[i] != NULL) {
-                        for (uint32_t k = 0; k < seg_cnt_; k++) {
-                            if (segments_[i][k] != NULL) {
-                                segments_[i][k]->ReleaseAndCount(gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+                    if (group->segments[i] != NULL) {
+                        for (uint32_t k = 0; k < group->seg_cnt; k++) {
+                            if (group->segments[i][k] != NULL) {
+                                group->segments[i][k]->ReleaseAndCount(gc_idx_cnt, gc_record_cnt,
+                                                                       gc_record_byte_size);
                             }
                         }
                     }
@@ -299,9 +414,9 @@ void MemTable::SchedGc() {
         if (deleted_num == real_index.size() || ttl_st_map.empty()) {
             continue;
         }
-        for (uint32_t j = 0; j < seg_cnt_; j++) {
+        for (uint32_t j = 0; j < group->seg_cnt; j++) {
             uint64_t seg_gc_time = ::baidu::common::timer::get_micros() / 1000;
-            Segment* segment = segments_[i][j];
+            Segment* segment = group->segments[i][j];
             segment->IncrGcVersion();
             segment->GcFreeList(gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
             if (ttl_st_map.size() == 1) {
@@ -309,19 +424,207 @@ void MemTable::SchedGc() {
             } else {
                 segment->ExecuteGc(ttl_st_map, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
             }
+            if (freeze_time > 0 && ttl_st_map.size() == 1 &&
+                ttl_st_map.begin()->second.ttl_type == ::openmldb::storage::TTLType::kAbsoluteTime) {
+                segment->Freeze(freeze_time, FLAGS_mem_freeze_min_cnt, freeze_cnt);
+            }
             seg_gc_time = ::baidu::common::timer::get_micros() / 1000 - seg_gc_time;
             PDLOG(INFO, "gc segment[%u][%u] done consumed %lu for table %s tid %u pid %u", i, j, seg_gc_time,
                   name_.c_str(), id_, pid_);
         }
     }
+    if (cold_table_ && enable_gc_.load(std::memory_order_relaxed)) {
+        MoveCold();
+    }
+    // free the memory retired by the gc of the table, once the readers entered before have left
+    uint64_t reclaimed = epoch_->Reclaim();
+    // and the managers of the tables dropped before, once their last tickets are gone
+    ::openmldb::base::EpochManager::FreeReleased();
     consumed = ::baidu::common::timer::get_micros() - consumed;
     record_cnt_.fetch_sub(gc_record_cnt, std::memory_order_relaxed);
     record_byte_size_.fetch_sub(gc_record_byte_size, std::memory_order_relaxed);
     PDLOG(INFO,
-          "gc finished, gc_idx_cnt %lu, gc_record_cnt %lu consumed %lu ms for "
+          "gc finished, gc_idx_cnt %lu, gc_record_cnt %lu, reclaimed %lu, consumed %lu ms for "
           "table %s tid %u pid %u",
-          gc_idx_cnt, gc_record_cnt, consumed / 1000, name_.c_str(), id_, pid_);
+          gc_idx_cnt, gc_record_cnt, reclaimed, consumed / 1000, name_.c_str(), id_, pid_);
+    if (freeze_cnt > 0) {
+        PDLOG(INFO, "froze %lu rows for table %s tid %u pid %u", freeze_cnt, name_.c_str(), id_, pid_);
+    }
     UpdateTTL();
+    // the rows are changed by the gc and the new ttl
+    BumpWriteVersion();
+    TrySplitSegments();
+    for (const auto& tracker : hot_key_trackers_) {
+        if (tracker) {
+            tracker->Decay();
+        }
+    }
+    std::lock_guard<std::mutex> lock(split_mu_);
+    gc_round_++;
+    retired_groups_.erase(std::remove_if(retired_groups_.begin(), retired_groups_.end(),
+                                         [this](const auto& kv) {
+                                             return kv.first + FLAGS_gc_deleted_pk_version_delta <= gc_round_;
+                                         }),
+                          retired_groups_.end());
+}
+
+void MemTable::MoveCold() {
+    uint64_t consumed = ::baidu::common::timer::get_micros();
+    uint64_t cold_time = consumed / 1000 - cold_age_;
+    uint64_t gc_idx_cnt = 0;
+    uint64_t gc_record_cnt = 0;
+    uint64_t gc_record_byte_size = 0;
+    uint64_t moved_cnt = 0;
+    auto group = GetSegmentGroup();
+    auto inner_indexs = table_index_.GetAllInnerIndex();
+    Dimensions dimensions;
+    auto dimension = dimensions.Add();
+    std::string buf;
+    for (uint32_t i = 0; i < inner_indexs->size(); i++) {
+        std::shared_ptr<IndexDef> index_def;
+        for (const auto& cur_index : inner_indexs->at(i)->GetIndex()) {
+            if (cur_index->IsReady()) {
+                index_def = cur_index;
+                break;
+            }
+        }
+        if (!index_def || group->segments[i] == NULL) {
+            continue;
+        }
+        // the cold tier puts the row with every ts column of the inner index
+        dimension->set_idx(index_def->GetId());
+        auto move = [&](const Slice& key, uint32_t ts_pos, uint64_t ts, const DataBlock* row) {
+            Slice value = GetRow(row, row_dict_.get(), &buf);
+            dimension->set_key(key.data(), key.size());
+            moved_cnt++;
+            return cold_table_->Put(ts, std::string(value.data(), value.size()), dimensions);
+        };
+        for (uint32_t j = 0; j < group->seg_cnt; j++) {
+            group->segments[i][j]->Gc4Cold(cold_time, move, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+        }
+    }
+    record_cnt_.fetch_sub(gc_record_cnt, std::memory_order_relaxed);
+    record_byte_size_.fetch_sub(gc_record_byte_size, std::memory_order_relaxed);
+    cold_table_->SchedGc();
+    PDLOG(INFO, "move %lu rows to the cold tier, gc_idx_cnt %lu, gc_record_cnt %lu, consumed %lu ms. tid %u pid %u",
+          moved_cnt, gc_idx_cnt, gc_record_cnt, (::baidu::common::timer::get_micros() - consumed) / 1000, id_, pid_);
+}
+
+void MemTable::TrySplitSegments() {
+    if (FLAGS_segment_split_min_put_cnt == 0 || segment_released_) {
+        return;
+    }
+    auto group = GetSegmentGroup();
+    uint32_t seg_cnt = group->seg_cnt;
+    // the puts of the segments in the last round
+    std::vector<uint64_t> put_cnts;
+    for (auto seg_arr : group->segments) {
+        if (seg_arr != NULL) {
+            for (uint32_t j = 0; j < seg_cnt; j++) {
+                put_cnts.push_back(seg_arr[j]->GetPutCnt());
+            }
+        }
+    }
+    std::vector<uint64_t> last_put_cnts;
+    last_put_cnts.swap(last_put_cnts_);
+    last_put_cnts_ = put_cnts;
+    if (last_put_cnts.size() == put_cnts.size() && last_group_ == group.get()) {
+        for (uint32_t i = 0; i < put_cnts.size(); i++) {
+            put_cnts[i] -= last_put_cnts[i];
+        }
+    }
+    last_group_ = group.get();
+    if (seg_cnt * 2 > FLAGS_max_seg_cnt) {
+        return;
+    }
+    std::vector<std::pair<std::string, uint64_t>> hot_keys;
+    uint32_t pos = 0;
+    for (uint32_t i = 0; i < group->segments.size(); i++) {
+        if (group->segments[i] == NULL) {
+            continue;
+        }
+        uint64_t total = 0;
+        uint64_t max = 0;
+        for (uint32_t j = 0; j < seg_cnt; j++, pos++) {
+            total += put_cnts[pos];
+            max = std::max(max, put_cnts[pos]);
+        }
+        // the hottest segment takes more than twice of its share
+        if (max < FLAGS_segment_split_min_put_cnt || max * seg_cnt <= total * 2) {
+            continue;
+        }
+        // a segment hot because of a single key is not cooled by a split. the counts of the
+        // tracker are halved every round, about twice the accesses of a round
+        if (hot_key_trackers_[i]) {
+            hot_key_trackers_[i]->GetHotKeys(&hot_keys);
+            if (!hot_keys.empty() && hot_keys[0].second > max) {
+                continue;
+            }
+        }
+        PDLOG(INFO, "segment of index %u has %lu puts of %lu in the last round. tid %u pid %u", i, max, total, id_,
+              pid_);
+        SplitSegments(seg_cnt * 2);
+        return;
+    }
+}
+
+bool MemTable::SplitSegments(uint32_t seg_cnt) {
+    std::lock_guard<std::mutex> split_lock(split_mu_);
+    auto group = GetSegmentGroup();
+    if (!group || segment_released_) {
+        return false;
+    }
+    uint32_t old_cnt = group->seg_cnt;
+    if (seg_cnt <= old_cnt || seg_cnt % old_cnt != 0) {
+        PDLOG(WARNING, "can not split %u segments into %u. tid %u pid %u", old_cnt, seg_cnt, id_, pid_);
+        return false;
+    }
+    // the keys of segment j go to the new segments j, j + old_cnt, j + 2 * old_cnt...
+    auto new_group = std::make_shared<SegmentGroup>(seg_cnt);
+    std::vector<Segment*> old_segs;
+    for (uint32_t i = 0; i < group->segments.size(); i++) {
+        Segment** seg_arr = group->segments[i];
+        if (seg_arr == NULL) {
+            continue;
+        }
+        Segment** new_seg_arr = new Segment*[seg_cnt];
+        for (uint32_t j = 0; j < seg_cnt; j++) {
+            new_seg_arr[j] = seg_arr[j % old_cnt]->NewEmptySegment();
+        }
+        new_group->segments[i] = new_seg_arr;
+        for (uint32_t j = 0; j < old_cnt; j++) {
+            old_segs.push_back(seg_arr[j]);
+        }
+    }
+    uint64_t consumed = ::baidu::common::timer::get_micros();
+    for (auto seg : old_segs) {
+        seg->GetPutMutex().lock();
+        seg->GetGcMutex().lock();
+    }
+    for (uint32_t i = 0; i < group->segments.size(); i++) {
+        if (group->segments[i] != NULL) {
+            for (uint32_t j = 0; j < old_cnt; j++) {
+                group->segments[i][j]->SplitUnlock(new_group->segments[i], seg_cnt, SEED);
+            }
+        }
+    }
+    // the old segments are locked, so their write counts are final. one more for the split itself
+    new_group->write_cnt_base = GetWriteCnt(group.get()) + 1;
+    // the writers waiting on the old segments retry on the new group
+    {
+        std::lock_guard<::openmldb::base::SpinMutex> lock(group_mu_);
+        segment_group_ = new_group;
+    }
+    cur_group_.store(new_group.get(), std::memory_order_release);
+    for (auto seg : old_segs) {
+        seg->GetGcMutex().unlock();
+        seg->GetPutMutex().unlock();
+    }
+    retired_groups_.emplace_back(gc_round_, group);
+    consumed = ::baidu::common::timer::get_micros() - consumed;
+    PDLOG(INFO, "split %u segments into %u, writes blocked %lu us. tid %u pid %u", old_cnt, seg_cnt, consumed, id_,
+          pid_);
+    return true;
 }
 
 // tll as ms
@@ -428,13 +731,11 @@ int MemTable::GetCount(uint32_t index, const std::string& pk, uint64_t& count) {
     if (index_def && !index_def->IsReady()) {
         return -1;
     }
-    uint32_t seg_idx = 0;
-    if (seg_cnt_ > 1) {
-        seg_idx = ::openmldb::base::hash(pk.c_str(), pk.length(), SEED) % seg_cnt_;
-    }
     Slice spk(pk);
-    uint32_t real_idx = index_def->GetInnerPos();
-    Segment* segment = segments_[real_idx][seg_idx];
+    // the entry is not freed by gc while it is counted
+    Ticket ticket;
+    ticket.Enter(epoch_.get());
+    Segment* segment = GetSegment(index_def->GetInnerPos(), spk);
     auto ts_col = index_def->GetTsColumn();
     if (ts_col) {
         return segment->GetCount(spk, ts_col->GetId(), count);
@@ -442,6 +743,14 @@ int MemTable::GetCount(uint32_t index, const std::string& pk, uint64_t& count) {
     return segment->GetCount(spk, count);
 }
 
+uint32_t MemTable::GetSegIdx(const std::string& pk) const {
+    uint32_t seg_cnt = GetSegCnt();
+    if (seg_cnt > 1) {
+        return ::openmldb::base::hash(pk.c_str(), pk.length(), SEED) % seg_cnt;
+    }
+    return 0;
+}
+
 TableIterator* MemTable::NewIterator(const std::string& pk, Ticket& ticket) { return NewIterator(0, pk, ticket); }
 
 TableIterator* MemTable::NewIterator(uint32_t index, const std::string& pk, Ticket& ticket) {
@@ -450,22 +759,29 @@ TableIterator* MemTable::NewIterator(uint32_t index, const std::string& pk, Tick
         PDLOG(WARNING, "index %d not found in table, tid %u pid %u", index, id_, pid_);
         return NULL;
     }
-    uint32_t seg_idx = 0;
-    if (seg_cnt_ > 1) {
-        seg_idx = ::openmldb::base::hash(pk.c_str(), pk.length(), SEED) % seg_cnt_;
-    }
     Slice spk(pk);
     uint32_t real_idx = index_def->GetInnerPos();
-    Segment* segment = segments_[real_idx][seg_idx];
+    hot_key_trackers_[real_idx]->Access(spk);
+    Segment* segment = GetSegment(real_idx, spk);
     auto ts_col = index_def->GetTsColumn();
+    TableIterator* it = NULL;
     if (ts_col) {
-        return segment->NewIterator(spk, ts_col->GetId(), ticket);
+        it = segment->NewIterator(spk, ts_col->GetId(), ticket);
+    } else {
+        it = segment->NewIterator(spk, ticket);
+    }
+    if (cold_table_) {
+        TableIterator* cold_it = cold_table_->NewIterator(index, pk, ticket);
+        if (cold_it != NULL) {
+            return new TieredIterator(it, cold_it);
+        }
     }
-    return segment->NewIterator(spk, ticket);
+    return it;
 }
 
 uint64_t MemTable::GetRecordIdxByteSize() {
     uint64_t record_idx_byte_size = 0;
+    auto group = GetSegmentGroup();
     auto inner_indexs = table_index_.GetAllInnerIndex();
     for (size_t i = 0; i < inner_indexs->size(); i++) {
         bool is_valid = false;
@@ -476,16 +792,35 @@ uint64_t MemTable::GetRecordIdxByteSize() {
             }
         }
         if (is_valid) {
-            for (uint32_t j = 0; j < seg_cnt_; j++) {
-                record_idx_byte_size += segments_[i][j]->GetIdxByteSize();
+            for (uint32_t j = 0; j < group->seg_cnt; j++) {
+                record_idx_byte_size += group->segments[i][j]->GetIdxByteSize();
             }
         }
     }
     return record_idx_byte_size;
 }
 
+uint64_t MemTable::GetWriteCnt(const SegmentGroup* group) {
+    uint64_t cnt = group->write_cnt_base;
+    for (auto seg_arr : group->segments) {
+        if (seg_arr != NULL) {
+            for (uint32_t j = 0; j < group->seg_cnt; j++) {
+                cnt += seg_arr[j]->GetWriteCnt();
+            }
+        }
+    }
+    return cnt;
+}
+
+uint64_t MemTable::GetWriteVersion() const {
+    const SegmentGroup* group = cur_group_.load(std::memory_order_acquire);
+    uint64_t version = write_version_.load(std::memory_order_acquire);
+    return group == NULL ? version : version + GetWriteCnt(group);
+}
+
 uint64_t MemTable::GetRecordIdxCnt() {
     uint64_t record_idx_cnt = 0;
+    auto group = GetSegmentGroup();
     auto inner_indexs = table_index_.GetAllInnerIndex();
     for (size_t i = 0; i < inner_indexs->size(); i++) {
         bool is_valid = false;
@@ -496,8 +831,8 @@ uint64_t MemTable::GetRecordIdxCnt() {
             }
         }
         if (is_valid) {
-            for (uint32_t j = 0; j < seg_cnt_; j++) {
-                record_idx_cnt += segments_[i][j]->GetIdxCnt();
+            for (uint32_t j = 0; j < group->seg_cnt; j++) {
+                record_idx_cnt += group->segments[i][j]->GetIdxCnt();
             }
         }
     }
@@ -506,6 +841,7 @@ uint64_t MemTable::GetRecordIdxCnt() {
 
 uint64_t MemTable::GetRecordPkCnt() {
     uint64_t record_pk_cnt = 0;
+    auto group = GetSegmentGroup();
     auto inner_indexs = table_index_.GetAllInnerIndex();
     for (size_t i = 0; i < inner_indexs->size(); i++) {
         bool is_valid = false;
@@ -516,8 +852,8 @@ uint64_t MemTable::GetRecordPkCnt() {
             }
         }
         if (is_valid) {
-            for (uint32_t j = 0; j < seg_cnt_; j++) {
-                record_pk_cnt += segments_[i][j]->GetPkCnt();
+            for (uint32_t j = 0; j < group->seg_cnt; j++) {
+                record_pk_cnt += group->segments[i][j]->GetPkCnt();
             }
         }
     }
@@ -532,13 +868,39 @@ bool MemTable::GetRecordIdxCnt(uint32_t idx, uint64_t** stat, uint32_t* size) {
     if (!index_def || !index_def->IsReady()) {
         return false;
     }
-    auto* data_array = new uint64_t[seg_cnt_];
+    auto group = GetSegmentGroup();
+    auto* data_array = new uint64_t[group->seg_cnt];
     uint32_t real_idx = index_def->GetInnerPos();
-    for (uint32_t i = 0; i < seg_cnt_; i++) {
-        data_array[i] = segments_[real_idx][i]->GetIdxCnt();
+    for (uint32_t i = 0; i < group->seg_cnt; i++) {
+        data_array[i] = group->segments[real_idx][i]->GetIdxCnt();
     }
     *stat = data_array;
-    *size = seg_cnt_;
+    *size = group->seg_cnt;
+    return true;
+}
+
+bool MemTable::GetSegAccessCnt(uint32_t idx, std::vector<uint64_t>* put_cnts, std::vector<uint64_t>* get_cnts) {
+    std::shared_ptr<IndexDef> index_def = table_index_.GetIndex(idx);
+    if (!index_def || !index_def->IsReady()) {
+        return false;
+    }
+    auto group = GetSegmentGroup();
+    Segment** seg_arr = group->segments[index_def->GetInnerPos()];
+    put_cnts->clear();
+    get_cnts->clear();
+    for (uint32_t i = 0; i < group->seg_cnt; i++) {
+        put_cnts->push_back(seg_arr[i]->GetPutCnt());
+        get_cnts->push_back(seg_arr[i]->GetGetCnt());
+    }
+    return true;
+}
+
+bool MemTable::GetHotKeys(uint32_t idx, std::vector<std::pair<std::string, uint64_t>>* hot_keys) {
+    std::shared_ptr<IndexDef> index_def = table_index_.GetIndex(idx);
+    if (!index_def || !index_def->IsReady()) {
+        return false;
+    }
+    hot_key_trackers_[index_def->GetInnerPos()]->GetHotKeys(hot_keys);
     return true;
 }
 
@@ -587,10 +949,14 @@ bool MemTable::AddIndex(const ::openmldb::common::ColumnKey& column_key) {
         } else {
             ts_vec.push_back(DEFUALT_TS_COL_ID);
         }
+        std::lock_guard<std::mutex> split_lock(split_mu_);
+        auto group = GetSegmentGroup();
         uint32_t inner_id = table_index_.GetAllInnerIndex()->size();
-        Segment** seg_arr = new Segment*[seg_cnt_];
-        for (uint32_t j = 0; j < seg_cnt_; j++) {
+        Segment** seg_arr = new Segment*[group->seg_cnt];
+        for (uint32_t j = 0; j < group->seg_cnt; j++) {
             seg_arr[j] = new Segment(FLAGS_absolute_default_skiplist_height, ts_vec);
+            seg_arr[j]->SetRowDict(row_dict_.get());
+            seg_arr[j]->SetEpochManager(epoch_.get());
             PDLOG(INFO, "init %u, %u segment. height %u, ts col num %u. tid %u pid %u", inner_id, j,
                   FLAGS_absolute_default_skiplist_height, ts_vec.size(), id_, pid_);
         }
@@ -600,7 +966,8 @@ bool MemTable::AddIndex(const ::openmldb::common::ColumnKey& column_key) {
             PDLOG(WARNING, "add index failed. tid %u pid %u", id_, pid_);
             return false;
         }
-        segments_[inner_id] = seg_arr;
+        hot_key_trackers_[inner_id] = std::make_shared<HotKeyTracker>(HOT_KEY_CAPACITY, FLAGS_hot_key_sample_rate);
+        group->segments[inner_id] = seg_arr;
         if (!column_key.ts_name().empty()) {
             auto ts_iter = schema.find(column_key.ts_name());
             index_def->SetTsColumn(std::make_shared<ColumnDef>(ts_iter->second));
@@ -621,6 +988,7 @@ bool MemTable::AddIndex(const ::openmldb::common::ColumnKey& column_key) {
     }
     index_def->SetStatus(IndexStatus::kReady);
     std::atomic_store_explicit(&table_meta_, new_table_meta, std::memory_order_release);
+    BumpWriteVersion();
     return true;
 }
 
@@ -645,6 +1013,7 @@ bool MemTable::DeleteIndex(const std::string& idx_name) {
     }
     std::atomic_store_explicit(&table_meta_, new_table_meta, std::memory_order_release);
     index_def->SetStatus(IndexStatus::kWaiting);
+    BumpWriteVersion();
     return true;
 }
 
@@ -667,7 +1036,81 @@ bool MemTable::DeleteIndex(const std::string& idx_name) {
     if (ts_col) {
         ts_idx = ts_col->GetId();
     }
-    return new MemTableKeyIterator(segments_[real_idx], seg_cnt_, ttl->ttl_type, expire_time, expire_cnt, ts_idx);
+    auto group = GetSegmentGroup();
+    auto it = new MemTableKeyIterator(group, real_idx, ttl->ttl_type, expire_time, expire_cnt, ts_idx);
+    if (cold_table_) {
+        ::hybridse::vm::WindowIterator* cold_it = cold_table_->NewWindowIterator(index);
+        if (cold_it != NULL) {
+            return new TieredKeyIterator(group, real_idx, it, cold_it);
+        }
+    }
+    return it;
+}
+
+bool MemTable::GetKeyEntries(uint32_t index, const std::vector<std::string>& keys, Ticket& ticket,
+                             std::vector<KeyEntry*>* entries) {
+    std::shared_ptr<IndexDef> index_def = table_index_.GetIndex(index);
+    if (!index_def || !index_def->IsReady() || entries == NULL) {
+        LOG(WARNING) << "index id " << index << "  not found. tid " << id_ << " pid " << pid_;
+        return false;
+    }
+    if (cold_table_) {
+        return false;
+    }
+    uint32_t real_idx = index_def->GetInnerPos();
+    const SegmentGroup* group = cur_group_.load(std::memory_order_acquire);
+    Segment** segments = group->segments[real_idx];
+    uint32_t ts_pos = 0;
+    auto ts_col = index_def->GetTsColumn();
+    if (ts_col) {
+        segments[0]->GetTsIdx(ts_col->GetId(), ts_pos);
+    }
+    // group the keys by segment, the keys of a segment are looked up together
+    std::vector<std::vector<uint32_t>> seg_keys(group->seg_cnt);
+    for (uint32_t i = 0; i < keys.size(); i++) {
+        hot_key_trackers_[real_idx]->Access(keys[i]);
+        uint32_t seg_idx = 0;
+        if (group->seg_cnt > 1) {
+            seg_idx = ::openmldb::base::hash(keys[i].c_str(), keys[i].length(), SEED) % group->seg_cnt;
+        }
+        seg_keys[seg_idx].push_back(i);
+    }
+    entries->assign(keys.size(), NULL);
+    std::vector<Slice> spks;
+    std::vector<KeyEntry*> seg_entries;
+    for (uint32_t seg_idx = 0; seg_idx < group->seg_cnt; seg_idx++) {
+        const auto& pos = seg_keys[seg_idx];
+        if (pos.empty()) {
+            continue;
+        }
+        spks.clear();
+        for (uint32_t i : pos) {
+            spks.emplace_back(keys[i]);
+        }
+        seg_entries.resize(pos.size());
+        segments[seg_idx]->MultiGet(spks.data(), spks.size(), ts_pos, ticket, seg_entries.data());
+        for (uint32_t i = 0; i < pos.size(); i++) {
+            (*entries)[pos[i]] = seg_entries[i];
+        }
+    }
+    return true;
+}
+
+::hybridse::vm::RowIterator* MemTable::NewWindowIterator(uint32_t index, KeyEntry* entry) {
+    std::shared_ptr<IndexDef> index_def = table_index_.GetIndex(index);
+    if (!index_def || entry == NULL) {
+        return NULL;
+    }
+    uint64_t expire_time = 0;
+    uint64_t expire_cnt = 0;
+    auto ttl = index_def->GetTTL();
+    if (enable_gc_.load(std::memory_order_relaxed)) {
+        expire_time = GetExpireTime(*ttl);
+        expire_cnt = ttl->lat_ttl;
+    }
+    KeyEntryIterator* it = entry->NewIterator();
+    it->SeekToFirst();
+    return new MemTableWindowIterator(it, ttl->ttl_type, expire_time, expire_cnt, row_dict_.get());
 }
 
 TraverseIterator* MemTable::NewTraverseIterator(uint32_t index) {
@@ -685,15 +1128,21 @@ TraverseIterator* MemTable::NewTraverseIterator(uint32_t index) {
     }
     uint32_t real_idx = index_def->GetInnerPos();
     auto ts_col = index_def->GetTsColumn();
-    if (ts_col) {
-        return new MemTableTraverseIterator(segments_[real_idx], seg_cnt_, ttl->ttl_type, expire_time, expire_cnt,
-                                            ts_col->GetId());
+    auto group = GetSegmentGroup();
+    auto it = new MemTableTraverseIterator(group, real_idx, ttl->ttl_type, expire_time, expire_cnt,
+                                           ts_col ? ts_col->GetId() : 0);
+    if (cold_table_) {
+        TraverseIterator* cold_it = cold_table_->NewTraverseIterator(index);
+        if (cold_it != NULL) {
+            return new TieredTraverseIterator(group, real_idx, it, cold_it);
+        }
     }
-    return new MemTableTraverseIterator(segments_[real_idx], seg_cnt_, ttl->ttl_type, expire_time, expire_cnt, 0);
+    return it;
 }
 
 bool MemTable::GetBulkLoadInfo(::openmldb::api::BulkLoadInfoResponse* response) {
-    response->set_seg_cnt(seg_cnt_);
+    auto group = GetSegmentGroup();
+    response->set_seg_cnt(group->seg_cnt);
 
     // TODO(hw): out of range will get -1, only a temporary solution.
     uint32_t idx = 0;
@@ -719,9 +1168,9 @@ bool MemTable::GetBulkLoadInfo(::openmldb::api::BulkLoadInfoResponse* response)
     }
     // repeated InnerSegments
     for (decltype(inner_indexes->size()) inner_id = 0; inner_id < inner_indexes->size(); ++inner_id) {
-        auto segments = segments_[inner_id];
+        auto segments = group->segments[inner_id];
         auto pb_segments = response->add_inner_segments();
-        for (decltype(seg_cnt_) i = 0; i < seg_cnt_; ++i) {
+        for (uint32_t i = 0; i < group->seg_cnt; ++i) {
             auto seg = segments[i];
             auto pb_seg = pb_segments->add_segment();
             pb_seg->set_ts_cnt(seg->GetTsCnt());
@@ -745,7 +1194,6 @@ bool MemTable::BulkLoad(const std::vector<DataBlock*>& data_blocks,
         for (int j = 0; j < inner_index.segment_size(); ++j) {
             const auto& segment_index = inner_index.segment(j);
             auto seg_idx = segment_index.id();
-            auto segment = segments_[real_idx][seg_idx];
             for (int key_idx = 0; key_idx < segment_index.key_entries_size(); ++key_idx) {
                 const auto& key_entries = segment_index.key_entries(key_idx);
                 auto pk = Slice(key_entries.key());
@@ -759,6 +1207,7 @@ bool MemTable::BulkLoad(const std::vector<DataBlock*>& data_blocks,
                         if (block == nullptr) {
                             // TODO(hw): error handle
                             LOG(INFO) << "block info mismatch";
+                            BumpWriteVersion();
                             return false;
                         }
 
@@ -766,20 +1215,29 @@ bool MemTable::BulkLoad(const std::vector<DataBlock*>& data_blocks,
                                 << ", time " << time_entry.time() << ", key_entry_id " << key_entry_id << ", block id "
                                 << time_entry.block_id();
                         block->dim_cnt_down++;
-                        segment->BulkLoadPut(key_entry_id, pk, time_entry.time(), block);
+                        // the segment is picked by the key, as the segments may be split after
+                        // GetBulkLoadInfo
+                        Segment* segment = NULL;
+                        do {
+                            segment = GetSegment(real_idx, pk);
+                        } while (!segment->BulkLoadPut(key_entry_id, pk, time_entry.time(), block) &&
+                                 segment->IsRetired());
                     }
                 }
             }
         }
     }
 
+    BumpWriteVersion();
     return true;
 }
 
-MemTableKeyIterator::MemTableKeyIterator(Segment** segments, uint32_t seg_cnt, ::openmldb::storage::TTLType ttl_type,
-                                         uint64_t expire_time, uint64_t expire_cnt, uint32_t ts_index)
-    : segments_(segments),
-      seg_cnt_(seg_cnt),
+MemTableKeyIterator::MemTableKeyIterator(std::shared_ptr<SegmentGroup> group, uint32_t real_idx,
+                                         ::openmldb::storage::TTLType ttl_type, uint64_t expire_time,
+                                         uint64_t expire_cnt, uint32_t ts_index)
+    : group_(group),
+      segments_(group->segments[real_idx]),
+      seg_cnt_(group->seg_cnt),
       seg_idx_(0),
       pk_it_(NULL),
       it_(NULL),
@@ -788,6 +1246,7 @@ MemTableKeyIterator::MemTableKeyIterator(Segment** segments, uint32_t seg_cnt, :
       expire_cnt_(expire_cnt),
       ticket_(),
       ts_idx_(0) {
+    ticket_.Enter(segments_[0]->GetEpochManager());
     uint32_t idx = 0;
     if (segments_[0]->GetTsIdx(ts_index, idx) == 0) {
         ts_idx_ = idx;
@@ -799,7 +1258,6 @@ MemTableKeyIterator::~MemTableKeyIterator() {
 }
 
 void MemTableKeyIterator::SeekToFirst() {
-    ticket_.Pop();
     if (pk_it_ != NULL) {
         delete pk_it_;
         pk_it_ = NULL;
@@ -818,7 +1276,6 @@ void MemTableKeyIterator::Seek(const std::string& key) {
         delete pk_it_;
         pk_it_ = NULL;
     }
-    ticket_.Pop();
     if (seg_cnt_ > 1) {
         seg_idx_ = ::openmldb::base::hash(key.c_str(), key.length(), SEED) % seg_cnt_;
     }
@@ -838,18 +1295,16 @@ bool MemTableKeyIterator::Valid() {
 void MemTableKeyIterator::Next() { NextPK(); }
 
 ::hybridse::vm::RowIterator* MemTableKeyIterator::GetRawValue() {
-    TimeEntries::Iterator* it = NULL;
+    KeyEntryIterator* it = NULL;
     if (segments_[seg_idx_]->GetTsCnt() > 1) {
         KeyEntry* entry = ((KeyEntry**)pk_it_->GetValue())[ts_idx_];  // NOLINT
-        it = entry->entries.NewIterator();
-        ticket_.Push(entry);
+        it = entry->NewIterator();
     } else {
         it = ((KeyEntry*)pk_it_->GetValue())  // NOLINT
-                 ->entries.NewIterator();
-        ticket_.Push((KeyEntry*)pk_it_->GetValue());  // NOLINT
+                 ->NewIterator();
     }
     it->SeekToFirst();
-    return new MemTableWindowIterator(it, ttl_type_, expire_time_, expire_cnt_);
+    return new MemTableWindowIterator(it, ttl_type_, expire_time_, expire_cnt_, segments_[seg_idx_]->GetRowDict());
 }
 
 std::unique_ptr<::hybridse::vm::RowIterator> MemTableKeyIterator::GetValue() {
@@ -864,7 +1319,6 @@ const hybridse::codec::Row MemTableKeyIterator::GetKey() {
 
 void MemTableKeyIterator::NextPK() {
     do {
-        ticket_.Pop();
         if (pk_it_->Valid()) {
             pk_it_->Next();
         }
@@ -884,11 +1338,12 @@ void MemTableKeyIterator::NextPK() {
     } while (true);
 }
 
-MemTableTraverseIterator::MemTableTraverseIterator(Segment** segments, uint32_t seg_cnt,
+MemTableTraverseIterator::MemTableTraverseIterator(std::shared_ptr<SegmentGroup> group, uint32_t real_idx,
                                                    ::openmldb::storage::TTLType ttl_type, uint64_t expire_time,
                                                    uint64_t expire_cnt, uint32_t ts_index)
-    : segments_(segments),
-      seg_cnt_(seg_cnt),
+    : group_(group),
+      segments_(group->segments[real_idx]),
+      seg_cnt_(group->seg_cnt),
       seg_idx_(0),
       pk_it_(NULL),
       it_(NULL),
@@ -897,6 +1352,7 @@ MemTableTraverseIterator::MemTableTraverseIterator(Segment** segments, uint32_t
       expire_value_(expire_time, expire_cnt, ttl_type),
       ticket_(),
       traverse_cnt_(0) {
+    ticket_.Enter(segments_[0]->GetEpochManager());
     uint32_t idx = 0;
     if (segments_[0]->GetTsIdx(ts_index, idx) == 0) {
         ts_idx_ = idx;
@@ -914,6 +1370,7 @@ bool MemTableTraverseIterator::Valid() {
 }
 
 void MemTableTraverseIterator::Next() {
+    row_buf_.Reset();
     it_->Next();
     record_idx_++;
     traverse_cnt_++;
@@ -925,10 +1382,10 @@ void MemTableTraverseIterator::Next() {
 uint64_t MemTableTraverseIterator::GetCount() const { return traverse_cnt_; }
 
 void MemTableTraverseIterator::NextPK() {
+    row_buf_.Reset();
     delete it_;
     it_ = NULL;
     do {
-        ticket_.Pop();
         if (pk_it_->Valid()) {
             pk_it_->Next();
         }
@@ -952,12 +1409,10 @@ void MemTableTraverseIterator::NextPK() {
         }
         if (segments_[seg_idx_]->GetTsCnt() > 1) {
             KeyEntry* entry = ((KeyEntry**)pk_it_->GetValue())[0];  // NOLINT
-            it_ = entry->entries.NewIterator();
-            ticket_.Push(entry);
+            it_ = entry->NewIterator();
         } else {
             it_ = ((KeyEntry*)pk_it_->GetValue())  // NOLINT
-                      ->entries.NewIterator();
-            ticket_.Push((KeyEntry*)pk_it_->GetValue());  // NOLINT
+                      ->NewIterator();
         }
         it_->SeekToFirst();
         record_idx_ = 1;
@@ -969,6 +1424,7 @@ void MemTableTraverseIterator::NextPK() {
 }
 
 void MemTableTraverseIterator::Seek(const std::string& key, uint64_t ts) {
+    row_buf_.Reset();
     if (pk_it_ != NULL) {
         delete pk_it_;
         pk_it_ = NULL;
@@ -977,7 +1433,6 @@ void MemTableTraverseIterator::Seek(const std::string& key, uint64_t ts) {
         delete it_;
         it_ = NULL;
     }
-    ticket_.Pop();
     if (seg_cnt_ > 1) {
         seg_idx_ = ::openmldb::base::hash(key.c_str(), key.length(), SEED) % seg_cnt_;
     }
@@ -987,12 +1442,10 @@ void MemTableTraverseIterator::Seek(const std::string& key, uint64_t ts) {
     if (pk_it_->Valid()) {
         if (segments_[seg_idx_]->GetTsCnt() > 1) {
             KeyEntry* entry = ((KeyEntry**)pk_it_->GetValue())[ts_idx_];  // NOLINT
-            ticket_.Push(entry);
-            it_ = entry->entries.NewIterator();
+            it_ = entry->NewIterator();
         } else {
-            ticket_.Push((KeyEntry*)pk_it_->GetValue());  // NOLINT
             it_ = ((KeyEntry*)pk_it_->GetValue())         // NOLINT
-                      ->entries.NewIterator();
+                      ->NewIterator();
         }
         if (spk.compare(pk_it_->GetKey()) != 0 || ts == 0) {
             it_->SeekToFirst();
@@ -1031,7 +1484,7 @@ void MemTableTraverseIterator::Seek(const std::string& key, uint64_t ts) {
 }
 
 openmldb::base::Slice MemTableTraverseIterator::GetValue() const {
-    return openmldb::base::Slice(it_->GetValue()->data, it_->GetValue()->size);
+    return row_buf_.Get(it_->GetValue(), segments_[seg_idx_]->GetRowDict());
 }
 
 uint64_t MemTableTraverseIterator::GetKey() const {
@@ -1049,7 +1502,7 @@ std::string MemTableTraverseIterator::GetPK() const {
 }
 
 void MemTableTraverseIterator::SeekToFirst() {
-    ticket_.Pop();
+    row_buf_.Reset();
     if (pk_it_ != NULL) {
         delete pk_it_;
         pk_it_ = NULL;
@@ -1064,12 +1517,10 @@ void MemTableTraverseIterator::SeekToFirst() {
         while (pk_it_->Valid()) {
             if (segments_[seg_idx_]->GetTsCnt() > 1) {
                 KeyEntry* entry = ((KeyEntry**)pk_it_->GetValue())[ts_idx_];  // NOLINT
-                ticket_.Push(entry);
-                it_ = entry->entries.NewIterator();
+                it_ = entry->NewIterator();
             } else {
-                ticket_.Push((KeyEntry*)pk_it_->GetValue());  // NOLINT
                 it_ = ((KeyEntry*)pk_it_->GetValue())         // NOLINT
-                          ->entries.NewIterator();
+                          ->NewIterator();
             }
             it_->SeekToFirst();
             traverse_cnt_++;
@@ -1080,7 +1531,6 @@ void MemTableTraverseIterator::SeekToFirst() {
             delete it_;
             it_ = NULL;
             pk_it_->Next();
-            ticket_.Pop();
             if (traverse_cnt_ >= FLAGS_max_traverse_cnt) {
                 return;
             }
@@ -1090,5 +1540,266 @@ void MemTableTraverseIterator::SeekToFirst() {
     }
 }
 
+// the hash of the segments of the memory table
+static inline bool HasHotKey(const std::shared_ptr<SegmentGroup>& group, Segment** segments, const std::string& key) {
+    uint32_t seg_idx = 0;
+    if (group->seg_cnt > 1) {
+        seg_idx = ::openmldb::base::hash(key.c_str(), key.length(), SEED) % group->seg_cnt;
+    }
+    return segments[seg_idx]->HasKey(Slice(key));
+}
+
+void TieredIterator::Settle() {
+    // the rows in both tiers are read from the memory table
+    while (hot_->Valid() && cold_->Valid() && hot_->GetKey() == cold_->GetKey()) {
+        cold_->Next();
+    }
+    if (hot_->Valid() && (!cold_->Valid() || hot_->GetKey() > cold_->GetKey())) {
+        cur_ = hot_.get();
+    } else if (cold_->Valid()) {
+        cur_ = cold_.get();
+    } else {
+        cur_ = NULL;
+    }
+}
+
+void TieredIterator::Next() {
+    cur_->Next();
+    Settle();
+}
+
+void TieredIterator::SeekToFirst() {
+    hot_->SeekToFirst();
+    cold_->SeekToFirst();
+    Settle();
+}
+
+void TieredIterator::Seek(uint64_t time) {
+    hot_->Seek(time);
+    cold_->Seek(time);
+    Settle();
+}
+
+void TieredWindowIterator::Settle() {
+    if (!cold_) {
+        cur_ = hot_->Valid() ? hot_.get() : NULL;
+        return;
+    }
+    while (hot_->Valid() && cold_->Valid() && hot_->GetKey() == cold_->GetKey()) {
+        cold_->Next();
+    }
+    if (hot_->Valid() && (!cold_->Valid() || hot_->GetKey() > cold_->GetKey())) {
+        cur_ = hot_.get();
+    } else if (cold_->Valid()) {
+        cur_ = cold_.get();
+    } else {
+        cur_ = NULL;
+    }
+}
+
+void TieredWindowIterator::Next() {
+    cur_->Next();
+    Settle();
+}
+
+void TieredWindowIterator::Seek(const uint64_t& key) {
+    hot_->Seek(key);
+    if (cold_) {
+        cold_->Seek(key);
+    }
+    Settle();
+}
+
+void TieredWindowIterator::SeekToFirst() {
+    hot_->SeekToFirst();
+    if (cold_) {
+        cold_->SeekToFirst();
+    }
+    Settle();
+}
+
+TieredKeyIterator::TieredKeyIterator(std::shared_ptr<SegmentGroup> group, uint32_t real_idx,
+                                     MemTableKeyIterator* hot, ::hybridse::vm::WindowIterator* cold)
+    : group_(group), segments_(group->segments[real_idx]), hot_(hot), cold_(cold), hot_phase_(true) {}
+
+void TieredKeyIterator::SkipHotKeys() {
+    while (cold_->Valid()) {
+        auto key = cold_->GetKey();
+        if (!HasHotKey(group_, segments_, std::string(reinterpret_cast<const char*>(key.buf()), key.size()))) {
+            break;
+        }
+        cold_->Next();
+    }
+}
+
+void TieredKeyIterator::SeekToCold() {
+    hot_phase_ = false;
+    cold_->SeekToFirst();
+    SkipHotKeys();
+}
+
+void TieredKeyIterator::SeekToFirst() {
+    hot_phase_ = true;
+    hot_->SeekToFirst();
+    if (!hot_->Valid()) {
+        SeekToCold();
+    }
+}
+
+void TieredKeyIterator::Seek(const std::string& key) {
+    if (HasHotKey(group_, segments_, key)) {
+        hot_phase_ = true;
+        hot_->Seek(key);
+        if (!hot_->Valid()) {
+            SeekToCold();
+        }
+    } else {
+        hot_phase_ = false;
+        cold_->Seek(key);
+        SkipHotKeys();
+    }
+}
+
+void TieredKeyIterator::Next() {
+    if (hot_phase_) {
+        hot_->Next();
+        if (!hot_->Valid()) {
+            SeekToCold();
+        }
+    } else {
+        cold_->Next();
+        SkipHotKeys();
+    }
+}
+
+::hybridse::vm::RowIterator* TieredKeyIterator::GetRawValue() {
+    if (!hot_phase_) {
+        return cold_->GetRawValue();
+    }
+    auto key = hot_->GetKey();
+    std::string pk(reinterpret_cast<const char*>(key.buf()), key.size());
+    // the cold iterator is not used in the hot phase but to find the cold rows of the key
+    ::hybridse::vm::RowIterator* cold_it = NULL;
+    cold_->Seek(pk);
+    if (cold_->Valid()) {
+        auto cold_key = cold_->GetKey();
+        if (pk.compare(0, pk.size(), reinterpret_cast<const char*>(cold_key.buf()), cold_key.size()) == 0) {
+            cold_it = cold_->GetRawValue();
+        }
+    }
+    auto it = new TieredWindowIterator(hot_->GetRawValue(), cold_it);
+    it->SeekToFirst();
+    return it;
+}
+
+TieredTraverseIterator::TieredTraverseIterator(std::shared_ptr<SegmentGroup> group, uint32_t real_idx,
+                                               MemTableTraverseIterator* hot, TraverseIterator* cold)
+    : group_(group),
+      segments_(group->segments[real_idx]),
+      hot_(hot),
+      cold_(cold),
+      hot_phase_(true),
+      pk_(),
+      hot_on_pk_(false),
+      cold_on_pk_(false),
+      use_hot_(false) {}
+
+void TieredTraverseIterator::SkipHotKeys() {
+    while (cold_->Valid() && HasHotKey(group_, segments_, cold_->GetPK())) {
+        cold_->NextPK();
+    }
+}
+
+void TieredTraverseIterator::Settle() {
+    while (hot_phase_) {
+        hot_on_pk_ = hot_->Valid() && hot_->GetPK() == pk_;
+        cold_on_pk_ = cold_->Valid() && cold_->GetPK() == pk_;
+        if (hot_on_pk_ && cold_on_pk_ && hot_->GetKey() == cold_->GetKey()) {
+            cold_->Next();
+            continue;
+        }
+        if (hot_on_pk_ || cold_on_pk_) {
+            use_hot_ = hot_on_pk_ && (!cold_on_pk_ || hot_->GetKey() > cold_->GetKey());
+            return;
+        }
+        if (hot_->Valid()) {
+            pk_ = hot_->GetPK();
+            cold_->Seek(pk_, UINT64_MAX);
+        } else if (hot_->GetCount() >= FLAGS_max_traverse_cnt) {
+            // stop at the key of the memory table
+            return;
+        } else {
+            hot_phase_ = false;
+            cold_->SeekToFirst();
+        }
+    }
+    SkipHotKeys();
+}
+
+void TieredTraverseIterator::Next() {
+    if (hot_phase_) {
+        Cur()->Next();
+        Settle();
+    } else {
+        cold_->Next();
+        SkipHotKeys();
+    }
+}
+
+void TieredTraverseIterator::NextPK() {
+    if (hot_phase_) {
+        if (hot_on_pk_) {
+            hot_->NextPK();
+        }
+        if (cold_on_pk_) {
+            cold_->NextPK();
+        }
+        Settle();
+    } else {
+        cold_->NextPK();
+        SkipHotKeys();
+    }
+}
+
+void TieredTraverseIterator::Seek(const std::string& key, uint64_t time) {
+    // the rows newer than `time` of `key` have been read
+    uint64_t cold_time = time == 0 ? UINT64_MAX : time;
+    if (HasHotKey(group_, segments_, key)) {
+        hot_phase_ = true;
+        pk_ = key;
+        hot_->Seek(key, time);
+        cold_->Seek(key, cold_time);
+        Settle();
+    } else {
+        hot_phase_ = false;
+        cold_->Seek(key, cold_time);
+        SkipHotKeys();
+    }
+}
+
+std::string TieredTraverseIterator::GetPK() const {
+    if (!hot_phase_) {
+        return cold_->GetPK();
+    }
+    return hot_on_pk_ || cold_on_pk_ ? pk_ : hot_->GetPK();
+}
+
+uint64_t TieredTraverseIterator::GetKey() const {
+    if (hot_phase_ && !hot_on_pk_ && !cold_on_pk_) {
+        return hot_->GetKey();
+    }
+    return Cur()->GetKey();
+}
+
+void TieredTraverseIterator::SeekToFirst() {
+    hot_phase_ = true;
+    hot_->SeekToFirst();
+    if (hot_->Valid()) {
+        pk_ = hot_->GetPK();
+        cold_->Seek(pk_, UINT64_MAX);
+    }
+    Settle();
+}
+
 }  // namespace storage
 }  // namespace openmldb
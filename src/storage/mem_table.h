@@ -20,11 +20,16 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "base/spinlock.h"
 #include "proto/tablet.pb.h"
+#include "storage/hot_key_tracker.h"
 #include "storage/iterator.h"
+#include "storage/row_dict.h"
 #include "storage/segment.h"
 #include "storage/table.h"
 #include "storage/ticket.h"
@@ -38,11 +43,26 @@ namespace storage {
 
 typedef google::protobuf::RepeatedPtrField<::openmldb::api::Dimension> Dimensions;
 
+// the segments of every inner index. segments are split by replacing the group, and
+// the iterators over a group keep it alive
+struct SegmentGroup {
+    explicit SegmentGroup(uint32_t cnt) : seg_cnt(cnt), write_cnt_base(0), segments(MAX_INDEX_NUM, NULL) {}
+    ~SegmentGroup();
+    SegmentGroup(const SegmentGroup&) = delete;
+    SegmentGroup& operator=(const SegmentGroup&) = delete;
+
+    const uint32_t seg_cnt;
+    // the writes of the groups replaced by splits, so that the write count of the table never goes
+    // back. it is set before the group is published
+    uint64_t write_cnt_base;
+    std::vector<Segment**> segments;
+};
+
 class MemTableWindowIterator : public ::hybridse::vm::RowIterator {
  public:
-    MemTableWindowIterator(TimeEntries::Iterator* it, ::openmldb::storage::TTLType ttl_type, uint64_t expire_time,
-                           uint64_t expire_cnt)
-        : it_(it), record_idx_(1), expire_value_(expire_time, expire_cnt, ttl_type), row_() {}
+    MemTableWindowIterator(KeyEntryIterator* it, ::openmldb::storage::TTLType ttl_type, uint64_t expire_time,
+                           uint64_t expire_cnt, const RowDict* row_dict = NULL)
+        : it_(it), record_idx_(1), expire_value_(expire_time, expire_cnt, ttl_type), row_dict_(row_dict), row_() {}
 
     ~MemTableWindowIterator() { delete it_; }
 
@@ -62,7 +82,20 @@ class MemTableWindowIterator : public ::hybridse::vm::RowIterator {
 
     // TODO(wangtaize) unify the row object
     const ::hybridse::codec::Row& GetValue() override {
-        row_.Reset(reinterpret_cast<const int8_t*>(it_->GetValue()->data), it_->GetValue()->size);
+        const DataBlock* block = it_->GetValue();
+        if (!block->dict_encoded) {
+            row_.Reset(reinterpret_cast<const int8_t*>(block->data), block->size);
+            return row_;
+        }
+        // the decoded row is owned by the row, which may be kept after the iterator moves
+        uint32_t size = RowDict::GetRowSize(block->data);
+        int8_t* buf = reinterpret_cast<int8_t*>(malloc(size));
+        if (row_dict_ == NULL || !row_dict_->Decode(block->data, block->size, reinterpret_cast<char*>(buf))) {
+            free(buf);
+            row_ = ::hybridse::codec::Row();
+            return row_;
+        }
+        row_ = ::hybridse::codec::Row(::hybridse::base::RefCountedSlice::CreateManaged(buf, size));
         return row_;
     }
 
@@ -74,15 +107,16 @@ class MemTableWindowIterator : public ::hybridse::vm::RowIterator {
     bool IsSeekable() const override { return true; }
 
  private:
-    TimeEntries::Iterator* it_;
+    KeyEntryIterator* it_;
     uint32_t record_idx_;
     TTLSt expire_value_;
+    const RowDict* row_dict_;
     ::hybridse::codec::Row row_;
 };
 
 class MemTableKeyIterator : public ::hybridse::vm::WindowIterator {
  public:
-    MemTableKeyIterator(Segment** segments, uint32_t seg_cnt, ::openmldb::storage::TTLType ttl_type,
+    MemTableKeyIterator(std::shared_ptr<SegmentGroup> group, uint32_t real_idx, ::openmldb::storage::TTLType ttl_type,
                         uint64_t expire_time, uint64_t expire_cnt, uint32_t ts_index);
 
     ~MemTableKeyIterator() override;
@@ -104,11 +138,12 @@ class MemTableKeyIterator : public ::hybridse::vm::WindowIterator {
     void NextPK();
 
  private:
+    std::shared_ptr<SegmentGroup> group_;
     Segment** segments_;
     uint32_t const seg_cnt_;
     uint32_t seg_idx_;
     KeyEntries::Iterator* pk_it_;
-    TimeEntries::Iterator* it_;
+    KeyEntryIterator* it_;
     ::openmldb::storage::TTLType ttl_type_;
     uint64_t expire_time_;
     uint64_t expire_cnt_;
@@ -119,8 +154,9 @@ class MemTableKeyIterator : public ::hybridse::vm::WindowIterator {
 
 class MemTableTraverseIterator : public TraverseIterator {
  public:
-    MemTableTraverseIterator(Segment** segments, uint32_t seg_cnt, ::openmldb::storage::TTLType ttl_type,
-                             uint64_t expire_time, uint64_t expire_cnt, uint32_t ts_index);
+    MemTableTraverseIterator(std::shared_ptr<SegmentGroup> group, uint32_t real_idx,
+                             ::openmldb::storage::TTLType ttl_type, uint64_t expire_time, uint64_t expire_cnt,
+                             uint32_t ts_index);
     ~MemTableTraverseIterator() override;
     inline bool Valid() override;
     void Next() override;
@@ -133,17 +169,122 @@ class MemTableTraverseIterator : public TraverseIterator {
     uint64_t GetCount() const override;
 
  private:
+    std::shared_ptr<SegmentGroup> group_;
     Segment** segments_;
     uint32_t const seg_cnt_;
     uint32_t seg_idx_;
     KeyEntries::Iterator* pk_it_;
-    TimeEntries::Iterator* it_;
+    KeyEntryIterator* it_;
     uint32_t record_idx_;
     uint32_t ts_idx_;
     // uint64_t expire_value_;
     TTLSt expire_value_;
     Ticket ticket_;
     uint64_t traverse_cnt_;
+    mutable RowBuffer row_buf_;
+};
+
+// the rows of a key in the memory table merged with the ones in its cold tier by ts desc. a row being
+// moved to the cold tier is in both tiers for a while, and the one in the memory table is read
+class TieredIterator : public TableIterator {
+ public:
+    TieredIterator(TableIterator* hot, TableIterator* cold) : hot_(hot), cold_(cold), cur_(NULL) {}
+    bool Valid() override { return cur_ != NULL; }
+    void Next() override;
+    openmldb::base::Slice GetValue() const override { return cur_->GetValue(); }
+    std::string GetPK() const override { return cur_->GetPK(); }
+    uint64_t GetKey() const override { return cur_->GetKey(); }
+    void SeekToFirst() override;
+    void Seek(uint64_t time) override;
+    uint64_t GetCount() const override { return hot_->GetCount() + cold_->GetCount(); }
+
+ private:
+    void Settle();
+
+    std::unique_ptr<TableIterator> hot_;
+    std::unique_ptr<TableIterator> cold_;
+    TableIterator* cur_;
+};
+
+class TieredWindowIterator : public ::hybridse::vm::RowIterator {
+ public:
+    // `cold` may be NULL if the key is not in the cold tier
+    TieredWindowIterator(::hybridse::vm::RowIterator* hot, ::hybridse::vm::RowIterator* cold)
+        : hot_(hot), cold_(cold), cur_(NULL) {}
+    bool Valid() const override { return cur_ != NULL; }
+    void Next() override;
+    const uint64_t& GetKey() const override { return cur_->GetKey(); }
+    const ::hybridse::codec::Row& GetValue() override { return cur_->GetValue(); }
+    void Seek(const uint64_t& key) override;
+    void SeekToFirst() override;
+    bool IsSeekable() const override { return true; }
+
+ private:
+    void Settle();
+
+    std::unique_ptr<::hybridse::vm::RowIterator> hot_;
+    std::unique_ptr<::hybridse::vm::RowIterator> cold_;
+    ::hybridse::vm::RowIterator* cur_;
+};
+
+// the keys of the memory table with their cold rows, then the keys only in the cold tier. a key put
+// into or removed from the memory table during the scan may be read twice or missed
+class TieredKeyIterator : public ::hybridse::vm::WindowIterator {
+ public:
+    TieredKeyIterator(std::shared_ptr<SegmentGroup> group, uint32_t real_idx, MemTableKeyIterator* hot,
+                      ::hybridse::vm::WindowIterator* cold);
+    void Seek(const std::string& key) override;
+    void SeekToFirst() override;
+    void Next() override;
+    bool Valid() override { return hot_phase_ ? hot_->Valid() : cold_->Valid(); }
+    std::unique_ptr<::hybridse::vm::RowIterator> GetValue() override {
+        return std::unique_ptr<::hybridse::vm::RowIterator>(GetRawValue());
+    }
+    ::hybridse::vm::RowIterator* GetRawValue() override;
+    const hybridse::codec::Row GetKey() override { return hot_phase_ ? hot_->GetKey() : cold_->GetKey(); }
+
+ private:
+    void SeekToCold();
+    void SkipHotKeys();
+
+    std::shared_ptr<SegmentGroup> group_;
+    Segment** segments_;
+    std::unique_ptr<MemTableKeyIterator> hot_;
+    std::unique_ptr<::hybridse::vm::WindowIterator> cold_;
+    bool hot_phase_;
+};
+
+// the same order as TieredKeyIterator. the scan stops with the memory table at max_traverse_cnt,
+// and goes on from GetPK and GetKey by Seek
+class TieredTraverseIterator : public TraverseIterator {
+ public:
+    TieredTraverseIterator(std::shared_ptr<SegmentGroup> group, uint32_t real_idx, MemTableTraverseIterator* hot,
+                           TraverseIterator* cold);
+    bool Valid() override { return hot_phase_ ? (hot_on_pk_ || cold_on_pk_) : cold_->Valid(); }
+    void Next() override;
+    void NextPK() override;
+    void Seek(const std::string& key, uint64_t time) override;
+    openmldb::base::Slice GetValue() const override { return Cur()->GetValue(); }
+    std::string GetPK() const override;
+    uint64_t GetKey() const override;
+    void SeekToFirst() override;
+    uint64_t GetCount() const override { return hot_->GetCount() + cold_->GetCount(); }
+
+ private:
+    TraverseIterator* Cur() const { return hot_phase_ && use_hot_ ? hot_.get() : cold_.get(); }
+    void Settle();
+    void SkipHotKeys();
+
+    std::shared_ptr<SegmentGroup> group_;
+    Segment** segments_;
+    std::unique_ptr<MemTableTraverseIterator> hot_;
+    std::unique_ptr<TraverseIterator> cold_;
+    bool hot_phase_;
+    // the key of the memory table read in the hot phase
+    std::string pk_;
+    bool hot_on_pk_;
+    bool cold_on_pk_;
+    bool use_hot_;
 };
 
 class MemTable : public Table {
@@ -178,6 +319,15 @@ class MemTable : public Table {
 
     ::hybridse::vm::WindowIterator* NewWindowIterator(uint32_t index);
 
+    // look up the entries of `keys` in index `index` at once, the lookups in a segment are
+    // interleaved. entries[i] is NULL if keys[i] is not found, the others are held by `ticket`.
+    // return false with a cold tier, whose rows are not in the entries
+    bool GetKeyEntries(uint32_t index, const std::vector<std::string>& keys, Ticket& ticket,  // NOLINT
+                       std::vector<KeyEntry*>* entries);
+
+    // the window of an entry got by GetKeyEntries
+    ::hybridse::vm::RowIterator* NewWindowIterator(uint32_t index, KeyEntry* entry);
+
     // release all memory allocated
     uint64_t Release();
 
@@ -197,10 +347,32 @@ class MemTable : public Table {
 
     uint64_t GetRecordCnt() const override { return record_cnt_.load(std::memory_order_relaxed); }
 
-    inline uint32_t GetSegCnt() const { return seg_cnt_; }
+    // the version grows after every write of the rows, including the deletes and the gc. the
+    // versions of different tables in a process never overlap. the writes are counted by the
+    // segments under their own locks, and summed up here
+    uint64_t GetWriteVersion() const;
+
+    inline uint32_t GetSegCnt() const { return cur_group_.load(std::memory_order_acquire)->seg_cnt; }
+
+    // the segment of `pk` in every index
+    uint32_t GetSegIdx(const std::string& pk) const;
+
+    // split every segment into seg_cnt / GetSegCnt() segments by rehashing the keys. seg_cnt should
+    // be a multiple of the current count. writers wait for the split, while readers go on reading
+    // the old segments. it should not run with SchedGc
+    bool SplitSegments(uint32_t seg_cnt);
+
+    // the puts and the sampled gets of the segments of an index
+    bool GetSegAccessCnt(uint32_t idx, std::vector<uint64_t>* put_cnts, std::vector<uint64_t>* get_cnts);
+
+    // the estimated hottest keys of an index and their accesses
+    bool GetHotKeys(uint32_t idx, std::vector<std::pair<std::string, uint64_t>>* hot_keys);
 
     inline void SetExpire(bool is_expire) { enable_gc_.store(is_expire, std::memory_order_relaxed); }
 
+    // rows are copied into `arena` afterwards, it should be set before the table is written
+    inline void SetNumaArena(std::shared_ptr<::openmldb::base::NumaArena> arena) { numa_arena_ = arena; }
+
     uint64_t GetExpireTime(const TTLSt& ttl_st) override;
 
     bool IsExpire(const ::openmldb::api::LogEntry& entry) override;
@@ -211,26 +383,80 @@ class MemTable : public Table {
 
     inline void RecordCntIncr(uint32_t cnt) { record_cnt_.fetch_add(cnt, std::memory_order_relaxed); }
 
+    // for the changes not counted by the segments: the gc, the indexes and the cold rows
+    inline void BumpWriteVersion() { write_version_.fetch_add(1, std::memory_order_release); }
+
     inline uint32_t GetKeyEntryHeight() const { return key_entry_max_height_; }
 
+    // NULL if the rows are not encoded by dictionaries
+    inline const RowDict* GetRowDict() const { return row_dict_.get(); }
+
+    // the rows older than cold_age of the table meta are moved to `cold_table` by the gc, and the
+    // reads merge both tiers. it should be set before Init, with the same schema and indexes
+    inline void SetColdTable(std::shared_ptr<Table> cold_table) { cold_table_ = cold_table; }
+
+    // NULL without a cold tier
+    inline std::shared_ptr<Table> GetColdTable() const { return cold_table_; }
+
     bool DeleteIndex(const std::string& idx_name) override;
 
     bool AddIndex(const ::openmldb::common::ColumnKey& column_key);
 
  private:
+    // move the rows older than cold_age_ of every index to the cold tier
+    void MoveCold();
+
     bool CheckAbsolute(const TTLSt& ttl, uint64_t ts);
 
     bool CheckLatest(uint32_t index_id, const std::string& key, uint64_t ts);
 
+    // the segment of `pk` in inner index `real_idx` of the current group
+    inline Segment* GetSegment(uint32_t real_idx, const Slice& pk) const;
+
+    // the writes counted by the segments of `group` and the groups before it
+    static uint64_t GetWriteCnt(const SegmentGroup* group);
+
+    std::shared_ptr<SegmentGroup> GetSegmentGroup() {
+        std::lock_guard<::openmldb::base::SpinMutex> lock(group_mu_);
+        return segment_group_;
+    }
+
+    // split the segments if the load of a segment is much more than the others, and not
+    // because of a single hot key
+    void TrySplitSegments();
+
  private:
+    // the segment count of a new table
     uint32_t seg_cnt_;
-    std::vector<Segment**> segments_;
+    // the garbage of the segments is retired to the epoch of the table, so a reader only holds
+    // back the reclaim of the tables it reads. released after the segments
+    std::unique_ptr<::openmldb::base::EpochManager, void (*)(::openmldb::base::EpochManager*)> epoch_;
+    // the current group, point reads and writes use cur_group_ without the lock. a replaced group
+    // is kept for gc_deleted_pk_version_delta rounds of gc
+    ::openmldb::base::SpinMutex group_mu_;
+    std::shared_ptr<SegmentGroup> segment_group_;
+    std::atomic<SegmentGroup*> cur_group_;
+    std::vector<std::pair<uint64_t, std::shared_ptr<SegmentGroup>>> retired_groups_;
+    uint64_t gc_round_;
+    // serialize the splits and AddIndex
+    std::mutex split_mu_;
+    std::vector<std::shared_ptr<HotKeyTracker>> hot_key_trackers_;
+    // the puts of the segments at the last check of TrySplitSegments
+    std::vector<uint64_t> last_put_cnts_;
+    const SegmentGroup* last_group_;
     std::atomic<bool> enable_gc_;
     uint64_t ttl_offset_;
     std::atomic<uint64_t> record_cnt_;
     bool segment_released_;
     std::atomic<uint64_t> record_byte_size_;
+    std::atomic<uint64_t> write_version_;
     uint32_t key_entry_max_height_;
+    std::shared_ptr<::openmldb::base::NumaArena> numa_arena_;
+    // the dictionaries of the string columns, shared by the segments
+    std::unique_ptr<RowDict> row_dict_;
+    std::shared_ptr<Table> cold_table_;
+    // in ms
+    uint64_t cold_age_;
 };
 
 }  // namespace storage
@@ -23,6 +23,7 @@
 #include <snappy.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <set>
 #include <utility>
 
@@ -53,6 +54,7 @@ DECLARE_uint32(load_table_batch);
 DECLARE_uint32(load_table_thread_num);
 DECLARE_uint32(load_table_queue_size);
 DECLARE_string(snapshot_compression);
+DECLARE_uint32(snapshot_max_delta_cnt);
 
 namespace openmldb {
 namespace storage {
@@ -60,6 +62,7 @@ namespace storage {
 const std::string SNAPSHOT_SUBFIX = ".sdb";  // NOLINT
 const uint32_t KEY_NUM_DISPLAY = 1000000;    // NOLINT
 const std::string MANIFEST = "MANIFEST";     // NOLINT
+const std::string DELTA_SUBFIX = ".delta";   // NOLINT
 
 MemTableSnapshot::MemTableSnapshot(uint32_t tid, uint32_t pid, LogParts* log_part, const std::string& db_root_path)
     : Snapshot(tid, pid), log_part_(log_part), db_root_path_(db_root_path) {}
@@ -87,6 +90,9 @@ bool MemTableSnapshot::Recover(std::shared_ptr<Table> table, uint64_t& latest_of
     }
     if (ret == 0) {
         RecoverFromSnapshot(manifest.name(), manifest.count(), table);
+        for (const auto& delta : manifest.deltas()) {
+            RecoverFromSnapshot(delta.name(), delta.count(), table, true);
+        }
         latest_offset = manifest.offset();
         offset_ = latest_offset;
     }
@@ -94,11 +100,11 @@ bool MemTableSnapshot::Recover(std::shared_ptr<Table> table, uint64_t& latest_of
 }
 
 void MemTableSnapshot::RecoverFromSnapshot(const std::string& snapshot_name, uint64_t expect_cnt,
-                                           std::shared_ptr<Table> table) {
+                                           std::shared_ptr<Table> table, bool is_delta) {
     std::string full_path = snapshot_path_ + "/" + snapshot_name;
     std::atomic<uint64_t> g_succ_cnt(0);
     std::atomic<uint64_t> g_failed_cnt(0);
-    RecoverSingleSnapshot(full_path, table, &g_succ_cnt, &g_failed_cnt);
+    RecoverSingleSnapshot(full_path, table, &g_succ_cnt, &g_failed_cnt, is_delta);
     PDLOG(INFO, "[Recover] progress done stat: success count %lu, failed count %lu",
           g_succ_cnt.load(std::memory_order_relaxed), g_failed_cnt.load(std::memory_order_relaxed));
     if (g_succ_cnt.load(std::memory_order_relaxed) != expect_cnt) {
@@ -108,7 +114,8 @@ void MemTableSnapshot::RecoverFromSnapshot(const std::string& snapshot_name, uin
 }
 
 void MemTableSnapshot::RecoverSingleSnapshot(const std::string& path, std::shared_ptr<Table> table,
-                                             std::atomic<uint64_t>* g_succ_cnt, std::atomic<uint64_t>* g_failed_cnt) {
+                                             std::atomic<uint64_t>* g_succ_cnt, std::atomic<uint64_t>* g_failed_cnt,
+                                             bool is_delta) {
     ::openmldb::base::TaskPool load_pool_(FLAGS_load_table_thread_num, FLAGS_load_table_batch);
     std::atomic<uint64_t> succ_cnt, failed_cnt;
     succ_cnt = failed_cnt = 0;
@@ -131,6 +138,7 @@ void MemTableSnapshot::RecoverSingleSnapshot(const std::string& path, std::share
         uint64_t consumed = ::baidu::common::timer::now_time();
         std::vector<std::string*> recordPtr;
         recordPtr.reserve(FLAGS_load_table_batch);
+        RecoverProgressBatch progress(progress_.get());
 
         while (true) {
             buffer.clear();
@@ -152,6 +160,18 @@ void MemTableSnapshot::RecoverSingleSnapshot(const std::string& path, std::share
                 failed_cnt.fetch_add(1, std::memory_order_relaxed);
                 continue;
             }
+            progress.Consume(record.size());
+            if (is_delta) {
+                // the puts of a delta before a tombstone do not have its key, so the tombstone
+                // only has to be applied after the snapshot and deltas before
+                ::openmldb::api::LogEntry entry;
+                if (entry.ParseFromArray(record.data(), record.size()) && entry.has_method_type() &&
+                    entry.method_type() == ::openmldb::api::MethodType::kDelete) {
+                    table->Delete(entry.dimensions(0).key(), entry.dimensions(0).idx());
+                    succ_cnt.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+            }
             std::string* sp = new std::string(record.data(), record.size());
             recordPtr.push_back(sp);
             if (recordPtr.size() >= FLAGS_load_table_batch) {
@@ -199,26 +219,45 @@ void MemTableSnapshot::Put(std::string& path, std::shared_ptr<Table>& table, std
 int MemTableSnapshot::TTLSnapshot(std::shared_ptr<Table> table, const ::openmldb::api::Manifest& manifest,
                                   WriteHandle* wh, uint64_t& count, uint64_t& expired_key_num,
                                   uint64_t& deleted_key_num) {
-    std::string full_path = snapshot_path_ + manifest.name();
+    std::set<uint32_t> deleted_index;
+    for (const auto& it : table->GetAllIndex()) {
+        if (it->GetStatus() != ::openmldb::storage::IndexStatus::kReady) {
+            deleted_index.insert(it->GetId());
+        }
+    }
+    if (TTLSnapshotFile(table, manifest.name(), manifest.count(), deleted_index, wh, count, expired_key_num,
+                        deleted_key_num) < 0) {
+        return -1;
+    }
+    for (const auto& delta : manifest.deltas()) {
+        if (TTLSnapshotFile(table, delta.name(), delta.count(), deleted_index, wh, count, expired_key_num,
+                            deleted_key_num) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int MemTableSnapshot::TTLSnapshotFile(std::shared_ptr<Table> table, const std::string& name, uint64_t expect_cnt,
+                                      const std::set<uint32_t>& deleted_index, WriteHandle* wh, uint64_t& count,
+                                      uint64_t& expired_key_num, uint64_t& deleted_key_num) {
+    std::string full_path = snapshot_path_ + name;
     FILE* fd = fopen(full_path.c_str(), "rb");
     if (fd == NULL) {
         PDLOG(WARNING, "fail to open path %s for error %s", full_path.c_str(), strerror(errno));
         return -1;
     }
     bool compressed = IsCompressed(full_path);
-    ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFile(manifest.name(), fd);
+    ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFile(name, fd);
     ::openmldb::log::Reader reader(seq_file, NULL, false, 0, compressed);
 
     std::string buffer;
     std::string tmp_buf;
     ::openmldb::api::LogEntry entry;
     bool has_error = false;
-    std::set<uint32_t> deleted_index;
-    for (const auto& it : table->GetAllIndex()) {
-        if (it->GetStatus() != ::openmldb::storage::IndexStatus::kReady) {
-            deleted_index.insert(it->GetId());
-        }
-    }
+    const uint64_t start_cnt = count + expired_key_num + deleted_key_num;
+    // the tombstones of deltas are applied by RemoveDeletedKey
+    uint64_t tombstone_cnt = 0;
     while (true) {
         ::openmldb::base::Slice record;
         ::openmldb::log::Status status = reader.ReadRecord(&record, &buffer);
@@ -237,6 +276,10 @@ int MemTableSnapshot::TTLSnapshot(std::shared_ptr<Table> table, const ::openmldb
             has_error = true;
             break;
         }
+        if (entry.has_method_type() && entry.method_type() == ::openmldb::api::MethodType::kDelete) {
+            tombstone_cnt++;
+            continue;
+        }
         int ret = RemoveDeletedKey(entry, deleted_index, &tmp_buf);
         if (ret == 1) {
             deleted_key_num++;
@@ -255,25 +298,64 @@ int MemTableSnapshot::TTLSnapshot(std::shared_ptr<Table> table, const ::openmldb
             break;
         }
         if ((count + expired_key_num + deleted_key_num) % KEY_NUM_DISPLAY == 0) {
-            PDLOG(INFO, "tackled key num[%lu] total[%lu]", count + expired_key_num, manifest.count());
+            PDLOG(INFO, "tackled key num[%lu] total[%lu]", count + expired_key_num, expect_cnt);
         }
         count++;
     }
     delete seq_file;
-    if (expired_key_num + count + deleted_key_num != manifest.count()) {
+    if (expired_key_num + count + deleted_key_num - start_cnt + tombstone_cnt != expect_cnt) {
         PDLOG(WARNING,
-              "key num not match! total key num[%lu] load key num[%lu] ttl key "
+              "key num not match! snapshot[%s] total key num[%lu] load key num[%lu] ttl key "
               "num[%lu]",
-              manifest.count(), count, expired_key_num);
+              name.c_str(), expect_cnt, count, expired_key_num);
         has_error = true;
     }
     if (has_error) {
         return -1;
     }
-    PDLOG(INFO, "load snapshot success. load key num[%lu] ttl key num[%lu]", count, expired_key_num);
+    PDLOG(INFO, "load snapshot %s success. load key num[%lu] ttl key num[%lu]", name.c_str(), count,
+          expired_key_num);
     return 0;
 }
 
+bool MemTableSnapshot::CollectDeletedKeyFromDeltas(const ::openmldb::api::Manifest& manifest) {
+    for (const auto& delta : manifest.deltas()) {
+        std::string full_path = snapshot_path_ + delta.name();
+        FILE* fd = fopen(full_path.c_str(), "rb");
+        if (fd == NULL) {
+            PDLOG(WARNING, "fail to open path %s for error %s", full_path.c_str(), strerror(errno));
+            return false;
+        }
+        ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFile(delta.name(), fd);
+        ::openmldb::log::Reader reader(seq_file, NULL, false, 0, IsCompressed(full_path));
+        std::string buffer;
+        ::openmldb::api::LogEntry entry;
+        bool has_error = false;
+        while (true) {
+            ::openmldb::base::Slice record;
+            ::openmldb::log::Status status = reader.ReadRecord(&record, &buffer);
+            if (status.IsEof()) {
+                break;
+            }
+            if (!status.ok() || !entry.ParseFromString(record.ToString())) {
+                PDLOG(WARNING, "fail to read record of %s for tid %u, pid %u", delta.name().c_str(), tid_, pid_);
+                has_error = true;
+                break;
+            }
+            if (entry.has_method_type() && entry.method_type() == ::openmldb::api::MethodType::kDelete) {
+                std::string combined_key = entry.dimensions(0).key() + "|" + std::to_string(entry.dimensions(0).idx());
+                uint64_t& offset = deleted_keys_[combined_key];
+                offset = std::max(offset, entry.log_index());
+            }
+        }
+        delete seq_file;
+        if (has_error) {
+            return false;
+        }
+    }
+    return true;
+}
+
 uint64_t MemTableSnapshot::CollectDeletedKey(uint64_t end_offset) {
     deleted_keys_.clear();
     ::openmldb::log::LogReader log_reader(log_part_, log_path_, false);
@@ -353,41 +435,62 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
         return -1;
     }
     making_snapshot_.store(true, std::memory_order_release);
-    std::string now_time = ::openmldb::base::GetNowTime();
-    std::string snapshot_name = now_time.substr(0, now_time.length() - 2) + ".sdb";
-    if (FLAGS_snapshot_compression != "off") {
-        snapshot_name.append(".");
-        snapshot_name.append(FLAGS_snapshot_compression);
+    ::openmldb::api::Manifest manifest;
+    int ret = -1;
+    int result = GetLocalManifest(snapshot_path_ + MANIFEST, manifest);
+    if (result == 0 && static_cast<uint32_t>(manifest.deltas_size()) < FLAGS_snapshot_max_delta_cnt) {
+        ret = MakeDeltaSnapshot(table, &manifest, out_offset, end_offset);
+    } else if (result > 0) {
+        ret = MakeFullSnapshot(table, nullptr, out_offset, end_offset, term);
+    } else if (result == 0) {
+        // compact the snapshot and its deltas
+        ret = MakeFullSnapshot(table, &manifest, out_offset, end_offset, term);
+    }
+    making_snapshot_.store(false, std::memory_order_release);
+    return ret;
+}
+
+int MemTableSnapshot::CompactDeltas(std::shared_ptr<Table> table) {
+    ::openmldb::api::Manifest manifest;
+    int result = GetLocalManifest(snapshot_path_ + MANIFEST, manifest);
+    if (result < 0) {
+        return -1;
+    } else if (result > 0 || manifest.deltas_size() == 0) {
+        return 0;
     }
+    uint64_t out_offset = 0;
+    return MakeFullSnapshot(table, &manifest, out_offset, manifest.offset(), manifest.term());
+}
+
+int MemTableSnapshot::MakeFullSnapshot(std::shared_ptr<Table> table, const ::openmldb::api::Manifest* manifest,
+                                       uint64_t& out_offset, uint64_t end_offset, uint64_t term) {
+    std::string snapshot_name = GenSnapshotName();
     std::string snapshot_name_tmp = snapshot_name + ".tmp";
     std::string full_path = snapshot_path_ + snapshot_name;
     std::string tmp_file_path = snapshot_path_ + snapshot_name_tmp;
     FILE* fd = fopen(tmp_file_path.c_str(), "ab+");
     if (fd == NULL) {
         PDLOG(WARNING, "fail to create file %s", tmp_file_path.c_str());
-        making_snapshot_.store(false, std::memory_order_release);
         return -1;
     }
     uint64_t collected_offset = CollectDeletedKey(end_offset);
     uint64_t start_time = ::baidu::common::timer::now_time();
     WriteHandle* wh = new WriteHandle(FLAGS_snapshot_compression, snapshot_name_tmp, fd);
-    ::openmldb::api::Manifest manifest;
     bool has_error = false;
     uint64_t write_count = 0;
     uint64_t expired_key_num = 0;
     uint64_t deleted_key_num = 0;
     uint64_t last_term = term;
-    int result = GetLocalManifest(snapshot_path_ + MANIFEST, manifest);
-    if (result == 0) {
-        // filter old snapshot
-        if (TTLSnapshot(table, manifest, wh, write_count, expired_key_num, deleted_key_num) < 0) {
+    if (manifest != nullptr) {
+        // the tombstones in the deltas delete the keys of the snapshot and the deltas before them
+        if (!CollectDeletedKeyFromDeltas(*manifest)) {
+            has_error = true;
+        } else if (TTLSnapshot(table, *manifest, wh, write_count, expired_key_num, deleted_key_num) < 0) {
+            // filter old snapshot
             has_error = true;
         }
-        last_term = manifest.term();
+        last_term = manifest->term();
         DEBUGLOG("old manifest term is %lu", last_term);
-    } else if (result < 0) {
-        // parse manifest error
-        has_error = true;
     }
 
     // get deleted index
@@ -397,12 +500,137 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
             deleted_index.insert(it->GetId());
         }
     }
-    ::openmldb::log::LogReader log_reader(log_part_, log_path_, false);
-    log_reader.SetOffset(offset_);
     uint64_t cur_offset = offset_;
+    if (!has_error && !DumpBinlog(table, deleted_index, collected_offset, false, wh, &cur_offset, &last_term,
+                                  &write_count, &expired_key_num, &deleted_key_num)) {
+        has_error = true;
+    }
+    if (wh != NULL) {
+        wh->EndLog();
+        delete wh;
+        wh = NULL;
+    }
+    int ret = 0;
+    if (has_error) {
+        unlink(tmp_file_path.c_str());
+        ret = -1;
+    } else {
+        if (rename(tmp_file_path.c_str(), full_path.c_str()) == 0) {
+            if (GenManifest(snapshot_name, write_count, cur_offset, last_term) == 0) {
+                // delete old snapshot
+                if (manifest != nullptr) {
+                    if (manifest->has_name() && manifest->name() != snapshot_name) {
+                        DEBUGLOG("old snapshot[%s] has deleted", manifest->name().c_str());
+                        unlink((snapshot_path_ + manifest->name()).c_str());
+                    }
+                    for (const auto& delta : manifest->deltas()) {
+                        DEBUGLOG("old snapshot delta[%s] has deleted", delta.name().c_str());
+                        unlink((snapshot_path_ + delta.name()).c_str());
+                    }
+                }
+                uint64_t consumed = ::baidu::common::timer::now_time() - start_time;
+                PDLOG(INFO,
+                      "make snapshot[%s] success. update offset from %lu to %lu."
+                      "use %lu second. write key %lu expired key %lu deleted key "
+                      "%lu",
+                      snapshot_name.c_str(), offset_, cur_offset, consumed, write_count, expired_key_num,
+                      deleted_key_num);
+                offset_ = cur_offset;
+                out_offset = cur_offset;
+            } else {
+                PDLOG(WARNING, "GenManifest failed. delete snapshot file[%s]", full_path.c_str());
+                unlink(full_path.c_str());
+                ret = -1;
+            }
+        } else {
+            PDLOG(WARNING, "rename[%s] failed", snapshot_name.c_str());
+            unlink(tmp_file_path.c_str());
+            ret = -1;
+        }
+    }
+    deleted_keys_.clear();
+    return ret;
+}
+
+int MemTableSnapshot::MakeDeltaSnapshot(std::shared_ptr<Table> table, ::openmldb::api::Manifest* manifest,
+                                        uint64_t& out_offset, uint64_t end_offset) {
+    uint64_t collected_offset = CollectDeletedKey(end_offset);
+    if (collected_offset <= offset_) {
+        PDLOG(INFO, "no binlog after offset %lu, skip making delta. tid %u pid %u", offset_, tid_, pid_);
+        deleted_keys_.clear();
+        out_offset = offset_;
+        return 0;
+    }
+    // offsets only grow, so the first offset makes the name unique
+    std::string delta_name = GenSnapshotName();
+    delta_name.insert(delta_name.find(SNAPSHOT_SUBFIX), "_" + std::to_string(offset_ + 1) + DELTA_SUBFIX);
+    std::string delta_name_tmp = delta_name + ".tmp";
+    std::string full_path = snapshot_path_ + delta_name;
+    std::string tmp_file_path = snapshot_path_ + delta_name_tmp;
+    FILE* fd = fopen(tmp_file_path.c_str(), "ab+");
+    if (fd == NULL) {
+        PDLOG(WARNING, "fail to create file %s", tmp_file_path.c_str());
+        deleted_keys_.clear();
+        return -1;
+    }
+    uint64_t start_time = ::baidu::common::timer::now_time();
+    WriteHandle* wh = new WriteHandle(FLAGS_snapshot_compression, delta_name_tmp, fd);
+    std::set<uint32_t> deleted_index;
+    for (const auto& it : table->GetAllIndex()) {
+        if (it->GetStatus() == ::openmldb::storage::IndexStatus::kDeleted) {
+            deleted_index.insert(it->GetId());
+        }
+    }
+    uint64_t cur_offset = offset_;
+    uint64_t last_term = manifest->term();
+    uint64_t write_count = 0;
+    uint64_t expired_key_num = 0;
+    uint64_t deleted_key_num = 0;
+    bool has_error = !DumpBinlog(table, deleted_index, collected_offset, true, wh, &cur_offset, &last_term,
+                                 &write_count, &expired_key_num, &deleted_key_num);
+    wh->EndLog();
+    delete wh;
+    deleted_keys_.clear();
+    if (has_error) {
+        unlink(tmp_file_path.c_str());
+        return -1;
+    }
+    if (rename(tmp_file_path.c_str(), full_path.c_str()) != 0) {
+        PDLOG(WARNING, "rename[%s] failed", delta_name.c_str());
+        unlink(tmp_file_path.c_str());
+        return -1;
+    }
+    auto delta = manifest->add_deltas();
+    delta->set_name(delta_name);
+    delta->set_count(write_count);
+    delta->set_offset(cur_offset);
+    manifest->set_offset(cur_offset);
+    manifest->set_term(last_term);
+    if (GenManifest(*manifest) != 0) {
+        PDLOG(WARNING, "GenManifest failed. delete snapshot delta file[%s]", full_path.c_str());
+        unlink(full_path.c_str());
+        return -1;
+    }
+    uint64_t consumed = ::baidu::common::timer::now_time() - start_time;
+    PDLOG(INFO,
+          "make snapshot delta[%s] success. update offset from %lu to %lu. use %lu second. write record %lu "
+          "expired key %lu deleted key %lu, deltas %d. tid %u pid %u",
+          delta_name.c_str(), offset_, cur_offset, consumed, write_count, expired_key_num, deleted_key_num,
+          manifest->deltas_size(), tid_, pid_);
+    offset_ = cur_offset;
+    out_offset = cur_offset;
+    return 0;
+}
+
+bool MemTableSnapshot::DumpBinlog(std::shared_ptr<Table> table, const std::set<uint32_t>& deleted_index,
+                                  uint64_t collected_offset, bool write_tombstone, WriteHandle* wh,
+                                  uint64_t* cur_offset, uint64_t* last_term, uint64_t* write_count,
+                                  uint64_t* expired_key_num, uint64_t* deleted_key_num) {
+    ::openmldb::log::LogReader log_reader(log_part_, log_path_, false);
+    log_reader.SetOffset(*cur_offset);
     std::string buffer;
     std::string tmp_buf;
-    while (!has_error && cur_offset < collected_offset) {
+    while (*cur_offset < collected_offset) {
         buffer.clear();
         ::openmldb::base::Slice record;
         ::openmldb::log::Status status = log_reader.ReadNextRecord(&record, &buffer);
@@ -411,44 +639,45 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
             if (!entry.ParseFromString(record.ToString())) {
                 PDLOG(WARNING, "fail to parse LogEntry. record[%s] size[%ld]",
                       ::openmldb::base::DebugString(record.ToString()).c_str(), record.ToString().size());
-                has_error = true;
-                break;
+                return false;
             }
-            if (entry.log_index() <= cur_offset) {
+            if (entry.log_index() <= *cur_offset) {
                 continue;
             }
-            if (cur_offset + 1 != entry.log_index()) {
-                PDLOG(WARNING, "log missing expect offset %lu but %ld", cur_offset + 1, entry.log_index());
+            if (*cur_offset + 1 != entry.log_index()) {
+                PDLOG(WARNING, "log missing expect offset %lu but %ld", *cur_offset + 1, entry.log_index());
                 continue;
             }
-            cur_offset = entry.log_index();
+            *cur_offset = entry.log_index();
             if (entry.has_method_type() && entry.method_type() == ::openmldb::api::MethodType::kDelete) {
-                continue;
-            }
-            if (entry.has_term()) {
-                last_term = entry.term();
-            }
-            int ret = RemoveDeletedKey(entry, deleted_index, &tmp_buf);
-            if (ret == 1) {
-                deleted_key_num++;
-                continue;
-            } else if (ret == 2) {
-                record.reset(tmp_buf.data(), tmp_buf.size());
-            }
-            if (table->IsExpire(entry)) {
-                expired_key_num++;
-                continue;
+                if (!write_tombstone || entry.dimensions_size() == 0) {
+                    continue;
+                }
+            } else {
+                if (entry.has_term()) {
+                    *last_term = entry.term();
+                }
+                int ret = RemoveDeletedKey(entry, deleted_index, &tmp_buf);
+                if (ret == 1) {
+                    (*deleted_key_num)++;
+                    continue;
+                } else if (ret == 2) {
+                    record.reset(tmp_buf.data(), tmp_buf.size());
+                }
+                if (table->IsExpire(entry)) {
+                    (*expired_key_num)++;
+                    continue;
+                }
             }
-            ::openmldb::log::Status status = wh->Write(record);
+            status = wh->Write(record);
             if (!status.ok()) {
-                PDLOG(WARNING, "fail to write snapshot. path[%s] status[%s]", tmp_file_path.c_str(),
+                PDLOG(WARNING, "fail to write snapshot. tid[%u] pid[%u] status[%s]", tid_, pid_,
                       status.ToString().c_str());
-                has_error = true;
-                break;
+                return false;
             }
-            write_count++;
-            if ((write_count + expired_key_num + deleted_key_num) % KEY_NUM_DISPLAY == 0) {
-                PDLOG(INFO, "has write key num[%lu] expired key num[%lu]", write_count, expired_key_num);
+            (*write_count)++;
+            if ((*write_count + *expired_key_num + *deleted_key_num) % KEY_NUM_DISPLAY == 0) {
+                PDLOG(INFO, "has write key num[%lu] expired key num[%lu]", *write_count, *expired_key_num);
             }
         } else if (status.IsEof()) {
             continue;
@@ -461,57 +690,17 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
                 PDLOG(WARNING,
                       "read new binlog file. tid[%u] pid[%u] cur_log_index[%d] "
                       "end_log_index[%d] cur_offset[%lu]",
-                      tid_, pid_, cur_log_index, end_log_index, cur_offset);
+                      tid_, pid_, cur_log_index, end_log_index, *cur_offset);
                 continue;
             }
             DEBUGLOG("has read all record!");
             break;
         } else {
             PDLOG(WARNING, "fail to get record. status is %s", status.ToString().c_str());
-            has_error = true;
-            break;
-        }
-    }
-    if (wh != NULL) {
-        wh->EndLog();
-        delete wh;
-        wh = NULL;
-    }
-    int ret = 0;
-    if (has_error) {
-        unlink(tmp_file_path.c_str());
-        ret = -1;
-    } else {
-        if (rename(tmp_file_path.c_str(), full_path.c_str()) == 0) {
-            if (GenManifest(snapshot_name, write_count, cur_offset, last_term) == 0) {
-                // delete old snapshot
-                if (manifest.has_name() && manifest.name() != snapshot_name) {
-                    DEBUGLOG("old snapshot[%s] has deleted", manifest.name().c_str());
-                    unlink((snapshot_path_ + manifest.name()).c_str());
-                }
-                uint64_t consumed = ::baidu::common::timer::now_time() - start_time;
-                PDLOG(INFO,
-                      "make snapshot[%s] success. update offset from %lu to %lu."
-                      "use %lu second. write key %lu expired key %lu deleted key "
-                      "%lu",
-                      snapshot_name.c_str(), offset_, cur_offset, consumed, write_count, expired_key_num,
-                      deleted_key_num);
-                offset_ = cur_offset;
-                out_offset = cur_offset;
-            } else {
-                PDLOG(WARNING, "GenManifest failed. delete snapshot file[%s]", full_path.c_str());
-                unlink(full_path.c_str());
-                ret = -1;
-            }
-        } else {
-            PDLOG(WARNING, "rename[%s] failed", snapshot_name.c_str());
-            unlink(tmp_file_path.c_str());
-            ret = -1;
+            return false;
         }
     }
-    deleted_keys_.clear();
-    making_snapshot_.store(false, std::memory_order_release);
-    return ret;
+    return true;
 }
 
 int MemTableSnapshot::RemoveDeletedKey(const ::openmldb::api::LogEntry& entry, const std::set<uint32_t>& deleted_index,
@@ -1105,6 +1294,12 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table,
         PDLOG(INFO, "snapshot is doing now. tid %u, pid %u", tid, pid);
         return -1;
     }
+    // the index data is extracted from the snapshot and the binlog only
+    if (CompactDeltas(table) < 0) {
+        PDLOG(WARNING, "fail to compact snapshot deltas. tid %u, pid %u", tid, pid);
+        making_snapshot_.store(false, std::memory_order_release);
+        return -1;
+    }
     std::string snapshot_name = GenSnapshotName();
     std::string snapshot_name_tmp = snapshot_name + ".tmp";
     std::string full_path = snapshot_path_ + snapshot_name;
@@ -1197,6 +1392,12 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table, const ::ope
         PDLOG(INFO, "snapshot is doing now. tid %u, pid %u", tid, pid);
         return -1;
     }
+    // the index data is extracted from the snapshot and the binlog only
+    if (CompactDeltas(table) < 0) {
+        PDLOG(WARNING, "fail to compact snapshot deltas. tid %u, pid %u", tid, pid);
+        making_snapshot_.store(false, std::memory_order_release);
+        return -1;
+    }
     std::string now_time = ::openmldb::base::GetNowTime();
     std::string snapshot_name = now_time.substr(0, now_time.length() - 2) + ".sdb";
     if (FLAGS_snapshot_compression != "off") {
@@ -1614,6 +1815,12 @@ bool MemTableSnapshot::DumpIndexData(std::shared_ptr<Table> table, const ::openm
         PDLOG(INFO, "snapshot is doing now. tid %u, pid %u", tid, pid);
         return false;
     }
+    // the index data is extracted from the snapshot and the binlog only
+    if (CompactDeltas(table) < 0) {
+        PDLOG(WARNING, "fail to compact snapshot deltas. tid %u, pid %u", tid, pid);
+        making_snapshot_.store(false, std::memory_order_release);
+        return false;
+    }
     std::map<std::string, uint32_t> column_desc_map;
     auto table_meta = table->GetTableMeta();
     for (int32_t i = 0; i < table_meta->column_desc_size(); ++i) {
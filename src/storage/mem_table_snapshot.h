@@ -50,13 +50,21 @@ class MemTableSnapshot : public Snapshot {
 
     bool Recover(std::shared_ptr<Table> table, uint64_t& latest_offset) override;
 
-    void RecoverFromSnapshot(const std::string& snapshot_name, uint64_t expect_cnt, std::shared_ptr<Table> table);
+    // `is_delta` if the file is a delta with tombstones
+    void RecoverFromSnapshot(const std::string& snapshot_name, uint64_t expect_cnt, std::shared_ptr<Table> table,
+                             bool is_delta = false);
 
+    // make a delta of the binlog after the last snapshot, or rewrite the snapshot, its deltas and
+    // the binlog into a new snapshot once the deltas reach FLAGS_snapshot_max_delta_cnt
     int MakeSnapshot(std::shared_ptr<Table> table,
                      uint64_t& out_offset,  // NOLINT
                      uint64_t end_offset,
                      uint64_t term = 0) override;
 
+    // merge the deltas into the snapshot without the binlog after them
+    int CompactDeltas(std::shared_ptr<Table> table);
+
+    // write the unexpired records of the snapshot and deltas of `manifest`
     int TTLSnapshot(std::shared_ptr<Table> table, const ::openmldb::api::Manifest& manifest, WriteHandle* wh,
                     uint64_t& count, uint64_t& expired_key_num,  // NOLINT
                     uint64_t& deleted_key_num);                  // NOLINT
@@ -118,10 +126,34 @@ class MemTableSnapshot : public Snapshot {
  private:
     // load single snapshot to table
     void RecoverSingleSnapshot(const std::string& path, std::shared_ptr<Table> table, std::atomic<uint64_t>* g_succ_cnt,
-                               std::atomic<uint64_t>* g_failed_cnt);
+                               std::atomic<uint64_t>* g_failed_cnt, bool is_delta);
+
+    // rewrite the snapshot of `manifest`, its deltas and the binlog into a new snapshot.
+    // `manifest` is nullptr if there is no snapshot yet
+    int MakeFullSnapshot(std::shared_ptr<Table> table, const ::openmldb::api::Manifest* manifest,
+                         uint64_t& out_offset,  // NOLINT
+                         uint64_t end_offset, uint64_t term);
+
+    // write the binlog after the snapshot and deltas of `manifest` into a new delta
+    int MakeDeltaSnapshot(std::shared_ptr<Table> table, ::openmldb::api::Manifest* manifest,
+                          uint64_t& out_offset,  // NOLINT
+                          uint64_t end_offset);
+
+    int TTLSnapshotFile(std::shared_ptr<Table> table, const std::string& name, uint64_t expect_cnt,
+                        const std::set<uint32_t>& deleted_index, WriteHandle* wh,
+                        uint64_t& count, uint64_t& expired_key_num,  // NOLINT
+                        uint64_t& deleted_key_num);                  // NOLINT
+
+    // write the binlog from `cur_offset` to `collected_offset`, with the deletes as tombstones if `write_tombstone`
+    bool DumpBinlog(std::shared_ptr<Table> table, const std::set<uint32_t>& deleted_index, uint64_t collected_offset,
+                    bool write_tombstone, WriteHandle* wh, uint64_t* cur_offset, uint64_t* last_term,
+                    uint64_t* write_count, uint64_t* expired_key_num, uint64_t* deleted_key_num);
 
     uint64_t CollectDeletedKey(uint64_t end_offset);
 
+    // add the tombstones of the deltas to deleted_keys_
+    bool CollectDeletedKeyFromDeltas(const ::openmldb::api::Manifest& manifest);
+
     int DecodeData(std::shared_ptr<Table> table, const openmldb::api::LogEntry& entry, uint32_t maxIdx,
                    std::vector<std::string>& row);  // NOLINT
 
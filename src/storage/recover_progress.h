@@ -0,0 +1,111 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+
+#include "base/rate_limiter.h"
+
+namespace openmldb {
+namespace storage {
+
+// bytes read from snapshot and binlog while loading one partition. reads are
+// throttled by the limiter shared by all loading partitions of a tablet
+class RecoverProgress {
+ public:
+    RecoverProgress(uint64_t total_bytes, ::openmldb::base::RateLimiter* limiter)
+        : total_bytes_(total_bytes), read_bytes_(0), start_time_(0), limiter_(limiter) {}
+    ~RecoverProgress() {}
+
+    void Start() { start_time_.store(NowMs(), std::memory_order_relaxed); }
+
+    void Consume(uint64_t bytes) {
+        if (limiter_ != nullptr) {
+            limiter_->Acquire(bytes);
+        }
+        read_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    uint64_t GetTotalBytes() const { return total_bytes_; }
+
+    // total bytes is estimated from file sizes, never report more than it
+    uint64_t GetReadBytes() const {
+        uint64_t read_bytes = read_bytes_.load(std::memory_order_relaxed);
+        return read_bytes < total_bytes_ ? read_bytes : total_bytes_;
+    }
+
+    uint64_t GetElapsedMs() const {
+        uint64_t start_time = start_time_.load(std::memory_order_relaxed);
+        return start_time == 0 ? 0 : NowMs() - start_time;
+    }
+
+    // remaining bytes at the average speed so far, 0 if unknown
+    uint64_t GetEtaMs() const {
+        uint64_t read_bytes = GetReadBytes();
+        if (read_bytes == 0) {
+            return 0;
+        }
+        return static_cast<uint64_t>(static_cast<double>(GetElapsedMs()) * (total_bytes_ - read_bytes) / read_bytes);
+    }
+
+ private:
+    static uint64_t NowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    const uint64_t total_bytes_;
+    std::atomic<uint64_t> read_bytes_;
+    std::atomic<uint64_t> start_time_;
+    ::openmldb::base::RateLimiter* limiter_;
+};
+
+// bytes read by one loading thread, handed to the progress and the limiter a
+// block at a time instead of once per record. the rest is flushed on destruction
+class RecoverProgressBatch {
+ public:
+    static constexpr uint64_t kBatchBytes = 64 * 1024;
+
+    explicit RecoverProgressBatch(RecoverProgress* progress) : progress_(progress), bytes_(0) {}
+    ~RecoverProgressBatch() { Flush(); }
+
+    void Consume(uint64_t bytes) {
+        if (progress_ == nullptr) {
+            return;
+        }
+        bytes_ += bytes;
+        if (bytes_ >= kBatchBytes) {
+            Flush();
+        }
+    }
+
+    void Flush() {
+        if (progress_ != nullptr && bytes_ > 0) {
+            progress_->Consume(bytes_);
+            bytes_ = 0;
+        }
+    }
+
+ private:
+    RecoverProgress* progress_;
+    uint64_t bytes_;
+};
+
+}  // namespace storage
+}  // namespace openmldb
@@ -0,0 +1,237 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/row_dict.h"
+
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <mutex>  // NOLINT
+
+namespace openmldb {
+namespace storage {
+
+// the same as the row codec
+static inline uint32_t GetAddrLength(uint32_t size) {
+    if (size <= UINT8_MAX) {
+        return 1;
+    } else if (size <= UINT16_MAX) {
+        return 2;
+    } else if (size <= ::openmldb::codec::UINT24_MAX) {
+        return 3;
+    }
+    return 4;
+}
+
+static inline void PutVarint(uint32_t value, std::string* dst) {
+    while (value >= 0x80) {
+        dst->push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    dst->push_back(static_cast<char>(value));
+}
+
+static inline const char* GetVarint(const char* p, const char* limit, uint32_t* value) {
+    uint32_t result = 0;
+    for (uint32_t shift = 0; shift <= 28 && p < limit; shift += 7) {
+        uint32_t byte = static_cast<uint8_t>(*p++);
+        result |= (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+RowDict::RowDict(const ::openmldb::codec::Schema& schema, uint32_t max_dict_size)
+    : max_dict_size_(max_dict_size),
+      valid_(false),
+      str_field_cnt_(0),
+      str_field_start_offset_(0),
+      saved_byte_size_(0),
+      dict_byte_size_(0),
+      sampled_cnt_(0),
+      sampled_ns_(0) {
+    if (schema.size() == 0) {
+        return;
+    }
+    ::openmldb::codec::RowView view(schema);
+    valid_ = view.IsValid();
+    str_field_cnt_ = view.GetStrFieldCnt();
+    str_field_start_offset_ = view.GetStrFieldStartOffset();
+    for (uint32_t i = 0; i < str_field_cnt_; i++) {
+        dicts_.emplace_back(new Dict());
+        dicts_.back()->chunks.resize((max_dict_size_ + kChunkSize - 1) / kChunkSize);
+    }
+}
+
+uint32_t RowDict::GetId(Dict* dict, const char* value, uint32_t size) {
+    std::string_view key(value, size);
+    std::lock_guard<::openmldb::base::SpinMutex> lock(dict->mu);
+    auto it = dict->ids.find(key);
+    if (it != dict->ids.end()) {
+        return it->second + 1;
+    }
+    uint32_t id = dict->size.load(std::memory_order_relaxed);
+    if (id >= max_dict_size_) {
+        return 0;
+    }
+    auto& chunk = dict->chunks[id / kChunkSize];
+    if (!chunk) {
+        chunk.reset(new std::string[kChunkSize]);
+    }
+    std::string& dict_value = chunk[id % kChunkSize];
+    dict_value.assign(value, size);
+    dict->ids.emplace(std::string_view(dict_value), id);
+    dict->size.store(id + 1, std::memory_order_release);
+    // the value, and about the node of the map
+    dict_byte_size_.fetch_add(sizeof(std::string) + size + 32, std::memory_order_relaxed);
+    return id + 1;
+}
+
+bool RowDict::Encode(const char* row, uint32_t size, std::string* encoded) {
+    if (!valid_ || str_field_cnt_ == 0 || size <= ::openmldb::codec::HEADER_LENGTH || row[0] != 1 ||
+        ::openmldb::codec::RowView::GetSchemaVersion(reinterpret_cast<const int8_t*>(row)) != 1 ||
+        GetRowSize(row) != size) {
+        return false;
+    }
+    uint32_t addr_length = GetAddrLength(size);
+    uint32_t str_start = str_field_start_offset_ + addr_length * str_field_cnt_;
+    if (str_start > size) {
+        return false;
+    }
+    const int8_t* input = reinterpret_cast<const int8_t*>(row);
+    static thread_local std::vector<uint32_t> ids;
+    static thread_local std::vector<std::string_view> values;
+    ids.resize(str_field_cnt_);
+    values.resize(str_field_cnt_);
+    uint32_t hit_size = 0;
+    for (uint32_t i = 0; i < str_field_cnt_; i++) {
+        int8_t* data = NULL;
+        uint32_t length = 0;
+        uint32_t next = i + 1 < str_field_cnt_ ? i + 1 : 0;
+        if (::openmldb::codec::v1::GetStrField(input, i, next, str_field_start_offset_, addr_length, &data,
+                                               &length) != 0) {
+            return false;
+        }
+        uint32_t offset = data - input;
+        if (offset < str_start || offset > size || length > size - offset) {
+            return false;
+        }
+        values[i] = std::string_view(reinterpret_cast<const char*>(data), length);
+        ids[i] = 0;
+        if (length > 0 && length <= kMaxValueSize) {
+            ids[i] = GetId(dicts_[i].get(), values[i].data(), length);
+            if (ids[i] > 0) {
+                hit_size += length;
+            }
+        }
+    }
+    // the ids take a byte at least for each string
+    if (hit_size <= str_field_cnt_) {
+        return false;
+    }
+    encoded->clear();
+    encoded->append(row, str_start);
+    for (uint32_t i = 0; i < str_field_cnt_; i++) {
+        PutVarint(ids[i], encoded);
+    }
+    for (uint32_t i = 0; i < str_field_cnt_; i++) {
+        if (ids[i] == 0) {
+            encoded->append(values[i].data(), values[i].size());
+        }
+    }
+    if (encoded->size() >= size) {
+        return false;
+    }
+    saved_byte_size_.fetch_add(size - encoded->size(), std::memory_order_relaxed);
+    return true;
+}
+
+bool RowDict::Decode(const char* data, uint32_t size, char* row) const {
+    static thread_local uint32_t tick = 0;
+    bool timed = ++tick >= kDecodeSampleRate;
+    std::chrono::steady_clock::time_point start;
+    if (timed) {
+        tick = 0;
+        start = std::chrono::steady_clock::now();
+    }
+    uint32_t row_size = GetRowSize(data);
+    uint32_t addr_length = GetAddrLength(row_size);
+    uint32_t str_start = str_field_start_offset_ + addr_length * str_field_cnt_;
+    if (str_start > size) {
+        return false;
+    }
+    memcpy(row, data, str_start);
+    const char* limit = data + size;
+    const char* ids = data + str_start;
+    // skip the ids to the inline strings
+    const char* inline_value = ids;
+    for (uint32_t i = 0; i < str_field_cnt_; i++) {
+        uint32_t id = 0;
+        inline_value = GetVarint(inline_value, limit, &id);
+        if (inline_value == NULL) {
+            return false;
+        }
+    }
+    const int8_t* output = reinterpret_cast<const int8_t*>(row);
+    for (uint32_t i = 0; i < str_field_cnt_; i++) {
+        uint32_t id = 0;
+        ids = GetVarint(ids, limit, &id);
+        int8_t* field = NULL;
+        uint32_t length = 0;
+        uint32_t next = i + 1 < str_field_cnt_ ? i + 1 : 0;
+        // the offsets of the fields are copied already
+        ::openmldb::codec::v1::GetStrField(output, i, next, str_field_start_offset_, addr_length, &field, &length);
+        uint32_t offset = field - output;
+        if (offset < str_start || offset > row_size || length > row_size - offset) {
+            return false;
+        }
+        char* dst = row + offset;
+        if (id == 0) {
+            if (length > static_cast<uint32_t>(limit - inline_value)) {
+                return false;
+            }
+            memcpy(dst, inline_value, length);
+            inline_value += length;
+        } else {
+            const Dict* dict = dicts_[i].get();
+            if (id > dict->size.load(std::memory_order_acquire)) {
+                return false;
+            }
+            const std::string& value = dict->GetValue(id - 1);
+            if (value.size() != length) {
+                return false;
+            }
+            memcpy(dst, value.data(), length);
+        }
+    }
+    if (timed) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        sampled_cnt_.fetch_add(1, std::memory_order_relaxed);
+        sampled_ns_.fetch_add(ns.count(), std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void RowDict::GetDecodeStat(uint64_t* decode_cnt, uint64_t* ns_per_row) const {
+    uint64_t cnt = sampled_cnt_.load(std::memory_order_relaxed);
+    *decode_cnt = cnt * kDecodeSampleRate;
+    *ns_per_row = cnt == 0 ? 0 : sampled_ns_.load(std::memory_order_relaxed) / cnt;
+}
+
+}  // namespace storage
+}  // namespace openmldb
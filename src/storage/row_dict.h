@@ -0,0 +1,105 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_STORAGE_ROW_DICT_H_
+#define SRC_STORAGE_ROW_DICT_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "base/spinlock.h"
+#include "codec/codec.h"
+
+namespace openmldb {
+namespace storage {
+
+// RowDict encodes the string fields of the rows of a memory table by a dictionary of each string
+// column. an encoded row keeps the bytes of the row up to the strings, i.e. the header, the fixed
+// fields and the string offsets, followed by the varint dictionary id + 1 of each string field,
+// 0 for a string kept inline, and the inline strings. a column takes new values until its
+// dictionary is full, so the values of a low cardinality column are soon all in the dictionary
+class RowDict {
+ public:
+    // the longer strings are kept inline
+    static constexpr uint32_t kMaxValueSize = 255;
+    // one of the decodes is timed
+    static constexpr uint32_t kDecodeSampleRate = 64;
+
+    // the rows of the other schema versions are not encoded
+    RowDict(const ::openmldb::codec::Schema& schema, uint32_t max_dict_size);
+
+    RowDict(const RowDict&) = delete;
+    RowDict& operator=(const RowDict&) = delete;
+
+    // return false if the row is kept as it is, e.g. no string of it is found in the dictionaries
+    bool Encode(const char* row, uint32_t size, std::string* encoded);
+
+    // the size of the row decoded from `data`
+    static uint32_t GetRowSize(const char* data) {
+        return ::openmldb::codec::RowView::GetSize(reinterpret_cast<const int8_t*>(data));
+    }
+
+    // decode the encoded `data` of `size` bytes into `row` of GetRowSize(data) bytes
+    bool Decode(const char* data, uint32_t size, char* row) const;
+
+    // an encoded row of `size` bytes is freed
+    void Free(const char* data, uint32_t size) {
+        saved_byte_size_.fetch_sub(GetRowSize(data) - size, std::memory_order_relaxed);
+    }
+
+    // the bytes saved by the encoded rows which are not freed
+    uint64_t GetSavedByteSize() const { return saved_byte_size_.load(std::memory_order_relaxed); }
+    uint64_t GetDictByteSize() const { return dict_byte_size_.load(std::memory_order_relaxed); }
+    // the decodes and their average cost, estimated by the timed ones
+    void GetDecodeStat(uint64_t* decode_cnt, uint64_t* ns_per_row) const;
+
+ private:
+    static constexpr uint32_t kChunkSize = 256;
+
+    struct Dict {
+        ::openmldb::base::SpinMutex mu;
+        // the keys refer to the values
+        std::unordered_map<std::string_view, uint32_t> ids;
+        // the values by id, in chunks allocated on demand and never moved
+        std::vector<std::unique_ptr<std::string[]>> chunks;
+        // the values published to the decoders
+        std::atomic<uint32_t> size{0};
+
+        const std::string& GetValue(uint32_t id) const { return chunks[id / kChunkSize][id % kChunkSize]; }
+    };
+
+    // return 0 if the value is not in the dictionary and it is full, or the id + 1 of the value
+    uint32_t GetId(Dict* dict, const char* value, uint32_t size);
+
+    uint32_t max_dict_size_;
+    bool valid_;
+    uint32_t str_field_cnt_;
+    uint32_t str_field_start_offset_;
+    std::vector<std::unique_ptr<Dict>> dicts_;
+    std::atomic<uint64_t> saved_byte_size_;
+    std::atomic<uint64_t> dict_byte_size_;
+    mutable std::atomic<uint64_t> sampled_cnt_;
+    mutable std::atomic<uint64_t> sampled_ns_;
+};
+
+}  // namespace storage
+}  // namespace openmldb
+
+#endif  // SRC_STORAGE_ROW_DICT_H_
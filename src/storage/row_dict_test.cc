@@ -0,0 +1,127 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/row_dict.h"
+
+#include <string>
+#include <vector>
+
+#include "codec/row_codec.h"
+#include "codec/schema_codec.h"
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace storage {
+
+using ::openmldb::codec::SchemaCodec;
+
+class RowDictTest : public ::testing::Test {
+ public:
+    RowDictTest() {
+        SchemaCodec::SetColumnDesc(schema_.Add(), "card", ::openmldb::type::kString);
+        SchemaCodec::SetColumnDesc(schema_.Add(), "price", ::openmldb::type::kBigInt);
+        SchemaCodec::SetColumnDesc(schema_.Add(), "mcc", ::openmldb::type::kString);
+        SchemaCodec::SetColumnDesc(schema_.Add(), "city", ::openmldb::type::kString);
+    }
+
+    std::string EncodeRow(const std::vector<std::string>& values, uint32_t version = 1) {
+        std::string row;
+        EXPECT_TRUE(::openmldb::codec::RowCodec::EncodeRow(values, schema_, version, row).OK());
+        return row;
+    }
+
+    std::string Decode(const RowDict& dict, const std::string& encoded) {
+        std::string row(RowDict::GetRowSize(encoded.data()), '\0');
+        EXPECT_TRUE(dict.Decode(encoded.data(), encoded.size(), &row[0]));
+        return row;
+    }
+
+ protected:
+    ::openmldb::codec::Schema schema_;
+};
+
+TEST_F(RowDictTest, EncodeDecode) {
+    RowDict dict(schema_, 3);
+    std::vector<std::string> rows;
+    for (int i = 0; i < 100; i++) {
+        // a new mcc of each row fills its dictionary, and the long card is kept inline
+        std::string card = i % 2 == 0 ? std::string(300, 'c') : "card" + std::to_string(i % 3);
+        rows.push_back(EncodeRow({card, std::to_string(i), "mcc" + std::to_string(i), "beijing"}));
+    }
+    uint64_t saved = 0;
+    for (const auto& row : rows) {
+        std::string encoded;
+        ASSERT_TRUE(dict.Encode(row.data(), row.size(), &encoded));
+        ASSERT_LT(encoded.size(), row.size());
+        saved += row.size() - encoded.size();
+        ASSERT_EQ(row, Decode(dict, encoded));
+    }
+    ASSERT_EQ(saved, dict.GetSavedByteSize());
+    ASSERT_GT(dict.GetDictByteSize(), 0u);
+
+    // the dictionary of card is full, and the others are empty or too long
+    std::string row = EncodeRow({"new card", "1", "", std::string(300, 'b')});
+    std::string encoded;
+    ASSERT_FALSE(dict.Encode(row.data(), row.size(), &encoded));
+
+    encoded.clear();
+    row = EncodeRow({"card1", "1", "", "beijing"});
+    ASSERT_TRUE(dict.Encode(row.data(), row.size(), &encoded));
+    ASSERT_EQ(row, Decode(dict, encoded));
+    dict.Free(encoded.data(), encoded.size());
+    ASSERT_EQ(saved, dict.GetSavedByteSize());
+
+    uint64_t decode_cnt = 0;
+    uint64_t ns_per_row = 0;
+    dict.GetDecodeStat(&decode_cnt, &ns_per_row);
+    ASSERT_EQ(RowDict::kDecodeSampleRate, decode_cnt);
+}
+
+TEST_F(RowDictTest, OtherVersion) {
+    RowDict dict(schema_, 16);
+    std::string row = EncodeRow({"card", "1", "mcc", "beijing"}, 2);
+    std::string encoded;
+    ASSERT_FALSE(dict.Encode(row.data(), row.size(), &encoded));
+    ASSERT_EQ(0u, dict.GetDictByteSize());
+
+    ::openmldb::codec::Schema schema;
+    SchemaCodec::SetColumnDesc(schema.Add(), "price", ::openmldb::type::kBigInt);
+    RowDict no_str_dict(schema, 16);
+    row.clear();
+    ASSERT_TRUE(::openmldb::codec::RowCodec::EncodeRow({"1"}, schema, 1, row).OK());
+    ASSERT_FALSE(no_str_dict.Encode(row.data(), row.size(), &encoded));
+}
+
+TEST_F(RowDictTest, InvalidData) {
+    RowDict dict(schema_, 16);
+    std::string row = EncodeRow({"card", "1", "mcc", "beijing"});
+    std::string encoded;
+    ASSERT_TRUE(dict.Encode(row.data(), row.size(), &encoded));
+    std::string decoded(RowDict::GetRowSize(encoded.data()), '\0');
+    // the ids are cut
+    ASSERT_FALSE(dict.Decode(encoded.data(), encoded.size() - 3, &decoded[0]));
+    // an id out of the dictionary
+    RowDict empty_dict(schema_, 16);
+    ASSERT_FALSE(empty_dict.Decode(encoded.data(), encoded.size(), &decoded[0]));
+}
+
+}  // namespace storage
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -17,8 +17,16 @@
 #include "storage/segment.h"
 
 #include <gflags/gflags.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/epoch.h"
 #include "base/glog_wapper.h"
+#include "base/hash.h"
 #include "base/strings.h"
 #include "common/timer.h"
 #include "storage/record.h"
@@ -26,11 +34,18 @@
 DECLARE_int32(gc_safe_offset);
 DECLARE_uint32(skiplist_max_height);
 DECLARE_uint32(gc_deleted_pk_version_delta);
+DECLARE_bool(gc_use_expire_index);
+DECLARE_uint32(gc_expire_bucket_ms);
+DECLARE_uint32(gc_slice_key_cnt);
+DECLARE_uint32(gc_slice_interval_us);
 
 namespace openmldb {
 namespace storage {
 
 static const SliceComparator scmp;
+// the gets of a thread are added to the segment ending a batch, which is a sample of the gets
+// without an atomic add on every get
+static constexpr uint32_t GET_CNT_BATCH = 16;
 Segment::Segment()
     : entries_(NULL),
       mu_(),
@@ -39,7 +54,16 @@ Segment::Segment()
       pk_cnt_(0),
       ts_cnt_(1),
       gc_version_(0),
-      ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000) {
+      ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000),
+      use_expire_index_(FLAGS_gc_use_expire_index),
+      expire_bucket_ms_(std::max(FLAGS_gc_expire_bucket_ms, 1u)),
+      put_cnt_(0),
+      get_cnt_(0),
+      write_cnt_(0),
+      retired_(false),
+      has_frozen_(false),
+      row_dict_(NULL),
+      epoch_(::openmldb::base::EpochManager::Default()) {
     entries_ = new KeyEntries((uint8_t)FLAGS_skiplist_max_height, 4, scmp);
     key_entry_max_height_ = (uint8_t)FLAGS_skiplist_max_height;
     entry_free_list_ = new KeyEntryNodeList(4, 4, tcmp);
@@ -54,7 +78,16 @@ Segment::Segment(uint8_t height)
       key_entry_max_height_(height),
       ts_cnt_(1),
       gc_version_(0),
-      ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000) {
+      ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000),
+      use_expire_index_(FLAGS_gc_use_expire_index),
+      expire_bucket_ms_(std::max(FLAGS_gc_expire_bucket_ms, 1u)),
+      put_cnt_(0),
+      get_cnt_(0),
+      write_cnt_(0),
+      retired_(false),
+      has_frozen_(false),
+      row_dict_(NULL),
+      epoch_(::openmldb::base::EpochManager::Default()) {
     entries_ = new KeyEntries((uint8_t)FLAGS_skiplist_max_height, 4, scmp);
     entry_free_list_ = new KeyEntryNodeList(4, 4, tcmp);
 }
@@ -68,7 +101,16 @@ Segment::Segment(uint8_t height, const std::vector<uint32_t>& ts_idx_vec)
       key_entry_max_height_(height),
       ts_cnt_(ts_idx_vec.size()),
       gc_version_(0),
-      ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000) {
+      ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000),
+      use_expire_index_(FLAGS_gc_use_expire_index),
+      expire_bucket_ms_(std::max(FLAGS_gc_expire_bucket_ms, 1u)),
+      put_cnt_(0),
+      get_cnt_(0),
+      write_cnt_(0),
+      retired_(false),
+      has_frozen_(false),
+      row_dict_(NULL),
+      epoch_(::openmldb::base::EpochManager::Default()) {
     entries_ = new KeyEntries((uint8_t)FLAGS_skiplist_max_height, 4, scmp);
     entry_free_list_ = new KeyEntryNodeList(4, 4, tcmp);
     for (uint32_t i = 0; i < ts_idx_vec.size(); i++) {
@@ -78,6 +120,10 @@ Segment::Segment(uint8_t height, const std::vector<uint32_t>& ts_idx_vec)
 }
 
 Segment::~Segment() {
+    if (IsRetired()) {
+        // the keys and entries are owned by the segments split from it
+        entries_->Clear();
+    }
     delete entries_;
     delete entry_free_list_;
 }
@@ -130,6 +176,10 @@ uint64_t Segment::Release() {
     delete f_it;
     entry_free_list_->Clear();
     idx_cnt_vec_.clear();
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        expire_index_.clear();
+    }
     return cnt;
 }
 
@@ -153,28 +203,45 @@ void Segment::ReleaseAndCount(uint64_t& gc_idx_cnt, uint64_t& gc_record_cnt, uin
     uint64_t cur_version = gc_version_.load(std::memory_order_relaxed);
     GcEntryFreeList(cur_version, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
     Release();
+    RetireGarbage();
 }
 
-void Segment::Put(const Slice& key, uint64_t time, const char* data, uint32_t size) {
+bool Segment::Put(const Slice& key, uint64_t time, const char* data, uint32_t size) {
     if (ts_cnt_ > 1) {
-        return;
+        return false;
     }
     auto* db = new DataBlock(1, data, size);
-    Put(key, time, db);
+    if (!Put(key, time, db)) {
+        delete db;
+        return false;
+    }
+    return true;
 }
 
-void Segment::Put(const Slice& key, uint64_t time, DataBlock* row) {
+bool Segment::Put(const Slice& key, uint64_t time, DataBlock* row) {
     if (ts_cnt_ > 1) {
-        return;
+        return false;
     }
     std::lock_guard<std::mutex> lock(mu_);
+    if (IsRetired()) {
+        return false;
+    }
     PutUnlock(key, time, row);
+    return true;
 }
 
 void Segment::PutUnlock(const Slice& key, uint64_t time, DataBlock* row) {
     void* entry = nullptr;
     uint32_t byte_size = 0;
     int ret = entries_->Get(key, entry);
+    // the oldest ts of the key before the put
+    uint64_t oldest = UINT64_MAX;
+    if (ret == 0 && entry != NULL) {
+        ((KeyEntry*)entry)->GetOldestTs(&oldest);  // NOLINT
+    }
+    if (use_expire_index_ && (oldest == UINT64_MAX || time / expire_bucket_ms_ < oldest / expire_bucket_ms_)) {
+        expire_index_[time / expire_bucket_ms_].emplace_back(key.data(), key.size());
+    }
     if (ret < 0 || entry == NULL) {
         char* pk = new char[key.size()];
         memcpy(pk, key.data(), key.size());
@@ -186,17 +253,49 @@ void Segment::PutUnlock(const Slice& key, uint64_t time, DataBlock* row) {
         pk_cnt_.fetch_add(1, std::memory_order_relaxed);
     }
     idx_cnt_.fetch_add(1, std::memory_order_relaxed);
-    uint8_t height = ((KeyEntry*)entry)->entries.Insert(time, row);  // NOLINT
-    ((KeyEntry*)entry)                                               // NOLINT
+    put_cnt_.fetch_add(1, std::memory_order_relaxed);
+    FrozenRows* frozen = ((KeyEntry*)entry)->frozen.load(std::memory_order_relaxed);  // NOLINT
+    if (frozen != NULL && time < frozen->boundary) {
+        PutFrozen((KeyEntry*)entry, frozen, time, row);  // NOLINT
+        byte_size += FROZEN_ROW_SIZE;
+    } else {
+        uint8_t height = ((KeyEntry*)entry)->entries.Insert(time, row);  // NOLINT
+        byte_size += GetRecordTsIdxSize(height);
+    }
+    ((KeyEntry*)entry)  // NOLINT
         ->count_.fetch_add(1, std::memory_order_relaxed);
-    byte_size += GetRecordTsIdxSize(height);
     idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
+    write_cnt_.fetch_add(1, std::memory_order_release);
+}
+
+void Segment::PutFrozen(KeyEntry* entry, FrozenRows* frozen, uint64_t time, DataBlock* row) {
+    // a late row, which is rare for the frozen rows are old. they are copied with it, before the rows
+    // at the same ts like the time entries
+    uint32_t cnt = frozen->GetSize();
+    uint32_t pos = frozen->LowerBound(time, cnt);
+    FrozenRows* rows = new FrozenRows(frozen->boundary, cnt + 1);
+    for (uint32_t i = 0; i < pos; i++) {
+        rows->Append(frozen->ts_vec[i], frozen->rows[i]);
+    }
+    rows->Append(time, row);
+    for (uint32_t i = pos; i < cnt; i++) {
+        rows->Append(frozen->ts_vec[i], frozen->rows[i]);
+    }
+    rows->cnt.store(cnt + 1, std::memory_order_relaxed);
+    entry->frozen.store(rows, std::memory_order_release);
+    // the writer retires the replaced rows under mu_, not into garbage_ which belongs to the gc
+    // thread. the epoch manager takes them under its own lock, and frees them once the readers
+    // which may still see them have left
+    epoch_->Retire([frozen] { delete frozen; });
 }
 
-void Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t time, DataBlock* row) {
+bool Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t time, DataBlock* row) {
     void* key_entry_or_list = nullptr;
     uint32_t byte_size = 0;
     std::lock_guard<std::mutex> lock(mu_);  // TODO(hw): need lock?
+    if (IsRetired()) {
+        return false;
+    }
     int ret = entries_->Get(key, key_entry_or_list);
     if (ts_cnt_ == 1) {
         PutUnlock(key, time, row);
@@ -213,6 +312,7 @@ void Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t
             uint8_t height = entries_->Insert(skey, entry_arr);
             byte_size += GetRecordPkMultiIdxSize(height, key.size(), key_entry_max_height_, ts_cnt_);
             pk_cnt_.fetch_add(1, std::memory_order_relaxed);
+            key_entry_or_list = entry_arr;
         }
         uint8_t height = ((KeyEntry**)key_entry_or_list)[key_entry_id]->entries.Insert(  // NOLINT
             time, row);
@@ -221,23 +321,30 @@ void Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t
         byte_size += GetRecordTsIdxSize(height);
         idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
         idx_cnt_vec_[key_entry_id]->fetch_add(1, std::memory_order_relaxed);
+        put_cnt_.fetch_add(1, std::memory_order_relaxed);
+        write_cnt_.fetch_add(1, std::memory_order_release);
     }
+    return true;
 }
 
-void Segment::Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, DataBlock* row) {
+bool Segment::Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, DataBlock* row) {
     uint32_t ts_size = ts_map.size();
     if (ts_size == 0) {
-        return;
+        return true;
     }
     if (ts_cnt_ == 1) {
         auto pos = ts_map.find(ts_idx_map_.begin()->first);
         if (pos != ts_map.end()) {
-            Put(key, pos->second, row);
+            return Put(key, pos->second, row);
         }
-        return;
+        return true;
     }
     void* entry_arr = NULL;
     std::lock_guard<std::mutex> lock(mu_);
+    if (IsRetired()) {
+        return false;
+    }
+    put_cnt_.fetch_add(1, std::memory_order_relaxed);
     for (const auto& kv : ts_map) {
         uint32_t byte_size = 0;
         auto pos = ts_idx_map_.find(kv.first);
@@ -268,17 +375,20 @@ void Segment::Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, D
         idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
         idx_cnt_vec_[pos->second]->fetch_add(1, std::memory_order_relaxed);
     }
+    write_cnt_.fetch_add(1, std::memory_order_release);
+    return true;
 }
 
 bool Segment::Get(const Slice& key, const uint64_t time, DataBlock** block) {
     if (block == NULL || ts_cnt_ > 1) {
         return false;
     }
+    CountGet();
     void* entry = NULL;
     if (entries_->Get(key, entry) < 0 || entry == NULL) {
         return false;
     }
-    *block = ((KeyEntry*)entry)->entries.Get(time);  // NOLINT
+    *block = ((KeyEntry*)entry)->Get(time);  // NOLINT
     return true;
 }
 
@@ -293,6 +403,7 @@ bool Segment::Get(const Slice& key, uint32_t idx, const uint64_t time, DataBlock
     if (ts_cnt_ == 1) {
         return Get(key, time, block);
     }
+    CountGet();
     void* entry = NULL;
     if (entries_->Get(key, entry) < 0 || entry == NULL) {
         return false;
@@ -302,38 +413,82 @@ bool Segment::Get(const Slice& key, uint32_t idx, const uint64_t time, DataBlock
 }
 
 bool Segment::Delete(const Slice& key) {
-    ::openmldb::base::Node<Slice, void*>* entry_node = NULL;
-    {
-        std::lock_guard<std::mutex> lock(mu_);
-        entry_node = entries_->Remove(key);
-        if (entry_node == NULL) {
-            return false;
-        }
+    // the removed entry is put into the free list before mu_ is released, or it may be lost
+    // in the free list of a retired segment
+    std::lock_guard<std::mutex> lock(mu_);
+    if (IsRetired()) {
+        return false;
     }
-    {
-        std::lock_guard<std::mutex> lock(gc_mu_);
-        entry_free_list_->Insert(gc_version_.load(std::memory_order_relaxed), entry_node);
+    ::openmldb::base::Node<Slice, void*>* entry_node = entries_->Remove(key);
+    if (entry_node == NULL) {
+        return false;
     }
+    write_cnt_.fetch_add(1, std::memory_order_release);
+    std::lock_guard<std::mutex> gc_lock(gc_mu_);
+    entry_free_list_->Insert(gc_version_.load(std::memory_order_relaxed), entry_node);
     return true;
 }
 
+void Segment::FreeBlock(DataBlock* block, uint64_t& gc_record_cnt, uint64_t& gc_record_byte_size) {
+    if (block->dim_cnt_down > 1) {
+        block->dim_cnt_down--;
+    } else {
+        gc_record_byte_size += GetRecordSize(block->size);
+        if (block->dict_encoded && row_dict_ != NULL) {
+            row_dict_->Free(block->data, block->size);
+        }
+        garbage_.blocks.push_back(block);
+        gc_record_cnt++;
+    }
+}
+
 void Segment::FreeList(::openmldb::base::Node<uint64_t, DataBlock*>* node, uint64_t& gc_idx_cnt,
                        uint64_t& gc_record_cnt, uint64_t& gc_record_byte_size) {
+    if (node == NULL) {
+        return;
+    }
+    garbage_.lists.push_back(node);
     while (node != NULL) {
         gc_idx_cnt++;
         ::openmldb::base::Node<uint64_t, DataBlock*>* tmp = node;
         idx_byte_size_.fetch_sub(GetRecordTsIdxSize(tmp->Height()));
         node = node->GetNextNoBarrier(0);
         DEBUGLOG("delete key %lu with height %u", tmp->GetKey(), tmp->Height());
-        if (tmp->GetValue()->dim_cnt_down > 1) {
-            tmp->GetValue()->dim_cnt_down--;
-        } else {
-            DEBUGLOG("delele data block for key %lu", tmp->GetKey());
-            gc_record_byte_size += GetRecordSize(tmp->GetValue()->size);
-            delete tmp->GetValue();
-            gc_record_cnt++;
-        }
-        delete tmp;
+        FreeBlock(tmp->GetValue(), gc_record_cnt, gc_record_byte_size);
+    }
+}
+
+FrozenRows* Segment::SplitFrozen(KeyEntry* entry, uint64_t ts, uint32_t* start, uint32_t* end) {
+    FrozenRows* frozen = entry->frozen.load(std::memory_order_relaxed);
+    if (frozen == NULL) {
+        return NULL;
+    }
+    uint32_t cnt = frozen->GetSize();
+    uint32_t pos = frozen->LowerBound(ts, cnt);
+    if (pos >= cnt) {
+        return NULL;
+    }
+    if (pos == 0) {
+        entry->frozen.store(NULL, std::memory_order_release);
+        garbage_.frozen.push_back(frozen);
+    } else {
+        // the readers beyond the count are like the ones on the nodes split from the time entries
+        frozen->cnt.store(pos, std::memory_order_release);
+    }
+    *start = pos;
+    *end = cnt;
+    return frozen;
+}
+
+void Segment::FreeFrozen(FrozenRows* frozen, uint32_t start, uint32_t end, uint64_t& gc_idx_cnt,
+                         uint64_t& gc_record_cnt, uint64_t& gc_record_byte_size) {
+    if (frozen == NULL) {
+        return;
+    }
+    for (uint32_t i = start; i < end; i++) {
+        gc_idx_cnt++;
+        idx_byte_size_.fetch_sub(FROZEN_ROW_SIZE, std::memory_order_relaxed);
+        FreeBlock(frozen->rows[i], gc_record_cnt, gc_record_byte_size);
     }
 }
 
@@ -342,8 +497,7 @@ void Segment::FreeEntry(::openmldb::base::Node<Slice, void*>* entry_node, uint64
     if (entry_node == NULL) {
         return;
     }
-    // free pk memory
-    delete[] entry_node->GetKey().data();
+    garbage_.key_nodes.push_back(entry_node);
     if (ts_cnt_ > 1) {
         KeyEntry** entry_arr = (KeyEntry**)entry_node->GetValue();  // NOLINT
         for (uint32_t i = 0; i < ts_cnt_; i++) {
@@ -357,10 +511,10 @@ void Segment::FreeEntry(::openmldb::base::Node<Slice, void*>* entry_node, uint64
                 FreeList(data_node, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
             }
             delete it;
-            delete entry;
+            garbage_.entries.push_back(entry);
             idx_cnt_vec_[i]->fetch_sub(gc_idx_cnt - old, std::memory_order_relaxed);
         }
-        delete[] entry_arr;
+        garbage_.entry_arrs.push_back(entry_arr);
         uint64_t byte_size =
             GetRecordPkMultiIdxSize(entry_node->Height(), entry_node->GetKey().size(), key_entry_max_height_, ts_cnt_);
         idx_byte_size_.fetch_sub(byte_size, std::memory_order_relaxed);
@@ -375,7 +529,12 @@ void Segment::FreeEntry(::openmldb::base::Node<Slice, void*>* entry_node, uint64
             FreeList(data_node, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
         }
         delete it;
-        delete entry;
+        // the frozen rows are deleted with the entry
+        FrozenRows* frozen = entry->frozen.load(std::memory_order_relaxed);
+        if (frozen != NULL) {
+            FreeFrozen(frozen, 0, frozen->GetSize(), gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+        }
+        garbage_.entries.push_back(entry);
         uint64_t byte_size =
             GetRecordPkIdxSize(entry_node->Height(), entry_node->GetKey().size(), key_entry_max_height_);
         idx_byte_size_.fetch_sub(byte_size, std::memory_order_relaxed);
@@ -393,7 +552,6 @@ void Segment::GcEntryFreeList(uint64_t version, uint64_t& gc_idx_cnt, uint64_t&
     while (node != NULL) {
         ::openmldb::base::Node<Slice, void*>* entry_node = node->GetValue();
         FreeEntry(entry_node, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
-        delete entry_node;
         ::openmldb::base::Node<uint64_t, ::openmldb::base::Node<Slice, void*>*>* tmp = node;
         node = node->GetNextNoBarrier(0);
         delete tmp;
@@ -402,16 +560,52 @@ void Segment::GcEntryFreeList(uint64_t version, uint64_t& gc_idx_cnt, uint64_t&
 }
 
 void Segment::GcFreeList(uint64_t& gc_idx_cnt, uint64_t& gc_record_cnt, uint64_t& gc_record_byte_size) {
+    // the readers of the deleted keys are waited for by the epoch manager
     uint64_t cur_version = gc_version_.load(std::memory_order_relaxed);
-    if (cur_version < FLAGS_gc_deleted_pk_version_delta) {
+    GcEntryFreeList(cur_version, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    RetireGarbage();
+}
+
+void Garbage::Free() {
+    for (auto node : lists) {
+        while (node != NULL) {
+            auto tmp = node;
+            node = node->GetNextNoBarrier(0);
+            delete tmp;
+        }
+    }
+    for (auto block : blocks) {
+        delete block;
+    }
+    for (auto entry : entries) {
+        delete entry;
+    }
+    for (auto entry_arr : entry_arrs) {
+        delete[] entry_arr;
+    }
+    for (auto node : key_nodes) {
+        delete[] node->GetKey().data();
+        delete node;
+    }
+    for (auto rows : frozen) {
+        delete rows;
+    }
+}
+
+void Segment::RetireGarbage() {
+    if (garbage_.IsEmpty()) {
         return;
     }
-    uint64_t free_list_version = cur_version - FLAGS_gc_deleted_pk_version_delta;
-    GcEntryFreeList(free_list_version, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    auto garbage = std::make_shared<Garbage>(std::move(garbage_));
+    garbage_ = Garbage();
+    epoch_->Retire([garbage] { garbage->Free(); });
 }
 
 void Segment::ExecuteGc(const TTLSt& ttl_st, uint64_t& gc_idx_cnt, uint64_t& gc_record_cnt,
                         uint64_t& gc_record_byte_size) {
+    if (has_frozen_ && ttl_st.ttl_type != ::openmldb::storage::TTLType::kAbsoluteTime) {
+        Thaw();
+    }
     uint64_t cur_time = ::baidu::common::timer::get_micros() / 1000;
     switch (ttl_st.ttl_type) {
         case ::openmldb::storage::TTLType::kAbsoluteTime: {
@@ -488,9 +682,7 @@ void Segment::Gc4Head(uint64_t keep_cnt, uint64_t& gc_idx_cnt, uint64_t& gc_reco
         ::openmldb::base::Node<uint64_t, DataBlock*>* node = NULL;
         {
             std::lock_guard<std::mutex> lock(mu_);
-            if (entry->refs_.load(std::memory_order_acquire) <= 0) {
-                node = entry->entries.SplitByPos(keep_cnt);
-            }
+            node = entry->entries.SplitByPos(keep_cnt);
         }
         uint64_t entry_gc_idx_cnt = 0;
         FreeList(node, entry_gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
@@ -502,6 +694,7 @@ void Segment::Gc4Head(uint64_t keep_cnt, uint64_t& gc_idx_cnt, uint64_t& gc_reco
              (::baidu::common::timer::get_micros() - consumed) / 1000, gc_idx_cnt - old);
     idx_cnt_.fetch_sub(gc_idx_cnt - old, std::memory_order_relaxed);
     delete it;
+    RetireGarbage();
 }
 
 void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, uint64_t& gc_idx_cnt, uint64_t& gc_record_cnt,
@@ -543,9 +736,7 @@ void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, uint64_t& g
                 }
                 case ::openmldb::storage::TTLType::kLatestTime: {
                     std::lock_guard<std::mutex> lock(mu_);
-                    if (entry->refs_.load(std::memory_order_acquire) <= 0) {
-                        node = entry->entries.SplitByPos(kv.second.lat_ttl);
-                    }
+                    node = entry->entries.SplitByPos(kv.second.lat_ttl);
                     break;
                 }
                 case ::openmldb::storage::TTLType::kAbsAndLat: {
@@ -555,9 +746,7 @@ void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, uint64_t& g
                     } else {
                         node = NULL;
                         std::lock_guard<std::mutex> lock(mu_);
-                        if (entry->refs_.load(std::memory_order_acquire) <= 0) {
-                            node = entry->entries.SplitByKeyAndPos(kv.second.abs_ttl, kv.second.lat_ttl);
-                        }
+                        node = entry->entries.SplitByKeyAndPos(kv.second.abs_ttl, kv.second.lat_ttl);
                     }
                     break;
                 }
@@ -568,14 +757,12 @@ void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, uint64_t& g
                     } else {
                         node = NULL;
                         std::lock_guard<std::mutex> lock(mu_);
-                        if (entry->refs_.load(std::memory_order_acquire) <= 0) {
-                            if (kv.second.abs_ttl == 0) {
-                                node = entry->entries.SplitByPos(kv.second.lat_ttl);
-                            } else if (kv.second.lat_ttl == 0) {
-                                node = entry->entries.Split(kv.second.abs_ttl);
-                            } else {
-                                node = entry->entries.SplitByKeyOrPos(kv.second.abs_ttl, kv.second.lat_ttl);
-                            }
+                        if (kv.second.abs_ttl == 0) {
+                            node = entry->entries.SplitByPos(kv.second.lat_ttl);
+                        } else if (kv.second.lat_ttl == 0) {
+                            node = entry->entries.Split(kv.second.abs_ttl);
+                        } else {
+                            node = entry->entries.SplitByKeyOrPos(kv.second.abs_ttl, kv.second.lat_ttl);
                         }
                         if (entry->entries.IsEmpty()) {
                             empty_cnt++;
@@ -619,18 +806,118 @@ void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, uint64_t& g
     DEBUGLOG("[GcAll] segment gc consumed %lu, count %lu", (::baidu::common::timer::get_micros() - consumed) / 1000,
              gc_idx_cnt - old);
     delete it;
+    RetireGarbage();
 }
 
 void Segment::SplitList(KeyEntry* entry, uint64_t ts, ::openmldb::base::Node<uint64_t, DataBlock*>** node) {
-    // skip entry that ocupied by reader
-    if (entry->refs_.load(std::memory_order_acquire) <= 0) {
-        *node = entry->entries.Split(ts);
+    *node = entry->entries.Split(ts);
+}
+
+uint64_t Segment::GetExpireIndexSize() {
+    std::lock_guard<std::mutex> lock(mu_);
+    uint64_t size = 0;
+    for (const auto& kv : expire_index_) {
+        size += kv.second.size();
+    }
+    return size;
+}
+
+void Segment::Gc4TTLByIndex(const uint64_t time, uint64_t& gc_idx_cnt, uint64_t& gc_record_cnt,
+                            uint64_t& gc_record_byte_size) {
+    uint64_t consumed = ::baidu::common::timer::get_micros();
+    uint64_t old = gc_idx_cnt;
+    uint64_t visited = 0;
+    // the keys of the buckets up to the bucket of `time` may have expired rows
+    const uint64_t last_bucket = time / expire_bucket_ms_;
+    const uint32_t slice_key_cnt = std::max(FLAGS_gc_slice_key_cnt, 1u);
+    // keys left with rows are filed again after the gc, so that they are not visited twice
+    std::vector<std::pair<uint64_t, std::string>> refiled;
+    std::vector<std::string> keys;
+    while (true) {
+        keys.clear();
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            while (keys.size() < slice_key_cnt && !expire_index_.empty() &&
+                   expire_index_.begin()->first <= last_bucket) {
+                auto& bucket = expire_index_.begin()->second;
+                while (keys.size() < slice_key_cnt && !bucket.empty()) {
+                    keys.push_back(std::move(bucket.back()));
+                    bucket.pop_back();
+                }
+                if (bucket.empty()) {
+                    expire_index_.erase(expire_index_.begin());
+                }
+            }
+        }
+        if (keys.empty()) {
+            break;
+        }
+        for (const auto& pk : keys) {
+            Slice key(pk);
+            void* value = NULL;
+            if (entries_->Get(key, value) < 0 || value == NULL) {
+                // deleted or filed more than once
+                continue;
+            }
+            KeyEntry* entry = (KeyEntry*)value;  // NOLINT
+            uint64_t oldest = 0;
+            if (!entry->GetOldestTs(&oldest)) {
+                // filed again by the next put
+                continue;
+            } else if (oldest > time) {
+                refiled.emplace_back(oldest / expire_bucket_ms_, pk);
+                continue;
+            }
+            ::openmldb::base::Node<uint64_t, DataBlock*>* node = NULL;
+            ::openmldb::base::Node<Slice, void*>* entry_node = NULL;
+            FrozenRows* frozen = NULL;
+            uint32_t start = 0;
+            uint32_t end = 0;
+            {
+                std::lock_guard<std::mutex> lock(mu_);
+                SplitList(entry, time, &node);
+                frozen = SplitFrozen(entry, time, &start, &end);
+                if (!entry->GetOldestTs(&oldest)) {
+                    entry_node = entries_->Remove(key);
+                } else {
+                    // the rows left are expired by the bucket of the oldest of them
+                    refiled.emplace_back(oldest / expire_bucket_ms_, pk);
+                }
+            }
+            if (entry_node != NULL) {
+                std::lock_guard<std::mutex> lock(gc_mu_);
+                entry_free_list_->Insert(gc_version_.load(std::memory_order_relaxed), entry_node);
+            }
+            uint64_t entry_gc_idx_cnt = 0;
+            FreeList(node, entry_gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+            FreeFrozen(frozen, start, end, entry_gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+            entry->count_.fetch_sub(entry_gc_idx_cnt, std::memory_order_relaxed);
+            gc_idx_cnt += entry_gc_idx_cnt;
+        }
+        visited += keys.size();
+        RetireGarbage();
+        if (FLAGS_gc_slice_interval_us > 0) {
+            usleep(FLAGS_gc_slice_interval_us);
+        }
     }
+    if (!refiled.empty()) {
+        std::lock_guard<std::mutex> lock(mu_);
+        for (auto& kv : refiled) {
+            expire_index_[kv.first].push_back(std::move(kv.second));
+        }
+    }
+    DEBUGLOG("[Gc4TTLByIndex] segment gc with key %lu ,consumed %lu, visited %lu, count %lu", time,
+             (::baidu::common::timer::get_micros() - consumed) / 1000, visited, gc_idx_cnt - old);
+    idx_cnt_.fetch_sub(gc_idx_cnt - old, std::memory_order_relaxed);
 }
 
 // fast gc with no global pause
 void Segment::Gc4TTL(const uint64_t time, uint64_t& gc_idx_cnt, uint64_t& gc_record_cnt,
                      uint64_t& gc_record_byte_size) {
+    if (use_expire_index_ && ts_cnt_ <= 1) {
+        Gc4TTLByIndex(time, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+        return;
+    }
     uint64_t consumed = ::baidu::common::timer::get_micros();
     uint64_t old = gc_idx_cnt;
     KeyEntries::Iterator* it = entries_->NewIterator();
@@ -639,22 +926,26 @@ void Segment::Gc4TTL(const uint64_t time, uint64_t& gc_idx_cnt, uint64_t& gc_rec
         KeyEntry* entry = (KeyEntry*)it->GetValue();  // NOLINT
         Slice key = it->GetKey();
         it->Next();
-        ::openmldb::base::Node<uint64_t, DataBlock*>* node = entry->entries.GetLast();
-        if (node == NULL) {
+        uint64_t oldest = 0;
+        if (!entry->GetOldestTs(&oldest)) {
             continue;
-        } else if (node->GetKey() > time) {
+        } else if (oldest > time) {
             DEBUGLOG(
                 "[Gc4TTL] segment gc with key %lu need not ttl, last node "
                 "key %lu",
-                time, node->GetKey());
+                time, oldest);
             continue;
         }
-        node = NULL;
+        ::openmldb::base::Node<uint64_t, DataBlock*>* node = NULL;
         ::openmldb::base::Node<Slice, void*>* entry_node = NULL;
+        FrozenRows* frozen = NULL;
+        uint32_t start = 0;
+        uint32_t end = 0;
         {
             std::lock_guard<std::mutex> lock(mu_);
             SplitList(entry, time, &node);
-            if (entry->entries.IsEmpty()) {
+            frozen = SplitFrozen(entry, time, &start, &end);
+            if (entry->IsEmpty()) {
                 entry_node = entries_->Remove(key);
             }
         }
@@ -664,6 +955,7 @@ void Segment::Gc4TTL(const uint64_t time, uint64_t& gc_idx_cnt, uint64_t& gc_rec
         }
         uint64_t entry_gc_idx_cnt = 0;
         FreeList(node, entry_gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+        FreeFrozen(frozen, start, end, entry_gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
         entry->count_.fetch_sub(entry_gc_idx_cnt, std::memory_order_relaxed);
         gc_idx_cnt += entry_gc_idx_cnt;
     }
@@ -671,6 +963,7 @@ void Segment::Gc4TTL(const uint64_t time, uint64_t& gc_idx_cnt, uint64_t& gc_rec
              (::baidu::common::timer::get_micros() - consumed) / 1000, gc_idx_cnt - old);
     idx_cnt_.fetch_sub(gc_idx_cnt - old, std::memory_order_relaxed);
     delete it;
+    RetireGarbage();
 }
 
 void Segment::Gc4TTLAndHead(const uint64_t time, const uint64_t keep_cnt, uint64_t& gc_idx_cnt, uint64_t& gc_record_cnt,
@@ -699,9 +992,7 @@ void Segment::Gc4TTLAndHead(const uint64_t time, const uint64_t keep_cnt, uint64
         node = NULL;
         {
             std::lock_guard<std::mutex> lock(mu_);
-            if (entry->refs_.load(std::memory_order_acquire) <= 0) {
-                node = entry->entries.SplitByKeyAndPos(time, keep_cnt);
-            }
+            node = entry->entries.SplitByKeyAndPos(time, keep_cnt);
         }
         uint64_t entry_gc_idx_cnt = 0;
         FreeList(node, entry_gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
@@ -714,6 +1005,7 @@ void Segment::Gc4TTLAndHead(const uint64_t time, const uint64_t keep_cnt, uint64
         time, keep_cnt, (::baidu::common::timer::get_micros() - consumed) / 1000, gc_idx_cnt - old);
     idx_cnt_.fetch_sub(gc_idx_cnt - old, std::memory_order_relaxed);
     delete it;
+    RetireGarbage();
 }
 
 void Segment::Gc4TTLOrHead(const uint64_t time, const uint64_t keep_cnt, uint64_t& gc_idx_cnt, uint64_t& gc_record_cnt,
@@ -744,9 +1036,7 @@ void Segment::Gc4TTLOrHead(const uint64_t time, const uint64_t keep_cnt, uint64_
         ::openmldb::base::Node<Slice, void*>* entry_node = NULL;
         {
             std::lock_guard<std::mutex> lock(mu_);
-            if (entry->refs_.load(std::memory_order_acquire) <= 0) {
-                node = entry->entries.SplitByKeyOrPos(time, keep_cnt);
-            }
+            node = entry->entries.SplitByKeyOrPos(time, keep_cnt);
             if (entry->entries.IsEmpty()) {
                 entry_node = entries_->Remove(key);
             }
@@ -766,6 +1056,225 @@ void Segment::Gc4TTLOrHead(const uint64_t time, const uint64_t keep_cnt, uint64_
         time, keep_cnt, (::baidu::common::timer::get_micros() - consumed) / 1000, gc_idx_cnt - old);
     idx_cnt_.fetch_sub(gc_idx_cnt - old, std::memory_order_relaxed);
     delete it;
+    RetireGarbage();
+}
+
+void Segment::Gc4Cold(
+    const uint64_t time,
+    const std::function<bool(const Slice& key, uint32_t ts_pos, uint64_t ts, const DataBlock* row)>& move,
+    uint64_t& gc_idx_cnt, uint64_t& gc_record_cnt, uint64_t& gc_record_byte_size) {
+    if (time == 0) {
+        return;
+    }
+    uint64_t consumed = ::baidu::common::timer::get_micros();
+    uint64_t old = gc_idx_cnt;
+    std::vector<const DataBlock*> moved;
+    KeyEntries::Iterator* it = entries_->NewIterator();
+    it->SeekToFirst();
+    while (it->Valid()) {
+        void* value = it->GetValue();
+        Slice key = it->GetKey();
+        it->Next();
+        uint32_t empty_cnt = 0;
+        for (uint32_t pos = 0; pos < ts_cnt_; pos++) {
+            KeyEntry* entry = ts_cnt_ > 1 ? ((KeyEntry**)value)[pos] : (KeyEntry*)value;  // NOLINT
+            ::openmldb::base::Node<uint64_t, DataBlock*>* node = entry->entries.GetLast();
+            if (node == NULL || node->GetKey() >= time) {
+                continue;
+            }
+            // the records are only freed by the gc, so they are valid while the list is read
+            moved.clear();
+            bool ok = true;
+            TimeEntries::Iterator* time_it = entry->entries.NewIterator();
+            for (time_it->Seek(time - 1); time_it->Valid(); time_it->Next()) {
+                if (!move(key, pos, time_it->GetKey(), time_it->GetValue())) {
+                    ok = false;
+                    break;
+                }
+                moved.push_back(time_it->GetValue());
+            }
+            delete time_it;
+            if (!ok) {
+                PDLOG(WARNING, "fail to move the records of key %s older than %lu", key.ToString().c_str(), time);
+                continue;
+            }
+            node = NULL;
+            {
+                std::lock_guard<std::mutex> lock(mu_);
+                SplitList(entry, time - 1, &node);
+                if (entry->entries.IsEmpty()) {
+                    empty_cnt++;
+                }
+            }
+            std::sort(moved.begin(), moved.end());
+            for (auto cur = node; cur != NULL; cur = cur->GetNextNoBarrier(0)) {
+                if (!std::binary_search(moved.begin(), moved.end(), cur->GetValue()) &&
+                    !move(key, pos, cur->GetKey(), cur->GetValue())) {
+                    PDLOG(WARNING, "fail to move the record of key %s ts %lu", key.ToString().c_str(), cur->GetKey());
+                }
+            }
+            uint64_t entry_gc_idx_cnt = 0;
+            FreeList(node, entry_gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+            entry->count_.fetch_sub(entry_gc_idx_cnt, std::memory_order_relaxed);
+            if (ts_cnt_ > 1) {
+                idx_cnt_vec_[pos]->fetch_sub(entry_gc_idx_cnt, std::memory_order_relaxed);
+            } else {
+                idx_cnt_.fetch_sub(entry_gc_idx_cnt, std::memory_order_relaxed);
+            }
+            gc_idx_cnt += entry_gc_idx_cnt;
+        }
+        if (empty_cnt == 0) {
+            continue;
+        }
+        ::openmldb::base::Node<Slice, void*>* entry_node = NULL;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            bool is_empty = true;
+            for (uint32_t pos = 0; pos < ts_cnt_ && is_empty; pos++) {
+                KeyEntry* entry = ts_cnt_ > 1 ? ((KeyEntry**)value)[pos] : (KeyEntry*)value;  // NOLINT
+                is_empty = entry->entries.IsEmpty();
+            }
+            if (is_empty) {
+                entry_node = entries_->Remove(key);
+            }
+        }
+        if (entry_node != NULL) {
+            std::lock_guard<std::mutex> lock(gc_mu_);
+            entry_free_list_->Insert(gc_version_.load(std::memory_order_relaxed), entry_node);
+        }
+    }
+    DEBUGLOG("[Gc4Cold] segment gc with key %lu consumed %lu, count %lu", time,
+             (::baidu::common::timer::get_micros() - consumed) / 1000, gc_idx_cnt - old);
+    delete it;
+    RetireGarbage();
+}
+
+void Segment::Freeze(const uint64_t time, uint32_t min_cnt, uint64_t& freeze_cnt) {
+    if (ts_cnt_ > 1 || time == 0) {
+        return;
+    }
+    uint64_t consumed = ::baidu::common::timer::get_micros();
+    uint64_t old = freeze_cnt;
+    KeyEntries::Iterator* it = entries_->NewIterator();
+    it->SeekToFirst();
+    while (it->Valid()) {
+        KeyEntry* entry = (KeyEntry*)it->GetValue();  // NOLINT
+        it->Next();
+        FreezeEntry(entry, time, min_cnt, freeze_cnt);
+    }
+    delete it;
+    RetireGarbage();
+    DEBUGLOG("[Freeze] segment freeze with key %lu, consumed %lu, count %lu", time,
+             (::baidu::common::timer::get_micros() - consumed) / 1000, freeze_cnt - old);
+}
+
+void Segment::FreezeEntry(KeyEntry* entry, uint64_t time, uint32_t min_cnt, uint64_t& freeze_cnt) {
+    ::openmldb::base::Node<uint64_t, DataBlock*>* node = entry->entries.GetLast();
+    if (entry->entries.IsEmpty() || node == NULL || node->GetKey() >= time) {
+        return;
+    }
+    // the rows to freeze are collected first, and the frozen rows are copied with them out of mu_
+    std::vector<std::pair<uint64_t, DataBlock*>> rows;
+    FrozenRows* frozen = NULL;
+    uint64_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        frozen = entry->frozen.load(std::memory_order_relaxed);
+        if (frozen != NULL && frozen->boundary >= time) {
+            return;
+        }
+        TimeEntries::Iterator* time_it = entry->entries.NewIterator();
+        for (time_it->Seek(time - 1); time_it->Valid(); time_it->Next()) {
+            rows.emplace_back(time_it->GetKey(), time_it->GetValue());
+        }
+        delete time_it;
+        count = entry->count_.load(std::memory_order_relaxed);
+    }
+    if (rows.empty() || rows.size() < min_cnt) {
+        return;
+    }
+    uint32_t frozen_cnt = frozen == NULL ? 0 : frozen->GetSize();
+    FrozenRows* new_frozen = new FrozenRows(time, rows.size() + frozen_cnt);
+    for (const auto& kv : rows) {
+        new_frozen->Append(kv.first, kv.second);
+    }
+    for (uint32_t i = 0; i < frozen_cnt; i++) {
+        new_frozen->Append(frozen->ts_vec[i], frozen->rows[i]);
+    }
+    new_frozen->cnt.store(rows.size() + frozen_cnt, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (entry->frozen.load(std::memory_order_relaxed) != frozen ||
+            entry->count_.load(std::memory_order_relaxed) != count) {
+            // the key is put meanwhile, and it is frozen by the next gc
+            delete new_frozen;
+            return;
+        }
+        // the rows are published before they are split, so that the readers find them in one place at least
+        entry->frozen.store(new_frozen, std::memory_order_release);
+        node = entry->entries.Split(time - 1);
+    }
+    if (frozen != NULL) {
+        garbage_.frozen.push_back(frozen);
+    }
+    if (node != NULL) {
+        // the blocks are moved to the frozen rows
+        garbage_.lists.push_back(node);
+    }
+    uint64_t byte_size = 0;
+    while (node != NULL) {
+        byte_size += GetRecordTsIdxSize(node->Height());
+        node = node->GetNextNoBarrier(0);
+    }
+    idx_byte_size_.fetch_sub(byte_size, std::memory_order_relaxed);
+    idx_byte_size_.fetch_add(rows.size() * FROZEN_ROW_SIZE, std::memory_order_relaxed);
+    freeze_cnt += rows.size();
+    has_frozen_ = true;
+}
+
+void Segment::Thaw() {
+    if (ts_cnt_ > 1) {
+        return;
+    }
+    bool has_frozen = false;
+    KeyEntries::Iterator* it = entries_->NewIterator();
+    it->SeekToFirst();
+    while (it->Valid()) {
+        KeyEntry* entry = (KeyEntry*)it->GetValue();  // NOLINT
+        it->Next();
+        if (entry->frozen.load(std::memory_order_relaxed) == NULL) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(mu_);
+        FrozenRows* frozen = entry->frozen.load(std::memory_order_relaxed);
+        uint32_t cnt = frozen->GetSize();
+        if (cnt == 0) {
+            // thawed by the last gc
+            entry->frozen.store(NULL, std::memory_order_release);
+            garbage_.frozen.push_back(frozen);
+            continue;
+        }
+        uint64_t byte_size = 0;
+        // from the oldest, so that the rows at the same ts keep their order
+        for (uint32_t i = cnt; i > 0; i--) {
+            byte_size += GetRecordTsIdxSize(entry->entries.Insert(frozen->ts_vec[i - 1], frozen->rows[i - 1]));
+        }
+        // no frozen rows, but not NULL until the next gc. a reader which loads NULL before a freeze
+        // and reloads it after the thaw would not know the rows are moved back
+        entry->frozen.store(new FrozenRows(0, 0), std::memory_order_release);
+        garbage_.frozen.push_back(frozen);
+        idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
+        idx_byte_size_.fetch_sub(cnt * FROZEN_ROW_SIZE, std::memory_order_relaxed);
+        has_frozen = true;
+    }
+    delete it;
+    has_frozen_ = has_frozen;
+    RetireGarbage();
+}
+
+bool Segment::HasKey(const Slice& key) {
+    void* entry = NULL;
+    return entries_->Get(key, entry) == 0 && entry != NULL;
 }
 
 int Segment::GetCount(const Slice& key, uint64_t& count) {
@@ -802,12 +1311,13 @@ MemTableIterator* Segment::NewIterator(const Slice& key, Ticket& ticket) {
     if (entries_ == NULL || ts_cnt_ > 1) {
         return new MemTableIterator(NULL);
     }
+    ticket.Enter(epoch_);
+    CountGet();
     void* entry = NULL;
     if (entries_->Get(key, entry) < 0 || entry == NULL) {
         return new MemTableIterator(NULL);
     }
-    ticket.Push((KeyEntry*)entry);                                           // NOLINT
-    return new MemTableIterator(((KeyEntry*)entry)->entries.NewIterator());  // NOLINT
+    return new MemTableIterator(((KeyEntry*)entry)->NewIterator(), row_dict_);  // NOLINT
 }
 
 MemTableIterator* Segment::NewIterator(const Slice& key, uint32_t idx, Ticket& ticket) {
@@ -818,15 +1328,267 @@ MemTableIterator* Segment::NewIterator(const Slice& key, uint32_t idx, Ticket& t
     if (ts_cnt_ == 1) {
         return NewIterator(key, ticket);
     }
+    ticket.Enter(epoch_);
+    CountGet();
     void* entry_arr = NULL;
     if (entries_->Get(key, entry_arr) < 0 || entry_arr == NULL) {
         return new MemTableIterator(NULL);
     }
-    ticket.Push(((KeyEntry**)entry_arr)[pos->second]);                                         // NOLINT
-    return new MemTableIterator(((KeyEntry**)entry_arr)[pos->second]->entries.NewIterator());  // NOLINT
+    return new MemTableIterator(((KeyEntry**)entry_arr)[pos->second]->NewIterator(), row_dict_);  // NOLINT
+}
+
+void Segment::MultiGet(const Slice* keys, uint32_t n, uint32_t ts_pos, Ticket& ticket, KeyEntry** entries) {
+    ticket.Enter(epoch_);
+    std::vector<::openmldb::base::Node<Slice, void*>*> nodes(n);
+    entries_->MultiSeek(keys, n, nodes.data());
+    for (uint32_t i = 0; i < n; i++) {
+        CountGet();
+        auto node = nodes[i];
+        entries[i] = NULL;
+        if (node == NULL || node->GetKey().compare(keys[i]) != 0 || node->GetValue() == NULL) {
+            continue;
+        }
+        if (ts_cnt_ > 1) {
+            if (ts_pos >= ts_cnt_) {
+                continue;
+            }
+            entries[i] = ((KeyEntry**)node->GetValue())[ts_pos];  // NOLINT
+        } else {
+            entries[i] = (KeyEntry*)node->GetValue();  // NOLINT
+        }
+    }
+}
+
+void Segment::CountGet() {
+    static thread_local uint32_t tick = 0;
+    if (++tick >= GET_CNT_BATCH) {
+        get_cnt_.fetch_add(tick, std::memory_order_relaxed);
+        tick = 0;
+    }
+}
+
+Segment* Segment::NewEmptySegment() const {
+    Segment* segment = NULL;
+    if (ts_idx_map_.empty()) {
+        segment = new Segment(key_entry_max_height_);
+    } else {
+        std::vector<uint32_t> ts_idx_vec(ts_idx_map_.size());
+        for (const auto& kv : ts_idx_map_) {
+            ts_idx_vec[kv.second] = kv.first;
+        }
+        segment = new Segment(key_entry_max_height_, ts_idx_vec);
+    }
+    segment->SetRowDict(row_dict_);
+    segment->SetEpochManager(epoch_);
+    return segment;
+}
+
+void Segment::AddEntry(uint8_t height, uint32_t key_size, void* value) {
+    auto count = [this](KeyEntry* entry, uint64_t* byte_size) {
+        uint64_t cnt = 0;
+        auto node = entry->entries.GetFirst();
+        while (node != NULL) {
+            cnt++;
+            *byte_size += GetRecordTsIdxSize(node->Height());
+            node = node->GetNextNoBarrier(0);
+        }
+        FrozenRows* frozen = entry->frozen.load(std::memory_order_relaxed);
+        if (frozen != NULL) {
+            cnt += frozen->GetSize();
+            *byte_size += frozen->GetSize() * FROZEN_ROW_SIZE;
+            has_frozen_ = true;
+        }
+        return cnt;
+    };
+    uint64_t byte_size = 0;
+    if (ts_cnt_ > 1) {
+        byte_size = GetRecordPkMultiIdxSize(height, key_size, key_entry_max_height_, ts_cnt_);
+        KeyEntry** entry_arr = (KeyEntry**)value;  // NOLINT
+        for (uint32_t i = 0; i < ts_cnt_; i++) {
+            idx_cnt_vec_[i]->fetch_add(count(entry_arr[i], &byte_size), std::memory_order_relaxed);
+        }
+    } else {
+        byte_size = GetRecordPkIdxSize(height, key_size, key_entry_max_height_);
+        idx_cnt_.fetch_add(count((KeyEntry*)value, &byte_size), std::memory_order_relaxed);  // NOLINT
+    }
+    idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
+    pk_cnt_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Segment::SplitUnlock(Segment** segs, uint32_t seg_cnt, uint32_t seed) {
+    auto seg_of = [segs, seg_cnt, seed](const Slice& key) {
+        return segs[::openmldb::base::hash(key.data(), key.size(), seed) % seg_cnt];
+    };
+    // the keys share their memory and entries with the old nodes, which are still read
+    KeyEntries::Iterator* it = entries_->NewIterator();
+    it->SeekToFirst();
+    while (it->Valid()) {
+        Slice key = it->GetKey();
+        void* value = it->GetValue();
+        Segment* seg = seg_of(key);
+        uint8_t height = seg->entries_->Insert(key, value);
+        seg->AddEntry(height, key.size(), value);
+        it->Next();
+    }
+    delete it;
+    KeyEntryNodeList::Iterator* f_it = entry_free_list_->NewIterator();
+    f_it->SeekToFirst();
+    while (f_it->Valid()) {
+        uint64_t version = f_it->GetKey();
+        ::openmldb::base::Node<Slice, void*>* entry_node = f_it->GetValue();
+        Segment* seg = seg_of(entry_node->GetKey());
+        seg->entry_free_list_->Insert(version, entry_node);
+        seg->AddEntry(entry_node->Height(), entry_node->GetKey().size(), entry_node->GetValue());
+        f_it->Next();
+    }
+    delete f_it;
+    entry_free_list_->Clear();
+    for (auto& kv : expire_index_) {
+        for (auto& key : kv.second) {
+            seg_of(Slice(key))->expire_index_[kv.first].push_back(std::move(key));
+        }
+    }
+    expire_index_.clear();
+    uint64_t version = gc_version_.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < seg_cnt; i++) {
+        if (segs[i]->gc_version_.load(std::memory_order_relaxed) < version) {
+            segs[i]->gc_version_.store(version, std::memory_order_relaxed);
+        }
+    }
+    retired_.store(true, std::memory_order_release);
 }
 
-MemTableIterator::MemTableIterator(TimeEntries::Iterator* it) : it_(it) {}
+KeyEntryIterator* KeyEntry::NewIterator() { return new KeyEntryIterator(this); }
+
+DataBlock* KeyEntry::Get(uint64_t time) {
+    const FrozenRows* rows = frozen.load(std::memory_order_acquire);
+    if (rows != NULL && time < rows->boundary) {
+        uint32_t cnt = rows->GetSize();
+        uint32_t pos = rows->LowerBound(time, cnt);
+        return pos < cnt && rows->ts_vec[pos] == time ? rows->rows[pos] : NULL;
+    }
+    return entries.Get(time);
+}
+
+bool KeyEntry::GetOldestTs(uint64_t* ts) {
+    const FrozenRows* rows = frozen.load(std::memory_order_acquire);
+    if (rows != NULL && rows->GetSize() > 0) {
+        *ts = rows->ts_vec[rows->GetSize() - 1];
+        return true;
+    }
+    if (entries.IsEmpty()) {
+        return false;
+    }
+    *ts = entries.GetLast()->GetKey();
+    return true;
+}
+
+KeyEntryIterator::KeyEntryIterator(KeyEntry* entry)
+    : entry_(entry),
+      it_(entry->entries.NewIterator()),
+      frozen_(NULL),
+      in_frozen_(false),
+      pos_(0),
+      resume_ts_(UINT64_MAX),
+      skip_cnt_(0) {}
+
+KeyEntryIterator::~KeyEntryIterator() { delete it_; }
+
+void KeyEntryIterator::Next() {
+    if (in_frozen_) {
+        pos_++;
+        return;
+    }
+    uint64_t ts = it_->GetKey();
+    if (ts == resume_ts_) {
+        skip_cnt_++;
+    } else {
+        resume_ts_ = ts;
+        skip_cnt_ = 1;
+    }
+    it_->Next();
+    Settle();
+}
+
+void KeyEntryIterator::Seek(const uint64_t time) {
+    resume_ts_ = time;
+    skip_cnt_ = 0;
+    Resume(entry_->frozen.load(std::memory_order_acquire));
+}
+
+void KeyEntryIterator::SeekToFirst() { Seek(UINT64_MAX); }
+
+void KeyEntryIterator::SeekToLast() {
+    while (true) {
+        frozen_ = entry_->frozen.load(std::memory_order_acquire);
+        if (frozen_ != NULL && frozen_->GetSize() > 0) {
+            in_frozen_ = true;
+            pos_ = frozen_->GetSize() - 1;
+            return;
+        }
+        in_frozen_ = false;
+        if (entry_->entries.IsEmpty()) {
+            it_->SeekToFirst();
+        } else {
+            it_->SeekToLast();
+        }
+        // the last node may be split by a freeze, after the frozen rows are published
+        if (entry_->frozen.load(std::memory_order_acquire) == frozen_) {
+            return;
+        }
+    }
+}
+
+void KeyEntryIterator::Settle() {
+    if (it_->Valid() && (frozen_ == NULL || it_->GetKey() >= frozen_->boundary)) {
+        return;
+    }
+    const FrozenRows* frozen = entry_->frozen.load(std::memory_order_acquire);
+    if (frozen != frozen_) {
+        // frozen or thawed since the frozen rows are loaded
+        Resume(frozen);
+    } else if (frozen_ != NULL) {
+        SeekFrozen();
+    }
+}
+
+void KeyEntryIterator::Resume(const FrozenRows* frozen) {
+    while (true) {
+        frozen_ = frozen;
+        in_frozen_ = false;
+        if (frozen_ != NULL && resume_ts_ < frozen_->boundary) {
+            break;
+        }
+        it_->Seek(resume_ts_);
+        for (uint32_t i = 0; i < skip_cnt_ && it_->Valid() && it_->GetKey() == resume_ts_; i++) {
+            it_->Next();
+        }
+        if (it_->Valid() && (frozen_ == NULL || it_->GetKey() >= frozen_->boundary)) {
+            return;
+        }
+        frozen = entry_->frozen.load(std::memory_order_acquire);
+        if (frozen == frozen_) {
+            break;
+        }
+    }
+    if (frozen_ != NULL) {
+        SeekFrozen();
+    }
+}
+
+void KeyEntryIterator::SeekFrozen() {
+    in_frozen_ = true;
+    uint32_t cnt = frozen_->GetSize();
+    pos_ = frozen_->LowerBound(resume_ts_, cnt);
+    for (uint32_t i = 0; i < skip_cnt_ && pos_ < cnt && frozen_->ts_vec[pos_] == resume_ts_; i++) {
+        pos_++;
+    }
+}
+
+MemTableIterator::MemTableIterator(KeyEntryIterator* it) : it_(it), row_dict_(NULL) {}
+
+MemTableIterator::MemTableIterator(KeyEntryIterator* it, const RowDict* row_dict)
+    : it_(it), row_dict_(row_dict) {}
 
 MemTableIterator::~MemTableIterator() {
     if (it_ != NULL) {
@@ -838,6 +1600,7 @@ void MemTableIterator::Seek(const uint64_t time) {
     if (it_ == NULL) {
         return;
     }
+    row_buf_.Reset();
     it_->Seek(time);
 }
 
@@ -852,11 +1615,12 @@ void MemTableIterator::Next() {
     if (it_ == NULL) {
         return;
     }
+    row_buf_.Reset();
     it_->Next();
 }
 
 ::openmldb::base::Slice MemTableIterator::GetValue() const {
-    return ::openmldb::base::Slice(it_->GetValue()->data, it_->GetValue()->size);
+    return row_buf_.Get(it_->GetValue(), row_dict_);
 }
 
 uint64_t MemTableIterator::GetKey() const { return it_->GetKey(); }
@@ -865,6 +1629,7 @@ void MemTableIterator::SeekToFirst() {
     if (it_ == NULL) {
         return;
     }
+    row_buf_.Reset();
     it_->SeekToFirst();
 }
 
@@ -872,6 +1637,7 @@ void MemTableIterator::SeekToLast() {
     if (it_ == NULL) {
         return;
     }
+    row_buf_.Reset();
     it_->SeekToLast();
 }
 
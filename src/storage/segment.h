@@ -17,16 +17,21 @@
 #ifndef SRC_STORAGE_SEGMENT_H_
 #define SRC_STORAGE_SEGMENT_H_
 
+#include <algorithm>
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <string>
 #include <vector>
 
+#include "base/numa.h"
 #include "base/skiplist.h"
 #include "base/slice.h"
 #include "proto/tablet.pb.h"
 #include "storage/iterator.h"
+#include "storage/row_dict.h"
 #include "storage/schema.h"
 #include "storage/ticket.h"
 
@@ -43,16 +48,21 @@ class Ticket;
 struct DataBlock {
     // dimension count down
     uint8_t dim_cnt_down;
+    // data is allocated from a NumaArena
+    bool in_arena;
+    // data is encoded by the RowDict of the table
+    bool dict_encoded;
     uint32_t size;
     char* data;
 
-    DataBlock(uint8_t dim_cnt, const char* input, uint32_t len) : dim_cnt_down(dim_cnt), size(len), data(NULL) {
+    DataBlock(uint8_t dim_cnt, const char* input, uint32_t len)
+        : dim_cnt_down(dim_cnt), in_arena(false), dict_encoded(false), size(len), data(NULL) {
         data = new char[len];
         memcpy(data, input, len);
     }
 
     DataBlock(uint8_t dim_cnt, char* input, uint32_t len, bool skip_copy)
-        : dim_cnt_down(dim_cnt), size(len), data(NULL) {
+        : dim_cnt_down(dim_cnt), in_arena(false), dict_encoded(false), size(len), data(NULL) {
         if (skip_copy) {
             data = input;
         } else {
@@ -61,8 +71,25 @@ struct DataBlock {
         }
     }
 
+    // copy the data into `arena` if it is not null and the data fits
+    DataBlock(uint8_t dim_cnt, const char* input, uint32_t len, ::openmldb::base::NumaArena* arena)
+        : dim_cnt_down(dim_cnt), in_arena(false), dict_encoded(false), size(len), data(NULL) {
+        if (arena != NULL) {
+            data = arena->Allocate(len);
+            in_arena = data != NULL;
+        }
+        if (data == NULL) {
+            data = new char[len];
+        }
+        memcpy(data, input, len);
+    }
+
     ~DataBlock() {
-        delete[] data;
+        if (in_arena) {
+            ::openmldb::base::NumaArena::Free(data, size);
+        } else {
+            delete[] data;
+        }
         data = NULL;
     }
 };
@@ -82,62 +109,182 @@ struct TimeComparator {
 static const TimeComparator tcmp;
 typedef ::openmldb::base::Skiplist<uint64_t, DataBlock*, TimeComparator> TimeEntries;
 
-class MemTableIterator : public TableIterator {
+// the row of `block`, which is decoded into `buf` if it is encoded by `row_dict`
+inline ::openmldb::base::Slice GetRow(const DataBlock* block, const RowDict* row_dict, std::string* buf) {
+    if (!block->dict_encoded) {
+        return ::openmldb::base::Slice(block->data, block->size);
+    }
+    buf->resize(RowDict::GetRowSize(block->data));
+    if (row_dict == NULL || !row_dict->Decode(block->data, block->size, &(*buf)[0])) {
+        return ::openmldb::base::Slice();
+    }
+    return ::openmldb::base::Slice(*buf);
+}
+
+// the row at the position of an iterator. an encoded row is decoded once, into a buffer which is
+// reused after the iterator moves, so the callers should copy the rows they keep
+class RowBuffer {
  public:
-    explicit MemTableIterator(TimeEntries::Iterator* it);
-    virtual ~MemTableIterator();
-    void Seek(const uint64_t time) override;
-    bool Valid() override;
-    void Next() override;
-    openmldb::base::Slice GetValue() const override;
-    uint64_t GetKey() const override;
-    void SeekToFirst() override;
-    void SeekToLast() override;
+    ::openmldb::base::Slice Get(const DataBlock* block, const RowDict* row_dict) {
+        if (block != block_) {
+            row_ = GetRow(block, row_dict, &buf_);
+            block_ = block;
+        }
+        return row_;
+    }
+    void Reset() { block_ = NULL; }
 
  private:
-    TimeEntries::Iterator* it_;
+    const DataBlock* block_ = NULL;
+    std::string buf_;
+    ::openmldb::base::Slice row_;
+};
+
+// the older rows of a key moved out of its time entries by Segment::Freeze, in the order of the
+// time entries. the rows are replaced as a whole by the late puts and the freezes, and only the count
+// is cut by the gc, so the readers go through them without any lock
+struct FrozenRows {
+    FrozenRows(uint64_t ts, uint32_t capacity) : boundary(ts), cnt(0) {
+        ts_vec.reserve(capacity);
+        rows.reserve(capacity);
+    }
+
+    void Append(uint64_t ts, DataBlock* row) {
+        ts_vec.push_back(ts);
+        rows.push_back(row);
+    }
+
+    uint32_t GetSize() const { return cnt.load(std::memory_order_acquire); }
+
+    // the position of the first row not newer than `time` in the first `size` rows
+    uint32_t LowerBound(uint64_t time, uint32_t size) const {
+        return std::lower_bound(ts_vec.begin(), ts_vec.begin() + size, time, std::greater<uint64_t>()) -
+               ts_vec.begin();
+    }
+
+    // the rows of the key older than it are all frozen
+    const uint64_t boundary;
+    std::vector<uint64_t> ts_vec;
+    std::vector<DataBlock*> rows;
+    std::atomic<uint32_t> cnt;
 };
 
+class KeyEntryIterator;
+
 class KeyEntry {
  public:
-    KeyEntry() : entries(12, 4, tcmp), refs_(0), count_(0) {}
-    explicit KeyEntry(uint8_t height) : entries(height, 4, tcmp), refs_(0), count_(0) {}
-    ~KeyEntry() {}
+    KeyEntry() : entries(12, 4, tcmp), count_(0), frozen(NULL) {}
+    explicit KeyEntry(uint8_t height) : entries(height, 4, tcmp), count_(0), frozen(NULL) {}
+    ~KeyEntry() { delete frozen.load(std::memory_order_relaxed); }
 
     // just return the count of datablock
     uint64_t Release() {
         uint64_t cnt = 0;
-        TimeEntries::Iterator* it = entries.NewIterator();
-        it->SeekToFirst();
-        while (it->Valid()) {
+        auto release = [&cnt](DataBlock* block) {
             cnt += 1;
-            DataBlock* block = it->GetValue();
             // Avoid double free
             if (block->dim_cnt_down > 1) {
                 block->dim_cnt_down--;
             } else {
                 delete block;
             }
+        };
+        TimeEntries::Iterator* it = entries.NewIterator();
+        it->SeekToFirst();
+        while (it->Valid()) {
+            release(it->GetValue());
             it->Next();
         }
         entries.Clear();
         delete it;
+        FrozenRows* rows = frozen.exchange(NULL, std::memory_order_relaxed);
+        if (rows != NULL) {
+            for (uint32_t i = 0; i < rows->GetSize(); i++) {
+                release(rows->rows[i]);
+            }
+            delete rows;
+        }
         return cnt;
     }
 
-    void Ref() { refs_.fetch_add(1, std::memory_order_relaxed); }
+    uint64_t GetCount() { return count_.load(std::memory_order_relaxed); }
 
-    void UnRef() { refs_.fetch_sub(1, std::memory_order_relaxed); }
+    // iterate the time entries and then the frozen rows. delete the iterator after it's used
+    KeyEntryIterator* NewIterator();
 
-    uint64_t GetCount() { return count_.load(std::memory_order_relaxed); }
+    // the row at `time`, see Skiplist::Get
+    DataBlock* Get(uint64_t time);
+
+    // the ts of the oldest row, false if there are no rows
+    bool GetOldestTs(uint64_t* ts);
+
+    bool IsEmpty() {
+        const FrozenRows* rows = frozen.load(std::memory_order_acquire);
+        return entries.IsEmpty() && (rows == NULL || rows->GetSize() == 0);
+    }
 
  public:
     TimeEntries entries;
-    std::atomic<uint64_t> refs_;
     std::atomic<uint64_t> count_;
+    // NULL if no rows are frozen, or no rows with boundary 0 for a while after they are thawed
+    std::atomic<FrozenRows*> frozen;
     friend Segment;
 };
 
+// iterate the rows of a key entry, the time entries first and then the frozen rows. the rows
+// frozen or thawed while it is used are neither skipped nor visited twice
+class KeyEntryIterator {
+ public:
+    explicit KeyEntryIterator(KeyEntry* entry);
+    ~KeyEntryIterator();
+
+    bool Valid() const { return in_frozen_ ? pos_ < frozen_->GetSize() : it_->Valid(); }
+    void Next();
+    const uint64_t& GetKey() const { return in_frozen_ ? frozen_->ts_vec[pos_] : it_->GetKey(); }
+    DataBlock* GetValue() const { return in_frozen_ ? frozen_->rows[pos_] : it_->GetValue(); }
+    void Seek(const uint64_t time);
+    void SeekToFirst();
+    void SeekToLast();
+
+ private:
+    // go on with the frozen rows at the end of the time entries newer than the boundary
+    void Settle();
+    // position at the resume point with `frozen` as the frozen rows
+    void Resume(const FrozenRows* frozen);
+    // position at the resume point in the frozen rows
+    void SeekFrozen();
+
+ private:
+    KeyEntry* entry_;
+    TimeEntries::Iterator* it_;
+    const FrozenRows* frozen_;
+    bool in_frozen_;
+    uint32_t pos_;
+    // the resume point: the first row not newer than resume_ts_, skipping the skip_cnt_ rows at
+    // resume_ts_ passed in the time entries
+    uint64_t resume_ts_;
+    uint32_t skip_cnt_;
+};
+
+class MemTableIterator : public TableIterator {
+ public:
+    explicit MemTableIterator(KeyEntryIterator* it);
+    MemTableIterator(KeyEntryIterator* it, const RowDict* row_dict);
+    virtual ~MemTableIterator();
+    void Seek(const uint64_t time) override;
+    bool Valid() override;
+    void Next() override;
+    openmldb::base::Slice GetValue() const override;
+    uint64_t GetKey() const override;
+    void SeekToFirst() override;
+    void SeekToLast() override;
+
+ private:
+    KeyEntryIterator* it_;
+    const RowDict* row_dict_;
+    mutable RowBuffer row_buf_;
+};
+
 struct SliceComparator {
     int operator()(const ::openmldb::base::Slice& a, const ::openmldb::base::Slice& b) const { return a.compare(b); }
 };
@@ -145,6 +292,27 @@ struct SliceComparator {
 typedef ::openmldb::base::Skiplist<::openmldb::base::Slice, void*, SliceComparator> KeyEntries;
 typedef ::openmldb::base::Skiplist<uint64_t, ::openmldb::base::Node<Slice, void*>*, TimeComparator> KeyEntryNodeList;
 
+// the memory unlinked by gc, which readers may still reach. it is retired to the epoch manager
+// and freed after the readers entered before have left
+struct Garbage {
+    // the lists split from the time entries, linked by the next pointers of level 0
+    std::vector<::openmldb::base::Node<uint64_t, DataBlock*>*> lists;
+    // the blocks not referred by other indexes any more
+    std::vector<DataBlock*> blocks;
+    std::vector<KeyEntry*> entries;
+    std::vector<KeyEntry**> entry_arrs;
+    // the nodes removed from the key entries, with their keys
+    std::vector<::openmldb::base::Node<Slice, void*>*> key_nodes;
+    // the frozen rows replaced, without their blocks
+    std::vector<FrozenRows*> frozen;
+
+    bool IsEmpty() const {
+        return lists.empty() && blocks.empty() && entries.empty() && entry_arrs.empty() && key_nodes.empty() &&
+               frozen.empty();
+    }
+    void Free();
+};
+
 class Segment {
  public:
     Segment();
@@ -152,16 +320,16 @@ class Segment {
     Segment(uint8_t height, const std::vector<uint32_t>& ts_idx_vec);
     ~Segment();
 
-    // Put time data
-    void Put(const Slice& key, uint64_t time, const char* data, uint32_t size);
+    // Put time data. puts and deletes return false on a retired segment, see SplitUnlock
+    bool Put(const Slice& key, uint64_t time, const char* data, uint32_t size);
 
-    void Put(const Slice& key, uint64_t time, DataBlock* row);
+    bool Put(const Slice& key, uint64_t time, DataBlock* row);
 
     void PutUnlock(const Slice& key, uint64_t time, DataBlock* row);
 
-    void BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t time, DataBlock* row);
+    bool BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t time, DataBlock* row);
 
-    void Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, DataBlock* row);
+    bool Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, DataBlock* row);
 
     // Get time data
     bool Get(const Slice& key, uint64_t time, DataBlock** block);
@@ -180,6 +348,10 @@ class Segment {
     void Gc4TTL(const uint64_t time, uint64_t& gc_idx_cnt,  // NOLINT
                 uint64_t& gc_record_cnt,                    // NOLINT
                 uint64_t& gc_record_byte_size);             // NOLINT
+    // Gc4TTL by the expire index, in slices of FLAGS_gc_slice_key_cnt keys
+    void Gc4TTLByIndex(const uint64_t time, uint64_t& gc_idx_cnt,  // NOLINT
+                       uint64_t& gc_record_cnt,                    // NOLINT
+                       uint64_t& gc_record_byte_size);             // NOLINT
     void Gc4Head(uint64_t keep_cnt, uint64_t& gc_idx_cnt,   // NOLINT
                  uint64_t& gc_record_cnt,                   // NOLINT
                  uint64_t& gc_record_byte_size);            // NOLINT
@@ -194,6 +366,20 @@ class Segment {
     void GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, uint64_t& gc_idx_cnt,  // NOLINT
                    uint64_t& gc_record_cnt,                                            // NOLINT
                    uint64_t& gc_record_byte_size);                                     // NOLINT
+    // unlink the records older than `time` of every key, which are passed to `move` with the ts position
+    // first. `move` is called before a record is unlinked, so that the readers find it in one place at
+    // least, and after for the records put meanwhile. the records of a key are kept if `move` fails
+    void Gc4Cold(const uint64_t time,
+                 const std::function<bool(const Slice& key, uint32_t ts_pos, uint64_t ts, const DataBlock* row)>& move,
+                 uint64_t& gc_idx_cnt,            // NOLINT
+                 uint64_t& gc_record_cnt,         // NOLINT
+                 uint64_t& gc_record_byte_size);  // NOLINT
+    // freeze the rows older than `time` of the keys with `min_cnt` of them in the time entries at least,
+    // see FrozenRows. the rows are moved with their order, so it is for a segment with one ts only
+    void Freeze(const uint64_t time, uint32_t min_cnt, uint64_t& freeze_cnt);  // NOLINT
+    // move the frozen rows back to the time entries, for the gc which is not by absolute ttl
+    void Thaw();
+    bool HasKey(const Slice& key);
     MemTableIterator* NewIterator(const Slice& key, Ticket& ticket);                   // NOLINT
     MemTableIterator* NewIterator(const Slice& key, uint32_t idx,
                                   Ticket& ticket);  // NOLINT
@@ -230,12 +416,21 @@ class Segment {
 
     inline uint64_t GetPkCnt() { return pk_cnt_.load(std::memory_order_relaxed); }
 
+    // the keys filed in the expire index, including the stale ones
+    uint64_t GetExpireIndexSize();
+
     void GcFreeList(uint64_t& entry_gc_idx_cnt,      // NOLINT
                     uint64_t& gc_record_cnt,         // NOLINT
                     uint64_t& gc_record_byte_size);  // NOLINT
 
     KeyEntries* GetKeyEntries() { return entries_; }
 
+    // look up the entries of `n` keys at once, see Skiplist::MultiSeek. entries[i] is
+    // the entry of keys[i] at `ts_pos` of the ts entries, or NULL if keys[i] is not found.
+    // the entries are valid while `ticket` is held
+    void MultiGet(const Slice* keys, uint32_t n, uint32_t ts_pos, Ticket& ticket,  // NOLINT
+                  KeyEntry** entries);
+
     int GetCount(const Slice& key, uint64_t& count);                // NOLINT
     int GetCount(const Slice& key, uint32_t idx, uint64_t& count);  // NOLINT
 
@@ -245,11 +440,60 @@ class Segment {
                          uint64_t& gc_record_cnt,         // NOLINT
                          uint64_t& gc_record_byte_size);  // NOLINT
 
+    // the puts, and the gets counted by sampling
+    uint64_t GetPutCnt() const { return put_cnt_.load(std::memory_order_relaxed); }
+    uint64_t GetGetCnt() const { return get_cnt_.load(std::memory_order_relaxed); }
+
+    // the puts and the deletes, counted under mu_ after the rows are changed
+    uint64_t GetWriteCnt() const { return write_cnt_.load(std::memory_order_acquire); }
+
+    // an empty segment with the same height and ts columns
+    Segment* NewEmptySegment() const;
+
+    // the lock of puts, held by the caller of SplitUnlock
+    std::mutex& GetPutMutex() { return mu_; }
+    std::mutex& GetGcMutex() { return gc_mu_; }
+
+    // move the keys of the segment, including the deleted ones waiting to be freed, into
+    // segs[hash(key, seed) % seg_cnt]. the segment is retired afterwards: its keys and entries are
+    // owned by `segs`, and it keeps the skiplist of the keys only for the readers which have not
+    // left it. mu_ and gc_mu_ should be locked, and gc should not run on the segment
+    void SplitUnlock(Segment** segs, uint32_t seg_cnt, uint32_t seed);
+
+    bool IsRetired() const { return retired_.load(std::memory_order_acquire); }
+
+    // the dictionary of the rows encoded by the table, which outlives the segment
+    void SetRowDict(RowDict* row_dict) { row_dict_ = row_dict; }
+    const RowDict* GetRowDict() const { return row_dict_; }
+
+    // the manager the garbage of the segment is retired to, which outlives the segment.
+    // it is EpochManager::Default() unless the table sets its own
+    void SetEpochManager(::openmldb::base::EpochManager* epoch) { epoch_ = epoch; }
+    ::openmldb::base::EpochManager* GetEpochManager() const { return epoch_; }
+
  private:
+    void CountGet();
+    // count a key moved in by SplitUnlock, `height` is the height of its node in the segment
+    void AddEntry(uint8_t height, uint32_t key_size, void* value);
+
     void FreeList(::openmldb::base::Node<uint64_t, DataBlock*>* node, uint64_t& gc_idx_cnt,  // NOLINT
                   uint64_t& gc_record_cnt,         // NOLINT
                   uint64_t& gc_record_byte_size);  // NOLINT
     void SplitList(KeyEntry* entry, uint64_t ts, ::openmldb::base::Node<uint64_t, DataBlock*>** node);
+    void FreeBlock(DataBlock* block, uint64_t& gc_record_cnt,  // NOLINT
+                   uint64_t& gc_record_byte_size);             // NOLINT
+    // cut the frozen rows of `entry` not newer than `ts`, which are rows [start, end) of the returned
+    // frozen rows, NULL if none. mu_ should be locked
+    FrozenRows* SplitFrozen(KeyEntry* entry, uint64_t ts, uint32_t* start, uint32_t* end);
+    void FreeFrozen(FrozenRows* frozen, uint32_t start, uint32_t end, uint64_t& gc_idx_cnt,  // NOLINT
+                    uint64_t& gc_record_cnt,                                                // NOLINT
+                    uint64_t& gc_record_byte_size);                                         // NOLINT
+    // put a row older than the boundary of the frozen rows of `entry`. mu_ should be locked
+    void PutFrozen(KeyEntry* entry, FrozenRows* frozen, uint64_t time, DataBlock* row);
+    void FreezeEntry(KeyEntry* entry, uint64_t time, uint32_t min_cnt, uint64_t& freeze_cnt);  // NOLINT
+
+    // retire the garbage collected so far to the epoch manager
+    void RetireGarbage();
 
     void GcEntryFreeList(uint64_t version, uint64_t& gc_idx_cnt,  // NOLINT
                          uint64_t& gc_record_cnt,                 // NOLINT
@@ -273,6 +517,22 @@ class Segment {
     std::map<uint32_t, uint32_t> ts_idx_map_;
     std::vector<std::shared_ptr<std::atomic<uint64_t>>> idx_cnt_vec_;
     uint64_t ttl_offset_;
+    // the expire index of a segment with one ts: the keys filed by the bucket of their oldest ts,
+    // so that the gc of absolute ttl only visits the keys which may have expired rows. a key may be
+    // filed more than once or after it is deleted, and it is checked when its bucket is visited
+    const bool use_expire_index_;
+    const uint64_t expire_bucket_ms_;
+    std::map<uint64_t, std::vector<std::string>> expire_index_;  // protected by mu_
+    std::atomic<uint64_t> put_cnt_;
+    std::atomic<uint64_t> get_cnt_;
+    std::atomic<uint64_t> write_cnt_;
+    std::atomic<bool> retired_;
+    // collected by gc, which runs on one thread
+    Garbage garbage_;
+    // some keys may have frozen rows, set by the gc
+    bool has_frozen_;
+    RowDict* row_dict_;
+    ::openmldb::base::EpochManager* epoch_;
 };
 
 }  // namespace storage
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/slice.h"
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+#include "storage/segment.h"
+
+DECLARE_bool(gc_use_expire_index);
+
+namespace openmldb {
+namespace storage {
+
+// the segment holds far more keys than the cache, and the keys of a batch are
+// picked at random, so most of the lookups miss the cache.
+// the items processed are key lookups, in batches of `state.range(0)` keys
+static constexpr uint32_t kKeyCnt = 1 << 21;
+
+static Segment* GetSegment() {
+    static Segment* segment = []() {
+        auto* seg = new Segment();
+        std::string value = "value";
+        for (uint32_t i = 0; i < kKeyCnt; i++) {
+            std::string key = "key_of_a_row_" + std::to_string(i);
+            seg->Put(::openmldb::base::Slice(key), 1635247427000, value.c_str(), value.size());
+        }
+        return seg;
+    }();
+    return segment;
+}
+
+static std::vector<std::string> BuildBatches(uint32_t cnt) {
+    std::mt19937 rand(0);
+    std::vector<std::string> keys(cnt);
+    for (auto& key : keys) {
+        key = "key_of_a_row_" + std::to_string(rand() % kKeyCnt);
+    }
+    return keys;
+}
+
+static void BM_SegmentGet(benchmark::State& state) {  // NOLINT
+    Segment* segment = GetSegment();
+    uint32_t batch_size = state.range(0);
+    auto keys = BuildBatches(1 << 20);
+    std::vector<::openmldb::base::Slice> spks(keys.begin(), keys.end());
+    size_t pos = 0;
+    for (auto _ : state) {
+        if (pos + batch_size > spks.size()) {
+            pos = 0;
+        }
+        Ticket ticket;
+        for (uint32_t i = 0; i < batch_size; i++) {
+            void* entry = NULL;
+            segment->GetKeyEntries()->Get(spks[pos + i], entry);
+            benchmark::DoNotOptimize(entry);
+        }
+        pos += batch_size;
+    }
+    state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+static void BM_SegmentMultiGet(benchmark::State& state) {  // NOLINT
+    Segment* segment = GetSegment();
+    uint32_t batch_size = state.range(0);
+    auto keys = BuildBatches(1 << 20);
+    std::vector<::openmldb::base::Slice> spks(keys.begin(), keys.end());
+    std::vector<KeyEntry*> entries(batch_size);
+    size_t pos = 0;
+    for (auto _ : state) {
+        if (pos + batch_size > spks.size()) {
+            pos = 0;
+        }
+        Ticket ticket;
+        segment->MultiGet(&spks[pos], batch_size, 0, ticket, entries.data());
+        benchmark::DoNotOptimize(entries.data());
+        pos += batch_size;
+    }
+    state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+// a gc of absolute ttl which expires 1% of the keys, by a sweep of all the keys if
+// `state.range(0)` is 0, or by the expire index
+static void BM_SegmentGc4TTL(benchmark::State& state) {  // NOLINT
+    constexpr uint32_t key_cnt = 1 << 18;
+    constexpr uint32_t expired_cnt = key_cnt / 100;
+    FLAGS_gc_use_expire_index = state.range(0) != 0;
+    Segment segment;
+    FLAGS_gc_use_expire_index = false;
+    std::string value = "value";
+    std::vector<std::string> keys(key_cnt);
+    for (uint32_t i = 0; i < key_cnt; i++) {
+        keys[i] = "key_of_a_row_" + std::to_string(i);
+        segment.Put(::openmldb::base::Slice(keys[i]), 1635247427000, value.c_str(), value.size());
+    }
+    uint64_t time = 1000;
+    uint32_t pos = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (uint32_t i = 0; i < expired_cnt; i++, pos = (pos + 1) % key_cnt) {
+            segment.Put(::openmldb::base::Slice(keys[pos]), time, value.c_str(), value.size());
+        }
+        time += 60000;
+        state.ResumeTiming();
+        uint64_t gc_idx_cnt = 0, gc_record_cnt = 0, gc_record_byte_size = 0;
+        segment.Gc4TTL(time, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+        benchmark::DoNotOptimize(gc_idx_cnt);
+    }
+    state.SetItemsProcessed(state.iterations() * expired_cnt);
+}
+
+BENCHMARK(BM_SegmentGet)->Arg(1)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BM_SegmentMultiGet)->Arg(1)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BM_SegmentGc4TTL)->Arg(0)->Arg(1);
+
+}  // namespace storage
+}  // namespace openmldb
@@ -17,15 +17,23 @@
 #include "storage/segment.h"
 
 #include <iostream>
+#include <map>
 #include <string>
+#include <vector>
 
+#include "base/epoch.h"
 #include "base/glog_wapper.h"  // NOLINT
+#include "gflags/gflags.h"
 #include "base/slice.h"
 #include "gtest/gtest.h"
 #include "storage/record.h"
 
 using ::openmldb::base::Slice;
 
+DECLARE_bool(gc_use_expire_index);
+DECLARE_uint32(gc_expire_bucket_ms);
+DECLARE_uint32(gc_slice_key_cnt);
+
 namespace openmldb {
 namespace storage {
 
@@ -66,6 +74,40 @@ TEST_F(SegmentTest, PutAndGet) {
     ASSERT_EQ(e, t);
 }
 
+TEST_F(SegmentTest, MultiGet) {
+    std::vector<uint32_t> ts_idx_vec = {1, 3};
+    Segment segment(8, ts_idx_vec);
+    std::string value = "test";
+    for (int i = 0; i < 100; i += 2) {
+        std::string key = "pk" + std::to_string(i);
+        std::map<int32_t, uint64_t> ts_map = {{1, 100 + i}, {3, 200 + i}};
+        DataBlock* row = new DataBlock(2, value.c_str(), value.size());
+        segment.Put(Slice(key), ts_map, row);
+    }
+    std::vector<std::string> keys;
+    for (int i = 0; i < 100; i++) {
+        keys.push_back("pk" + std::to_string(i));
+    }
+    std::vector<Slice> spks(keys.begin(), keys.end());
+    std::vector<KeyEntry*> entries(keys.size());
+    Ticket ticket;
+    uint32_t ts_pos = 0;
+    ASSERT_EQ(0, segment.GetTsIdx(3, ts_pos));
+    segment.MultiGet(spks.data(), spks.size(), ts_pos, ticket, entries.data());
+    for (int i = 0; i < 100; i++) {
+        if (i % 2 == 1) {
+            ASSERT_TRUE(entries[i] == NULL);
+            continue;
+        }
+        ASSERT_TRUE(entries[i] != NULL);
+        auto it = entries[i]->entries.NewIterator();
+        it->SeekToFirst();
+        ASSERT_TRUE(it->Valid());
+        ASSERT_EQ(200u + i, it->GetKey());
+        delete it;
+    }
+}
+
 TEST_F(SegmentTest, PutAndScan) {
     Segment segment;
     Slice pk("test1");
@@ -250,6 +292,237 @@ TEST_F(SegmentTest, TestGc4TTL) {
     ASSERT_EQ(2 * GetRecordSize(5), (int64_t)gc_record_byte_size);
 }
 
+TEST_F(SegmentTest, TestGc4Cold) {
+    Segment segment;
+    for (int i = 0; i < 10; i++) {
+        segment.Put("PK1", 9760 + i, "test", 4);
+    }
+    segment.Put("PK2", 9760, "test", 4);
+    uint64_t gc_idx_cnt = 0;
+    uint64_t gc_record_cnt = 0;
+    uint64_t gc_record_byte_size = 0;
+    std::map<std::string, std::vector<uint64_t>> moved;
+    bool fail = true;
+    auto move = [&](const Slice& key, uint32_t ts_pos, uint64_t ts, const DataBlock* row) {
+        if (fail) {
+            return false;
+        }
+        moved[key.ToString()].push_back(ts);
+        return true;
+    };
+    // the records are kept if they are not moved
+    segment.Gc4Cold(9765, move, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    ASSERT_EQ(0, (int64_t)gc_idx_cnt);
+    ASSERT_EQ(11, (int64_t)segment.GetIdxCnt());
+    fail = false;
+    segment.Gc4Cold(9765, move, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    ASSERT_EQ(6, (int64_t)gc_idx_cnt);
+    ASSERT_EQ(6, (int64_t)gc_record_cnt);
+    ASSERT_EQ(6 * GetRecordSize(4), (int64_t)gc_record_byte_size);
+    ASSERT_EQ(std::vector<uint64_t>({9764, 9763, 9762, 9761, 9760}), moved["PK1"]);
+    ASSERT_EQ(std::vector<uint64_t>({9760}), moved["PK2"]);
+    ASSERT_TRUE(segment.HasKey("PK1"));
+    ASSERT_FALSE(segment.HasKey("PK2"));
+    ASSERT_EQ(5, (int64_t)segment.GetIdxCnt());
+    Ticket ticket;
+    MemTableIterator* it = segment.NewIterator("PK1", ticket);
+    it->SeekToFirst();
+    int cnt = 0;
+    for (; it->Valid(); it->Next()) {
+        ASSERT_GE(it->GetKey(), 9765u);
+        cnt++;
+    }
+    ASSERT_EQ(5, cnt);
+    delete it;
+}
+
+TEST_F(SegmentTest, ReadWhileGc) {
+    Segment segment;
+    Slice pk("test1");
+    for (int i = 0; i < 10; i++) {
+        segment.Put(pk, 9760 + i, "test", 4);
+    }
+    auto manager = ::openmldb::base::EpochManager::Default();
+    manager->Reclaim();
+    {
+        Ticket ticket;
+        MemTableIterator* it = segment.NewIterator("test1", ticket);
+        it->Seek(9762);
+        ASSERT_TRUE(it->Valid());
+        uint64_t gc_idx_cnt = 0;
+        uint64_t gc_record_cnt = 0;
+        uint64_t gc_record_byte_size = 0;
+        segment.Gc4TTL(9769, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+        segment.GcFreeList(gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+        ASSERT_EQ(10, (int64_t)gc_idx_cnt);
+        ASSERT_EQ(0, (int64_t)segment.GetPkCnt());
+        // the rows and the key are unlinked, and freed after the ticket is destroyed
+        ASSERT_EQ(0u, manager->Reclaim());
+        int size = 0;
+        while (it->Valid()) {
+            ASSERT_EQ("test", it->GetValue().ToString());
+            it->Next();
+            size++;
+        }
+        ASSERT_EQ(3, size);
+        delete it;
+    }
+    ASSERT_EQ(2u, manager->Reclaim());
+    ASSERT_EQ(0u, manager->GetRetiredCnt());
+}
+
+TEST_F(SegmentTest, TestGc4TTLByIndex) {
+    FLAGS_gc_use_expire_index = true;
+    FLAGS_gc_expire_bucket_ms = 10;
+    FLAGS_gc_slice_key_cnt = 3;
+    Segment segment;
+    Segment sweep_segment;
+    FLAGS_gc_use_expire_index = false;
+    for (int i = 0; i < 10; i++) {
+        std::string pk = "pk" + std::to_string(i);
+        for (uint64_t ts = 1000 + i * 10; ts < 1000 + i * 10 + 5; ts++) {
+            segment.Put(pk, ts, "test1", 5);
+            sweep_segment.Put(pk, ts, "test1", 5);
+        }
+    }
+    // each key is filed once
+    ASSERT_EQ(10u, segment.GetExpireIndexSize());
+    for (uint64_t time : {900, 1002, 1032, 1052, 1200}) {
+        uint64_t gc_idx_cnt = 0, gc_record_cnt = 0, gc_record_byte_size = 0;
+        segment.Gc4TTL(time, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+        uint64_t sweep_idx_cnt = 0, sweep_record_cnt = 0, sweep_record_byte_size = 0;
+        sweep_segment.Gc4TTL(time, sweep_idx_cnt, sweep_record_cnt, sweep_record_byte_size);
+        ASSERT_EQ(sweep_idx_cnt, gc_idx_cnt);
+        ASSERT_EQ(sweep_record_cnt, gc_record_cnt);
+        ASSERT_EQ(sweep_record_byte_size, gc_record_byte_size);
+        ASSERT_EQ(sweep_segment.GetIdxCnt(), segment.GetIdxCnt());
+        ASSERT_EQ(sweep_segment.GetPkCnt(), segment.GetPkCnt());
+        if (time == 1032) {
+            // pk0 to pk3 are expired, pk3 is partly expired and filed again
+            ASSERT_EQ(7u, segment.GetExpireIndexSize());
+        }
+    }
+    ASSERT_EQ(0u, segment.GetExpireIndexSize());
+    ASSERT_EQ(0u, segment.GetIdxCnt());
+    // a put older than the oldest ts files the key again
+    segment.Put("pk0", 2000, "test1", 5);
+    segment.Put("pk0", 2001, "test1", 5);
+    ASSERT_EQ(1u, segment.GetExpireIndexSize());
+    segment.Put("pk0", 1990, "test1", 5);
+    ASSERT_EQ(2u, segment.GetExpireIndexSize());
+    uint64_t gc_idx_cnt = 0, gc_record_cnt = 0, gc_record_byte_size = 0;
+    segment.Gc4TTL(1995, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    ASSERT_EQ(1u, gc_idx_cnt);
+    // pk0 is filed twice in bucket 200, and the stale one is dropped by the next gc
+    ASSERT_EQ(2u, segment.GetExpireIndexSize());
+    segment.Gc4TTL(2005, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    ASSERT_EQ(3u, gc_idx_cnt);
+    ASSERT_EQ(0u, segment.GetExpireIndexSize());
+}
+
+TEST_F(SegmentTest, Freeze) {
+    Segment segment;
+    for (int i = 0; i < 10; i++) {
+        segment.Put("PK1", 9760 + i, "test", 4);
+    }
+    segment.Put("PK1", 9765, "dup", 3);
+    segment.Put("PK2", 9760, "test", 4);
+    uint64_t idx_byte_size = segment.GetIdxByteSize();
+    uint64_t freeze_cnt = 0;
+    // PK2 has too few rows to freeze
+    segment.Freeze(9766, 2, freeze_cnt);
+    ASSERT_EQ(7u, freeze_cnt);
+    ASSERT_LT(segment.GetIdxByteSize(), idx_byte_size);
+    ASSERT_EQ(12u, segment.GetIdxCnt());
+    uint64_t count = 0;
+    ASSERT_EQ(0, segment.GetCount("PK1", count));
+    ASSERT_EQ(11u, count);
+    // a late put goes to the frozen rows
+    segment.Put("PK1", 9758, "late", 4);
+    DataBlock* block = NULL;
+    ASSERT_TRUE(segment.Get("PK1", 9758, &block));
+    ASSERT_EQ("late", std::string(block->data, block->size));
+    ASSERT_TRUE(segment.Get("PK1", 9767, &block));
+    ASSERT_EQ("test", std::string(block->data, block->size));
+
+    Ticket ticket;
+    MemTableIterator* it = segment.NewIterator("PK1", ticket);
+    std::vector<std::string> rows;
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        rows.push_back(std::to_string(it->GetKey()) + it->GetValue().ToString());
+    }
+    ASSERT_EQ(std::vector<std::string>({"9769test", "9768test", "9767test", "9766test", "9765dup", "9765test",
+                                        "9764test", "9763test", "9762test", "9761test", "9760test", "9758late"}),
+              rows);
+    it->Seek(9765);
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ("dup", it->GetValue().ToString());
+    it->Seek(9759);
+    ASSERT_EQ(9758u, it->GetKey());
+    it->SeekToLast();
+    ASSERT_EQ(9758u, it->GetKey());
+    delete it;
+
+    // the frozen rows are cut by the gc
+    uint64_t gc_idx_cnt = 0;
+    uint64_t gc_record_cnt = 0;
+    uint64_t gc_record_byte_size = 0;
+    segment.Gc4TTL(9762, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    ASSERT_EQ(5u, gc_idx_cnt);
+    ASSERT_EQ(5u, gc_record_cnt);
+    ASSERT_EQ(0, segment.GetCount("PK1", count));
+    ASSERT_EQ(8u, count);
+    ASSERT_FALSE(segment.HasKey("PK2"));
+    segment.Gc4TTL(9770, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    ASSERT_EQ(13u, gc_idx_cnt);
+    ASSERT_FALSE(segment.HasKey("PK1"));
+    ASSERT_EQ(0u, segment.GetIdxCnt());
+    segment.GcFreeList(gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    segment.IncrGcVersion();
+    segment.IncrGcVersion();
+    segment.GcFreeList(gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    ASSERT_EQ(0u, segment.GetPkCnt());
+}
+
+TEST_F(SegmentTest, ReadWhileFreeze) {
+    Segment segment;
+    for (int i = 0; i < 20; i++) {
+        segment.Put("PK", 9760 + i / 2, "test", 4);
+    }
+    Ticket ticket;
+    MemTableIterator* it = segment.NewIterator("PK", ticket);
+    it->SeekToFirst();
+    uint64_t freeze_cnt = 0;
+    int cnt = 0;
+    // the rows are frozen and thawed under the iterator, which visits each once
+    for (uint64_t time : {9775, 9777, 9780}) {
+        for (int i = 0; i < 3; i++) {
+            ASSERT_TRUE(it->Valid());
+            it->Next();
+            cnt++;
+        }
+        segment.Freeze(time - 10, 1, freeze_cnt);
+    }
+    ASSERT_EQ(20u, freeze_cnt);
+    segment.Thaw();
+    uint64_t last = UINT64_MAX;
+    for (; it->Valid(); it->Next()) {
+        ASSERT_LE(it->GetKey(), last);
+        last = it->GetKey();
+        cnt++;
+    }
+    ASSERT_EQ(20, cnt);
+    delete it;
+    it = segment.NewIterator("PK", ticket);
+    cnt = 0;
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        cnt++;
+    }
+    ASSERT_EQ(20, cnt);
+    delete it;
+    ASSERT_EQ(20u, segment.GetIdxCnt());
+}
+
 TEST_F(SegmentTest, TestGc4TTLAndHead) {
     Segment segment;
     segment.Put("PK1", 9766, "test1", 5);
@@ -407,6 +680,97 @@ TEST_F(SegmentTest, PutAndGetTS) {
     ASSERT_EQ(e, t);
 }
 
+TEST_F(SegmentTest, Split) {
+    std::vector<uint32_t> ts_idx_vec = {1, 3};
+    for (bool multi_ts : {false, true}) {
+        Segment* segment = multi_ts ? new Segment(8, ts_idx_vec) : new Segment(8);
+        std::map<int32_t, uint64_t> ts_map;
+        for (int i = 0; i < 100; i++) {
+            std::string pk = "pk" + std::to_string(i);
+            for (int j = 0; j < 3; j++) {
+                if (multi_ts) {
+                    ts_map = {{1, 1000 + j}, {3, 2000 + j}};
+                    ASSERT_TRUE(segment->Put(pk, ts_map, new DataBlock(2, "value", 5)));
+                } else {
+                    ASSERT_TRUE(segment->Put(pk, 1000 + j, "value", 5));
+                }
+            }
+        }
+        ASSERT_EQ(300u, segment->GetPutCnt());
+        // a deleted key waiting in the free list
+        ASSERT_TRUE(segment->Delete("pk0"));
+        uint64_t idx_byte_size = segment->GetIdxByteSize();
+        Segment* segs[4];
+        for (int i = 0; i < 4; i++) {
+            segs[i] = segment->NewEmptySegment();
+            ASSERT_EQ(segment->GetTsCnt(), segs[i]->GetTsCnt());
+        }
+        {
+            // readers are not blocked by the split
+            Ticket ticket;
+            MemTableIterator* it =
+                multi_ts ? segment->NewIterator("pk1", 3, ticket) : segment->NewIterator("pk1", ticket);
+            segment->SplitUnlock(segs, 4, 0xe17a1465);
+            ASSERT_TRUE(segment->IsRetired());
+            ASSERT_FALSE(segment->Put("pk1", 3000, "value", 5));
+            ASSERT_FALSE(segment->Delete("pk1"));
+            it->SeekToFirst();
+            int cnt = 0;
+            for (; it->Valid(); it->Next()) {
+                cnt++;
+            }
+            ASSERT_EQ(3, cnt);
+            delete it;
+        }
+
+        uint64_t pk_cnt = 0;
+        uint64_t idx_cnt = 0;
+        uint64_t split_idx_byte_size = 0;
+        for (int i = 0; i < 4; i++) {
+            pk_cnt += segs[i]->GetPkCnt();
+            idx_cnt += segs[i]->GetIdxCnt();
+            split_idx_byte_size += segs[i]->GetIdxByteSize();
+            ASSERT_GT(segs[i]->GetPkCnt(), 0u);
+        }
+        // pk0 is counted until it is freed
+        ASSERT_EQ(100u, pk_cnt);
+        ASSERT_EQ(300u, idx_cnt);
+        // the nodes of the keys are new, with other heights
+        ASSERT_NE(0u, split_idx_byte_size);
+        ASSERT_NE(0u, idx_byte_size);
+        for (int i = 1; i < 100; i++) {
+            std::string pk = "pk" + std::to_string(i);
+            DataBlock* block = NULL;
+            int found = 0;
+            for (int j = 0; j < 4; j++) {
+                bool ok = multi_ts ? segs[j]->Get(pk, 3, 2001, &block) : segs[j]->Get(pk, 1001, &block);
+                if (ok && block != NULL) {
+                    found++;
+                }
+            }
+            ASSERT_EQ(1, found);
+        }
+        delete segment;
+
+        uint64_t gc_idx_cnt = 0;
+        uint64_t gc_record_cnt = 0;
+        uint64_t gc_record_byte_size = 0;
+        for (int i = 0; i < 4; i++) {
+            segs[i]->IncrGcVersion();
+            segs[i]->IncrGcVersion();
+            segs[i]->GcFreeList(gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+        }
+        ASSERT_EQ(multi_ts ? 6u : 3u, gc_idx_cnt);
+        pk_cnt = 0;
+        for (int i = 0; i < 4; i++) {
+            pk_cnt += segs[i]->GetPkCnt();
+            segs[i]->Release();
+            delete segs[i];
+        }
+        ASSERT_EQ(99u, pk_cnt);
+    }
+}
+
 }  // namespace storage
 }  // namespace openmldb
 
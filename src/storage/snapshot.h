@@ -21,6 +21,7 @@
 
 #include "log/log_writer.h"
 #include "proto/tablet.pb.h"
+#include "storage/recover_progress.h"
 #include "storage/table.h"
 
 namespace openmldb {
@@ -38,7 +39,9 @@ class Snapshot {
     virtual bool Recover(std::shared_ptr<Table> table,
                          uint64_t& latest_offset) = 0;  // NOLINT
     uint64_t GetOffset() { return offset_; }
+    void SetRecoverProgress(std::shared_ptr<RecoverProgress> progress) { progress_ = progress; }
     int GenManifest(const std::string& snapshot_name, uint64_t key_count, uint64_t offset, uint64_t term);
+    int GenManifest(const ::openmldb::api::Manifest& manifest);
     static int GetLocalManifest(const std::string& full_path,
                                 ::openmldb::api::Manifest& manifest);  // NOLINT
 
@@ -48,6 +51,7 @@ class Snapshot {
     uint64_t offset_;
     std::atomic<bool> making_snapshot_;
     std::string snapshot_path_;
+    std::shared_ptr<RecoverProgress> progress_;
 };
 
 }  // namespace storage
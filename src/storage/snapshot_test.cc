@@ -24,6 +24,7 @@
 #include <unistd.h>
 
 #include <iostream>
+#include <memory>
 
 #include "base/file_util.h"
 #include "base/glog_wapper.h"
@@ -42,6 +43,8 @@
 
 DECLARE_string(db_root_path);
 DECLARE_string(snapshot_compression);
+DECLARE_uint32(snapshot_max_delta_cnt);
+DECLARE_uint32(binlog_replay_thread_num);
 
 using ::openmldb::api::LogEntry;
 namespace openmldb {
@@ -346,6 +349,107 @@ TEST_F(SnapshotTest, Recover_only_binlog) {
     ASSERT_FALSE(it->Valid());
 }
 
+TEST_F(SnapshotTest, Recover_binlog_with_progress) {
+    std::string binlog_dir = FLAGS_db_root_path + "/3_4/binlog/";
+    LogParts* log_part = new LogParts(12, 4, scmp);
+    uint64_t offset = 0;
+    uint32_t binlog_index = 0;
+    WriteHandle* wh = NULL;
+    RollWLogFile(&wh, log_part, binlog_dir, binlog_index, offset);
+    uint64_t record_size = 0;
+    for (int count = 0; count < 10; count++) {
+        offset++;
+        auto entry = ::openmldb::test::PackKVEntry(offset, "key", "value" + std::to_string(count), count + 1, 0);
+        std::string buffer;
+        entry.SerializeToString(&buffer);
+        record_size += buffer.size();
+        ::openmldb::base::Slice slice(buffer);
+        ::openmldb::log::Status status = wh->Write(slice);
+        ASSERT_TRUE(status.ok());
+    }
+    wh->Sync();
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    std::shared_ptr<MemTable> table =
+        std::make_shared<MemTable>("test", 3, 4, 8, mapping, 0, ::openmldb::type::TTLType::kAbsoluteTime);
+    table->Init();
+    MemTableSnapshot snapshot(3, 4, log_part, FLAGS_db_root_path);
+    snapshot.Init();
+    ::openmldb::base::RateLimiter limiter(0);
+    auto progress = std::make_shared<RecoverProgress>(record_size * 2, &limiter);
+    progress->Start();
+    ASSERT_EQ(0u, progress->GetEtaMs());
+    snapshot.SetRecoverProgress(progress);
+    uint64_t snapshot_offset = 0;
+    uint64_t latest_offset = 0;
+    ASSERT_TRUE(snapshot.Recover(table, snapshot_offset));
+    Binlog binlog(log_part, binlog_dir);
+    binlog.SetRecoverProgress(progress);
+    binlog.RecoverFromBinlog(table, snapshot_offset, latest_offset);
+    ASSERT_EQ(10u, latest_offset);
+    ASSERT_EQ(record_size * 2, progress->GetTotalBytes());
+    ASSERT_EQ(record_size, progress->GetReadBytes());
+    ASSERT_EQ(10u, table->GetRecordCnt());
+}
+
+TEST_F(SnapshotTest, Recover_binlog_parallel) {
+    std::string binlog_dir = FLAGS_db_root_path + "/4_5/binlog/";
+    LogParts* log_part = new LogParts(12, 4, scmp);
+    uint64_t offset = 0;
+    uint32_t binlog_index = 0;
+    WriteHandle* wh = NULL;
+    RollWLogFile(&wh, log_part, binlog_dir, binlog_index, offset);
+    // key0 is deleted in the middle, only the later 10 records of it are left
+    for (int count = 0; count < 1000; count++) {
+        offset++;
+        std::string key = "key" + std::to_string(count % 50);
+        auto entry = ::openmldb::test::PackKVEntry(offset, key, "value" + std::to_string(count), count + 1, 0);
+        std::string buffer;
+        entry.SerializeToString(&buffer);
+        ::openmldb::base::Slice slice(buffer);
+        ::openmldb::log::Status status = wh->Write(slice);
+        ASSERT_TRUE(status.ok());
+        if (count == 499) {
+            offset++;
+            ::openmldb::api::LogEntry delete_entry;
+            delete_entry.set_log_index(offset);
+            delete_entry.set_method_type(::openmldb::api::MethodType::kDelete);
+            ::openmldb::api::Dimension* dimension = delete_entry.add_dimensions();
+            dimension->set_key("key0");
+            dimension->set_idx(0);
+            delete_entry.SerializeToString(&buffer);
+            ASSERT_TRUE(wh->Write(::openmldb::base::Slice(buffer)).ok());
+        }
+    }
+    wh->Sync();
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    std::shared_ptr<MemTable> table =
+        std::make_shared<MemTable>("test", 4, 5, 8, mapping, 0, ::openmldb::type::TTLType::kAbsoluteTime);
+    table->Init();
+    FLAGS_binlog_replay_thread_num = 4;
+    uint64_t latest_offset = 0;
+    Binlog binlog(log_part, binlog_dir);
+    binlog.RecoverFromBinlog(table, 0, latest_offset);
+    FLAGS_binlog_replay_thread_num = 1;
+    ASSERT_EQ(1001u, latest_offset);
+    Ticket ticket;
+    for (int i = 0; i < 50; i++) {
+        TableIterator* it = table->NewIterator("key" + std::to_string(i), ticket);
+        it->SeekToFirst();
+        uint32_t cnt = 0;
+        uint64_t last_ts = UINT64_MAX;
+        while (it->Valid()) {
+            ASSERT_LT(it->GetKey(), last_ts);
+            last_ts = it->GetKey();
+            cnt++;
+            it->Next();
+        }
+        ASSERT_EQ(i == 0 ? 10u : 20u, cnt);
+        delete it;
+    }
+}
+
 TEST_F(SnapshotTest, Recover_only_snapshot_multi) {
     std::string snapshot_dir = FLAGS_db_root_path + "/3_2/snapshot";
     std::string binlog_dir = FLAGS_db_root_path + "/3_2/binlog";
@@ -854,6 +958,116 @@ TEST_F(SnapshotTest, MakeSnapshot) {
     ASSERT_EQ(7, (int64_t)manifest.term());
 }
 
+TEST_F(SnapshotTest, MakeDeltaSnapshot) {
+    FLAGS_snapshot_max_delta_cnt = 2;
+    LogParts* log_part = new LogParts(12, 4, scmp);
+    MemTableSnapshot snapshot(5, 1, log_part, FLAGS_db_root_path);
+    snapshot.Init();
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    std::shared_ptr<MemTable> table =
+        std::make_shared<MemTable>("tx_log", 5, 1, 8, mapping, 2, ::openmldb::type::TTLType::kAbsoluteTime);
+    table->Init();
+    uint64_t offset = 0;
+    uint32_t binlog_index = 0;
+    std::string log_path = FLAGS_db_root_path + "/5_1/binlog/";
+    std::string snapshot_path = FLAGS_db_root_path + "/5_1/snapshot/";
+    WriteHandle* wh = NULL;
+    RollWLogFile(&wh, log_part, log_path, binlog_index, offset++);
+    auto put = [&](const std::string& key, const std::string& value) {
+        auto entry =
+            ::openmldb::test::PackKVEntry(offset++, key, value, ::baidu::common::timer::get_micros() / 1000, 5);
+        std::string buffer;
+        entry.SerializeToString(&buffer);
+        ASSERT_TRUE(wh->Write(::openmldb::base::Slice(buffer)).ok());
+    };
+    auto del = [&](const std::string& key) {
+        ::openmldb::api::LogEntry entry;
+        entry.set_log_index(offset++);
+        entry.set_method_type(::openmldb::api::MethodType::kDelete);
+        ::openmldb::api::Dimension* dimension = entry.add_dimensions();
+        dimension->set_key(key);
+        dimension->set_idx(0);
+        entry.set_term(5);
+        std::string buffer;
+        entry.SerializeToString(&buffer);
+        ASSERT_TRUE(wh->Write(::openmldb::base::Slice(buffer)).ok());
+    };
+    auto check = [&](int file_cnt, uint64_t manifest_offset, uint64_t count, int delta_cnt) {
+        std::vector<std::string> vec;
+        ASSERT_EQ(0, ::openmldb::base::GetFileName(snapshot_path, vec));
+        ASSERT_EQ(file_cnt, (int32_t)vec.size());
+        ::openmldb::api::Manifest manifest;
+        ASSERT_EQ(0, GetManifest(snapshot_path + "MANIFEST", &manifest));
+        ASSERT_EQ(manifest_offset, manifest.offset());
+        ASSERT_EQ(count, manifest.count());
+        ASSERT_EQ(delta_cnt, manifest.deltas_size());
+    };
+    for (int i = 0; i < 10; i++) {
+        put("key" + std::to_string(i), "value");
+    }
+    // the first snapshot is a full one
+    uint64_t offset_value = 0;
+    ASSERT_EQ(0, snapshot.MakeSnapshot(table, offset_value, 0));
+    ASSERT_EQ(10u, offset_value);
+    check(2, 10, 10, 0);
+
+    for (int i = 10; i < 15; i++) {
+        put("key" + std::to_string(i), "value");
+    }
+    del("key1");
+    put("key1", "new_value");
+    ASSERT_EQ(0, snapshot.MakeSnapshot(table, offset_value, 0));
+    ASSERT_EQ(17u, offset_value);
+    check(3, 17, 10, 1);
+    del("key2");
+    ASSERT_EQ(0, snapshot.MakeSnapshot(table, offset_value, 0));
+    ASSERT_EQ(18u, offset_value);
+    check(4, 18, 10, 2);
+    {
+        ::openmldb::api::Manifest manifest;
+        ASSERT_EQ(0, GetManifest(snapshot_path + "MANIFEST", &manifest));
+        // 5 puts, 1 tombstone and the put after it
+        ASSERT_EQ(7u, manifest.deltas(0).count());
+        ASSERT_EQ(17u, manifest.deltas(0).offset());
+        ASSERT_EQ(1u, manifest.deltas(1).count());
+    }
+
+    // recover from the snapshot and the deltas
+    {
+        std::shared_ptr<MemTable> new_table =
+            std::make_shared<MemTable>("tx_log", 5, 1, 8, mapping, 2, ::openmldb::type::TTLType::kAbsoluteTime);
+        new_table->Init();
+        MemTableSnapshot new_snapshot(5, 1, log_part, FLAGS_db_root_path);
+        ASSERT_TRUE(new_snapshot.Init());
+        uint64_t latest_offset = 0;
+        ASSERT_TRUE(new_snapshot.Recover(new_table, latest_offset));
+        ASSERT_EQ(18u, latest_offset);
+        Ticket ticket;
+        std::unique_ptr<TableIterator> it(new_table->NewIterator("key1", ticket));
+        it->SeekToFirst();
+        ASSERT_TRUE(it->Valid());
+        std::string value(it->GetValue().data(), it->GetValue().size());
+        ASSERT_EQ("new_value", ::openmldb::test::DecodeV(value));
+        it->Next();
+        ASSERT_FALSE(it->Valid());
+        it.reset(new_table->NewIterator("key2", ticket));
+        it->SeekToFirst();
+        ASSERT_FALSE(it->Valid());
+        it.reset(new_table->NewIterator("key14", ticket));
+        it->SeekToFirst();
+        ASSERT_TRUE(it->Valid());
+    }
+
+    // the deltas reach snapshot_max_delta_cnt and are compacted
+    put("key15", "value");
+    ASSERT_EQ(0, snapshot.MakeSnapshot(table, offset_value, 0));
+    ASSERT_EQ(19u, offset_value);
+    // 8 puts of the snapshot, 6 of the first delta and 1 of the binlog
+    check(2, 19, 15, 0);
+    FLAGS_snapshot_max_delta_cnt = 0;
+}
+
 TEST_F(SnapshotTest, MakeSnapshot_with_delete_index) {
     LogParts* log_part = new LogParts(12, 4, scmp);
     MemTableSnapshot snapshot(1, 3, log_part, FLAGS_db_root_path);
@@ -17,6 +17,9 @@
 #include <gflags/gflags.h>
 #include <atomic>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
 #include <utility>
 
 #include "base/glog_wapper.h"
@@ -38,6 +41,8 @@ DECLARE_string(ssd_root_path);
 DECLARE_string(hdd_root_path);
 DECLARE_uint32(max_traverse_cnt);
 DECLARE_int32(gc_safe_offset);
+DECLARE_uint32(hot_key_sample_rate);
+DECLARE_uint32(mem_freeze_age);
 
 namespace openmldb {
 namespace storage {
@@ -209,6 +214,340 @@ TEST_P(TableTest, MultiDimissionPut0) {
     delete table;
 }
 
+TEST_P(TableTest, NumaArenaPut) {
+    ::openmldb::common::StorageMode storageMode = GetParam();
+    if (storageMode == openmldb::common::kHDD) {
+        return;
+    }
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    mapping.insert(std::make_pair("idx1", 1));
+    auto table = new MemTable("tx_log", 1, 1, 8, mapping, 0, ::openmldb::type::kAbsoluteTime);
+    auto arena = std::make_shared<::openmldb::base::NumaArena>(-1);
+    table->SetNumaArena(arena);
+    table->Init();
+    auto meta = ::openmldb::test::GetTableMeta({"idx0", "idx1"});
+    ::openmldb::codec::SDKCodec sdk_codec(meta);
+    std::vector<std::string> rows;
+    for (int i = 0; i < 100; i++) {
+        Dimensions dimensions;
+        ::openmldb::api::Dimension* d0 = dimensions.Add();
+        d0->set_key("d0");
+        d0->set_idx(0);
+        ::openmldb::api::Dimension* d1 = dimensions.Add();
+        d1->set_key("d1_" + std::to_string(i % 10));
+        d1->set_idx(1);
+        std::string result;
+        sdk_codec.EncodeRow({"d0", "d1_" + std::to_string(i % 10)}, &result);
+        ASSERT_TRUE(table->Put(i + 1, result, dimensions));
+        rows.push_back(result);
+    }
+    ASSERT_EQ(1u, arena->GetChunkCnt());
+    Ticket ticket;
+    TableIterator* it = table->NewIterator(0, "d0", ticket);
+    it->SeekToFirst();
+    for (int i = 99; i >= 0; i--) {
+        ASSERT_TRUE(it->Valid());
+        ASSERT_EQ(rows[i], it->GetValue().ToString());
+        it->Next();
+    }
+    ASSERT_FALSE(it->Valid());
+    delete it;
+    // the rows outlive the arena
+    arena.reset();
+    it = table->NewIterator(1, "d1_3", ticket);
+    it->SeekToFirst();
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ(rows[93], it->GetValue().ToString());
+    delete it;
+    delete table;
+}
+
+TEST_P(TableTest, SplitSegments) {
+    ::openmldb::common::StorageMode storageMode = GetParam();
+    if (storageMode == openmldb::common::kHDD) {
+        return;
+    }
+    FLAGS_hot_key_sample_rate = 1;
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    mapping.insert(std::make_pair("idx1", 1));
+    auto table = new MemTable("tx_log", 1, 1, 8, mapping, 0, ::openmldb::type::kAbsoluteTime);
+    table->Init();
+    FLAGS_hot_key_sample_rate = 64;
+    auto meta = ::openmldb::test::GetTableMeta({"idx0", "idx1"});
+    ::openmldb::codec::SDKCodec sdk_codec(meta);
+    auto put = [&](int i) {
+        Dimensions dimensions;
+        ::openmldb::api::Dimension* d0 = dimensions.Add();
+        d0->set_key("d0_" + std::to_string(i % 50));
+        d0->set_idx(0);
+        ::openmldb::api::Dimension* d1 = dimensions.Add();
+        d1->set_key(i % 2 == 0 ? "hot" : "d1_" + std::to_string(i));
+        d1->set_idx(1);
+        std::string result;
+        sdk_codec.EncodeRow({d0->key(), d1->key()}, &result);
+        return table->Put(i + 1, result, dimensions);
+    };
+    for (int i = 0; i < 200; i++) {
+        ASSERT_TRUE(put(i));
+    }
+    uint64_t idx_cnt = table->GetRecordIdxCnt();
+    uint64_t pk_cnt = table->GetRecordPkCnt();
+    uint64_t idx_byte_size = table->GetRecordIdxByteSize();
+    std::vector<uint64_t> put_cnts;
+    std::vector<uint64_t> get_cnts;
+    ASSERT_TRUE(table->GetSegAccessCnt(0, &put_cnts, &get_cnts));
+    ASSERT_EQ(8u, put_cnts.size());
+    ASSERT_EQ(200u, std::accumulate(put_cnts.begin(), put_cnts.end(), 0ul));
+    std::vector<std::pair<std::string, uint64_t>> hot_keys;
+    ASSERT_TRUE(table->GetHotKeys(1, &hot_keys));
+    ASSERT_EQ("hot", hot_keys[0].first);
+    ASSERT_EQ(100u, hot_keys[0].second);
+
+    // the iterators over the old segments go on after the split
+    TraverseIterator* traverse_it = table->NewTraverseIterator(0);
+    traverse_it->SeekToFirst();
+    ASSERT_FALSE(table->SplitSegments(12));
+    ASSERT_TRUE(table->SplitSegments(16));
+    ASSERT_EQ(16u, table->GetSegCnt());
+    uint64_t cnt = 0;
+    for (; traverse_it->Valid(); traverse_it->Next()) {
+        cnt++;
+    }
+    ASSERT_EQ(200u, cnt);
+    delete traverse_it;
+
+    ASSERT_EQ(idx_cnt, table->GetRecordIdxCnt());
+    ASSERT_EQ(pk_cnt, table->GetRecordPkCnt());
+    ASSERT_GT(table->GetRecordIdxByteSize(), idx_byte_size / 2);
+    for (int i = 200; i < 300; i++) {
+        ASSERT_TRUE(put(i));
+    }
+    ASSERT_TRUE(table->Delete("d0_1", 0));
+    Ticket ticket;
+    for (int i = 0; i < 50; i++) {
+        TableIterator* it = table->NewIterator(0, "d0_" + std::to_string(i), ticket);
+        it->SeekToFirst();
+        int rows = 0;
+        for (; it->Valid(); it->Next()) {
+            rows++;
+        }
+        ASSERT_EQ(i == 1 ? 0 : 6, rows);
+        delete it;
+    }
+    ASSERT_TRUE(table->GetSegAccessCnt(0, &put_cnts, &get_cnts));
+    ASSERT_EQ(16u, put_cnts.size());
+    ASSERT_EQ(100u, std::accumulate(put_cnts.begin(), put_cnts.end(), 0ul));
+    table->SchedGc();
+    table->SchedGc();
+    table->SchedGc();
+    // the deleted key is freed by the new segment
+    ASSERT_EQ(151u, pk_cnt);
+    ASSERT_EQ(200u, table->GetRecordPkCnt());
+    delete table;
+}
+
+TEST_P(TableTest, DictEncode) {
+    ::openmldb::common::StorageMode storageMode = GetParam();
+    if (storageMode == openmldb::common::kHDD) {
+        return;
+    }
+    ::openmldb::api::TableMeta table_meta;
+    table_meta.set_name("dict_t");
+    table_meta.set_tid(1);
+    table_meta.set_pid(1);
+    table_meta.set_seg_cnt(4);
+    table_meta.set_format_version(1);
+    table_meta.set_dict_encode(true);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "card", ::openmldb::type::kString);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "mcc", ::openmldb::type::kString);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "ts1", ::openmldb::type::kBigInt);
+    SchemaCodec::SetIndex(table_meta.add_column_key(), "card", "card", "ts1", ::openmldb::type::kAbsoluteTime, 0, 0);
+    SchemaCodec::SetIndex(table_meta.add_column_key(), "mcc", "mcc", "ts1", ::openmldb::type::kAbsoluteTime, 0, 0);
+    MemTable* table = new MemTable(table_meta);
+    ASSERT_TRUE(table->Init());
+    ASSERT_TRUE(table->GetRowDict() != NULL);
+    ::openmldb::codec::SDKCodec codec(table_meta);
+    std::map<uint64_t, std::string> rows;
+    for (int i = 0; i < 100; i++) {
+        std::vector<std::string> row = {"card" + std::to_string(i % 10), "mcc" + std::to_string(i % 5),
+                                        std::to_string(1000 + i)};
+        Dimensions dimensions;
+        ::openmldb::api::Dimension* dim = dimensions.Add();
+        dim->set_idx(0);
+        dim->set_key(row[0]);
+        dim = dimensions.Add();
+        dim->set_idx(1);
+        dim->set_key(row[1]);
+        std::string value;
+        ASSERT_EQ(0, codec.EncodeRow(row, &value));
+        ASSERT_TRUE(table->Put(0, value, dimensions));
+        rows.emplace(1000 + i, value);
+    }
+    ASSERT_GT(table->GetRowDict()->GetSavedByteSize(), 0u);
+
+    // the rows are decoded by every iterator, once at a position
+    TraverseIterator* traverse_it = table->NewTraverseIterator(1);
+    traverse_it->SeekToFirst();
+    uint64_t cnt = 0;
+    for (; traverse_it->Valid(); traverse_it->Next()) {
+        ASSERT_EQ(rows[traverse_it->GetKey()], traverse_it->GetValue().ToString());
+        ASSERT_EQ(traverse_it->GetValue().data(), traverse_it->GetValue().data());
+        cnt++;
+    }
+    ASSERT_EQ(100u, cnt);
+    delete traverse_it;
+    Ticket ticket;
+    TableIterator* it = table->NewIterator(0, "card3", ticket);
+    it->SeekToFirst();
+    cnt = 0;
+    for (; it->Valid(); it->Next()) {
+        ASSERT_EQ(rows[it->GetKey()], it->GetValue().ToString());
+        cnt++;
+    }
+    ASSERT_EQ(10u, cnt);
+    delete it;
+    ::hybridse::vm::WindowIterator* window_it = table->NewWindowIterator(0);
+    window_it->SeekToFirst();
+    cnt = 0;
+    for (; window_it->Valid(); window_it->Next()) {
+        std::unique_ptr<::hybridse::vm::RowIterator> row_it = window_it->GetValue();
+        for (row_it->SeekToFirst(); row_it->Valid(); row_it->Next()) {
+            const ::hybridse::codec::Row& row = row_it->GetValue();
+            ASSERT_EQ(rows[row_it->GetKey()], std::string(reinterpret_cast<const char*>(row.buf()), row.size()));
+            cnt++;
+        }
+    }
+    ASSERT_EQ(100u, cnt);
+    delete window_it;
+    uint64_t decode_cnt = 0;
+    uint64_t ns_per_row = 0;
+    table->GetRowDict()->GetDecodeStat(&decode_cnt, &ns_per_row);
+    ASSERT_GT(decode_cnt, 0u);
+    delete table;
+}
+
+TEST_P(TableTest, TieredTable) {
+    ::openmldb::common::StorageMode storageMode = GetParam();
+    if (storageMode == openmldb::common::kMemory) {
+        return;
+    }
+    uint32_t id = counter++;
+    ::openmldb::api::TableMeta table_meta;
+    table_meta.set_name("tiered_t");
+    table_meta.set_tid(id);
+    table_meta.set_pid(1);
+    table_meta.set_seg_cnt(4);
+    table_meta.set_format_version(1);
+    table_meta.set_cold_age(1);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "card", ::openmldb::type::kString);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "mcc", ::openmldb::type::kString);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "ts1", ::openmldb::type::kBigInt);
+    SchemaCodec::SetIndex(table_meta.add_column_key(), "card", "card", "ts1", ::openmldb::type::kAbsoluteTime, 0, 0);
+    SchemaCodec::SetIndex(table_meta.add_column_key(), "mcc", "mcc", "ts1", ::openmldb::type::kAbsoluteTime, 0, 0);
+    ::openmldb::api::TableMeta cold_meta(table_meta);
+    cold_meta.set_storage_mode(storageMode);
+    std::string cold_path = GetDBPath(FLAGS_hdd_root_path, id, 1) + "/cold";
+    std::shared_ptr<Table> cold_table(CreateTable(cold_meta, cold_path));
+    ASSERT_TRUE(cold_table->Init());
+    MemTable* table = new MemTable(table_meta);
+    table->SetColdTable(cold_table);
+    ASSERT_TRUE(table->Init());
+    ASSERT_TRUE(table->GetColdTable() != NULL);
+    ::openmldb::codec::SDKCodec codec(table_meta);
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    std::map<std::string, std::map<uint64_t, std::string>> rows;
+    auto put = [&](const std::string& card, const std::string& mcc, uint64_t ts) {
+        std::vector<std::string> row = {card, mcc, std::to_string(ts)};
+        Dimensions dimensions;
+        ::openmldb::api::Dimension* dim = dimensions.Add();
+        dim->set_idx(0);
+        dim->set_key(card);
+        dim = dimensions.Add();
+        dim->set_idx(1);
+        dim->set_key(mcc);
+        std::string value;
+        ASSERT_EQ(0, codec.EncodeRow(row, &value));
+        ASSERT_TRUE(table->Put(0, value, dimensions));
+        rows[card].emplace(ts, value);
+    };
+    // the old rows go to the cold tier at once, and the ones about to be old are moved by the gc
+    for (int i = 0; i < 20; i++) {
+        put("card" + std::to_string(i % 4), "mcc" + std::to_string(i % 2), now - 120 * 1000 - i);
+        put("card" + std::to_string(i % 4), "mcc" + std::to_string(i % 2), now - 60 * 1000 + 500 - i);
+        put("card" + std::to_string(i % 4), "mcc" + std::to_string(i % 2), now - i);
+    }
+    // the keys only in the cold tier
+    put("card_cold", "mcc_cold", now - 120 * 1000);
+    ASSERT_EQ(40u, table->GetRecordCnt());
+    sleep(1);
+    table->SchedGc();
+    ASSERT_EQ(20u, table->GetRecordCnt());
+
+    auto check_rows = [&](const std::string& card) {
+        Ticket ticket;
+        TableIterator* it = table->NewIterator(0, card, ticket);
+        it->SeekToFirst();
+        auto expected = rows[card].rbegin();
+        for (; it->Valid(); it->Next()) {
+            ASSERT_TRUE(expected != rows[card].rend());
+            ASSERT_EQ(expected->first, it->GetKey());
+            ASSERT_EQ(expected->second, it->GetValue().ToString());
+            expected++;
+        }
+        ASSERT_TRUE(expected == rows[card].rend());
+        delete it;
+    };
+    for (const auto& kv : rows) {
+        check_rows(kv.first);
+    }
+
+    TraverseIterator* traverse_it = table->NewTraverseIterator(0);
+    traverse_it->SeekToFirst();
+    std::map<std::string, uint64_t> cnts;
+    uint64_t last_ts = UINT64_MAX;
+    std::string last_pk;
+    for (; traverse_it->Valid(); traverse_it->Next()) {
+        if (traverse_it->GetPK() == last_pk) {
+            ASSERT_LT(traverse_it->GetKey(), last_ts);
+        }
+        last_pk = traverse_it->GetPK();
+        last_ts = traverse_it->GetKey();
+        ASSERT_EQ(rows[last_pk][last_ts], traverse_it->GetValue().ToString());
+        cnts[last_pk]++;
+    }
+    delete traverse_it;
+    ASSERT_EQ(rows.size(), cnts.size());
+    for (const auto& kv : rows) {
+        ASSERT_EQ(kv.second.size(), cnts[kv.first]);
+    }
+
+    ::hybridse::vm::WindowIterator* window_it = table->NewWindowIterator(0);
+    window_it->SeekToFirst();
+    uint64_t cnt = 0;
+    for (; window_it->Valid(); window_it->Next()) {
+        auto key = window_it->GetKey();
+        std::string card(reinterpret_cast<const char*>(key.buf()), key.size());
+        std::unique_ptr<::hybridse::vm::RowIterator> row_it = window_it->GetValue();
+        uint64_t key_cnt = 0;
+        for (row_it->SeekToFirst(); row_it->Valid(); row_it->Next()) {
+            const ::hybridse::codec::Row& row = row_it->GetValue();
+            ASSERT_EQ(rows[card][row_it->GetKey()], std::string(reinterpret_cast<const char*>(row.buf()), row.size()));
+            key_cnt++;
+        }
+        ASSERT_EQ(rows[card].size(), key_cnt);
+        cnt += key_cnt;
+    }
+    ASSERT_EQ(61u, cnt);
+    delete window_it;
+
+    ASSERT_TRUE(table->Delete("card1", 0));
+    rows.erase("card1");
+    check_rows("card1");
+    delete table;
+}
+
 TEST_P(TableTest, IsExpired) {
     ::openmldb::common::StorageMode storageMode = GetParam();
     std::map<std::string, uint32_t> mapping;
@@ -1641,6 +1980,78 @@ TEST_F(TableTest, Release) {
     delete table;
 }
 
+TEST_F(TableTest, WriteVersion) {
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    MemTable* table = new MemTable("tx_log", 1, 1, 8, mapping, 0, ::openmldb::type::kLatestTime);
+    MemTable* other_table = new MemTable("tx_log", 2, 1, 8, mapping, 0, ::openmldb::type::kLatestTime);
+    table->Init();
+    other_table->Init();
+    uint64_t version = table->GetWriteVersion();
+    ASSERT_NE(version, other_table->GetWriteVersion());
+    table->Put("test", 9537, "test", 4);
+    ASSERT_GT(table->GetWriteVersion(), version);
+    version = table->GetWriteVersion();
+    ASSERT_EQ(version, table->GetWriteVersion());
+    table->Delete("test", 0);
+    ASSERT_GT(table->GetWriteVersion(), version);
+    version = table->GetWriteVersion();
+    table->SchedGc();
+    ASSERT_GT(table->GetWriteVersion(), version);
+    // the writes counted by the old segments are kept by a split
+    for (int i = 0; i < 10; i++) {
+        table->Put("key" + std::to_string(i), 9537, "test", 4);
+    }
+    version = table->GetWriteVersion();
+    ASSERT_TRUE(table->SplitSegments(16));
+    ASSERT_GT(table->GetWriteVersion(), version);
+    version = table->GetWriteVersion();
+    table->Put("key0", 9538, "test", 4);
+    ASSERT_GT(table->GetWriteVersion(), version);
+    delete table;
+    delete other_table;
+}
+
+TEST_F(TableTest, Freeze) {
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    MemTable* table = new MemTable("tx_log", 1, 1, 8, mapping, 0, ::openmldb::type::kAbsoluteTime);
+    table->Init();
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    for (int i = 0; i < 40; i++) {
+        table->Put("test", now - 20 * 60 * 1000 - i, "old", 3);
+    }
+    for (int i = 0; i < 10; i++) {
+        table->Put("test", now - i, "new", 3);
+    }
+    uint64_t idx_byte_size = table->GetRecordIdxByteSize();
+    FLAGS_mem_freeze_age = 10;
+    table->SchedGc();
+    FLAGS_mem_freeze_age = 0;
+    ASSERT_LT(table->GetRecordIdxByteSize(), idx_byte_size);
+    ASSERT_EQ(50u, table->GetRecordIdxCnt());
+    // a late put among the frozen rows
+    table->Put("test", now - 20 * 60 * 1000 - 100, "late", 4);
+    Ticket ticket;
+    TableIterator* it = table->NewIterator("test", ticket);
+    it->SeekToFirst();
+    int cnt = 0;
+    uint64_t last = UINT64_MAX;
+    while (it->Valid()) {
+        ASSERT_LE(it->GetKey(), last);
+        last = it->GetKey();
+        ASSERT_EQ(cnt < 10 ? "new" : (cnt < 50 ? "old" : "late"), it->GetValue().ToString());
+        cnt++;
+        it->Next();
+    }
+    ASSERT_EQ(51, cnt);
+    it->Seek(now - 20 * 60 * 1000 - 39);
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ(now - 20 * 60 * 1000 - 39, it->GetKey());
+    delete it;
+    delete table;
+}
+
 TEST_P(TableTest, TSColIDLength) {
     ::openmldb::common::StorageMode storageMode = GetParam();
     ::openmldb::api::TableMeta table_meta;
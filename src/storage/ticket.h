@@ -17,27 +17,55 @@
 #ifndef SRC_STORAGE_TICKET_H_
 #define SRC_STORAGE_TICKET_H_
 
+#include <utility>
 #include <vector>
 
-#include "storage/segment.h"
+#include "base/epoch.h"
 
 namespace openmldb {
 namespace storage {
 
-class KeyEntry;
-
+// a reader of the memory tables holds a ticket while it reads. the ticket enters the epoch of
+// every table it reads, and the memory freed by the gc of those tables meanwhile is not reclaimed
+// until the ticket is destroyed, see EpochManager. a ticket should live no longer than one query
+// or scan. it may outlive the tables it read, and it is not thread safe
 class Ticket {
  public:
-    Ticket();
-    ~Ticket();
+    Ticket() : manager_(nullptr), slot_(0) {}
+    ~Ticket() {
+        if (manager_ != nullptr) {
+            manager_->Exit(slot_);
+        }
+        for (const auto& kv : others_) {
+            kv.first->Exit(kv.second);
+        }
+    }
     Ticket(const Ticket&) = delete;
     Ticket& operator=(const Ticket& s) = delete;
 
-    void Push(KeyEntry* entry);
-    void Pop();
+    // enter the epoch of `manager` unless the ticket is in, before reading what it guards
+    void Enter(::openmldb::base::EpochManager* manager) {
+        if (manager == manager_) {
+            return;
+        }
+        if (manager_ == nullptr) {
+            slot_ = manager->Enter();
+            manager_ = manager;
+            return;
+        }
+        for (const auto& kv : others_) {
+            if (kv.first == manager) {
+                return;
+            }
+        }
+        others_.emplace_back(manager, manager->Enter());
+    }
 
  private:
-    std::vector<KeyEntry*> entries_;
+    // most tickets read one table
+    ::openmldb::base::EpochManager* manager_;
+    uint32_t slot_;
+    std::vector<std::pair<::openmldb::base::EpochManager*, uint32_t>> others_;
 };
 
 }  // namespace storage
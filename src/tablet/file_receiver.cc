@@ -16,15 +16,33 @@
 
 #include "tablet/file_receiver.h"
 
+#include <errno.h>
+#include <string.h>
+
 #include "base/file_util.h"
 #include "base/glog_wapper.h"
 #include "base/strings.h"
+#include "log/crc32c.h"
 
 namespace openmldb {
 namespace tablet {
 
+uint32_t RangeChecksum(const butil::IOBuf& data) {
+    uint32_t crc = 0;
+    for (size_t i = 0; i < data.backing_block_num(); i++) {
+        auto block = data.backing_block(i);
+        crc = ::openmldb::log::Extend(crc, block.data(), block.size());
+    }
+    return crc;
+}
+
+uint32_t FileChecksum(const std::vector<uint32_t>& range_checksums) {
+    return ::openmldb::log::Value(reinterpret_cast<const char*>(range_checksums.data()),
+                                  range_checksums.size() * sizeof(uint32_t));
+}
+
 FileReceiver::FileReceiver(const std::string& file_name, const std::string& dir_name, const std::string& path)
-    : file_name_(file_name), dir_name_(dir_name), path_(path), size_(0), block_id_(0), file_(NULL) {}
+    : file_name_(file_name), dir_name_(dir_name), path_(path), size_(0), block_id_(0), file_(NULL), file_size_(0) {}
 
 FileReceiver::~FileReceiver() {
     if (file_) fclose(file_);
@@ -80,6 +98,74 @@ int FileReceiver::WriteData(const std::string& data, uint64_t block_id) {
     return 0;
 }
 
+bool FileReceiver::InitRanges(uint64_t file_size) {
+    if (!Init()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    file_size_ = file_size;
+    size_ = 0;
+    range_checksums_.clear();
+    return true;
+}
+
+int FileReceiver::WriteRange(butil::IOBuf* data, uint64_t offset) {
+    if (file_ == NULL) {
+        PDLOG(WARNING, "file is NULL");
+        return -1;
+    }
+    uint64_t len = data->size();
+    // offset + len may overflow with a huge offset
+    if (offset > file_size_ || len > file_size_ - offset) {
+        PDLOG(WARNING, "range [%lu, %lu) is out of file %s%s of size %lu", offset, offset + len, path_.c_str(),
+              file_name_.c_str(), file_size_);
+        return -1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (range_checksums_.count(offset) > 0) {
+            DEBUGLOG("range at %lu has been received", offset);
+            data->clear();
+            return 0;
+        }
+    }
+    uint32_t checksum = RangeChecksum(*data);
+    int fd = fileno(file_);
+    uint64_t written = 0;
+    while (!data->empty()) {
+        ssize_t n = data->pcut_into_file_descriptor(fd, offset + written, data->size());
+        if (n < 0) {
+            PDLOG(WARNING, "write error. name %s%s, error %s", path_.c_str(), file_name_.c_str(), strerror(errno));
+            return -1;
+        }
+        written += n;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    if (range_checksums_.emplace(offset, checksum).second) {
+        size_ += len;
+    }
+    return 0;
+}
+
+bool FileReceiver::CheckRanges(uint32_t checksum) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (size_ != file_size_) {
+        PDLOG(WARNING, "file %s%s is incomplete. received %lu, file size %lu", path_.c_str(), file_name_.c_str(),
+              size_, file_size_);
+        return false;
+    }
+    std::vector<uint32_t> checksums;
+    checksums.reserve(range_checksums_.size());
+    for (const auto& kv : range_checksums_) {
+        checksums.push_back(kv.second);
+    }
+    if (FileChecksum(checksums) != checksum) {
+        PDLOG(WARNING, "checksum mismatch. file %s%s", path_.c_str(), file_name_.c_str());
+        return false;
+    }
+    return true;
+}
+
 void FileReceiver::SaveFile() {
     std::string full_path = path_ + file_name_;
     std::string tmp_file_path = full_path + ".tmp";
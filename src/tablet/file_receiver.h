@@ -16,11 +16,20 @@
 
 #pragma once
 
+#include <map>
+#include <mutex>  // NOLINT
 #include <string>
+#include <vector>
+
+#include "butil/iobuf.h"
 
 namespace openmldb {
 namespace tablet {
 
+// a file sent by ranges is checked by the crc32c of the crc32c of its ranges in order
+uint32_t RangeChecksum(const butil::IOBuf& data);
+uint32_t FileChecksum(const std::vector<uint32_t>& range_checksums);
+
 class FileReceiver {
  public:
     FileReceiver(const std::string& file_name, const std::string& dir_name, const std::string& path);
@@ -32,6 +41,14 @@ class FileReceiver {
     void SaveFile();
     uint64_t GetBlockId();
 
+    // receive a file of `file_size` by ranges, which may be written concurrently,
+    // in any order and more than once
+    bool InitRanges(uint64_t file_size);
+    // write `data` at `offset` without a copy, `data` is cleared
+    int WriteRange(butil::IOBuf* data, uint64_t offset);
+    // check that all the ranges are received and match `checksum`
+    bool CheckRanges(uint32_t checksum);
+
  private:
     std::string file_name_;
     std::string dir_name_;
@@ -39,6 +56,10 @@ class FileReceiver {
     uint64_t size_;
     uint64_t block_id_;
     FILE* file_;
+    uint64_t file_size_;
+    std::mutex mu_;
+    // the checksums of the received ranges by offset
+    std::map<uint64_t, uint32_t> range_checksums_;
 };
 
 }  // namespace tablet
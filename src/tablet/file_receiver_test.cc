@@ -0,0 +1,105 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/file_receiver.h"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/glog_wapper.h"
+#include "gtest/gtest.h"
+
+namespace openmldb::tablet {
+
+class FileReceiverTest : public ::testing::Test {
+ public:
+    FileReceiverTest() : path_("/tmp/file_receiver_test_" + std::to_string(getpid()) + "/") {}
+    ~FileReceiverTest() { ::openmldb::base::RemoveDirRecursive(path_); }
+
+ protected:
+    std::string path_;
+};
+
+static butil::IOBuf ToIOBuf(const std::string& str) {
+    butil::IOBuf buf;
+    buf.append(str.data(), str.size());
+    return buf;
+}
+
+TEST_F(FileReceiverTest, WriteRange) {
+    std::string content;
+    for (int i = 0; i < 2500; i++) {
+        content.append(std::to_string(i));
+    }
+    const uint64_t range_size = 4096;
+    std::vector<std::string> ranges;
+    std::vector<uint32_t> checksums;
+    for (uint64_t offset = 0; offset < content.size(); offset += range_size) {
+        ranges.push_back(content.substr(offset, range_size));
+        checksums.push_back(RangeChecksum(ToIOBuf(ranges.back())));
+    }
+    ASSERT_GT(ranges.size(), 2u);
+    uint32_t checksum = FileChecksum(checksums);
+
+    FileReceiver receiver("data", "", path_);
+    ASSERT_TRUE(receiver.InitRanges(content.size()));
+    // in reverse order, the first range twice
+    for (int i = ranges.size() - 1; i >= 0; i--) {
+        auto buf = ToIOBuf(ranges[i]);
+        ASSERT_EQ(0, receiver.WriteRange(&buf, i * range_size));
+        ASSERT_TRUE(buf.empty());
+        if (i > 0) {
+            ASSERT_FALSE(receiver.CheckRanges(checksum));
+        }
+    }
+    auto buf = ToIOBuf(ranges[0]);
+    ASSERT_EQ(0, receiver.WriteRange(&buf, 0));
+    // out of the file
+    buf = ToIOBuf(ranges[1]);
+    ASSERT_EQ(-1, receiver.WriteRange(&buf, content.size()));
+    // an offset which overflows with the size of the range
+    buf = ToIOBuf(ranges[1]);
+    ASSERT_EQ(-1, receiver.WriteRange(&buf, UINT64_MAX - 10));
+    ASSERT_FALSE(receiver.CheckRanges(checksum + 1));
+    ASSERT_TRUE(receiver.CheckRanges(checksum));
+    receiver.SaveFile();
+
+    std::ifstream file(path_ + "data");
+    std::stringstream received;
+    received << file.rdbuf();
+    ASSERT_EQ(content, received.str());
+}
+
+TEST_F(FileReceiverTest, EmptyFile) {
+    FileReceiver receiver("empty", "", path_);
+    ASSERT_TRUE(receiver.InitRanges(0));
+    ASSERT_TRUE(receiver.CheckRanges(FileChecksum({})));
+    receiver.SaveFile();
+    ASSERT_TRUE(::openmldb::base::IsExists(path_ + "empty"));
+}
+
+}  // namespace openmldb::tablet
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    return RUN_ALL_TESTS();
+}
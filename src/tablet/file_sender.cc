@@ -16,14 +16,21 @@
 
 #include "tablet/file_sender.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
 #include <thread>  // NOLINT
 #include <vector>
 
 #include "base/file_util.h"
 #include "base/glog_wapper.h"
+#include "base/rate_limiter.h"
 #include "boost/algorithm/string/predicate.hpp"
 #include "common/timer.h"
 #include "gflags/gflags.h"
+#include "tablet/file_receiver.h"
 
 DECLARE_int32(send_file_max_try);
 DECLARE_uint32(stream_block_size);
@@ -34,17 +41,28 @@ DECLARE_int32(stream_close_wait_time_ms);
 DECLARE_int32(retry_send_file_wait_time_ms);
 DECLARE_int32(request_max_retry);
 DECLARE_int32(request_timeout_ms);
+DECLARE_uint32(send_file_parallelism);
 
 namespace openmldb {
 namespace tablet {
 
+// all the files sent by the process share the bandwidth of FLAGS_stream_bandwidth_limit, which is
+// read again on every use so that a change of the flag takes effect at once
+static ::openmldb::base::RateLimiter* GetBandwidthLimiter() {
+    uint64_t rate = FLAGS_stream_bandwidth_limit > 0 ? FLAGS_stream_bandwidth_limit : 0;
+    static ::openmldb::base::RateLimiter limiter(rate);
+    if (limiter.GetRate() != rate) {
+        limiter.SetRate(rate);
+    }
+    return &limiter;
+}
+
 FileSender::FileSender(uint32_t tid, uint32_t pid, const std::string& endpoint)
     : tid_(tid),
       pid_(pid),
       endpoint_(endpoint),
       cur_try_time_(0),
       max_try_time_(FLAGS_send_file_max_try),
-      limit_time_(0),
       channel_(NULL),
       stub_(NULL) {}
 
@@ -54,12 +72,6 @@ FileSender::~FileSender() {
 }
 
 bool FileSender::Init() {
-    // compute the used time(microseconds) that send a block by limit bandwidth.
-    // limit_time = (FLAGS_stream_block_size / FLAGS_stream_bandwidth_limit) *
-    // 1000 * 1000
-    if (FLAGS_stream_bandwidth_limit > 0) {
-        limit_time_ = (FLAGS_stream_block_size * 1000000) / FLAGS_stream_bandwidth_limit;
-    }
     channel_ = new brpc::Channel();
     brpc::ChannelOptions options;
     options.timeout_ms = FLAGS_request_timeout_ms;
@@ -78,7 +90,7 @@ int FileSender::WriteData(const std::string& file_name, const std::string& dir_n
     if (buffer == NULL) {
         return -1;
     }
-    uint64_t cur_time = ::baidu::common::timer::get_micros();
+    GetBandwidthLimiter()->Acquire(len);
     ::openmldb::api::SendDataRequest request;
     request.set_tid(tid_);
     request.set_pid(pid_);
@@ -106,12 +118,6 @@ int FileSender::WriteData(const std::string& file_name, const std::string& dir_n
               response.msg().c_str());
         return -1;
     }
-    uint64_t time_used = ::baidu::common::timer::get_micros() - cur_time;
-    if (limit_time_ > time_used && len > FLAGS_stream_block_size / 2) {
-        uint64_t sleep_time = limit_time_ - time_used;
-        DEBUGLOG("sleep %lu us, limit_time %lu time_used %lu", sleep_time, limit_time_, time_used);
-        std::this_thread::sleep_for(std::chrono::microseconds(sleep_time));
-    }
     return 0;
 }
 
@@ -139,7 +145,11 @@ int FileSender::SendFile(const std::string& file_name, const std::string& dir_na
                   file_size);
         }
         try_times--;
-        if (SendFileInternal(file_name, dir_name, full_path, file_size) < 0) {
+        if (FLAGS_send_file_parallelism > 1) {
+            if (SendFileByRanges(file_name, dir_name, full_path, file_size) < 0) {
+                continue;
+            }
+        } else if (SendFileInternal(file_name, dir_name, full_path, file_size) < 0) {
             continue;
         }
         if (CheckFile(file_name, dir_name, file_size) < 0) {
@@ -204,7 +214,116 @@ int FileSender::SendFileInternal(const std::string& file_name, const std::string
     return ret;
 }
 
-int FileSender::CheckFile(const std::string& file_name, const std::string& dir_name, uint64_t file_size) {
+int FileSender::SendRange(const std::string& file_name, const std::string& dir_name, uint64_t block_id,
+                          uint64_t offset, uint64_t file_size, const butil::IOBuf* data, bool eof,
+                          uint32_t checksum) {
+    ::openmldb::api::SendDataRequest request;
+    request.set_tid(tid_);
+    request.set_pid(pid_);
+    request.set_file_name(file_name);
+    if (!dir_name.empty()) {
+        request.set_dir_name(dir_name);
+    }
+    request.set_block_id(block_id);
+    request.set_offset(offset);
+    request.set_file_size(file_size);
+    brpc::Controller cntl;
+    if (data != nullptr) {
+        request.set_block_size(data->size());
+        // the blocks of the attachment are shared with `data`
+        cntl.request_attachment().append(*data);
+    } else {
+        request.set_block_size(0);
+    }
+    if (eof) {
+        request.set_eof(true);
+        request.set_checksum(checksum);
+    }
+    ::openmldb::api::GeneralResponse response;
+    stub_->SendData(&cntl, &request, &response, NULL);
+    if (cntl.Failed()) {
+        PDLOG(WARNING, "send range failed. tid %u pid %u file %s offset %lu error msg %s", tid_, pid_,
+              file_name.c_str(), offset, cntl.ErrorText().c_str());
+        return -1;
+    } else if (response.code() != 0) {
+        PDLOG(WARNING, "send range failed. tid %u pid %u file %s offset %lu error msg %s", tid_, pid_,
+              file_name.c_str(), offset, response.msg().c_str());
+        return -1;
+    }
+    return 0;
+}
+
+int FileSender::SendFileByRanges(const std::string& file_name, const std::string& dir_name,
+                                 const std::string& full_path, uint64_t file_size) {
+    int fd = open(full_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        PDLOG(WARNING, "fail to open file %s", full_path.c_str());
+        return -1;
+    }
+    if (SendRange(file_name, dir_name, 0, 0, file_size, nullptr, false, 0) < 0) {
+        PDLOG(WARNING, "Init file receiver failed. tid[%u] pid[%u] file %s", tid_, pid_, file_name.c_str());
+        close(fd);
+        return -1;
+    }
+    const uint64_t block_size = FLAGS_stream_block_size;
+    const uint64_t block_num = (file_size + block_size - 1) / block_size;
+    const uint64_t report_block_num = block_num / 100;
+    std::vector<uint32_t> checksums(block_num);
+    std::atomic<uint64_t> next_block(0);
+    std::atomic<bool> has_error(false);
+    auto send_blocks = [&]() {
+        butil::IOPortal data;
+        uint64_t block = 0;
+        while (!has_error.load(std::memory_order_relaxed) &&
+               (block = next_block.fetch_add(1, std::memory_order_relaxed)) < block_num) {
+            uint64_t offset = block * block_size;
+            uint64_t len = std::min(block_size, file_size - offset);
+            data.clear();
+            while (data.size() < len) {
+                if (data.pappend_from_file_descriptor(fd, offset + data.size(), len - data.size()) <= 0) {
+                    PDLOG(WARNING, "read file %s error. error message: %s", file_name.c_str(), strerror(errno));
+                    has_error.store(true, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            checksums[block] = RangeChecksum(data);
+            GetBandwidthLimiter()->Acquire(len);
+            // a failed block is sent again alone
+            int try_times = FLAGS_send_file_max_try;
+            while (SendRange(file_name, dir_name, block + 1, offset, file_size, &data, false, 0) < 0) {
+                if (--try_times <= 0 || has_error.load(std::memory_order_relaxed)) {
+                    has_error.store(true, std::memory_order_relaxed);
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS_retry_send_file_wait_time_ms));
+            }
+            if (report_block_num == 0 || (block + 1) % report_block_num == 0) {
+                PDLOG(INFO,
+                      "send block num[%lu] total block num[%lu]. tid[%u] pid[%u] "
+                      "file[%s] endpoint[%s]",
+                      block + 1, block_num, tid_, pid_, file_name.c_str(), endpoint_.c_str());
+            }
+        }
+    };
+    uint64_t thread_num = std::min<uint64_t>(FLAGS_send_file_parallelism, block_num);
+    std::vector<std::thread> threads;
+    for (uint64_t i = 1; i < thread_num; i++) {
+        threads.emplace_back(send_blocks);
+    }
+    send_blocks();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    close(fd);
+    if (has_error.load(std::memory_order_relaxed)) {
+        return -1;
+    }
+    return SendRange(file_name, dir_name, block_num + 1, file_size, file_size, nullptr, true,
+                     FileChecksum(checksums));
+}
+
+int FileSender::CheckFile(const std::string& file_name, const std::string& dir_name, uint64_t file_size,
+                          bool log_mismatch) {
     ::openmldb::api::CheckFileRequest check_request;
     ::openmldb::api::GeneralResponse response;
     check_request.set_tid(tid_);
@@ -222,13 +341,29 @@ int FileSender::CheckFile(const std::string& file_name, const std::string& dir_n
         return -1;
     }
     if (response.code() != 0) {
-        PDLOG(WARNING, "check file[%s] failed. tid[%u] pid[%u]", file_name.c_str(), tid_, pid_);
+        if (log_mismatch) {
+            PDLOG(WARNING, "check file[%s] failed. tid[%u] pid[%u]", file_name.c_str(), tid_, pid_);
+        }
         return -1;
     }
     PDLOG(INFO, "send file[%s] success. tid[%u] pid[%u]", file_name.c_str(), tid_, pid_);
     return 0;
 }
 
+int FileSender::SendFileIfMissing(const std::string& file_name, const std::string& full_path) {
+    uint64_t file_size = 0;
+    if (!::openmldb::base::GetFileSize(full_path, file_size)) {
+        PDLOG(WARNING, "get size failed. file[%s]", full_path.c_str());
+        return -1;
+    }
+    if (CheckFile(file_name, "", file_size, false) == 0) {
+        PDLOG(INFO, "file %s exists in %s, skip it. tid[%u] pid[%u]", file_name.c_str(), endpoint_.c_str(), tid_,
+              pid_);
+        return 0;
+    }
+    return SendFile(file_name, full_path);
+}
+
 int FileSender::SendDir(const std::string& dir_name, const std::string& full_path) {
     std::vector<std::string> file_vec;
     ::openmldb::base::GetFileName(full_path, file_vec);
@@ -21,6 +21,8 @@
 
 #include <string>
 
+#include "butil/iobuf.h"
+
 #include "proto/tablet.pb.h"
 
 namespace openmldb {
@@ -35,18 +37,28 @@ class FileSender {
     int SendFile(const std::string& file_name, const std::string& full_path);
     int SendFileInternal(const std::string& file_name, const std::string& dir_name, const std::string& full_path,
                          uint64_t file_size);
+    // send the blocks of the file by FLAGS_send_file_parallelism threads. the blocks are read into
+    // the attachments without a copy, retried one by one and checked by the checksum of the file
+    int SendFileByRanges(const std::string& file_name, const std::string& dir_name, const std::string& full_path,
+                         uint64_t file_size);
     int SendDir(const std::string& dir_name, const std::string& full_path);
     int WriteData(const std::string& file_name, const std::string& dir_name, const char* buffer, size_t len,
                   uint64_t block_id);
-    int CheckFile(const std::string& file_name, const std::string& dir_name, uint64_t file_size);
+    int CheckFile(const std::string& file_name, const std::string& dir_name, uint64_t file_size,
+                  bool log_mismatch = true);
+    // skip the file if the remote has a file of the same name and size. it is only for the
+    // files which are not modified after they are made, e.g. snapshots
+    int SendFileIfMissing(const std::string& file_name, const std::string& full_path);
 
  private:
+    int SendRange(const std::string& file_name, const std::string& dir_name, uint64_t block_id, uint64_t offset,
+                  uint64_t file_size, const butil::IOBuf* data, bool eof, uint32_t checksum);
+
     uint32_t tid_;
     uint32_t pid_;
     std::string endpoint_;
     uint32_t cur_try_time_;
     uint32_t max_try_time_;
-    uint64_t limit_time_;
     brpc::Channel* channel_;
     ::openmldb::api::TabletServer_Stub* stub_;
 };
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "tablet/table_status_tracker.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "base/glog_wapper.h"
+#include "common/timer.h"
+
+namespace openmldb::tablet {
+
+TableStatusTracker::TableStatusTracker()
+    : mu_(), epoch_(::baidu::common::timer::get_micros()), version_(0), min_version_(0), status_(), dropped_() {}
+
+void TableStatusTracker::Filter(uint64_t epoch, uint64_t since_version,
+                                ::openmldb::api::GetTableStatusResponse* response) {
+    std::lock_guard<std::mutex> lock(mu_);
+    uint64_t version = version_ + 1;
+    bool changed = false;
+    std::vector<uint64_t> versions;
+    versions.reserve(response->all_table_status_size());
+    std::map<Key, std::pair<uint64_t, size_t>> status;
+    for (const auto& table_status : response->all_table_status()) {
+        Key key(table_status.tid(), table_status.pid());
+        size_t hash = std::hash<std::string>()(table_status.SerializeAsString());
+        auto it = status_.find(key);
+        if (it == status_.end() || it->second.second != hash) {
+            status.emplace(key, std::make_pair(version, hash));
+            versions.push_back(version);
+            dropped_.erase(key);
+            changed = true;
+        } else {
+            status.emplace(key, it->second);
+            versions.push_back(it->second.first);
+        }
+    }
+    for (const auto& kv : status_) {
+        if (status.find(kv.first) == status.end()) {
+            dropped_[kv.first] = version;
+            changed = true;
+        }
+    }
+    status_.swap(status);
+    if (changed) {
+        version_ = version;
+    }
+    while (dropped_.size() > kMaxDroppedCnt) {
+        auto it = std::min_element(dropped_.begin(), dropped_.end(),
+                                   [](const auto& a, const auto& b) { return a.second < b.second; });
+        min_version_ = std::max(min_version_, it->second);
+        dropped_.erase(it);
+    }
+    response->set_status_epoch(epoch_);
+    response->set_status_version(version_);
+    if (epoch != epoch_ || since_version < min_version_ || since_version > version_) {
+        response->set_is_delta(false);
+        return;
+    }
+    auto* all_status = response->mutable_all_table_status();
+    int cnt = 0;
+    for (int i = 0; i < all_status->size(); i++) {
+        if (versions[i] > since_version) {
+            all_status->SwapElements(cnt++, i);
+        }
+    }
+    all_status->DeleteSubrange(cnt, all_status->size() - cnt);
+    for (const auto& kv : dropped_) {
+        if (kv.second > since_version) {
+            auto* dropped = response->add_dropped_table_status();
+            dropped->set_tid(kv.first.first);
+            dropped->set_pid(kv.first.second);
+        }
+    }
+    response->set_is_delta(true);
+}
+
+}  // namespace openmldb::tablet
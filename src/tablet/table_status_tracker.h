@@ -0,0 +1,61 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SRC_TABLET_TABLE_STATUS_TRACKER_H_
+#define SRC_TABLET_TABLE_STATUS_TRACKER_H_
+
+#include <map>
+#include <mutex>  // NOLINT
+#include <utility>
+
+#include "proto/tablet.pb.h"
+
+namespace openmldb::tablet {
+
+// TableStatusTracker versions the table status polled by the nameserver. A partition gets a new
+// version when its status changes, so a poll returns only the partitions changed since the last one.
+// The epoch identifies the versions of this process
+class TableStatusTracker {
+ public:
+    TableStatusTracker();
+
+    // `response` has the status of all partitions. keep the partitions changed after `since_version`
+    // of `epoch`, and add the partitions dropped after it. all are kept if the delta is unknown
+    void Filter(uint64_t epoch, uint64_t since_version, ::openmldb::api::GetTableStatusResponse* response);
+
+    uint64_t GetEpoch() const { return epoch_; }
+
+    // dropped partitions kept to build deltas
+    static constexpr uint32_t kMaxDroppedCnt = 1024;
+
+ private:
+    using Key = std::pair<uint32_t, uint32_t>;
+
+    std::mutex mu_;
+    const uint64_t epoch_;
+    uint64_t version_;
+    // deltas since the versions before it are unknown
+    uint64_t min_version_;
+    // the version and hash of the last status of a partition
+    std::map<Key, std::pair<uint64_t, size_t>> status_;
+    // the version a partition was dropped in
+    std::map<Key, uint64_t> dropped_;
+};
+
+}  // namespace openmldb::tablet
+
+#endif  // SRC_TABLET_TABLE_STATUS_TRACKER_H_
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "tablet/table_status_tracker.h"
+
+#include <map>
+#include <set>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+namespace openmldb::tablet {
+
+class TableStatusTrackerTest : public ::testing::Test {};
+
+static ::openmldb::api::GetTableStatusResponse BuildResponse(
+    const std::map<std::pair<uint32_t, uint32_t>, uint64_t>& offsets) {
+    ::openmldb::api::GetTableStatusResponse response;
+    for (const auto& kv : offsets) {
+        auto* status = response.add_all_table_status();
+        status->set_tid(kv.first.first);
+        status->set_pid(kv.first.second);
+        status->set_offset(kv.second);
+    }
+    return response;
+}
+
+static std::set<std::pair<uint32_t, uint32_t>> GetKeys(
+    const ::google::protobuf::RepeatedPtrField<::openmldb::api::TableStatus>& all_status) {
+    std::set<std::pair<uint32_t, uint32_t>> keys;
+    for (const auto& status : all_status) {
+        keys.emplace(status.tid(), status.pid());
+    }
+    return keys;
+}
+
+TEST_F(TableStatusTrackerTest, Filter) {
+    TableStatusTracker tracker;
+    std::map<std::pair<uint32_t, uint32_t>, uint64_t> offsets = {{{1, 0}, 10}, {{1, 1}, 20}, {{2, 0}, 30}};
+    // the first poll knows no epoch
+    auto response = BuildResponse(offsets);
+    tracker.Filter(0, 0, &response);
+    ASSERT_FALSE(response.is_delta());
+    ASSERT_EQ(3, response.all_table_status_size());
+    ASSERT_EQ(tracker.GetEpoch(), response.status_epoch());
+    uint64_t version = response.status_version();
+
+    // nothing changed
+    response = BuildResponse(offsets);
+    tracker.Filter(tracker.GetEpoch(), version, &response);
+    ASSERT_TRUE(response.is_delta());
+    ASSERT_EQ(0, response.all_table_status_size());
+    ASSERT_EQ(0, response.dropped_table_status_size());
+    ASSERT_EQ(version, response.status_version());
+
+    offsets[{1, 1}] = 21;
+    offsets.erase({2, 0});
+    offsets[{3, 0}] = 0;
+    response = BuildResponse(offsets);
+    tracker.Filter(tracker.GetEpoch(), version, &response);
+    ASSERT_TRUE(response.is_delta());
+    ASSERT_EQ((std::set<std::pair<uint32_t, uint32_t>>{{1, 1}, {3, 0}}), GetKeys(response.all_table_status()));
+    ASSERT_EQ((std::set<std::pair<uint32_t, uint32_t>>{{2, 0}}), GetKeys(response.dropped_table_status()));
+    for (const auto& status : response.all_table_status()) {
+        ASSERT_EQ(offsets[std::make_pair(status.tid(), status.pid())], status.offset());
+    }
+    uint64_t new_version = response.status_version();
+    ASSERT_GT(new_version, version);
+
+    // a poll that missed the last one still gets its changes
+    response = BuildResponse(offsets);
+    tracker.Filter(tracker.GetEpoch(), version, &response);
+    ASSERT_EQ(2, response.all_table_status_size());
+    ASSERT_EQ(1, response.dropped_table_status_size());
+
+    // the versions of another epoch are unknown
+    response = BuildResponse(offsets);
+    tracker.Filter(tracker.GetEpoch() + 1, new_version, &response);
+    ASSERT_FALSE(response.is_delta());
+    ASSERT_EQ(3, response.all_table_status_size());
+    ASSERT_EQ(0, response.dropped_table_status_size());
+}
+
+TEST_F(TableStatusTrackerTest, DroppedOverflow) {
+    TableStatusTracker tracker;
+    std::map<std::pair<uint32_t, uint32_t>, uint64_t> offsets;
+    for (uint32_t tid = 0; tid <= TableStatusTracker::kMaxDroppedCnt; tid++) {
+        offsets[{tid, 0}] = 0;
+    }
+    auto response = BuildResponse(offsets);
+    tracker.Filter(0, 0, &response);
+    uint64_t version = response.status_version();
+    // drop them one by one, the first drop is forgotten at last
+    for (uint32_t tid = 0; tid <= TableStatusTracker::kMaxDroppedCnt; tid++) {
+        offsets.erase({tid, 0});
+        response = BuildResponse(offsets);
+        tracker.Filter(tracker.GetEpoch(), response.status_version(), &response);
+    }
+    response = BuildResponse(offsets);
+    tracker.Filter(tracker.GetEpoch(), version, &response);
+    ASSERT_FALSE(response.is_delta());
+    ASSERT_EQ(0, response.all_table_status_size());
+    // a later version is still a delta
+    response = BuildResponse(offsets);
+    tracker.Filter(tracker.GetEpoch(), version + 1, &response);
+    ASSERT_TRUE(response.is_delta());
+    ASSERT_EQ(TableStatusTracker::kMaxDroppedCnt, static_cast<uint32_t>(response.dropped_table_status_size()));
+}
+
+}  // namespace openmldb::tablet
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
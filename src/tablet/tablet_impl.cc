@@ -30,6 +30,7 @@
 #include <snappy.h>
 
 #include <algorithm>
+#include <deque>
 #include <thread>  // NOLINT
 #include <utility>
 #include <vector>
@@ -43,6 +44,7 @@
 #endif
 #include "base/file_util.h"
 #include "base/glog_wapper.h"
+#include "base/count_down_latch.h"
 #include "base/hash.h"
 #include "base/proto_util.h"
 #include "base/status.h"
@@ -71,9 +73,13 @@ using ::openmldb::storage::DiskTable;
 
 DECLARE_int32(gc_interval);
 DECLARE_int32(gc_pool_size);
+DECLARE_bool(enable_numa);
+DECLARE_string(numa_fake_topology);
+DECLARE_double(numa_arena_max_waste_ratio);
 DECLARE_int32(disk_gc_interval);
 DECLARE_int32(statdb_ttl);
 DECLARE_uint32(scan_max_bytes_size);
+DECLARE_uint32(multi_scan_max_key_cnt);
 DECLARE_uint32(scan_reserve_size);
 DECLARE_double(mem_release_rate);
 DECLARE_string(db_root_path);
@@ -81,6 +87,8 @@ DECLARE_string(ssd_root_path);
 DECLARE_string(hdd_root_path);
 DECLARE_bool(binlog_notify_on_put);
 DECLARE_int32(task_pool_size);
+DECLARE_uint32(load_table_parallelism);
+DECLARE_uint64(load_table_read_bandwidth_limit);
 DECLARE_int32(io_pool_size);
 DECLARE_int32(make_snapshot_time);
 DECLARE_int32(make_snapshot_check_interval);
@@ -136,6 +144,9 @@ TabletImpl::TabletImpl()
       task_pool_(FLAGS_task_pool_size),
       io_pool_(FLAGS_io_pool_size),
       snapshot_pool_(FLAGS_snapshot_pool_size),
+      load_seq_(0),
+      load_rate_limiter_(FLAGS_load_table_read_bandwidth_limit),
+      load_pool_(FLAGS_load_table_parallelism),
       mode_root_paths_(),
       mode_recycle_root_paths_(),
       follower_(false),
@@ -150,9 +161,13 @@ TabletImpl::TabletImpl()
       startup_mode_(::openmldb::type::StartupMode::kStandalone) {}
 
 TabletImpl::~TabletImpl() {
+    load_pool_.Stop(true);
     task_pool_.Stop(true);
     keep_alive_pool_.Stop(true);
     gc_pool_.Stop(true);
+    for (auto& pool : numa_gc_pools_) {
+        pool->Stop(true);
+    }
     io_pool_.Stop(true);
     snapshot_pool_.Stop(true);
     delete zk_client_;
@@ -185,6 +200,7 @@ bool TabletImpl::Init(const std::string& zk_cluster, const std::string& zk_path,
     ::openmldb::base::SplitString(FLAGS_recycle_bin_hdd_root_path, ",",
                                   mode_recycle_root_paths_[::openmldb::common::kHDD]);
     deploy_collector_ = std::make_unique<::openmldb::statistics::DeployQueryTimeCollector>();
+    InitNuma();
 
     if (!zk_cluster.empty()) {
         zk_client_ = new ZkClient(zk_cluster, real_endpoint, FLAGS_zk_session_timeout, endpoint, zk_path);
@@ -911,7 +927,8 @@ int32_t TabletImpl::ScanIndex(const ::openmldb::api::ScanRequest* request, const
     bool remove_duplicated_record =
         request->has_enable_remove_duplicated_record() && request->enable_remove_duplicated_record();
     uint64_t last_time = 0;
-    uint32_t total_block_size = 0;
+    // the rows in io_buf before, of the other keys of a multi scan, share the limit of the bytes
+    uint64_t total_block_size = io_buf->size();
     uint32_t record_count = 0;
     combine_it->SeekToFirst();
     while (combine_it->Valid()) {
@@ -1202,6 +1219,32 @@ int32_t TabletImpl::CountIndex(uint64_t expire_time, uint64_t expire_cnt, ::open
     return 0;
 }
 
+template <typename Response>
+static void SetScanCode(int32_t code, Response* response) {
+    switch (code) {
+        case 0:
+            return;
+        case -1:
+            response->set_msg("invalid args");
+            response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
+            return;
+        case -2:
+            response->set_msg("st/et sub key type is invalid");
+            response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
+            return;
+        case -3:
+            response->set_code(::openmldb::base::ReturnCode::kReacheTheScanMaxBytesSize);
+            response->set_msg("reach the max scan byte size");
+            return;
+        case -4:
+            response->set_msg("fail to encode data rows");
+            response->set_code(::openmldb::base::ReturnCode::kEncodeError);
+            return;
+        default:
+            return;
+    }
+}
+
 void TabletImpl::Scan(RpcController* controller, const ::openmldb::api::ScanRequest* request,
                       ::openmldb::api::ScanResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
@@ -1296,27 +1339,122 @@ void TabletImpl::Scan(RpcController* controller, const ::openmldb::api::ScanRequ
         PDLOG(INFO, "slow log[scan]. key %s index_name %s time %lu. tid %u, pid %u", request->pk().c_str(),
               index_name.c_str(), end_time - start_time, request->tid(), request->pid());
     }
-    switch (code) {
-        case 0:
-            return;
-        case -1:
-            response->set_msg("invalid args");
-            response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
-            return;
-        case -2:
-            response->set_msg("st/et sub key type is invalid");
-            response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
-            return;
-        case -3:
-            response->set_code(::openmldb::base::ReturnCode::kReacheTheScanMaxBytesSize);
-            response->set_msg("reach the max scan byte size");
+    SetScanCode(code, response);
+}
+
+void TabletImpl::MultiScan(RpcController* controller, const ::openmldb::api::MultiScanRequest* request,
+                           ::openmldb::api::MultiScanResponse* response, Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    uint64_t start_time = ::baidu::common::timer::get_micros();
+    uint32_t tid = request->tid();
+    uint32_t pid = request->pid();
+    std::shared_ptr<Table> table = GetTable(tid, pid);
+    if (!table) {
+        PDLOG(WARNING, "table is not exist. tid %u, pid %u", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kTableIsNotExist);
+        response->set_msg("table is not exist");
+        return;
+    }
+    if (table->GetTableStat() == ::openmldb::storage::kLoading) {
+        PDLOG(WARNING, "table is loading. tid %u, pid %u", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kTableIsLoading);
+        response->set_msg("table is loading");
+        return;
+    }
+    int scan_cnt = request->scans_size();
+    if (scan_cnt > static_cast<int>(FLAGS_multi_scan_max_key_cnt)) {
+        PDLOG(WARNING, "too many keys %d in a multi scan, max %u. tid %u, pid %u", scan_cnt,
+              FLAGS_multi_scan_max_key_cnt, tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
+        response->set_msg("too many keys in a multi scan");
+        return;
+    }
+    // resolve the index of each scan once per index name
+    std::map<std::string, std::shared_ptr<IndexDef>> index_defs;
+    std::vector<std::shared_ptr<IndexDef>> scan_index(scan_cnt);
+    for (int i = 0; i < scan_cnt; i++) {
+        const auto& scan = request->scans(i);
+        if (scan.st() < scan.et()) {
+            response->set_code(::openmldb::base::ReturnCode::kStLessThanEt);
+            response->set_msg("starttime less than endtime");
             return;
-        case -4:
-            response->set_msg("fail to encode data rows");
-            response->set_code(::openmldb::base::ReturnCode::kEncodeError);
+        }
+        const std::string& index_name = scan.idx_name().empty() ? table->GetPkIndex()->GetName() : scan.idx_name();
+        auto iter = index_defs.find(index_name);
+        if (iter == index_defs.end()) {
+            auto index_def = table->GetIndex(index_name);
+            if (!index_def || !index_def->IsReady()) {
+                PDLOG(WARNING, "idx name %s not found in table tid %u, pid %u", index_name.c_str(), tid, pid);
+                response->set_code(::openmldb::base::ReturnCode::kIdxNameNotFound);
+                response->set_msg("idx name not found");
+                return;
+            }
+            iter = index_defs.emplace(index_name, index_def).first;
+        }
+        scan_index[i] = iter->second;
+    }
+    // look up the keys grouped by index and segment, so that the lookups in one segment
+    // are next to each other. all the key entries are held by one ticket
+    std::vector<int> order(scan_cnt);
+    for (int i = 0; i < scan_cnt; i++) {
+        order[i] = i;
+    }
+    auto mem_table = std::dynamic_pointer_cast<::openmldb::storage::MemTable>(table);
+    if (mem_table) {
+        std::vector<std::pair<uint32_t, uint32_t>> group(scan_cnt);
+        for (int i = 0; i < scan_cnt; i++) {
+            group[i] = {scan_index[i]->GetInnerPos(), mem_table->GetSegIdx(request->scans(i).pk())};
+        }
+        std::stable_sort(order.begin(), order.end(), [&group](int l, int r) { return group[l] < group[r]; });
+    }
+    auto ticket = std::make_shared<::openmldb::storage::Ticket>();
+    std::vector<QueryIt> query_its(scan_cnt);
+    for (int i : order) {
+        query_its[i].ticket = ticket;
+        GetIterator(table, request->scans(i).pk(), scan_index[i]->GetId(), &query_its[i].it, &query_its[i].ticket);
+        if (!query_its[i].it) {
+            response->set_code(::openmldb::base::ReturnCode::kTsNameNotFound);
+            response->set_msg("ts name not found");
             return;
-        default:
+        }
+        query_its[i].table = table;
+    }
+    auto table_meta = table->GetTableMeta();
+    const std::map<int32_t, std::shared_ptr<Schema>> vers_schema = table->GetAllVersionSchema();
+    std::map<uint32_t, ::openmldb::storage::TTLSt> expired_values;
+    auto* cntl = dynamic_cast<brpc::Controller*>(controller);
+    butil::IOBuf& buf = cntl->response_attachment();
+    for (int i = 0; i < scan_cnt; i++) {
+        const auto& scan = request->scans(i);
+        uint32_t index = scan_index[i]->GetId();
+        auto iter = expired_values.find(index);
+        if (iter == expired_values.end()) {
+            ::openmldb::storage::TTLSt expired_value = *scan_index[i]->GetTTL();
+            expired_value.abs_ttl = table->GetExpireTime(expired_value);
+            iter = expired_values.emplace(index, expired_value).first;
+        }
+        std::vector<QueryIt> q_its;
+        q_its.push_back(std::move(query_its[i]));
+        CombineIterator combine_it(std::move(q_its), scan.st(), scan.st_type(), iter->second);
+        size_t buf_size = buf.size();
+        uint32_t count = 0;
+        int32_t code = ScanIndex(&scan, *table_meta, vers_schema, &combine_it, &buf, &count);
+        if (code != 0) {
+            PDLOG(WARNING, "fail to scan key %s of scan %d. tid %u, pid %u", scan.pk().c_str(), i, tid, pid);
+            SetScanCode(code, response);
+            response->clear_count();
+            response->clear_buf_size();
+            buf.clear();
             return;
+        }
+        response->add_count(count);
+        response->add_buf_size(buf.size() - buf_size);
+    }
+    response->set_code(::openmldb::base::ReturnCode::kOk);
+    uint64_t end_time = ::baidu::common::timer::get_micros();
+    if (start_time + FLAGS_query_slow_log_threshold < end_time) {
+        PDLOG(INFO, "slow log[multi scan]. key cnt %d time %lu. tid %u, pid %u", scan_cnt, end_time - start_time, tid,
+              pid);
     }
 }
 
@@ -1456,6 +1594,10 @@ void TabletImpl::Traverse(RpcController* controller, const ::openmldb::api::Trav
     }
     std::map<std::string, std::vector<std::pair<uint64_t, openmldb::base::Slice>>> value_map;
     std::vector<std::string> key_seq;
+    // a row decoded by dictionaries is valid until the iterator moves, so it is copied till encoded
+    auto mem_table = std::dynamic_pointer_cast<MemTable>(table);
+    bool copy_value = mem_table && mem_table->GetRowDict() != NULL;
+    std::deque<std::string> decoded_rows;
     uint32_t total_block_size = 0;
     bool remove_duplicated_record = false;
     if (request->has_enable_remove_duplicated_record()) {
@@ -1481,6 +1623,9 @@ void TabletImpl::Traverse(RpcController* controller, const ::openmldb::api::Trav
             key_seq.emplace_back(last_pk);
         }
         openmldb::base::Slice value = it->GetValue();
+        if (copy_value) {
+            value = openmldb::base::Slice(decoded_rows.emplace_back(value.data(), value.size()));
+        }
         value_map[last_pk].push_back(std::make_pair(it->GetKey(), value));
         total_block_size += last_pk.length() + value.size();
         scount++;
@@ -1681,7 +1826,7 @@ void TabletImpl::ProcessQuery(RpcController* ctrl, const openmldb::api::QueryReq
                 return;
             }
             byte_size += output_row.size();
-            buf->append(reinterpret_cast<void*>(output_row.buf()), output_row.size());
+            codec::MoveRowSlice(&output_row, 0, buf);
             count += 1;
         }
         response->set_schema(session.GetEncodedSchema());
@@ -1896,8 +2041,8 @@ void TabletImpl::ProcessBatchRequestQuery(RpcController* ctrl,
                 LOG(WARNING) << "illegal row ptrs: expect 2";
                 return;
             }
-            buf.append(output_row.buf(1), output_row.size(1));
             response->add_row_sizes(output_row.size(1));
+            codec::MoveRowSlice(&output_row, 1, &buf);
         } else {
             if (output_row.GetRowPtrCnt() != 1) {
                 response->set_msg("illegal row ptrs: expect 1");
@@ -1905,8 +2050,8 @@ void TabletImpl::ProcessBatchRequestQuery(RpcController* ctrl,
                 LOG(WARNING) << "illegal row ptrs: expect 1";
                 return;
             }
-            buf.append(output_row.buf(0), output_row.size(0));
             response->add_row_sizes(output_row.size(0));
+            codec::MoveRowSlice(&output_row, 0, &buf);
         }
     }
 
@@ -2339,63 +2484,103 @@ void TabletImpl::UpdateTableMetaForAddField(RpcController* controller,
 void TabletImpl::GetTableStatus(RpcController* controller, const ::openmldb::api::GetTableStatusRequest* request,
                                 ::openmldb::api::GetTableStatusResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
-    std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
-    for (auto it = tables_.begin(); it != tables_.end(); ++it) {
-        if (request->has_tid() && request->tid() != it->first) {
-            continue;
-        }
-        for (auto pit = it->second.begin(); pit != it->second.end(); ++pit) {
-            if (request->has_pid() && request->pid() != pit->first) {
+    {
+        std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
+        for (auto it = tables_.begin(); it != tables_.end(); ++it) {
+            if (request->has_tid() && request->tid() != it->first) {
                 continue;
             }
-            std::shared_ptr<Table> table = pit->second;
-            ::openmldb::api::TableStatus* status = response->add_all_table_status();
-            status->set_mode(::openmldb::api::TableMode::kTableFollower);
-            if (table->IsLeader()) {
-                status->set_mode(::openmldb::api::TableMode::kTableLeader);
-            }
-            status->set_tid(table->GetId());
-            status->set_pid(table->GetPid());
-            status->set_compress_type(table->GetCompressType());
-            status->set_storage_mode(table->GetStorageMode());
-            status->set_name(table->GetName());
-            status->set_diskused(table->GetDiskused());
-            if (::openmldb::api::TableState_IsValid(table->GetTableStat())) {
-                status->set_state(::openmldb::api::TableState(table->GetTableStat()));
-            }
-            std::shared_ptr<LogReplicator> replicator = GetReplicatorUnLock(table->GetId(), table->GetPid());
-            if (replicator) {
-                status->set_offset(replicator->GetOffset());
-            }
-            status->set_record_cnt(table->GetRecordCnt());
-            if (table->GetStorageMode() == common::kMemory) {
-                if (MemTable* mem_table = dynamic_cast<MemTable*>(table.get())) {
-                    status->set_is_expire(mem_table->GetExpireStatus());
-                    status->set_record_byte_size(mem_table->GetRecordByteSize());
-                    status->set_record_idx_byte_size(mem_table->GetRecordIdxByteSize());
-                    status->set_record_pk_cnt(mem_table->GetRecordPkCnt());
-                    status->set_skiplist_height(mem_table->GetKeyEntryHeight());
-                    uint64_t record_idx_cnt = 0;
-                    auto indexs = table->GetAllIndex();
-                    for (const auto& index_def : indexs) {
-                        ::openmldb::api::TsIdxStatus* ts_idx_status = status->add_ts_idx_status();
-                        ts_idx_status->set_idx_name(index_def->GetName());
-                        uint64_t* stats = NULL;
-                        uint32_t size = 0;
-                        bool ok = mem_table->GetRecordIdxCnt(index_def->GetId(), &stats, &size);
-                        if (ok) {
-                            for (uint32_t i = 0; i < size; i++) {
-                                ts_idx_status->add_seg_cnts(stats[i]);
-                                record_idx_cnt += stats[i];
+            for (auto pit = it->second.begin(); pit != it->second.end(); ++pit) {
+                if (request->has_pid() && request->pid() != pit->first) {
+                    continue;
+                }
+                std::shared_ptr<Table> table = pit->second;
+                ::openmldb::api::TableStatus* status = response->add_all_table_status();
+                status->set_mode(::openmldb::api::TableMode::kTableFollower);
+                if (table->IsLeader()) {
+                    status->set_mode(::openmldb::api::TableMode::kTableLeader);
+                }
+                status->set_tid(table->GetId());
+                status->set_pid(table->GetPid());
+                status->set_compress_type(table->GetCompressType());
+                status->set_storage_mode(table->GetStorageMode());
+                status->set_name(table->GetName());
+                status->set_diskused(table->GetDiskused());
+                if (::openmldb::api::TableState_IsValid(table->GetTableStat())) {
+                    status->set_state(::openmldb::api::TableState(table->GetTableStat()));
+                }
+                std::shared_ptr<LogReplicator> replicator = GetReplicatorUnLock(table->GetId(), table->GetPid());
+                if (replicator) {
+                    status->set_offset(replicator->GetOffset());
+                }
+                status->set_record_cnt(table->GetRecordCnt());
+                // partitions waiting for or in loading
+                std::shared_ptr<RecoverProgress> progress = GetLoadProgress(table->GetId(), table->GetPid());
+                if (progress) {
+                    ::openmldb::api::LoadProgress* load_progress = status->mutable_load_progress();
+                    load_progress->set_total_bytes(progress->GetTotalBytes());
+                    load_progress->set_read_bytes(progress->GetReadBytes());
+                    load_progress->set_elapsed_ms(progress->GetElapsedMs());
+                    load_progress->set_eta_ms(progress->GetEtaMs());
+                }
+                if (table->GetStorageMode() == common::kMemory) {
+                    if (MemTable* mem_table = dynamic_cast<MemTable*>(table.get())) {
+                        status->set_is_expire(mem_table->GetExpireStatus());
+                        status->set_record_byte_size(mem_table->GetRecordByteSize());
+                        status->set_record_idx_byte_size(mem_table->GetRecordIdxByteSize());
+                        status->set_record_pk_cnt(mem_table->GetRecordPkCnt());
+                        status->set_skiplist_height(mem_table->GetKeyEntryHeight());
+                        if (const ::openmldb::storage::RowDict* row_dict = mem_table->GetRowDict()) {
+                            uint64_t decode_cnt = 0;
+                            uint64_t ns_per_row = 0;
+                            row_dict->GetDecodeStat(&decode_cnt, &ns_per_row);
+                            status->set_dict_saved_byte_size(row_dict->GetSavedByteSize());
+                            status->set_dict_byte_size(row_dict->GetDictByteSize());
+                            status->set_dict_decode_cnt(decode_cnt);
+                            status->set_dict_decode_ns_per_row(ns_per_row);
+                        }
+                        uint64_t record_idx_cnt = 0;
+                        auto indexs = table->GetAllIndex();
+                        for (const auto& index_def : indexs) {
+                            ::openmldb::api::TsIdxStatus* ts_idx_status = status->add_ts_idx_status();
+                            ts_idx_status->set_idx_name(index_def->GetName());
+                            uint64_t* stats = NULL;
+                            uint32_t size = 0;
+                            bool ok = mem_table->GetRecordIdxCnt(index_def->GetId(), &stats, &size);
+                            if (ok) {
+                                for (uint32_t i = 0; i < size; i++) {
+                                    ts_idx_status->add_seg_cnts(stats[i]);
+                                    record_idx_cnt += stats[i];
+                                }
+                            }
+                            delete[] stats;
+                            std::vector<uint64_t> put_cnts;
+                            std::vector<uint64_t> get_cnts;
+                            if (mem_table->GetSegAccessCnt(index_def->GetId(), &put_cnts, &get_cnts)) {
+                                for (uint32_t i = 0; i < put_cnts.size(); i++) {
+                                    ts_idx_status->add_seg_put_cnts(put_cnts[i]);
+                                    ts_idx_status->add_seg_get_cnts(get_cnts[i]);
+                                }
+                            }
+                            std::vector<std::pair<std::string, uint64_t>> hot_keys;
+                            if (mem_table->GetHotKeys(index_def->GetId(), &hot_keys)) {
+                                for (const auto& kv : hot_keys) {
+                                    auto hot_key = ts_idx_status->add_hot_keys();
+                                    hot_key->set_key(kv.first);
+                                    hot_key->set_cnt(kv.second);
+                                }
                             }
                         }
-                        delete[] stats;
+                        status->set_idx_cnt(record_idx_cnt);
                     }
-                    status->set_idx_cnt(record_idx_cnt);
                 }
             }
         }
     }
+    // the polls of the nameserver
+    if (request->has_since_version() && !request->has_tid() && !request->has_pid()) {
+        table_status_tracker_.Filter(request->status_epoch(), request->since_version(), response);
+    }
     response->set_code(::openmldb::base::ReturnCode::kOk);
 }
 
@@ -2633,7 +2818,9 @@ void TabletImpl::SendData(RpcController* controller, const ::openmldb::api::Send
                     std::make_pair(combine_key, std::make_shared<FileReceiver>(request->file_name(), dir_name, path)));
                 iter = file_receiver_map_.find(combine_key);
             }
-            if (!iter->second->Init()) {
+            bool init_ok = request->has_offset() ? iter->second->InitRanges(request->file_size())
+                                                 : iter->second->Init();
+            if (!init_ok) {
                 PDLOG(WARNING, "file receiver init failed. tid %u, pid %u, file_name %s", tid, pid,
                       request->file_name().c_str());
                 response->set_code(::openmldb::base::ReturnCode::kFileReceiverInitFailed);
@@ -2659,6 +2846,45 @@ void TabletImpl::SendData(RpcController* controller, const ::openmldb::api::Send
         response->set_msg("cannot find receiver");
         return;
     }
+    if (request->has_offset()) {
+        // the blocks of a file sent by ranges may arrive in any order and more than once
+        if (request->eof()) {
+            bool check_ok = receiver->CheckRanges(request->checksum());
+            if (check_ok) {
+                receiver->SaveFile();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mu_);
+                file_receiver_map_.erase(combine_key);
+            }
+            if (!check_ok) {
+                PDLOG(WARNING, "check received file failed. tid %u, pid %u, file_name %s", tid, pid,
+                      request->file_name().c_str());
+                response->set_code(::openmldb::base::ReturnCode::kReceiveDataError);
+                response->set_msg("check received file failed");
+                return;
+            }
+        } else if (request->block_id() > 0) {
+            if (cntl->request_attachment().size() != request->block_size()) {
+                PDLOG(WARNING, "receive data error. tid %u, pid %u, file_name %s, expected length %u real length %lu",
+                      tid, pid, request->file_name().c_str(), request->block_size(),
+                      cntl->request_attachment().size());
+                response->set_code(::openmldb::base::ReturnCode::kReceiveDataError);
+                response->set_msg("receive data error");
+                return;
+            }
+            if (receiver->WriteRange(&cntl->request_attachment(), request->offset()) < 0) {
+                PDLOG(WARNING, "receiver write data failed. tid %u, pid %u, file_name %s", tid, pid,
+                      request->file_name().c_str());
+                response->set_code(::openmldb::base::ReturnCode::kWriteDataFailed);
+                response->set_msg("write data failed");
+                return;
+            }
+        }
+        response->set_msg("ok");
+        response->set_code(::openmldb::base::ReturnCode::kOk);
+        return;
+    }
     if (receiver->GetBlockId() == request->block_id()) {
         response->set_msg("ok");
         response->set_code(::openmldb::base::ReturnCode::kOk);
@@ -2796,6 +3022,7 @@ void TabletImpl::SendSnapshotInternal(const std::string& endpoint, uint32_t tid,
         full_path.append("snapshot/");
         std::string manifest_file = full_path + "MANIFEST";
         std::string snapshot_file;
+        std::vector<std::string> delta_files;
         {
             int fd = open(manifest_file.c_str(), O_RDONLY);
             if (fd < 0) {
@@ -2811,10 +3038,17 @@ void TabletImpl::SendSnapshotInternal(const std::string& endpoint, uint32_t tid,
                 break;
             }
             snapshot_file = manifest.name();
+            for (const auto& delta : manifest.deltas()) {
+                delta_files.push_back(delta.name());
+            }
         }
         if (table->GetStorageMode() == common::kMemory) {
-            // send snapshot file
-            if (sender.SendFile(snapshot_file, full_path + snapshot_file) < 0) {
+            // send the snapshot and its deltas, the ones sent before are skipped
+            bool send_ok = sender.SendFileIfMissing(snapshot_file, full_path + snapshot_file) == 0;
+            for (size_t i = 0; send_ok && i < delta_files.size(); i++) {
+                send_ok = sender.SendFileIfMissing(delta_files[i], full_path + delta_files[i]) == 0;
+            }
+            if (!send_ok) {
                 PDLOG(WARNING, "send snapshot failed. tid[%u] pid[%u]", tid, pid);
                 break;
             }
@@ -3011,9 +3245,21 @@ void TabletImpl::LoadTable(RpcController* controller, const ::openmldb::api::Loa
             if (table_meta.seg_cnt() > 0) {
                 seg_cnt = table_meta.seg_cnt();
             }
-            PDLOG(INFO, "start to recover table with id %u pid %u name %s seg_cnt %d ", tid, pid, name.c_str(),
-                  seg_cnt);
-            task_pool_.AddTask(boost::bind(&TabletImpl::LoadTableInternal, this, tid, pid, task_ptr));
+            uint64_t total_bytes = 0;
+            ::openmldb::base::GetDirSizeRecur(db_path + "/snapshot", total_bytes);
+            ::openmldb::base::GetDirSizeRecur(db_path + "/binlog", total_bytes);
+            bool is_leader = table_meta.mode() == ::openmldb::api::TableMode::kTableLeader;
+            PDLOG(INFO, "start to recover table with id %u pid %u name %s seg_cnt %d leader %d size %lu", tid, pid,
+                  name.c_str(), seg_cnt, is_leader, total_bytes);
+            {
+                std::lock_guard<std::mutex> lock(load_mu_);
+                load_progress_[std::make_pair(tid, pid)] =
+                    std::make_shared<RecoverProgress>(total_bytes, FLAGS_load_table_read_bandwidth_limit > 0
+                                                                       ? &load_rate_limiter_
+                                                                       : nullptr);
+                pending_loads_.push(PendingLoad{tid, pid, is_leader, total_bytes, load_seq_++, task_ptr});
+            }
+            load_pool_.AddTask(boost::bind(&TabletImpl::SchedLoadTable, this));
         } else {
             task_pool_.AddTask(boost::bind(&TabletImpl::LoadDiskTableInternal, this, tid, pid, table_meta, task_ptr));
             PDLOG(INFO, "load table tid[%u] pid[%u] storage mode[%s]", tid, pid,
@@ -3027,6 +3273,30 @@ void TabletImpl::LoadTable(RpcController* controller, const ::openmldb::api::Loa
     SetTaskStatus(task_ptr, ::openmldb::api::TaskStatus::kFailed);
 }
 
+void TabletImpl::SchedLoadTable() {
+    PendingLoad load;
+    {
+        std::lock_guard<std::mutex> lock(load_mu_);
+        if (pending_loads_.empty()) {
+            return;
+        }
+        load = pending_loads_.top();
+        pending_loads_.pop();
+    }
+    LoadTableInternal(load.tid, load.pid, load.task_ptr);
+    std::lock_guard<std::mutex> lock(load_mu_);
+    load_progress_.erase(std::make_pair(load.tid, load.pid));
+}
+
+std::shared_ptr<RecoverProgress> TabletImpl::GetLoadProgress(uint32_t tid, uint32_t pid) {
+    std::lock_guard<std::mutex> lock(load_mu_);
+    auto it = load_progress_.find(std::make_pair(tid, pid));
+    if (it == load_progress_.end()) {
+        return std::shared_ptr<RecoverProgress>();
+    }
+    return it->second;
+}
+
 int TabletImpl::LoadTableInternal(uint32_t tid, uint32_t pid, std::shared_ptr<::openmldb::api::TaskInfo> task_ptr) {
     do {
         // load snapshot data
@@ -3060,7 +3330,15 @@ int TabletImpl::LoadTableInternal(uint32_t tid, uint32_t pid, std::shared_ptr<::
         }
         std::string binlog_path = GetDBPath(db_root_path, tid, pid) + "/binlog/";
         ::openmldb::storage::Binlog binlog(replicator->GetLogPart(), binlog_path);
-        if (snapshot->Recover(table, snapshot_offset) &&
+        std::shared_ptr<RecoverProgress> progress = GetLoadProgress(tid, pid);
+        if (progress) {
+            progress->Start();
+            snapshot->SetRecoverProgress(progress);
+            binlog.SetRecoverProgress(progress);
+        }
+        bool recovered = snapshot->Recover(table, snapshot_offset);
+        snapshot->SetRecoverProgress(std::shared_ptr<RecoverProgress>());
+        if (recovered &&
             binlog.RecoverFromBinlog(table, snapshot_offset, latest_offset)) {
             // recover aggregator if exists
             std::string aggr_path = GetDBPath(db_root_path, tid, pid) + "/aggr_info.txt";
@@ -3099,7 +3377,8 @@ int TabletImpl::LoadTableInternal(uint32_t tid, uint32_t pid, std::shared_ptr<::
             replicator->SetSnapshotLogPartIndex(snapshot->GetOffset());
             replicator->StartSyncing();
             table->SchedGc();
-            gc_pool_.DelayTask(FLAGS_gc_interval * 60 * 1000, boost::bind(&TabletImpl::GcTable, this, tid, pid, false));
+            GetGcPool(pid).DelayTask(FLAGS_gc_interval * 60 * 1000,
+                                     boost::bind(&TabletImpl::GcTable, this, tid, pid, false));
             io_pool_.DelayTask(FLAGS_binlog_sync_to_disk_interval,
                                boost::bind(&TabletImpl::SchedSyncDisk, this, tid, pid));
             task_pool_.DelayTask(FLAGS_binlog_delete_interval,
@@ -3226,6 +3505,7 @@ int32_t TabletImpl::DeleteTableInternal(uint32_t tid, uint32_t pid,
                                         std::shared_ptr<::openmldb::api::TaskInfo> task_ptr) {
     std::string root_path;
     std::string recycle_bin_root_path;
+    std::string cold_root_path;
     int32_t code = -1;
     do {
         std::shared_ptr<Table> table = GetTable(tid, pid);
@@ -3233,6 +3513,12 @@ int32_t TabletImpl::DeleteTableInternal(uint32_t tid, uint32_t pid,
             PDLOG(WARNING, "table is not exist. tid %u pid %u", tid, pid);
             break;
         }
+        auto mem_table = std::dynamic_pointer_cast<MemTable>(table);
+        if (mem_table && mem_table->GetColdTable() &&
+            !ChooseDBRootPath(tid, pid, table->GetTableMeta()->cold_storage_mode(), cold_root_path)) {
+            PDLOG(WARNING, "fail to get cold tier root path. tid %u pid %u", tid, pid);
+            break;
+        }
 
         bool ok = ChooseDBRootPath(tid, pid, table->GetStorageMode(), root_path);
         if (!ok) {
@@ -3282,6 +3568,15 @@ int32_t TabletImpl::DeleteTableInternal(uint32_t tid, uint32_t pid,
     }
 
     std::string source_path = GetDBPath(root_path, tid, pid);
+    if (!cold_root_path.empty()) {
+        // the cold tier is not kept in the recycle bin, it is rebuilt on load
+        ::openmldb::base::RemoveDirRecursive(GetColdPath(cold_root_path, tid, pid));
+        std::string cold_db_path = GetDBPath(cold_root_path, tid, pid);
+        if (cold_db_path != source_path) {
+            // the partition directory under a separate cold root is removed if nothing else is left in it
+            remove(cold_db_path.c_str());
+        }
+    }
     if (!::openmldb::base::IsExists(source_path)) {
         if (task_ptr) {
             std::lock_guard<std::mutex> lock(mu_);
@@ -3381,7 +3676,7 @@ void TabletImpl::CreateTable(RpcController* controller, const ::openmldb::api::C
     PDLOG(INFO, "create table with id %u pid %u name %s", tid, pid, name.c_str());
 
     int gc_interval = table->GetStorageMode() == common::kMemory ? FLAGS_gc_interval : FLAGS_disk_gc_interval;
-    gc_pool_.DelayTask(gc_interval * 60 * 1000, boost::bind(&TabletImpl::GcTable, this, tid, pid, false));
+    GetGcPool(pid).DelayTask(gc_interval * 60 * 1000, boost::bind(&TabletImpl::GcTable, this, tid, pid, false));
     response->set_code(::openmldb::base::ReturnCode::kOk);
     response->set_msg("ok");
 }
@@ -3398,7 +3693,7 @@ void TabletImpl::ExecuteGc(RpcController* controller, const ::openmldb::api::Exe
         response->set_msg("table not found");
         return;
     }
-    gc_pool_.AddTask(boost::bind(&TabletImpl::GcTable, this, tid, pid, true));
+    GetGcPool(pid).AddTask(boost::bind(&TabletImpl::GcTable, this, tid, pid, true));
     response->set_code(::openmldb::base::ReturnCode::kOk);
     response->set_msg("ok");
     PDLOG(INFO, "ExecuteGc. tid %u pid %u", tid, pid);
@@ -3796,7 +4091,33 @@ int TabletImpl::CreateTableInternal(const ::openmldb::api::TableMeta* table_meta
     std::string table_db_path = GetDBPath(db_root_path, tid, pid);
     Table* table_ptr;
     if (table_meta->storage_mode() == openmldb::common::kMemory) {
-        table_ptr = new MemTable(*table_meta);
+        auto mem_table = new MemTable(*table_meta);
+        if (numa_topology_) {
+            mem_table->SetNumaArena(numa_arenas_[numa_topology_->GetNode(pid)]);
+        }
+        if (table_meta->cold_age() > 0) {
+            std::string cold_root_path;
+            if (!ChooseDBRootPath(tid, pid, table_meta->cold_storage_mode(), cold_root_path)) {
+                PDLOG(WARNING, "fail to get cold tier root path. tid %u, pid %u", tid, pid);
+                msg.assign("fail to get cold tier root path");
+                delete mem_table;
+                return -1;
+            }
+            // the cold tier is rebuilt from the snapshot and the binlog with the memory table
+            std::string cold_path = GetColdPath(cold_root_path, tid, pid);
+            ::openmldb::base::RemoveDirRecursive(cold_path);
+            ::openmldb::api::TableMeta cold_meta(*table_meta);
+            cold_meta.set_storage_mode(table_meta->cold_storage_mode());
+            auto cold_table = std::make_shared<DiskTable>(cold_meta, cold_path);
+            if (!cold_table->Init()) {
+                PDLOG(WARNING, "fail to init cold tier. tid %u, pid %u", tid, pid);
+                msg.assign("fail to init cold tier");
+                delete mem_table;
+                return -1;
+            }
+            mem_table->SetColdTable(cold_table);
+        }
+        table_ptr = mem_table;
     } else {
         table_ptr = new DiskTable(*table_meta, table_db_path);
     }
@@ -4062,13 +4383,63 @@ std::shared_ptr<::openmldb::api::TaskInfo> TabletImpl::FindMultiTask(const ::ope
     return std::shared_ptr<::openmldb::api::TaskInfo>();
 }
 
+void TabletImpl::InitNuma() {
+    if (!FLAGS_enable_numa) {
+        return;
+    }
+    numa_topology_ = ::openmldb::base::NumaTopology::Create(FLAGS_numa_fake_topology);
+    if (!numa_topology_) {
+        PDLOG(WARNING, "fail to get numa topology [%s], numa is disabled", FLAGS_numa_fake_topology.c_str());
+        return;
+    }
+    uint32_t node_cnt = numa_topology_->GetNodeCnt();
+    for (uint32_t node = 0; node < node_cnt; node++) {
+        // the pages of a fake node can not be bound, they are placed by the writing thread
+        numa_arenas_.push_back(
+            std::make_shared<::openmldb::base::NumaArena>(numa_topology_->IsFake() ? -1 : static_cast<int>(node),
+                                                          FLAGS_numa_arena_max_waste_ratio));
+        numa_gc_pools_.emplace_back(new ThreadPool(FLAGS_gc_pool_size));
+        // every thread of the pool takes one of the binding tasks, as none of them returns before all are taken
+        auto latch = std::make_shared<::openmldb::base::CountDownLatch>(FLAGS_gc_pool_size);
+        auto topology = numa_topology_;
+        for (int32_t i = 0; i < FLAGS_gc_pool_size; i++) {
+            numa_gc_pools_.back()->AddTask([topology, node, latch]() {
+                if (!topology->BindCurrentThread(node)) {
+                    PDLOG(WARNING, "fail to bind gc thread to numa node %u", node);
+                }
+                latch->CountDown();
+                latch->Wait();
+            });
+        }
+        latch->Wait();
+    }
+    PDLOG(INFO, "numa is enabled with %u nodes%s", node_cnt, numa_topology_->IsFake() ? " (fake)" : "");
+    task_pool_.DelayTask(FLAGS_gc_interval * 60 * 1000, boost::bind(&TabletImpl::SchedNumaArenaStats, this));
+}
+
+void TabletImpl::SchedNumaArenaStats() {
+    for (uint32_t node = 0; node < numa_arenas_.size(); node++) {
+        const auto& arena = numa_arenas_[node];
+        PDLOG(INFO, "numa arena of node %u: live chunks %lu, used bytes %lu, waste ratio %.2f", node,
+              arena->GetLiveChunkCnt(), arena->GetUsedBytes(), arena->GetWasteRatio());
+    }
+    task_pool_.DelayTask(FLAGS_gc_interval * 60 * 1000, boost::bind(&TabletImpl::SchedNumaArenaStats, this));
+}
+
+ThreadPool& TabletImpl::GetGcPool(uint32_t pid) {
+    if (!numa_topology_) {
+        return gc_pool_;
+    }
+    return *numa_gc_pools_[numa_topology_->GetNode(pid)];
+}
+
 void TabletImpl::GcTable(uint32_t tid, uint32_t pid, bool execute_once) {
     std::shared_ptr<Table> table = GetTable(tid, pid);
     if (table) {
         int32_t gc_interval = table->GetStorageMode() == common::kMemory ? FLAGS_gc_interval : FLAGS_disk_gc_interval;
         table->SchedGc();
         if (!execute_once) {
-            gc_pool_.DelayTask(gc_interval * 60 * 1000, boost::bind(&TabletImpl::GcTable, this, tid, pid, false));
+            GetGcPool(pid).DelayTask(gc_interval * 60 * 1000, boost::bind(&TabletImpl::GcTable, this, tid, pid, false));
         }
         return;
     }
@@ -4175,6 +4546,14 @@ void TabletImpl::ShowMemPool(RpcController* controller, const ::openmldb::api::H
 #endif
 }
 
+void TabletImpl::DeployMetrics(RpcController* controller, const ::openmldb::api::HttpRequest* request,
+                               ::openmldb::api::HttpResponse* response, Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+    cntl->http_response().set_content_type("text/plain; version=0.0.4");
+    cntl->response_attachment().append(deploy_collector_->ExportPrometheus());
+}
+
 void TabletImpl::CheckZkClient() {
     if (zk_client_) {
         if (!zk_client_->IsConnected()) {
@@ -5420,7 +5799,7 @@ void TabletImpl::RunRequestQuery(RpcController* ctrl, const openmldb::api::Query
         return;
     }
     size_t buf_total_size;
-    if (!codec::EncodeRpcRow(output, &buf, &buf_total_size)) {
+    if (!codec::MoveRpcRow(&output, &buf, &buf_total_size)) {
         response.set_code(::openmldb::base::kSQLRunError);
         response.set_msg("fail to encode sql output row");
         return;
@@ -5523,6 +5902,10 @@ std::string TabletImpl::GetDBPath(const std::string& root_path, uint32_t tid, ui
     return root_path + "/" + std::to_string(tid) + "_" + std::to_string(pid);
 }
 
+std::string TabletImpl::GetColdPath(const std::string& cold_root_path, uint32_t tid, uint32_t pid) {
+    return GetDBPath(cold_root_path, tid, pid) + "/cold";
+}
+
 bool TabletImpl::IsCollectDeployStatsEnabled() const {
     auto p = std::atomic_load_explicit(&global_variables_, std::memory_order_relaxed);
     auto it = p->find(DEPLOY_STATS);
@@ -5554,7 +5937,7 @@ void TabletImpl::TryCollectDeployStats(const std::string& db, const std::string&
     if (!s.ok()) {
         LOG(ERROR) << "[ERROR] collect deploy stat: " << s;
     }
-    LOG(INFO) << "collected " << deploy_name << " for " << time;
+    DLOG(INFO) << "collected " << deploy_name << " for " << time;
 }
 
 void TabletImpl::BulkLoad(RpcController* controller, const ::openmldb::api::BulkLoadRequest* request,
@@ -5818,6 +6201,19 @@ void TabletImpl::GetAndFlushDeployStats(::google::protobuf::RpcController* contr
         new_row->set_count(r.count_);
         new_row->set_total(r.GetTotalAsStr(statistics::TimeUnit::MICRO_SECOND));
     }
+    for (auto& r : deploy_collector_->FlushLatencies()) {
+        if (r.count == 0) {
+            continue;
+        }
+        auto latency = response->add_latencies();
+        latency->set_deploy_name(r.deploy_name);
+        latency->set_count(r.count);
+        latency->set_p50(r.p50);
+        latency->set_p90(r.p90);
+        latency->set_p99(r.p99);
+        latency->set_p999(r.p999);
+        latency->set_max(r.max);
+    }
     response->set_code(ReturnCode::kOk);
 }
 
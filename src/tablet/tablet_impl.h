@@ -23,11 +23,14 @@
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <queue>
 #include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/numa.h"
+#include "base/rate_limiter.h"
 #include "base/spinlock.h"
 #include "catalog/tablet_catalog.h"
 #include "common/thread_pool.h"
@@ -43,6 +46,7 @@
 #include "tablet/combine_iterator.h"
 #include "tablet/file_receiver.h"
 #include "tablet/sp_cache.h"
+#include "tablet/table_status_tracker.h"
 #include "vm/engine.h"
 #include "zk/zk_client.h"
 
@@ -56,6 +60,7 @@ using ::openmldb::storage::Aggregator;
 using ::openmldb::storage::Aggrs;
 using ::openmldb::storage::IndexDef;
 using ::openmldb::storage::MemTable;
+using ::openmldb::storage::RecoverProgress;
 using ::openmldb::storage::Snapshot;
 using ::openmldb::storage::Table;
 using ::openmldb::zk::ZkClient;
@@ -71,6 +76,30 @@ typedef std::map<uint32_t, std::map<uint32_t, std::shared_ptr<LogReplicator>>> R
 typedef std::map<uint32_t, std::map<uint32_t, std::shared_ptr<Snapshot>>> Snapshots;
 typedef std::map<uint64_t, std::shared_ptr<Aggrs>> Aggregators;
 
+// memory table partition waiting to be loaded
+struct PendingLoad {
+    uint32_t tid;
+    uint32_t pid;
+    bool is_leader;
+    uint64_t total_bytes;
+    uint64_t seq;
+    std::shared_ptr<::openmldb::api::TaskInfo> task_ptr;
+};
+
+// leaders serve requests as soon as they are loaded, so they go first. larger
+// partitions start earlier to shorten the tail of the whole startup
+struct PendingLoadLess {
+    bool operator()(const PendingLoad& l, const PendingLoad& r) const {
+        if (l.is_leader != r.is_leader) {
+            return r.is_leader;
+        }
+        if (l.total_bytes != r.total_bytes) {
+            return l.total_bytes < r.total_bytes;
+        }
+        return l.seq > r.seq;
+    }
+};
+
 class TabletImpl : public ::openmldb::api::TabletServer {
  public:
     TabletImpl();
@@ -92,6 +121,9 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     void Scan(RpcController* controller, const ::openmldb::api::ScanRequest* request,
               ::openmldb::api::ScanResponse* response, Closure* done);
 
+    void MultiScan(RpcController* controller, const ::openmldb::api::MultiScanRequest* request,
+                   ::openmldb::api::MultiScanResponse* response, Closure* done);
+
     void Delete(RpcController* controller, const ::openmldb::api::DeleteRequest* request,
                 ::openmldb::api::GeneralResponse* response, Closure* done);
 
@@ -168,6 +200,9 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     void ShowMemPool(RpcController* controller, const ::openmldb::api::HttpRequest* request,
                      ::openmldb::api::HttpResponse* response, Closure* done);
 
+    void DeployMetrics(RpcController* controller, const ::openmldb::api::HttpRequest* request,
+                       ::openmldb::api::HttpResponse* response, Closure* done);
+
     void GetAllSnapshotOffset(RpcController* controller, const ::openmldb::api::EmptyRequest* request,
                               ::openmldb::api::TableSnapshotOffsetResponse* response, Closure* done);
 
@@ -299,6 +334,15 @@ class TabletImpl : public ::openmldb::api::TabletServer {
 
     std::shared_ptr<Aggrs> GetAggregatorsUnLock(uint32_t tid, uint32_t pid);
 
+    // create the node local arenas and gc pools if numa is enabled
+    void InitNuma();
+
+    // the gc pool on the numa node of a memory table partition
+    ThreadPool& GetGcPool(uint32_t pid);
+
+    // log the chunks and waste of the numa arenas every gc interval
+    void SchedNumaArenaStats();
+
     void GcTable(uint32_t tid, uint32_t pid, bool execute_once);
 
     void GcTableSnapshot(uint32_t tid, uint32_t pid);
@@ -350,6 +394,11 @@ class TabletImpl : public ::openmldb::api::TabletServer {
 
     int32_t DeleteTableInternal(uint32_t tid, uint32_t pid, std::shared_ptr<::openmldb::api::TaskInfo> task_ptr);
 
+    // pop the pending load with the highest priority and run it
+    void SchedLoadTable();
+
+    std::shared_ptr<RecoverProgress> GetLoadProgress(uint32_t tid, uint32_t pid);
+
     int LoadTableInternal(uint32_t tid, uint32_t pid, std::shared_ptr<::openmldb::api::TaskInfo> task_ptr);
     int LoadDiskTableInternal(uint32_t tid, uint32_t pid, const ::openmldb::api::TableMeta& table_meta,
                                       std::shared_ptr<::openmldb::api::TaskInfo> task_ptr);
@@ -426,6 +475,9 @@ class TabletImpl : public ::openmldb::api::TabletServer {
 
     std::string GetDBPath(const std::string& root_path, uint32_t tid, uint32_t pid);
 
+    // the cold tier of a memory table partition, used by both the load and the drop of it
+    std::string GetColdPath(const std::string& cold_root_path, uint32_t tid, uint32_t pid);
+
     bool IsCollectDeployStatsEnabled() const;
 
     // collect deploy statistics into memory
@@ -453,9 +505,16 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     ThreadPool task_pool_;
     ThreadPool io_pool_;
     ThreadPool snapshot_pool_;
+    std::mutex load_mu_;
+    std::priority_queue<PendingLoad, std::vector<PendingLoad>, PendingLoadLess> pending_loads_;
+    std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<RecoverProgress>> load_progress_;
+    uint64_t load_seq_;
+    ::openmldb::base::RateLimiter load_rate_limiter_;
+    ThreadPool load_pool_;
     std::map<uint64_t, std::list<std::shared_ptr<::openmldb::api::TaskInfo>>> task_map_;
     std::set<std::string> sync_snapshot_set_;
     std::map<std::string, std::shared_ptr<FileReceiver>> file_receiver_map_;
+    TableStatusTracker table_status_tracker_;
     BulkLoadMgr bulk_load_mgr_;
     std::map<::openmldb::common::StorageMode, std::vector<std::string>>
         mode_root_paths_;
@@ -480,6 +539,11 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     std::shared_ptr<std::map<std::string, std::string>> global_variables_;
 
     std::unique_ptr<openmldb::statistics::DeployQueryTimeCollector> deploy_collector_;
+
+    // null if numa is disabled. partitions are homed to nodes by pid
+    std::shared_ptr<::openmldb::base::NumaTopology> numa_topology_;
+    std::vector<std::shared_ptr<::openmldb::base::NumaArena>> numa_arenas_;
+    std::vector<std::unique_ptr<ThreadPool>> numa_gc_pools_;
 };
 
 }  // namespace tablet
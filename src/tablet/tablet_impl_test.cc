@@ -51,6 +51,8 @@ DECLARE_int32(disk_gc_interval);
 DECLARE_int32(make_snapshot_threshold_offset);
 DECLARE_int32(binlog_delete_interval);
 DECLARE_uint32(max_traverse_cnt);
+DECLARE_uint32(scan_max_bytes_size);
+DECLARE_uint32(multi_scan_max_key_cnt);
 DECLARE_bool(recycle_bin_enabled);
 DECLARE_string(recycle_bin_root_path);
 DECLARE_string(recycle_bin_ssd_root_path);
@@ -1950,6 +1952,73 @@ TEST_P(TabletImplTest, ScanWithLimit) {
     ASSERT_EQ(2, (signed)srp.count());
 }
 
+TEST_P(TabletImplTest, MultiScanLimit) {
+    ::openmldb::common::StorageMode storage_mode = GetParam();
+    TabletImpl tablet;
+    uint32_t id = counter++;
+    tablet.Init("");
+    ::openmldb::api::CreateTableRequest request;
+    ::openmldb::api::TableMeta* table_meta = request.mutable_table_meta();
+    table_meta->set_name("t0");
+    table_meta->set_tid(id);
+    table_meta->set_pid(1);
+    table_meta->set_storage_mode(storage_mode);
+    AddDefaultSchema(0, 0, ::openmldb::type::TTLType::kAbsoluteTime, table_meta);
+    ::openmldb::api::CreateTableResponse response;
+    MockClosure closure;
+    tablet.CreateTable(NULL, &request, &response, &closure);
+    ASSERT_EQ(0, response.code());
+    ::openmldb::api::MultiScanRequest mr;
+    mr.set_tid(id);
+    mr.set_pid(1);
+    uint32_t row_size = 0;
+    for (int i = 0; i < 10; i++) {
+        std::string key = "test" + std::to_string(i);
+        ::openmldb::api::PutRequest prequest;
+        PackDefaultDimension(key, &prequest);
+        prequest.set_time(9527);
+        prequest.set_value(::openmldb::test::EncodeKV(key, "value0"));
+        prequest.set_tid(id);
+        prequest.set_pid(1);
+        ::openmldb::api::PutResponse presponse;
+        tablet.Put(NULL, &prequest, &presponse, &closure);
+        ASSERT_EQ(0, presponse.code());
+        row_size = prequest.value().size();
+        auto* scan = mr.add_scans();
+        scan->set_pk(key);
+        scan->set_st(9528);
+        scan->set_et(0);
+    }
+    uint32_t old_max_bytes = FLAGS_scan_max_bytes_size;
+    uint32_t old_max_keys = FLAGS_multi_scan_max_key_cnt;
+    {
+        brpc::Controller cntl;
+        ::openmldb::api::MultiScanResponse mrp;
+        tablet.MultiScan(&cntl, &mr, &mrp, &closure);
+        ASSERT_EQ(0, mrp.code());
+        ASSERT_EQ(10, mrp.count_size());
+        ASSERT_EQ(10 * row_size, cntl.response_attachment().size());
+    }
+    {
+        // every key is under the limit, all of them are not
+        FLAGS_scan_max_bytes_size = 5 * row_size;
+        brpc::Controller cntl;
+        ::openmldb::api::MultiScanResponse mrp;
+        tablet.MultiScan(&cntl, &mr, &mrp, &closure);
+        ASSERT_EQ(::openmldb::base::ReturnCode::kReacheTheScanMaxBytesSize, mrp.code());
+        ASSERT_EQ(0u, cntl.response_attachment().size());
+        FLAGS_scan_max_bytes_size = old_max_bytes;
+    }
+    {
+        FLAGS_multi_scan_max_key_cnt = 5;
+        brpc::Controller cntl;
+        ::openmldb::api::MultiScanResponse mrp;
+        tablet.MultiScan(&cntl, &mr, &mrp, &closure);
+        ASSERT_EQ(::openmldb::base::ReturnCode::kInvalidParameter, mrp.code());
+        FLAGS_multi_scan_max_key_cnt = old_max_keys;
+    }
+}
+
 TEST_P(TabletImplTest, Scan) {
     ::openmldb::common::StorageMode storage_mode = GetParam();
     TabletImpl tablet;
@@ -2367,6 +2436,56 @@ TEST_F(TabletImplTest, DropTableNoRecycleDisk) {
     FLAGS_recycle_bin_hdd_root_path = tmp_recycle_bin_hdd_root_path;
 }
 
+TEST_F(TabletImplTest, DropTableColdTier) {
+    bool tmp_recycle_bin_enabled = FLAGS_recycle_bin_enabled;
+    std::string tmp_db_root_path = FLAGS_db_root_path;
+    std::string tmp_hdd_root_path = FLAGS_hdd_root_path;
+    std::vector<std::string> file_vec;
+    FLAGS_recycle_bin_enabled = false;
+    FLAGS_db_root_path = "/tmp/gtest/db";
+    FLAGS_hdd_root_path = "/tmp/gtest/hdd";
+    ::openmldb::base::RemoveDirRecursive("/tmp/gtest");
+    TabletImpl tablet;
+    uint32_t id = counter++;
+    tablet.Init("");
+    MockClosure closure;
+
+    // the cold tier is under the hdd root, apart from the memory table
+    ::openmldb::api::CreateTableRequest request;
+    ::openmldb::api::TableMeta* table_meta = request.mutable_table_meta();
+    table_meta->set_name("t0");
+    table_meta->set_tid(id);
+    table_meta->set_pid(1);
+    table_meta->set_storage_mode(::openmldb::common::kMemory);
+    table_meta->set_cold_age(10);
+    table_meta->set_cold_storage_mode(::openmldb::common::kHDD);
+    AddDefaultSchema(0, 0, ::openmldb::type::TTLType::kAbsoluteTime, table_meta);
+    table_meta->set_mode(::openmldb::api::TableMode::kTableLeader);
+    ::openmldb::api::CreateTableResponse response;
+    tablet.CreateTable(NULL, &request, &response, &closure);
+    ASSERT_EQ(0, response.code());
+    std::string cold_path = FLAGS_hdd_root_path + "/" + std::to_string(id) + "_1/cold";
+    ASSERT_TRUE(::openmldb::base::IsExists(cold_path));
+
+    ::openmldb::api::DropTableRequest dr;
+    dr.set_tid(id);
+    dr.set_pid(1);
+    ::openmldb::api::DropTableResponse drs;
+    tablet.DropTable(NULL, &dr, &drs, &closure);
+    ASSERT_EQ(0, drs.code());
+    sleep(1);
+    ASSERT_FALSE(::openmldb::base::IsExists(cold_path));
+    ::openmldb::base::GetChildFileName(FLAGS_hdd_root_path, file_vec);
+    ASSERT_TRUE(file_vec.empty());
+    file_vec.clear();
+    ::openmldb::base::GetChildFileName(FLAGS_db_root_path, file_vec);
+    ASSERT_TRUE(file_vec.empty());
+    ::openmldb::base::RemoveDirRecursive("/tmp/gtest");
+    FLAGS_recycle_bin_enabled = tmp_recycle_bin_enabled;
+    FLAGS_db_root_path = tmp_db_root_path;
+    FLAGS_hdd_root_path = tmp_hdd_root_path;
+}
+
 TEST_P(TabletImplTest, Recover) {
     ::openmldb::common::StorageMode storage_mode = GetParam();
     uint32_t id = counter++;